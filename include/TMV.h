@@ -30,9 +30,11 @@
 #include "tmv/TMV_Matrix.h"
 
 #include "tmv/TMV_LUD.h"
+#include "tmv/TMV_LUMixedD.h"
 #include "tmv/TMV_QRD.h"
 #include "tmv/TMV_QRPD.h"
 #include "tmv/TMV_SVD.h"
+#include "tmv/TMV_Schur.h"
 
 #include "tmv/TMV_VectorArith.h"
 #include "tmv/TMV_MatrixArith.h"
@@ -31,5 +31,6 @@
 #include "tmv/TMV_BandQRD.h"
 #include "tmv/TMV_BandSVD.h"
 #include "tmv/TMV_BandMatrixArith.h"
+#include "tmv/TMV_BatchedBandMatrix.h"
 
 #endif
@@ -30,5 +30,6 @@
 #include "tmv/TMV_SmallVectorArith.h"
 #include "tmv/TMV_SmallMatrixArith.h"
 #include "tmv/TMV_SmallMatrixDiv.h"
+#include "tmv/TMV_BatchedSmallMatrix.h"
 
 #endif
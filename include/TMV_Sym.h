@@ -29,8 +29,11 @@
 #include "tmv/TMV_SymMatrix.h"
 #include "tmv/TMV_SymLDLD.h"
 #include "tmv/TMV_SymSVD.h"
+#include "tmv/TMV_SymIterEigen.h"
 #include "tmv/TMV_SymCHD.h"
 #include "tmv/TMV_SymMatrixArith.h"
 #include "tmv/TMV_SymHouseholder.h"
+#include "tmv/TMV_Factorization.h"
+#include "tmv/TMV_SolveQueue.h"
 
 #endif
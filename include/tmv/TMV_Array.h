@@ -24,12 +24,16 @@
 // memory.
 //
 // First, AlignedArray works basically like a regular new v[]
-// allocation, except that if we are doing SSE or SSE2, then we enforce
-// that the allocation is aligned on a 128 byte boundary.
+// allocation, except that the allocation is aligned to a configurable
+// boundary (64 bytes by default), and large allocations may be backed
+// by huge pages.
 //
 // Second, StackArray is used for small arrays and emulates a normal C array
 // on the stack: T v[N].  However, when N is large, it uses the
 // heap instead to avoid stack overflows.
+//
+// The heap memory for AlignedArray comes from an Allocator, which may
+// be set per thread.  See the description below.
 
 #ifndef Array_H
 #define Array_H
@@ -44,20 +48,167 @@ namespace tmv
     inline bool TMV_Aligned(const T* p)
     { return (reinterpret_cast<ptrdiff_t>(p) & 0xf) == 0; }
 
-    // There doesn't seem to be any portable C++ function that guarantees
-    // that the memory allocated will be aligned as necessary for
-    // SSE functions.
-    // Sometimes posix_memalign or memalign does this job.
-    // But it doesn't seem to be standard, since some systems don't have it.
-    // Other systems have _mm_malloc (ICPC) or _aligned_malloc (WIN).
-    // So probably I should have ifdefs that check to see if one of these
-    // is available and use that instead.
+    // The memory for AlignedArray (and hence for Vector, Matrix, etc.
+    // and all of the temporaries used in the arithmetic and division
+    // routines) comes from an Allocator.  By default, this is just the
+    // global heap via new [].  But if you are doing the same kinds of
+    // calculations over and over (e.g. decomposing many matrices of the
+    // same size), you can avoid going back to the heap every time
+    // by installing a different allocator.
+    //
+    // The allocator is set per thread.  The easiest way to do this is
+    // with an AllocatorGuard, which installs an allocator for the
+    // lifetime of the guard and then restores the previous one:
+    //
+    //     tmv::PoolAllocator pool;
+    //     for(...) {
+    //         tmv::AllocatorGuard guard(pool);
+    //         ...
+    //     }
     //
-    // But for now we have this simple class that simply loads a bit more
-    // memory than necessary and then finds the starting point that is
-    // 16 byte aligned.
+    // Each array remembers the allocator that provided its memory and
+    // gives it back to the same one, so the allocator must outlive any
+    // arrays that were allocated from it.  The two allocators provided
+    // here are not thread safe, so arrays allocated from them should be
+    // destroyed by the same thread that made them.  (Worker threads in
+    // an OpenMP parallel region use their own allocator, which is the
+    // global heap unless they install something else.)
+    //
+    // You can also write your own allocator by deriving from Allocator.
+    // The memory returned by allocate must be aligned to (at least) 
+    // align bytes, which is always a power of 2.  The easiest way to do
+    // that is to get the memory from HeapAllocate (see below).
+    class Allocator
+    {
+    public :
+        virtual ~Allocator() {}
+        virtual void* allocate(size_t nbytes, size_t align) = 0;
+        virtual void deallocate(void* p, size_t nbytes) = 0;
+    };
 
-    // Also, the TMV_END_PADDING option is implemented here.  If it is
+    // Get or set the allocator for the current thread.  0 means the
+    // global heap.  SetAllocator returns the previous value.
+    Allocator* GetAllocator();
+    Allocator* SetAllocator(Allocator* alloc);
+
+    class AllocatorGuard
+    {
+    public :
+        explicit AllocatorGuard(Allocator& alloc) :
+            itsprev(SetAllocator(&alloc)) {}
+        ~AllocatorGuard() { SetAllocator(itsprev); }
+    private :
+        Allocator* itsprev;
+
+        AllocatorGuard(const AllocatorGuard&);
+        AllocatorGuard& operator=(const AllocatorGuard&);
+    };
+
+    // PoolAllocator keeps freed blocks in lists by size class (powers
+    // of 2) and hands them out again when a block of the same class
+    // is requested.  Blocks are only returned to the heap when the pool
+    // is destroyed or when release() is called.
+    class PoolAllocator : public Allocator
+    {
+    public :
+        PoolAllocator();
+        ~PoolAllocator();
+        void* allocate(size_t nbytes, size_t align);
+        void deallocate(void* p, size_t nbytes);
+        // Return all of the currently unused blocks to the heap.
+        void release();
+    private :
+        enum { NCLASS = 8*sizeof(size_t) };
+        void* itsfree[NCLASS];
+
+        PoolAllocator(const PoolAllocator&);
+        PoolAllocator& operator=(const PoolAllocator&);
+    };
+
+    // ArenaAllocator hands out consecutive pieces of a large chunk of
+    // memory, getting a new chunk from the heap when the current one
+    // is full.  The memory is reclaimed all at once when everything
+    // allocated from the arena has been deallocated.  At that point,
+    // if more than one chunk was needed, they are replaced by a single
+    // chunk big enough for all of them, so a repeated calculation
+    // will not need to go to the heap after the first time through.
+    class ArenaAllocator : public Allocator
+    {
+    public :
+        explicit ArenaAllocator(size_t chunksize=(1<<20));
+        ~ArenaAllocator();
+        void* allocate(size_t nbytes, size_t align);
+        void deallocate(void* p, size_t nbytes);
+        // The total capacity of the arena in bytes.
+        size_t capacity() const { return itstotal; }
+    private :
+        struct Chunk;
+        Chunk* itschunk;
+        size_t itschunksize;
+        size_t itstotal;
+        size_t itsused;
+        ptrdiff_t itsnlive;
+
+        void newChunk(size_t nbytes);
+        void freeChunks();
+
+        ArenaAllocator(const ArenaAllocator&);
+        ArenaAllocator& operator=(const ArenaAllocator&);
+    };
+
+    // These count, for the current thread, the number of allocations
+    // made for AlignedArrays (through whichever allocator is active),
+    // and the number of those (including the chunks or blocks
+    // that PoolAllocator and ArenaAllocator get for themselves) that 
+    // actually went to the heap.  This is useful to check that a
+    // calculation does not need to do any heap allocations when using 
+    // an allocator.
+    ptrdiff_t AllocationCount();
+    ptrdiff_t HeapAllocationCount();
+    void ResetAllocationCounts();
+
+    // The alignment of the memory allocated for AlignedArrays.
+    //
+    // The default is 64 bytes, which is the width of an AVX-512 register
+    // and the size of a cache line on most current machines.  This can
+    // be changed when compiling the library by defining TMV_ALIGNMENT to
+    // some other power of 2 (at least 16, which SSE needs), or at run
+    // time with SetAlignment.  The value is global, not per thread, so
+    // it should be set before any other threads are allocating memory.
+#ifndef TMV_ALIGNMENT
+#define TMV_ALIGNMENT 64
+#endif
+    size_t GetAlignment();
+    void SetAlignment(size_t align);
+
+    // Large allocations are aligned to the start of a huge page (2MB),
+    // and on Linux they are marked with madvise(MADV_HUGEPAGE), so the
+    // kernel can back them with transparent huge pages.  This greatly
+    // reduces the number of TLB misses when working with very large
+    // matrices.  Allocations of at least GetHugePageThreshold() bytes
+    // are treated this way.  The default is 32MB, which can be changed 
+    // with TMV_HUGEPAGE_THRESHOLD or SetHugePageThreshold.  
+    // A value of 0 turns this off.
+#ifndef TMV_HUGEPAGE_THRESHOLD
+#define TMV_HUGEPAGE_THRESHOLD (size_t(1)<<25)
+#endif
+    const size_t TMV_HugePageSize = size_t(1)<<21;
+    size_t GetHugePageThreshold();
+    void SetHugePageThreshold(size_t nbytes);
+
+    // The functions that AlignedMemory uses for all of its memory.
+    // AllocateBytes uses the current thread's allocator and records
+    // it in alloc, so the memory can be returned to the same place.
+    // The memory is aligned to GetAlignment() bytes.
+    void* AllocateBytes(size_t nbytes, Allocator*& alloc);
+    void DeallocateBytes(void* p, size_t nbytes, Allocator* alloc);
+    // Direct aligned heap allocation, included in HeapAllocationCount.
+    // This uses posix_memalign (or _aligned_malloc on Windows), and
+    // applies the huge page treatment described above.
+    void* HeapAllocate(size_t nbytes, size_t align);
+    void HeapDeallocate(void* p);
+
+    // The TMV_END_PADDING option is implemented here.  If it is
     // defined, then we write 0's to the end of the full 16 byte word.
     // This is mostly useful when running valgrind with a BLAS library
     // that isn't careful about reading past the end of the allocated
@@ -65,115 +216,41 @@ namespace tmv
     // So if end padding is enabled, we make sure to allocate enough memory
     // to finish the block of 16 bytes.  And we write 0's to the values
     // that aren't part of the requested memory.
-
-    // First the regular non-SSE version, where we don't need aligment.
+    //
+    // All of the types used here (float, double, int, ptrdiff_t, etc.)
+    // are trivial, so we can just use the raw memory from the allocator.
     template <typename T>
     class AlignedMemory
     {
     public:
-        inline AlignedMemory() : p(0) {}
+        inline AlignedMemory() : p(0), nb(0), alloc(0) {}
         inline void allocate(const ptrdiff_t n)
         {
 #ifdef TMV_END_PADDING
-            const ptrdiff_t nn = n + 16/sizeof(T);
-            p = new T[nn];
+            const ptrdiff_t nn = n + (16+sizeof(T)-1)/sizeof(T);
+            nb = nn*sizeof(T);
+            p = static_cast<T*>(AllocateBytes(nb,alloc));
             for(ptrdiff_t i=n;i<nn;++i) p[i] = T(0);
 #else
-            p = new T[n];
+            nb = n*sizeof(T);
+            p = static_cast<T*>(AllocateBytes(nb,alloc));
 #endif
+            TMVAssert(TMV_Aligned(p));
         }
         inline void deallocate()
-        { if (p) delete [] p; p=0; }
+        { if (p) DeallocateBytes(p,nb,alloc); p=0; }
         inline void swapWith(AlignedMemory<T>& rhs)
-        { T* temp = p; p = rhs.p; rhs.p = temp; }
+        {
+            T* temp = p; p = rhs.p; rhs.p = temp;
+            size_t temp2 = nb; nb = rhs.nb; rhs.nb = temp2;
+            Allocator* temp3 = alloc; alloc = rhs.alloc; rhs.alloc = temp3;
+        }
         inline T* get() { return p; }
         inline const T* get() const { return p; }
     private:
         T* p;
-    };
-
-    // Now specialize float and double
-    // We do this regardless of whether __SSE__ or __SSE2__ is defined,
-    // since these might be allocated in a unit that doesn't defined them
-    // and then have get() called in a unit that does.  This leads to problems!
-    // So we always make the float and double allocations aligned at
-    // 16 byte boundaries.
-    template <>
-    class AlignedMemory<float>
-    {
-    public:
-        AlignedMemory() : mem(0), p(0) {}
-        inline void allocate(const ptrdiff_t n)
-        {
-#ifdef TMV_END_PADDING
-            const ptrdiff_t nn = (n<<2)+15 + 16;
-            mem = new char[nn];
-            p = calculateP();
-            for(ptrdiff_t i=n;i<(nn>>2);++i) p[i] = 0.F;
-#else
-            mem = new char[(n<<2)+15];
-            p = calculateP();
-#endif
-            TMVAssert((void*)(mem+(n<<2)+15) >= (void*)(p+n));
-        }
-        inline void deallocate()
-        { if (mem) delete [] mem; mem=0; p=0; }
-        inline void swapWith(AlignedMemory<float>& rhs)
-        {
-            char* temp1 = mem; mem = rhs.mem; rhs.mem = temp1;
-            float* temp2 = p; p = rhs.p; rhs.p = temp2;
-        }
-        inline float* get() { return p; }
-        inline float* calculateP()
-        {
-            float* pf = reinterpret_cast<float*>(
-                mem + ((0x10-((ptrdiff_t)(mem) & 0xf)) & ~0x10));
-            TMVAssert( ((ptrdiff_t)(pf) & 0xf) == 0);
-            return pf;
-        }
-        inline const float* get() const  { return p; }
-    private:
-        char* mem;
-        float* p;
-    };
-    template <>
-    class AlignedMemory<double>
-    {
-    public:
-        AlignedMemory() : mem(0), p(0) {}
-        inline void allocate(const ptrdiff_t n)
-        {
-#ifdef TMV_END_PADDING
-            const ptrdiff_t nn = (n<<3)+15 + 16;
-            mem = new char[nn];
-            p = calculateP();
-            for(ptrdiff_t i=n;i<(nn>>3);++i) p[i] = 0.;
-#else
-            mem = new char[(n<<3)+15];
-            p = calculateP();
-#endif
-            TMVAssert((void*)(mem+(n<<3)+15) >= (void*)(p+n));
-        }
-        inline void deallocate()
-        { if (mem) delete [] mem; mem=0; p=0; }
-        inline void swapWith(AlignedMemory<double>& rhs)
-        {
-            char* temp1 = mem; mem = rhs.mem; rhs.mem = temp1;
-            double* temp2 = p; p = rhs.p; rhs.p = temp2;
-        }
-        inline double* calculateP()
-        {
-            double* pd = reinterpret_cast<double*>(
-                mem + ((0x10-((ptrdiff_t)(mem) & 0xf)) & ~0x10));
-            TMVAssert( ((ptrdiff_t)(pd) & 0xf) == 0);
-            return pd;
-        }
-        inline double* get() { return p; }
-        inline const double* get() const { return p; }
-
-    private :
-        char* mem;
-        double* p;
+        size_t nb;
+        Allocator* alloc;
     };
 
 #ifdef TMV_INITIALIZE_NAN
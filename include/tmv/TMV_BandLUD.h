@@ -92,6 +92,43 @@ namespace tmv {
     inline void LU_Decompose(BandMatrix<T,A1>& LUx, Permutation& P, ptrdiff_t Anhi)
     { LU_Decompose(LUx.view(),P,Anhi); }
 
+    // Large band matrices with small bandwidth (nlo,nhi <= 16) are 
+    // LU decomposed with a partitioned (SPIKE) algorithm, which splits 
+    // both the decomposition and subsequent divisions across OpenMP 
+    // threads.  It is used when there are at least minrows rows per 
+    // thread.  UseBandSpike(0) turns it off.
+    // If nparts > 0, it uses that many partitions regardless of the 
+    // number of threads.  (This is mostly useful for testing.)
+    // The regular decomposition is still calculated if you access it
+    // with getL(), getU(), etc., or need it for something other than 
+    // left division (e.g. x%m, det, inverse).
+    struct BandSpikeSingleton
+    {
+        // Same caveat as QRP_StrictSingleton about thread safety.
+        static inline ptrdiff_t& minrows()
+        {
+            static ptrdiff_t n = 4096;
+            return n;
+        }
+        static inline int& nparts()
+        {
+            static int n = 0;
+            return n;
+        }
+    };
+
+    inline void UseBandSpike(ptrdiff_t minrows=4096, int nparts=0)
+    { 
+        BandSpikeSingleton::minrows() = minrows;
+        BandSpikeSingleton::nparts() = nparts;
+    }
+
+    inline ptrdiff_t BandSpike_MinRows()
+    { return BandSpikeSingleton::minrows(); }
+
+    inline int BandSpike_NumParts()
+    { return BandSpikeSingleton::nparts(); }
+
     template <typename T>
     class BandLUDiv : public Divider<T>
     {
@@ -140,6 +177,8 @@ namespace tmv {
         //
 
         bool isTrans() const;
+        // Whether the partitioned algorithm is used for left division.
+        bool isPartitioned() const;
         LowerTriMatrix<T,UnitDiag> getL() const;
         ConstBandMatrixView<T> getU() const;
         const GenBandMatrix<T>& getLU() const;
@@ -960,6 +960,7 @@ namespace tmv {
         { return (j+nlo() >= i && i+nhi() >= j); }
 
         inline const BaseMatrix<T>& getMatrix() const { return *this; }
+        Divider<T>* newDiv() const;
 
     private :
 
@@ -4062,9 +4063,9 @@ namespace tmv {
             stor == RowMajor ? 1 :
             stor == ColMajor ? nlo+nhi :
             rs >= cs ? cs : rs+1 );
-        T* m0 = (stor == DiagMajor) ? m - nlo*ptrdiff_t(stepi) : m;
+        const T* m0 = (stor == DiagMajor) ? m - nlo*ptrdiff_t(stepi) : m;
         return ConstBandMatrixView<T>(
-            m0,cs,rs,nlo,nhi,stepi,stepj,NonConj);
+            m0,cs,rs,nlo,nhi,stepi,stepj,stepi+stepj,NonConj);
     }
 
     template <typename T>
@@ -208,16 +208,19 @@ namespace tmv {
 
     enum DivType {
         XX=0, LU=1, CH=2, QR=4, QRP=8, SV=16,
+        // LU decomposition done in lower precision, with the solutions
+        // refined to full precision.  (See TMV_LUMixedD.h)
+        LUMixed=32,
         // We store the divtype in a binary field integer.
         // In addition to the above, we also use the same object to
         // store the following other flags related to division.
         // So these values must not clash with the above DivType values.
         // These aren't technically DivType's but since they are
         // stored together, I think this adds to type-safety.
-        DivInPlaceFlag = 32,
-        SaveDivFlag = 64,
+        DivInPlaceFlag = 64,
+        SaveDivFlag = 128,
         // And finally shorthand for "one of the real DivType's":
-        DivTypeFlags = 31
+        DivTypeFlags = 63
     };
     inline DivType operator|(DivType a, DivType b)
     {
@@ -865,6 +868,7 @@ namespace tmv {
             d==QR ? "QR" :
             d==QRP ? "QRP" :
             d==SV ? "SV" :
+            d==LUMixed ? "LUMixed" :
             "unkown DivType";
     }
 
@@ -40,6 +40,10 @@
 #include "tmv/TMV_BaseVector.h"
 #include "tmv/TMV_IOStyle.h"
 
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
 namespace tmv {
 
     template <typename T>
@@ -66,6 +70,9 @@ namespace tmv {
     template <typename T>
     class Divider;
 
+    template <typename T>
+    class DivHelper;
+
     template <typename T>
     struct AssignableToMatrix
     {
@@ -131,6 +138,64 @@ namespace tmv {
 
     }; // BaseMatrix
 
+    // The pointer to the Divider that DivHelper creates lazily.
+    // It acts like an auto_ptr, but with C++11, the pointer is atomic, 
+    // so that one thread may create the Divider while others read it.
+    // The creation is protected by a lock (see DivLock), so it only 
+    // happens once, but once the Divider exists, reading it takes
+    // no locks at all.
+    template <typename T>
+    class DivPtr
+    {
+    public :
+
+        DivPtr() : p(0) {}
+        ~DivPtr() { delete get(); }
+
+#if __cplusplus >= 201103L
+        Divider<T>* get() const 
+        { return p.load(std::memory_order_acquire); }
+        void reset(Divider<T>* q=0) 
+        { delete p.exchange(q,std::memory_order_acq_rel); }
+        Divider<T>* release() 
+        { return p.exchange(0,std::memory_order_acq_rel); }
+#else
+        Divider<T>* get() const { return p; }
+        void reset(Divider<T>* q=0) 
+        { if (q != p) { delete p; p = q; } }
+        Divider<T>* release() 
+        { Divider<T>* q = p; p = 0; return q; }
+#endif
+        Divider<T>* operator->() const { return get(); }
+        Divider<T>& operator*() const { return *get(); }
+
+    private :
+
+#if __cplusplus >= 201103L
+        std::atomic<Divider<T>*> p;
+#else
+        Divider<T>* p;
+#endif
+
+        DivPtr(const DivPtr<T>&);
+        DivPtr<T>& operator=(const DivPtr<T>&);
+    };
+
+    // Holds the lock for creating the Divider of a particular matrix
+    // while in scope.  (The lock is recursive, so a thread that already
+    // holds it can safely take it again.)
+    template <typename T>
+    class DivLock
+    {
+    public :
+        DivLock(const DivHelper<T>& dh) : itsdh(dh) { itsdh.lockDiv(); }
+        ~DivLock() { itsdh.unlockDiv(); }
+    private :
+        const DivHelper<T>& itsdh;
+        DivLock(const DivLock<T>&);
+        DivLock<T>& operator=(const DivLock<T>&);
+    };
+
     template <typename T>
     class DivHelper : virtual public AssignableToMatrix<T>
     {
@@ -323,14 +388,40 @@ namespace tmv {
         const Divider<T>* getDiv() const;
         void resetDivType() const;
 
+        // Set divtype to the default for this matrix if divideUsing was
+        // never called.  This writes to divtype, so when several threads 
+        // may divide at once, it needs to be called under the DivLock.
+        void setDefaultDivType() const;
+
+        // Get the Divider, calling setDiv() if necessary.
+        // If the Divider is saved, this is safe to call from several 
+        // threads at once.  The first one creates it, and the rest 
+        // wait for it to be done.  Once it exists, no locks are used.
+        // If it is not saved, each thread makes its own Divider in temp,
+        // which owns it, and no lock is needed unless the decomposition
+        // is done in place.
+        const Divider<T>* acquireDiv(auto_ptr<Divider<T> >& temp) const;
+
+        // Make a new Divider of the current DivType without storing it
+        // in this object.  setDiv() uses it under the lock, and 
+        // acquireDiv() uses it without any lock when the Divider is 
+        // not saved, so it must not modify the matrix.  Both call 
+        // setDefaultDivType() first.  Matrix types that don't use a 
+        // Divider return 0.
+        virtual Divider<T>* newDiv() const { return 0; }
+
         // Two more that need to be defined in the derived class:
         virtual const BaseMatrix<T>& getMatrix() const = 0;
 
-        mutable auto_ptr<Divider<T> > divider;
+        mutable DivPtr<T> divider;
         mutable DivType divtype;
 
     private :
 
+        friend class DivLock<T>;
+        void lockDiv() const;
+        void unlockDiv() const;
+
         DivHelper(const DivHelper<T>&);
         DivHelper<T>& operator=(const DivHelper<T>&);
 
@@ -0,0 +1,363 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV BatchedBandMatrix class.
+//
+// A BatchedBandMatrix holds nbatch independent NxN band matrices, all
+// with the same nlo and nhi, in a structure-of-arrays layout: element
+// (i,j) of every matrix in the batch is stored contiguously.  It is the
+// band matrix analog of BatchedSmallMatrix, but with the sizes set at
+// run time.
+//
+// This is intended for applications like ADI methods, which need to
+// solve many thousands of independent tridiagonal (or narrow band)
+// systems of moderate size, where constructing a BandMatrix and
+// BandLUDiv for each one would dominate the calculation.
+//
+// The right hand sides for the batch are given as a column major
+// nbatch x N Matrix B, so B(k,i) is element i of the k-th vector.
+// Thus the same interleaved layout applies to them: column i of B is
+// element i of every vector in the batch.
+//
+// Constructors:
+//
+//    BatchedBandMatrix<T>(ptrdiff_t nbatch, ptrdiff_t N, int nlo, int nhi)
+//        Makes a batch of nbatch NxN band matrices with _uninitialized_
+//        values.
+//
+//    BatchedBandMatrix<T>(ptrdiff_t nbatch, ptrdiff_t N, int nlo, int nhi,
+//            T x)
+//        Makes a batch of band matrices with all values in the band = x
+//
+// Access:
+//
+//    m(k,i,j)
+//        Returns element (i,j) of the k-th matrix in the batch.
+//        (i,j) must be in the band.
+//
+//    m.get(k)
+//        Returns a copy of the k-th matrix as a BandMatrix<T>.
+//
+//    m.set(k,m2)
+//        Sets the k-th matrix to be a copy of the band matrix m2.
+//
+// Batched solvers:
+//
+//    BatchTridiag_Solve(A,B,work)
+//        Solves A(k) x(k) = B(k) for each k using the Thomas algorithm,
+//        which is Gaussian elimination without pivoting.  A must be
+//        tridiagonal, and each A(k) should be diagonally dominant (or
+//        otherwise safe to decompose without pivoting), as is usual for
+//        ADI systems.  B is overwritten with x.
+//
+//    BatchBandLU_Solve(A,B,work)
+//        Solves A(k) x(k) = B(k) for each k using a band LU decomposition
+//        with partial pivoting.  The pivoting is done with conditional
+//        assignments rather than branches, so it vectorizes across the
+//        batch too.  B is overwritten with x.
+//
+// A is not modified by either solver.  The work is done in a copy of
+// each chunk of the batch in work, which is a BatchBandWorkspace<T>.
+// The workspace is resized as needed, so if you reuse the same one for
+// each call (e.g. once per time step), the memory is only allocated the
+// first time.  It may not be used by two calls at the same time though.
+// The versions without the work argument use a temporary workspace.
+//
+// The batch is split into chunks of TMV_BATCHBAND_CHUNK systems, which
+// are done in parallel with OpenMP (when it is enabled).
+//
+// Like the BatchedSmallMatrix routines, these don't check for singular
+// matrices.  A singular matrix just produces inf or nan values in
+// its own part of B without affecting the rest of the batch.
+
+
+#ifndef TMV_BatchedBandMatrix_H
+#define TMV_BatchedBandMatrix_H
+
+#include "tmv/TMV_BandMatrix.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Array.h"
+
+namespace tmv {
+
+    // The number of systems that are processed together by each call
+    // to the solver kernels.
+    const ptrdiff_t TMV_BATCHBAND_CHUNK = 64;
+
+    template <typename T>
+    class BatchedBandMatrix
+    {
+    public:
+
+        typedef T value_type;
+        typedef TMV_RealType(T) real_type;
+        typedef BatchedBandMatrix<T> type;
+        typedef T& reference;
+
+        //
+        // Constructors
+        //
+
+        inline BatchedBandMatrix(
+            ptrdiff_t nbatch, ptrdiff_t N, int nlo, int nhi) :
+            itsnb(nbatch), itsn(N), itsnlo(nlo), itsnhi(nhi),
+            itss(RoundUpStride(nbatch)), itsm(N*(nlo+nhi+1)*itss)
+        {
+            TMVAssert(nbatch>=0);
+            TMVAssert(N>=0);
+            TMVAssert(nlo>=0 && nhi>=0);
+#ifdef TMV_EXTRA_DEBUG
+            setAllTo(T(888));
+#endif
+        }
+
+        inline BatchedBandMatrix(
+            ptrdiff_t nbatch, ptrdiff_t N, int nlo, int nhi, const T& x) :
+            itsnb(nbatch), itsn(N), itsnlo(nlo), itsnhi(nhi),
+            itss(RoundUpStride(nbatch)), itsm(N*(nlo+nhi+1)*itss)
+        {
+            TMVAssert(nbatch>=0);
+            TMVAssert(N>=0);
+            TMVAssert(nlo>=0 && nhi>=0);
+            setAllTo(x);
+        }
+
+        inline BatchedBandMatrix(const type& m2) :
+            itsnb(m2.itsnb), itsn(m2.itsn), itsnlo(m2.itsnlo),
+            itsnhi(m2.itsnhi), itss(m2.itss), itsm(m2.size())
+        {
+            const T* p2 = m2.itsm.get();
+            T* p1 = itsm.get();
+            for(ptrdiff_t i=0;i<size();++i) p1[i] = p2[i];
+        }
+
+        inline ~BatchedBandMatrix() {}
+
+        inline type& operator=(const type& m2)
+        {
+            TMVAssert(m2.itsnb == itsnb);
+            TMVAssert(m2.itsn == itsn);
+            TMVAssert(m2.itsnlo == itsnlo);
+            TMVAssert(m2.itsnhi == itsnhi);
+            if (&m2 != this) {
+                const T* p2 = m2.itsm.get();
+                T* p1 = itsm.get();
+                for(ptrdiff_t i=0;i<size();++i) p1[i] = p2[i];
+            }
+            return *this;
+        }
+
+        //
+        // Access
+        //
+
+        inline T operator()(ptrdiff_t k, ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            TMVAssert(i>=0 && i<itsn);
+            TMVAssert(j>=0 && j<itsn);
+            TMVAssert(j-i >= -itsnlo && j-i <= itsnhi);
+            return itsm.get()[index(i,j) + k];
+        }
+
+        inline T& operator()(ptrdiff_t k, ptrdiff_t i, ptrdiff_t j)
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            TMVAssert(i>=0 && i<itsn);
+            TMVAssert(j>=0 && j<itsn);
+            TMVAssert(j-i >= -itsnlo && j-i <= itsnhi);
+            return itsm.get()[index(i,j) + k];
+        }
+
+        inline BandMatrix<T> get(ptrdiff_t k) const
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            BandMatrix<T> m(itsn,itsn,itsnlo,itsnhi);
+            const T* p = itsm.get() + k;
+            for(ptrdiff_t i=0;i<itsn;++i) {
+                const ptrdiff_t j1 = TMV_MAX(i-itsnlo,ptrdiff_t(0));
+                const ptrdiff_t j2 = TMV_MIN(i+itsnhi+1,itsn);
+                for(ptrdiff_t j=j1;j<j2;++j) m.ref(i,j) = p[index(i,j)];
+            }
+            return m;
+        }
+
+        inline void set(ptrdiff_t k, const GenBandMatrix<T>& m)
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            TMVAssert(m.colsize() == itsn && m.rowsize() == itsn);
+            TMVAssert(m.nlo() <= itsnlo && m.nhi() <= itsnhi);
+            T* p = itsm.get() + k;
+            for(ptrdiff_t i=0;i<itsn;++i) {
+                const ptrdiff_t j1 = TMV_MAX(i-itsnlo,ptrdiff_t(0));
+                const ptrdiff_t j2 = TMV_MIN(i+itsnhi+1,itsn);
+                for(ptrdiff_t j=j1;j<j2;++j)
+                    p[index(i,j)] =
+                        (j-i >= -m.nlo() && j-i <= m.nhi()) ? m.cref(i,j) : T(0);
+            }
+        }
+
+        inline ptrdiff_t nbatch() const { return itsnb; }
+        inline ptrdiff_t colsize() const { return itsn; }
+        inline ptrdiff_t rowsize() const { return itsn; }
+        inline int nlo() const { return itsnlo; }
+        inline int nhi() const { return itsnhi; }
+
+        // Row i of each matrix is stored as the nlo+nhi+1 elements
+        // (i,i-nlo) .. (i,i+nhi), each of which is a contiguous array
+        // of nbatch values.  stride() is the distance between these
+        // arrays.  The elements outside of the matrix (e.g. (0,-1)) are
+        // stored too, but they are not used.
+        inline ptrdiff_t stride() const { return itss; }
+        inline const T* cptr() const { return itsm.get(); }
+        inline T* ptr() { return itsm.get(); }
+
+        //
+        // Modifying Functions
+        //
+
+        inline type& setZero()
+        { return setAllTo(T(0)); }
+
+        inline type& setAllTo(const T& x)
+        {
+            T* p = itsm.get();
+            for(ptrdiff_t i=0;i<size();++i) p[i] = x;
+            return *this;
+        }
+
+        inline type& setToIdentity(const T& x=T(1))
+        {
+            setZero();
+            T* p = itsm.get();
+            for(ptrdiff_t i=0;i<itsn;++i) {
+                T* pii = p + index(i,i);
+                for(ptrdiff_t k=0;k<itsnb;++k) pii[k] = x;
+            }
+            return *this;
+        }
+
+    private:
+
+        // Round the stride up to a multiple of 8, so each (i,j) row of
+        // the batch starts on an aligned boundary.
+        static inline ptrdiff_t RoundUpStride(ptrdiff_t n)
+        { return ((n+7)>>3)<<3; }
+
+        inline ptrdiff_t size() const
+        { return itsn*(itsnlo+itsnhi+1)*itss; }
+
+        inline ptrdiff_t index(ptrdiff_t i, ptrdiff_t j) const
+        { return (i*(itsnlo+itsnhi+1) + (j-i+itsnlo))*itss; }
+
+        ptrdiff_t itsnb;
+        ptrdiff_t itsn;
+        int itsnlo;
+        int itsnhi;
+        ptrdiff_t itss;
+        AlignedArray<T> itsm;
+
+    }; // BatchedBandMatrix
+
+    // The working space for the batched solvers.
+    template <typename T>
+    class BatchBandWorkspace
+    {
+    public:
+
+        inline BatchBandWorkspace() : itssize(0) {}
+        inline ~BatchBandWorkspace() {}
+
+        // Make sure there is room for at least n elements.
+        inline T* get(ptrdiff_t n)
+        {
+            if (n > itssize) {
+                itsw.resize(n);
+                itssize = n;
+            }
+            return itsw.get();
+        }
+
+        inline ptrdiff_t size() const { return itssize; }
+
+    private:
+
+        ptrdiff_t itssize;
+        AlignedArray<T> itsw;
+
+        BatchBandWorkspace(const BatchBandWorkspace<T>&);
+        BatchBandWorkspace<T>& operator=(const BatchBandWorkspace<T>&);
+    };
+
+    template <typename T>
+    void BatchTridiag_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B,
+        BatchBandWorkspace<T>& work);
+
+    template <typename T>
+    void BatchBandLU_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B,
+        BatchBandWorkspace<T>& work);
+
+    template <typename T>
+    inline void BatchTridiag_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B)
+    {
+        BatchBandWorkspace<T> work;
+        BatchTridiag_Solve(A,B,work);
+    }
+
+    template <typename T>
+    inline void BatchBandLU_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B)
+    {
+        BatchBandWorkspace<T> work;
+        BatchBandLU_Solve(A,B,work);
+    }
+
+    template <typename T, int A2>
+    inline void BatchTridiag_Solve(
+        const BatchedBandMatrix<T>& A, Matrix<T,A2>& B,
+        BatchBandWorkspace<T>& work)
+    { BatchTridiag_Solve(A,B.view(),work); }
+
+    template <typename T, int A2>
+    inline void BatchBandLU_Solve(
+        const BatchedBandMatrix<T>& A, Matrix<T,A2>& B,
+        BatchBandWorkspace<T>& work)
+    { BatchBandLU_Solve(A,B.view(),work); }
+
+    template <typename T, int A2>
+    inline void BatchTridiag_Solve(
+        const BatchedBandMatrix<T>& A, Matrix<T,A2>& B)
+    { BatchTridiag_Solve(A,B.view()); }
+
+    template <typename T, int A2>
+    inline void BatchBandLU_Solve(
+        const BatchedBandMatrix<T>& A, Matrix<T,A2>& B)
+    { BatchBandLU_Solve(A,B.view()); }
+
+} // namespace tmv
+
+#endif
@@ -0,0 +1,540 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+//---------------------------------------------------------------------------
+//
+// This file defines the TMV BatchedSmallMatrix class.
+//
+// A BatchedSmallMatrix holds nbatch independent MxN matrices in a
+// structure-of-arrays layout: element (i,j) of every matrix in the batch
+// is stored contiguously.  So the operations below, which do the same
+// arithmetic on every matrix in the batch, run their inner loop over the
+// batch index, which the compiler can vectorize.  For large batches,
+// the batch is also split into chunks that are done in parallel with
+// OpenMP (when it is enabled).
+//
+// This is intended for applications that need to do the same operation
+// on many thousands of tiny matrices (e.g. 3x3 or 4x4), where the
+// overhead of doing each one as a separate SmallMatrix dominates.
+//
+// Constructors:
+//
+//    BatchedSmallMatrix<T,M,N>(ptrdiff_t nbatch)
+//        Makes a batch of nbatch MxN matrices with _uninitialized_ values
+//
+//    BatchedSmallMatrix<T,M,N>(ptrdiff_t nbatch, T x)
+//        Makes a batch of nbatch MxN matrices with all values = x
+//
+// Access:
+//
+//    m(k,i,j)
+//        Returns element (i,j) of the k-th matrix in the batch.
+//
+//    m.get(k)
+//        Returns a copy of the k-th matrix as a SmallMatrix<T,M,N>.
+//
+//    m.set(k,m2)
+//        Sets the k-th matrix to be a copy of the SmallMatrix m2.
+//
+// Batched operations:
+//
+//    BatchMultMM(A,B,C)
+//        C(k) = A(k) * B(k) for each k.  C may not be the same as A or B.
+//
+//    BatchLU_Solve(A,B)
+//        Solves A(k) X(k) = B(k) for each k using an LU decomposition with
+//        partial pivoting.  Both A and B are overwritten: A with its
+//        LU decomposition (with the row swaps applied) and B with X.
+//
+//    BatchCH_Solve(A,B)
+//        Solves A(k) X(k) = B(k) for each k using a Cholesky decomposition.
+//        Only the lower triangle of each A(k) is used, and it is taken to be
+//        hermitian and positive definite.  A is overwritten with L in its
+//        lower triangle and B with X.
+//
+//    BatchInverse(A,Ainv)
+//        Ainv(k) = A(k)^-1 for each k.  A is not modified.
+//
+//    BatchDet(A,det)
+//        det(k) = det(A(k)) for each k.  A is not modified.
+//
+// None of the batched division routines check for singular (or for CH,
+// non-positive-definite) matrices, since doing so would require a branch
+// for every matrix in the batch.  Such a matrix just produces inf or nan
+// values in its own output without affecting the rest of the batch.
+
+
+#ifndef TMV_BatchedSmallMatrix_H
+#define TMV_BatchedSmallMatrix_H
+
+#include "tmv/TMV_SmallMatrix.h"
+#include "tmv/TMV_Array.h"
+
+namespace tmv {
+
+    // The number of matrices that are processed together by each
+    // call to the kernels below.  Small enough that the pivot indices
+    // and working column fit on the stack, large enough to amortize
+    // the loop overhead.
+    const ptrdiff_t TMV_BATCH_CHUNK = 64;
+
+    template <typename T, ptrdiff_t M, ptrdiff_t N>
+    class BatchedSmallMatrix
+    {
+    public:
+
+        typedef T value_type;
+        typedef TMV_RealType(T) real_type;
+        typedef BatchedSmallMatrix<T,M,N> type;
+        typedef T& reference;
+
+        //
+        // Constructors
+        //
+
+        explicit inline BatchedSmallMatrix(ptrdiff_t nbatch) :
+            itsnb(nbatch), itss(RoundUpStride(nbatch)), itsm(M*N*itss)
+        {
+            TMVAssert(M>0);
+            TMVAssert(N>0);
+            TMVAssert(nbatch>=0);
+#ifdef TMV_EXTRA_DEBUG
+            setAllTo(T(888));
+#endif
+        }
+
+        inline BatchedSmallMatrix(ptrdiff_t nbatch, const T& x) :
+            itsnb(nbatch), itss(RoundUpStride(nbatch)), itsm(M*N*itss)
+        {
+            TMVAssert(M>0);
+            TMVAssert(N>0);
+            TMVAssert(nbatch>=0);
+            setAllTo(x);
+        }
+
+        inline BatchedSmallMatrix(const type& m2) :
+            itsnb(m2.itsnb), itss(m2.itss), itsm(M*N*itss)
+        {
+            const T* p2 = m2.itsm.get();
+            T* p1 = itsm.get();
+            for(ptrdiff_t i=0;i<M*N*itss;++i) p1[i] = p2[i];
+        }
+
+        inline ~BatchedSmallMatrix() {}
+
+        inline type& operator=(const type& m2)
+        {
+            TMVAssert(m2.itsnb == itsnb);
+            if (&m2 != this) {
+                const T* p2 = m2.itsm.get();
+                T* p1 = itsm.get();
+                for(ptrdiff_t i=0;i<M*N*itss;++i) p1[i] = p2[i];
+            }
+            return *this;
+        }
+
+        //
+        // Access
+        //
+
+        inline T operator()(ptrdiff_t k, ptrdiff_t i, ptrdiff_t j) const
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            TMVAssert(i>=0 && i<M);
+            TMVAssert(j>=0 && j<N);
+            return itsm.get()[(i+j*M)*itss + k];
+        }
+
+        inline T& operator()(ptrdiff_t k, ptrdiff_t i, ptrdiff_t j)
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            TMVAssert(i>=0 && i<M);
+            TMVAssert(j>=0 && j<N);
+            return itsm.get()[(i+j*M)*itss + k];
+        }
+
+        inline SmallMatrix<T,M,N> get(ptrdiff_t k) const
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            SmallMatrix<T,M,N> m;
+            const T* p = itsm.get() + k;
+            for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=0;i<M;++i)
+                m.ref(i,j) = p[(i+j*M)*itss];
+            return m;
+        }
+
+        template <int A2>
+        inline void set(ptrdiff_t k, const SmallMatrix<T,M,N,A2>& m)
+        {
+            TMVAssert(k>=0 && k<itsnb);
+            T* p = itsm.get() + k;
+            for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=0;i<M;++i)
+                p[(i+j*M)*itss] = m.cref(i,j);
+        }
+
+        inline ptrdiff_t nbatch() const { return itsnb; }
+        inline ptrdiff_t colsize() const { return M; }
+        inline ptrdiff_t rowsize() const { return N; }
+
+        // The distance between element (i,j) and element (i+1,j) of
+        // the same matrix is stride().  The elements of a single
+        // matrix are stored column major.
+        inline ptrdiff_t stride() const { return itss; }
+        inline const T* cptr() const { return itsm.get(); }
+        inline T* ptr() { return itsm.get(); }
+
+        //
+        // Modifying Functions
+        //
+
+        inline type& setZero()
+        { return setAllTo(T(0)); }
+
+        inline type& setAllTo(const T& x)
+        {
+            T* p = itsm.get();
+            for(ptrdiff_t i=0;i<M*N*itss;++i) p[i] = x;
+            return *this;
+        }
+
+        inline type& setToIdentity(const T& x=T(1))
+        {
+            TMVAssert(M == N);
+            setZero();
+            T* p = itsm.get();
+            for(ptrdiff_t i=0;i<M;++i) {
+                T* pii = p + (i+i*M)*itss;
+                for(ptrdiff_t k=0;k<itsnb;++k) pii[k] = x;
+            }
+            return *this;
+        }
+
+    private:
+
+        // Round the stride up to a multiple of 8, so each (i,j) row of
+        // the batch starts on an aligned boundary.
+        static inline ptrdiff_t RoundUpStride(ptrdiff_t n)
+        { return ((n+7)>>3)<<3; }
+
+        ptrdiff_t itsnb;
+        ptrdiff_t itss;
+        AlignedArray<T> itsm;
+
+    }; // BatchedSmallMatrix
+
+    //
+    // The kernels.
+    // Each of these does the calculation for nk consecutive matrices in
+    // the batch, starting at the given pointers.  s is the stride.
+    //
+
+    template <typename T, ptrdiff_t M, ptrdiff_t K, ptrdiff_t N>
+    inline void BatchMultMMKernel(
+        const T* A, ptrdiff_t sa, const T* B, ptrdiff_t sb,
+        T* C, ptrdiff_t sc, ptrdiff_t nk)
+    {
+        for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=0;i<M;++i) {
+            T* Cij = C + (i+j*M)*sc;
+            const T* Ai0 = A + i*sa;
+            const T* B0j = B + j*K*sb;
+            for(ptrdiff_t k=0;k<nk;++k) Cij[k] = Ai0[k] * B0j[k];
+            for(ptrdiff_t l=1;l<K;++l) {
+                const T* Ail = A + (i+l*M)*sa;
+                const T* Blj = B + (l+j*K)*sb;
+                for(ptrdiff_t k=0;k<nk;++k) Cij[k] += Ail[k] * Blj[k];
+            }
+        }
+    }
+
+    // LU decompose the NxN matrices in A, applying the same row operations
+    // to the NxR matrices in B, and then back substitute to get A^-1 B.
+    // If R == 0, B is not used.
+    // If det != 0, the determinant of each matrix is stored there.
+    template <typename T, ptrdiff_t N, ptrdiff_t R>
+    inline void BatchLUKernel(
+        T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, T* det, ptrdiff_t nk)
+    {
+        typedef TMV_RealType(T) RT;
+        ptrdiff_t ip[TMV_BATCH_CHUNK];
+        RT piv[TMV_BATCH_CHUNK];
+        T d[TMV_BATCH_CHUNK];
+        TMVAssert(nk <= TMV_BATCH_CHUNK);
+        if (det) for(ptrdiff_t k=0;k<nk;++k) d[k] = T(1);
+
+        for(ptrdiff_t j=0;j<N;++j) {
+            // Find the pivot for each matrix.  The comparisons are done
+            // with conditional assignments, so the loop vectorizes.
+            const T* Ajj = A + (j+j*N)*sa;
+            for(ptrdiff_t k=0;k<nk;++k) {
+                ip[k] = j;
+                piv[k] = TMV_ABS2(Ajj[k]);
+            }
+            for(ptrdiff_t r=j+1;r<N;++r) {
+                const T* Arj = A + (r+j*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) {
+                    const RT x = TMV_ABS2(Arj[k]);
+                    const bool bigger = x > piv[k];
+                    piv[k] = bigger ? x : piv[k];
+                    ip[k] = bigger ? r : ip[k];
+                }
+            }
+
+            // Swap row j with row ip in each matrix.  Again, do it without
+            // branching by blending each row below j with row j.
+            if (j < N-1) {
+                for(ptrdiff_t c=0;c<N+R;++c) {
+                    T* Ajc = c<N ? A + (j+c*N)*sa : B + (j+(c-N)*N)*sb;
+                    const ptrdiff_t rs = c<N ? sa : sb;
+                    for(ptrdiff_t k=0;k<nk;++k) {
+                        const T aj = Ajc[k];
+                        T newj = aj;
+                        for(ptrdiff_t r=j+1;r<N;++r) {
+                            T* Arc = Ajc + (r-j)*rs;
+                            const T ar = Arc[k];
+                            const bool sw = ip[k] == r;
+                            newj = sw ? ar : newj;
+                            Arc[k] = sw ? aj : ar;
+                        }
+                        Ajc[k] = newj;
+                    }
+                }
+                if (det) for(ptrdiff_t k=0;k<nk;++k)
+                    d[k] = ip[k] == j ? d[k] : -d[k];
+            }
+            if (det) for(ptrdiff_t k=0;k<nk;++k) d[k] *= Ajj[k];
+
+            // Eliminate the elements below the diagonal.
+            for(ptrdiff_t r=j+1;r<N;++r) {
+                T* Arj = A + (r+j*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) Arj[k] /= Ajj[k];
+                for(ptrdiff_t c=j+1;c<N;++c) {
+                    T* Arc = A + (r+c*N)*sa;
+                    const T* Ajc = A + (j+c*N)*sa;
+                    for(ptrdiff_t k=0;k<nk;++k) Arc[k] -= Arj[k] * Ajc[k];
+                }
+                for(ptrdiff_t c=0;c<R;++c) {
+                    T* Brc = B + (r+c*N)*sb;
+                    const T* Bjc = B + (j+c*N)*sb;
+                    for(ptrdiff_t k=0;k<nk;++k) Brc[k] -= Arj[k] * Bjc[k];
+                }
+            }
+        }
+        if (det) for(ptrdiff_t k=0;k<nk;++k) det[k] = d[k];
+
+        // Back substitute with U.
+        for(ptrdiff_t c=0;c<R;++c) {
+            for(ptrdiff_t j=N-1;j>=0;--j) {
+                T* Bjc = B + (j+c*N)*sb;
+                for(ptrdiff_t l=j+1;l<N;++l) {
+                    const T* Ajl = A + (j+l*N)*sa;
+                    const T* Blc = B + (l+c*N)*sb;
+                    for(ptrdiff_t k=0;k<nk;++k) Bjc[k] -= Ajl[k] * Blc[k];
+                }
+                const T* Ajj = A + (j+j*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) Bjc[k] /= Ajj[k];
+            }
+        }
+    }
+
+    // Cholesky decompose the lower triangle of A = L L^H, and then solve
+    // for L^-H L^-1 B.
+    template <typename T, ptrdiff_t N, ptrdiff_t R>
+    inline void BatchCHKernel(
+        T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, ptrdiff_t nk)
+    {
+        for(ptrdiff_t j=0;j<N;++j) {
+            T* Ajj = A + (j+j*N)*sa;
+            for(ptrdiff_t l=0;l<j;++l) {
+                const T* Ajl = A + (j+l*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) Ajj[k] -= TMV_NORM(Ajl[k]);
+            }
+            for(ptrdiff_t k=0;k<nk;++k) Ajj[k] = TMV_SQRT(TMV_REAL(Ajj[k]));
+            for(ptrdiff_t r=j+1;r<N;++r) {
+                T* Arj = A + (r+j*N)*sa;
+                for(ptrdiff_t l=0;l<j;++l) {
+                    const T* Arl = A + (r+l*N)*sa;
+                    const T* Ajl = A + (j+l*N)*sa;
+                    for(ptrdiff_t k=0;k<nk;++k)
+                        Arj[k] -= Arl[k] * TMV_CONJ(Ajl[k]);
+                }
+                for(ptrdiff_t k=0;k<nk;++k) Arj[k] /= Ajj[k];
+            }
+        }
+
+        for(ptrdiff_t c=0;c<R;++c) {
+            // Forward substitute with L.
+            for(ptrdiff_t j=0;j<N;++j) {
+                T* Bjc = B + (j+c*N)*sb;
+                for(ptrdiff_t l=0;l<j;++l) {
+                    const T* Ajl = A + (j+l*N)*sa;
+                    const T* Blc = B + (l+c*N)*sb;
+                    for(ptrdiff_t k=0;k<nk;++k) Bjc[k] -= Ajl[k] * Blc[k];
+                }
+                const T* Ajj = A + (j+j*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) Bjc[k] /= Ajj[k];
+            }
+            // Back substitute with L^H.
+            for(ptrdiff_t j=N-1;j>=0;--j) {
+                T* Bjc = B + (j+c*N)*sb;
+                for(ptrdiff_t l=j+1;l<N;++l) {
+                    const T* Alj = A + (l+j*N)*sa;
+                    const T* Blc = B + (l+c*N)*sb;
+                    for(ptrdiff_t k=0;k<nk;++k)
+                        Bjc[k] -= TMV_CONJ(Alj[k]) * Blc[k];
+                }
+                const T* Ajj = A + (j+j*N)*sa;
+                for(ptrdiff_t k=0;k<nk;++k) Bjc[k] /= Ajj[k];
+            }
+        }
+    }
+
+    // Call f(k1,nk,data) for each chunk of TMV_BATCH_CHUNK matrices
+    // in a batch of nb matrices, where k1 is the index of the first matrix
+    // in the chunk and nk is the number of matrices in it.  The chunks are
+    // done in parallel with OpenMP if it is enabled.  This is done in
+    // TMV_BatchedSmallMatrix.cpp, so this file doesn't need the OpenMP
+    // pragmas itself.
+    typedef void (*BatchChunkFunction)(ptrdiff_t k1, ptrdiff_t nk, void* data);
+    void BatchForEachChunk(ptrdiff_t nb, BatchChunkFunction f, void* data);
+
+    // These hold the arguments of each batched operation, along with
+    // a function that runs the appropriate kernel on one chunk.
+    template <typename T, ptrdiff_t M, ptrdiff_t K, ptrdiff_t N>
+    struct BatchMultMMChunk
+    {
+        const BatchedSmallMatrix<T,M,K>* A;
+        const BatchedSmallMatrix<T,K,N>* B;
+        BatchedSmallMatrix<T,M,N>* C;
+
+        static void call(ptrdiff_t k1, ptrdiff_t nk, void* data)
+        {
+            BatchMultMMChunk* d = static_cast<BatchMultMMChunk*>(data);
+            BatchMultMMKernel<T,M,K,N>(
+                d->A->cptr()+k1,d->A->stride(),d->B->cptr()+k1,d->B->stride(),
+                d->C->ptr()+k1,d->C->stride(),nk);
+        }
+    };
+
+    template <typename T, ptrdiff_t N, ptrdiff_t R>
+    struct BatchSolveChunk
+    {
+        BatchedSmallMatrix<T,N,N>* A;
+        BatchedSmallMatrix<T,N,R>* B;
+
+        static void callLU(ptrdiff_t k1, ptrdiff_t nk, void* data)
+        {
+            BatchSolveChunk* d = static_cast<BatchSolveChunk*>(data);
+            BatchLUKernel<T,N,R>(
+                d->A->ptr()+k1,d->A->stride(),d->B->ptr()+k1,d->B->stride(),
+                0,nk);
+        }
+
+        static void callCH(ptrdiff_t k1, ptrdiff_t nk, void* data)
+        {
+            BatchSolveChunk* d = static_cast<BatchSolveChunk*>(data);
+            BatchCHKernel<T,N,R>(
+                d->A->ptr()+k1,d->A->stride(),d->B->ptr()+k1,d->B->stride(),
+                nk);
+        }
+    };
+
+    template <typename T, ptrdiff_t N>
+    struct BatchDetChunk
+    {
+        BatchedSmallMatrix<T,N,N>* LU;
+        VectorView<T>* det;
+
+        static void call(ptrdiff_t k1, ptrdiff_t nk, void* data)
+        {
+            BatchDetChunk* d = static_cast<BatchDetChunk*>(data);
+            T dk[TMV_BATCH_CHUNK];
+            BatchLUKernel<T,N,0>(d->LU->ptr()+k1,d->LU->stride(),0,0,dk,nk);
+            for(ptrdiff_t k=0;k<nk;++k) (*d->det)(k1+k) = dk[k];
+        }
+    };
+
+    //
+    // The batched operations.
+    // These split the batch into chunks of TMV_BATCH_CHUNK matrices
+    // and run the kernels on the chunks in parallel.
+    //
+
+    template <typename T, ptrdiff_t M, ptrdiff_t K, ptrdiff_t N>
+    inline void BatchMultMM(
+        const BatchedSmallMatrix<T,M,K>& A,
+        const BatchedSmallMatrix<T,K,N>& B,
+        BatchedSmallMatrix<T,M,N>& C)
+    {
+        TMVAssert(A.nbatch() == C.nbatch());
+        TMVAssert(B.nbatch() == C.nbatch());
+        TMVAssert((const void*)(&A) != (const void*)(&C));
+        TMVAssert((const void*)(&B) != (const void*)(&C));
+        BatchMultMMChunk<T,M,K,N> d;
+        d.A = &A; d.B = &B; d.C = &C;
+        BatchForEachChunk(C.nbatch(),&BatchMultMMChunk<T,M,K,N>::call,&d);
+    }
+
+    template <typename T, ptrdiff_t N, ptrdiff_t R>
+    inline void BatchLU_Solve(
+        BatchedSmallMatrix<T,N,N>& A, BatchedSmallMatrix<T,N,R>& B)
+    {
+        TMVAssert(A.nbatch() == B.nbatch());
+        BatchSolveChunk<T,N,R> d;
+        d.A = &A; d.B = &B;
+        BatchForEachChunk(A.nbatch(),&BatchSolveChunk<T,N,R>::callLU,&d);
+    }
+
+    template <typename T, ptrdiff_t N, ptrdiff_t R>
+    inline void BatchCH_Solve(
+        BatchedSmallMatrix<T,N,N>& A, BatchedSmallMatrix<T,N,R>& B)
+    {
+        TMVAssert(A.nbatch() == B.nbatch());
+        BatchSolveChunk<T,N,R> d;
+        d.A = &A; d.B = &B;
+        BatchForEachChunk(A.nbatch(),&BatchSolveChunk<T,N,R>::callCH,&d);
+    }
+
+    template <typename T, ptrdiff_t N>
+    inline void BatchInverse(
+        const BatchedSmallMatrix<T,N,N>& A, BatchedSmallMatrix<T,N,N>& Ainv)
+    {
+        TMVAssert(A.nbatch() == Ainv.nbatch());
+        TMVAssert(&A != &Ainv);
+        BatchedSmallMatrix<T,N,N> LU = A;
+        Ainv.setToIdentity();
+        BatchLU_Solve(LU,Ainv);
+    }
+
+    template <typename T, ptrdiff_t N>
+    inline void BatchDet(
+        const BatchedSmallMatrix<T,N,N>& A, VectorView<T> det)
+    {
+        TMVAssert(A.nbatch() == det.size());
+        BatchedSmallMatrix<T,N,N> LU = A;
+        BatchDetChunk<T,N> d;
+        d.LU = &LU; d.det = &det;
+        BatchForEachChunk(A.nbatch(),&BatchDetChunk<T,N>::call,&d);
+    }
+
+} // namespace tmv
+
+#endif
@@ -26,7 +26,7 @@
 //
 // There are currently 4 algorithms for doing division (and Inverse and Det)
 //
-// LU Decomposition
+// LU Decomposition (optionally done in lower precision with refinement)
 // QR Decomposition (with or without Permutation)
 // Singular Value Decomposition (compact or full)
 // Cholskey (only for SymMatrix)
@@ -34,6 +34,7 @@
 // To tell a Matrix to use a particular algorithm, use the command:
 // m.divideUsing(ALG)
 // where ALG is LU, QR, QRP, SV or CH  for the algorithms above.
+// (Or LUMixed for the mixed precision version of LU.)
 //
 // The default algorithm is LU for square matrices or QR for non-square.
 //
@@ -46,6 +47,13 @@
 // This will only be true, if it was previously set up, _and_ the
 // Matrix hasn't been modified since then.
 //
+// Several threads may divide by the same (const) Matrix at once.
+// If the Divider is saved (m.saveDiv()), only the first thread to 
+// need it creates it, and the others use it without any locking.
+// If it is not saved, each thread creates its own.  The functions
+// that change the division behavior (divideUsing, saveDiv, unsetDiv,
+// etc.) are not thread-safe.
+//
 // If you want access to the various Divider functions directly,
 // They can be accessed by:
 //
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//---------------------------------------------------------------------------
+//
+// This file defines the Factorization class, a standalone handle to
+// a matrix decomposition.
+//
+// Normally a decomposition lives inside the matrix being divided
+// (see divideUsing and saveDiv in TMV_BaseMatrix.h), so it can only be
+// used through that matrix object.  A Factorization instead owns its own
+// copy of the factors, so it does not need the original matrix after
+// it is constructed.  Copying a Factorization is cheap: the copies share
+// the same factors, which are never modified after construction.  So
+// a Factorization may be passed around freely and used concurrently
+// from any number of threads.
+//
+// A Factorization may also be written to a binary blob and read back
+// later, so an expensive decomposition can be cached on disk.  When
+// reading a blob, you may choose to use the memory in place rather than
+// copying it, which is appropriate for a file that has been mmapped.
+//
+// The blob is an exact image of the memory used by the factorization,
+// so it is only readable on a machine with the same byte order and the
+// same sizes of T and ptrdiff_t.  These are checked when reading.
+//
+// Constructors:
+//
+//    Factorization<T>()
+//        Makes an empty factorization.
+//
+//    Factorization<T>(const GenMatrix<T>& A, DivType dt=LU)
+//        Decomposes a general matrix A.
+//        dt may be LU, QR, QRP or SV.  LU requires A to be square.
+//
+//    Factorization<T>(const GenSymMatrix<T>& A, DivType dt=LU)
+//        Decomposes a symmetric or hermitian matrix A.
+//        dt may be LU (which does the Bunch-Kaufman LDL decomposition),
+//        CH (which requires A to be hermitian and positive definite),
+//        or SV.
+//
+// Access functions:
+//
+//    DivType getDivType() const
+//    bool isEmpty() const
+//    bool isSym() const  (True for the LDL and CH decompositions)
+//    ptrdiff_t colsize() const
+//    ptrdiff_t rowsize() const
+//        These refer to the original matrix A.
+//
+//    bool isSingular() const
+//    T det() const
+//    RT logDet(T* sign=0) const
+//
+// Division:
+//
+//    void LDivEq(MatrixView<T> m) const
+//    void LDivEq(VectorView<T> v) const
+//        m = A^-1 m.  A must be square.
+//
+//    void RDivEq(MatrixView<T> m) const
+//    void RDivEq(VectorView<T> v) const
+//        m = m A^-1.  A must be square.
+//
+//    void LDiv(const GenMatrix<T>& m, MatrixView<T> x) const
+//    void LDiv(const GenVector<T>& v, VectorView<T> x) const
+//        x = A^-1 m.  For QR, QRP and SV, A may be non-square, in
+//        which case this is the least squares solution.
+//
+//    void RDiv(const GenMatrix<T>& m, MatrixView<T> x) const
+//    void RDiv(const GenVector<T>& v, VectorView<T> x) const
+//        x = m A^-1.
+//
+//    Each column of m (or row for RDiv) is an independent right hand
+//    side.  When there are many of them, they are split into blocks
+//    that are solved in parallel if OpenMP is enabled.
+//
+// Serialization:
+//
+//    size_t blobSize() const
+//        The number of bytes needed to store the factorization.
+//
+//    void writeBlob(char* buf) const
+//        Write the factorization into buf, which must have room for
+//        blobSize() bytes.
+//
+//    void writeBlob(std::ostream& os) const
+//        Write the factorization to a binary stream.
+//
+//    static Factorization<T> readBlob(
+//        const char* buf, size_t n, bool copy=true)
+//        Read a factorization from the n bytes starting at buf.
+//        If copy is false, the new factorization uses buf directly,
+//        so buf must remain valid (and unchanged) for as long as the
+//        factorization or any copy of it is in use.  In this case,
+//        buf must be aligned at least as strictly as T.
+//
+//    static Factorization<T> readBlob(std::istream& is)
+//        Read a factorization from a binary stream.
+//
+
+
+#ifndef TMV_Factorization_H
+#define TMV_Factorization_H
+
+#include "tmv/TMV_BaseMatrix.h"
+#include "tmv/TMV_BaseSymMatrix.h"
+#include <iosfwd>
+
+namespace tmv {
+
+    template <typename T>
+    class Factorization
+    {
+    public :
+
+        typedef TMV_RealType(T) RT;
+
+        //
+        // Constructors
+        //
+
+        Factorization();
+        explicit Factorization(const GenMatrix<T>& A, DivType dt=LU);
+        explicit Factorization(const GenSymMatrix<T>& A, DivType dt=LU);
+        Factorization(const Factorization<T>& rhs);
+        Factorization<T>& operator=(const Factorization<T>& rhs);
+#if __cplusplus >= 201103L
+        Factorization(Factorization<T>&& rhs);
+        Factorization<T>& operator=(Factorization<T>&& rhs);
+#endif
+        ~Factorization();
+
+        //
+        // Access
+        //
+
+        DivType getDivType() const;
+        bool isEmpty() const { return pimpl == 0; }
+        bool isSym() const;
+        ptrdiff_t colsize() const;
+        ptrdiff_t rowsize() const;
+
+        bool isSingular() const;
+        T det() const;
+        RT logDet(T* sign=0) const;
+
+        //
+        // Division
+        //
+
+        void LDivEq(MatrixView<T> m) const;
+        void RDivEq(MatrixView<T> m) const;
+        void LDiv(const GenMatrix<T>& m, MatrixView<T> x) const;
+        void RDiv(const GenMatrix<T>& m, MatrixView<T> x) const;
+
+        void LDivEq(VectorView<T> v) const;
+        void RDivEq(VectorView<T> v) const;
+        void LDiv(const GenVector<T>& v, VectorView<T> x) const;
+        void RDiv(const GenVector<T>& v, VectorView<T> x) const;
+
+        //
+        // Serialization
+        //
+
+        size_t blobSize() const;
+        void writeBlob(char* buf) const;
+        void writeBlob(std::ostream& os) const;
+        static Factorization<T> readBlob(
+            const char* buf, size_t n, bool copy=true);
+        static Factorization<T> readBlob(std::istream& is);
+
+    private :
+
+        struct Factorization_Impl;
+        Factorization_Impl* pimpl;
+
+        explicit Factorization(Factorization_Impl* p) : pimpl(p) {}
+
+    };
+
+} // namespace tmv
+
+#endif
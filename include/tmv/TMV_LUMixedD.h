@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+//---------------------------------------------------------------------------
+//
+// This file contains the code for doing division using an LU 
+// decomposition that is calculated in lower precision than the 
+// matrix itself (e.g. float for a Matrix<double>), with the 
+// solutions refined back to full precision.
+//
+// The O(N^3) decomposition is the expensive part of an LU division,
+// and it is roughly twice as fast in single precision as in double,
+// since twice as many values fit into each cache line and each
+// SIMD register.  The O(N^2) solves are cheap by comparison, so we
+// can afford to do a few extra of them to recover the lost precision.
+// This is classical iterative refinement:
+//
+// x = (PLU)^-1 b
+// repeat:
+//   r = b - A x              (in full precision)
+//   x += (PLU)^-1 r          (using the low precision PLU)
+//
+// The iteration stops when each column of the residual r satisfies
+// |r|_inf <= sqrt(N) eps |A|_inf |x|_inf, where eps is the 
+// full precision machine epsilon.  This is the same criterion that
+// LAPACK's dsgesv uses.
+//
+// Refinement only converges if cond(A) is not too large compared with
+// 1/eps of the lower precision, so if it fails to converge (or if A
+// has elements outside the range of the lower precision type), 
+// a regular full precision LUDiv is calculated instead and used for 
+// that solution and all subsequent ones.  usedFallback() reports 
+// whether this has happened.
+//
+// The original matrix is needed to calculate the residuals, so it is
+// never overwritten, even if divideInPlace() was requested.  Likewise,
+// the matrix must not be modified while the LUMixedDiv is in use.
+//
+// The determinant always uses the full precision decomposition, 
+// so calling det() or logDet() triggers the fallback calculation.
+//
+// For float, there is no lower precision, so LUMixed acts just like LU
+// except for the (usually trivial) refinement step.
+// For long double, the decomposition is done in double.
+//
+
+
+#ifndef TMV_LUMixedD_H
+#define TMV_LUMixedD_H
+
+#include "tmv/TMV_Divider.h"
+#include "tmv/TMV_BaseMatrix.h"
+
+namespace tmv {
+
+    template <typename T>
+    class LUMixedDiv : public Divider<T>
+    {
+
+    public :
+
+        //
+        // Constructors
+        //
+
+        // Note: inplace is ignored, since A is needed for the residuals.
+        LUMixedDiv(const GenMatrix<T>& A, bool inplace);
+        ~LUMixedDiv();
+
+        //
+        // Divider Versions of DivEq and Div
+        //
+
+        template <typename T1>
+        void doLDivEq(MatrixView<T1> m) const;
+
+        template <typename T1>
+        void doRDivEq(MatrixView<T1> m) const;
+
+        template <typename T1, typename T2>
+        void doLDiv(const GenMatrix<T1>& m1, MatrixView<T2> m0) const;
+
+        template <typename T1, typename T2>
+        void doRDiv(const GenMatrix<T1>& m1, MatrixView<T2> m0) const;
+
+#include "tmv/TMV_AuxAllDiv.h"
+
+        //
+        // Determinant, Inverse
+        //
+
+        T det() const;
+
+        TMV_RealType(T) logDet(T* sign) const;
+
+        template <typename T1>
+        void doMakeInverse(MatrixView<T1> minv) const;
+
+        void doMakeInverseATA(MatrixView<T> minv) const;
+
+        bool isSingular() const;
+
+        //
+        // Access Decomposition
+        //
+
+        // Whether the full precision LU decomposition has been needed.
+        bool usedFallback() const;
+
+        // The total number of low precision solves done so far.
+        ptrdiff_t getNumIter() const;
+
+        bool checkDecomp(const BaseMatrix<T>& m, std::ostream* fout) const;
+
+    private :
+
+        struct LUMixedDiv_Impl;
+        auto_ptr<LUMixedDiv_Impl> pimpl;
+
+        ptrdiff_t colsize() const;
+        ptrdiff_t rowsize() const;
+
+    private :
+
+        LUMixedDiv(const LUMixedDiv<T>&);
+        LUMixedDiv<T>& operator=(const LUMixedDiv<T>&);
+
+    };
+
+} // namespace tmv
+
+#endif
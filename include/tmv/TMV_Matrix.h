@@ -460,7 +460,7 @@
 //    change the algorithm used by the code on the fly.
 //    In particular, you can write:
 //    m.divideUsing(dt)
-//    where dt is LU, QR, QRP, or SV
+//    where dt is LU, QR, QRP, SV, or LUMixed
 //    (ie. anything but CH)
 //    Each of these also has an in-place version whcih overwrites the
 //    current Matrix memory with the decomposition needed for
@@ -484,6 +484,15 @@
 //    Likewise:
 //    qrd(), qrpd(), svd() return the corresponding Divider classes.
 //
+//    LUMixed does the LU decomposition in lower precision, and refines
+//    the solutions back to full precision.  lumd() returns its
+//    LUMixedDiv<T> class.  See TMV_LUMixedD.h for details.
+//
+//    rsvd(k,oversample,niter) sets the divider to a truncated SVD
+//    of rank k, found with a randomized algorithm, and returns it.
+//    See RandomSV_Decompose in TMV_SVD.h for the meaning of the 
+//    other parameters.
+//
 
 
 #ifndef TMV_Matrix_H
@@ -508,6 +517,9 @@ namespace tmv {
     template <typename T>
     class LUDiv;
 
+    template <typename T>
+    class LUMixedDiv;
+
     template <typename T>
     class QRDiv;
 
@@ -934,7 +946,8 @@ namespace tmv {
 
         inline void divideUsing(DivType dt) const
         {
-            TMVAssert(dt == LU || dt == QR || dt == QRP || dt == SV);
+            TMVAssert(dt == LU || dt == QR || dt == QRP || dt == SV ||
+                      dt == LUMixed);
             DivHelper<T>::divideUsing(dt);
         }
 
@@ -947,6 +960,15 @@ namespace tmv {
             return static_cast<const LUDiv<T>&>(*this->getDiv());
         }
 
+        inline const LUMixedDiv<T>& lumd() const
+        {
+            divideUsing(LUMixed);
+            setDiv();
+            TMVAssert(this->getDiv());
+            TMVAssert(divIsLUMixedDiv());
+            return static_cast<const LUMixedDiv<T>&>(*this->getDiv());
+        }
+
         inline const QRDiv<T>& qrd() const
         {
             divideUsing(QR);
@@ -974,6 +996,17 @@ namespace tmv {
             return static_cast<const SVDiv<T>&>(*this->getDiv());
         }
 
+        // Divide using a truncated SVD of rank k, found with the 
+        // randomized algorithm of RandomSV_Decompose.
+        // This also calls saveDiv(), since the decomposition can't 
+        // be redone automatically if it is deleted.
+        inline const SVDiv<T>& rsvd(
+            ptrdiff_t k, ptrdiff_t oversample=10, ptrdiff_t niter=2) const
+        {
+            setRandomSVDiv(k,oversample,niter);
+            return svd();
+        }
+
 
         //
         // I/O
@@ -1012,15 +1045,19 @@ namespace tmv {
     protected :
 
         inline const BaseMatrix<T>& getMatrix() const { return *this; }
+        Divider<T>* newDiv() const;
 
     private :
 
         type& operator=(const type&);
 
         bool divIsLUDiv() const;
+        bool divIsLUMixedDiv() const;
         bool divIsQRDiv() const;
         bool divIsQRPDiv() const;
         bool divIsSVDiv() const;
+        void setRandomSVDiv(
+            ptrdiff_t k, ptrdiff_t oversample, ptrdiff_t niter) const;
 
     }; // GenMatrix
 
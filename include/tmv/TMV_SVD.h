@@ -102,6 +102,33 @@ namespace tmv {
         Matrix<T,A1>& U, DiagMatrix<TMV_RealType(T),A2>& S, bool StoreU)
     { SV_Decompose(U.view(),S.view(),StoreU); }
 
+    // Find the k = S.size() largest singular values of A and their
+    // singular vectors using a randomized algorithm:
+    // A ~= U S Vt, where U is M x k, S is k x k, and Vt is k x N.
+    // A may have either more rows or more columns.
+    // The random projection uses k+oversample vectors, and niter
+    // power iterations are done to improve the accuracy when the 
+    // singular values decrease slowly.
+    template <typename T>
+    void RandomSV_Decompose(
+        const GenMatrix<T>& A, MatrixView<T> U, 
+        DiagMatrixView<TMV_RealType(T)> S, MatrixView<T> Vt,
+        ptrdiff_t oversample=10, ptrdiff_t niter=2);
+
+    template <typename T, int A2>
+    inline void RandomSV_Decompose(
+        const GenMatrix<T>& A, MatrixView<T> U, 
+        DiagMatrix<TMV_RealType(T),A2>& S, MatrixView<T> Vt,
+        ptrdiff_t oversample=10, ptrdiff_t niter=2)
+    { RandomSV_Decompose(A,U,S.view(),Vt,oversample,niter); }
+
+    template <typename T, int A1, int A2, int A3>
+    inline void RandomSV_Decompose(
+        const GenMatrix<T>& A, Matrix<T,A1>& U, 
+        DiagMatrix<TMV_RealType(T),A2>& S, Matrix<T,A3>& Vt,
+        ptrdiff_t oversample=10, ptrdiff_t niter=2)
+    { RandomSV_Decompose(A,U.view(),S.view(),Vt.view(),oversample,niter); }
+
 
     template <typename T>
     class SVDiv : public Divider<T>
@@ -114,6 +141,10 @@ namespace tmv {
         //
 
         SVDiv(const GenMatrix<T>& A, bool _inplace);
+
+        // A truncated SVD of rank k, found with RandomSV_Decompose.
+        SVDiv(const GenMatrix<T>& A, ptrdiff_t k, 
+              ptrdiff_t oversample, ptrdiff_t niter);
         ~SVDiv();
 
         //
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+//---------------------------------------------------------------------------
+#ifndef TMV_Schur_H
+#define TMV_Schur_H
+
+#include "tmv/TMV_BaseMatrix.h"
+
+namespace tmv {
+
+    // Decompose the square matrix A into A = Z T Zt, where Z is unitary
+    // and T is upper triangular (the Schur decomposition).
+    // For real matrices, T is instead quasi-upper-triangular, with 
+    // 2x2 blocks on the diagonal for each pair of complex conjugate
+    // eigenvalues (the real Schur form).
+    // On output, A is replaced by T, and Z holds the Schur vectors.
+    // The eigenvalues are returned in lambda in the order they appear
+    // along the diagonal of T.
+    // If multishift is false, the classic Francis double-shift QR
+    // algorithm is used, rather than multishift QR with aggressive
+    // early deflation.  This is mostly useful for comparison.
+    template <typename T>
+    void Schur_Decompose(
+        MatrixView<T> A, MatrixView<T> Z, 
+        VectorView<std::complex<TMV_RealType(T)> > lambda, 
+        bool multishift=true);
+
+    // Find the eigenvalues and eigenvectors of a general square matrix A.
+    // For each lambda(i), A V.col(i) = lambda(i) V.col(i).
+    // The eigenvalues are generally complex, even for real A, so 
+    // V and lambda are always complex.
+    // The eigenvectors are normalized to have unit 2-norm.
+    // Note that unlike for hermitian matrices, the eigenvalues are not
+    // sorted, and V is not unitary.
+    template <typename T>
+    void Eigen(
+        const GenMatrix<T>& A, 
+        MatrixView<std::complex<TMV_RealType(T)> > V, 
+        VectorView<std::complex<TMV_RealType(T)> > lambda);
+
+    // The same, but don't return V
+    template <typename T>
+    void Eigen(
+        const GenMatrix<T>& A, 
+        VectorView<std::complex<TMV_RealType(T)> > lambda);
+
+    template <typename T, int A3>
+    inline void Schur_Decompose(
+        MatrixView<T> A, MatrixView<T> Z, 
+        Vector<std::complex<TMV_RealType(T)>,A3>& lambda, 
+        bool multishift=true)
+    { Schur_Decompose(A,Z,lambda.view(),multishift); }
+
+    template <typename T, int A1, int A2, int A3>
+    inline void Schur_Decompose(
+        Matrix<T,A1>& A, Matrix<T,A2>& Z, 
+        Vector<std::complex<TMV_RealType(T)>,A3>& lambda, 
+        bool multishift=true)
+    { Schur_Decompose(A.view(),Z.view(),lambda.view(),multishift); }
+
+    template <typename T, int A2>
+    inline void Eigen(
+        const GenMatrix<T>& A, 
+        MatrixView<std::complex<TMV_RealType(T)> > V, 
+        Vector<std::complex<TMV_RealType(T)>,A2>& lambda)
+    { Eigen(A,V,lambda.view()); }
+
+    template <typename T, int A1>
+    inline void Eigen(
+        const GenMatrix<T>& A, 
+        Matrix<std::complex<TMV_RealType(T)>,A1>& V, 
+        VectorView<std::complex<TMV_RealType(T)> > lambda)
+    { Eigen(A,V.view(),lambda); }
+
+    template <typename T, int A1, int A2>
+    inline void Eigen(
+        const GenMatrix<T>& A, 
+        Matrix<std::complex<TMV_RealType(T)>,A1>& V, 
+        Vector<std::complex<TMV_RealType(T)>,A2>& lambda)
+    { Eigen(A,V.view(),lambda.view()); }
+
+    template <typename T, int A2>
+    inline void Eigen(
+        const GenMatrix<T>& A, 
+        Vector<std::complex<TMV_RealType(T)>,A2>& lambda)
+    { Eigen(A,lambda.view()); }
+
+} // namespace tmv
+
+#endif
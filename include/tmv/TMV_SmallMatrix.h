@@ -39,9 +39,13 @@
 // SmallMatrix doesn't have views like a regular Matrix.
 // All the normal viewing kinds of routines just return a regular MatrixView.
 // It is mostly useful for fast element access and simple tasks
-// like multiplication and addition.  For most division routines,
-// SmallMatrix just sends the task to a regular matrix.  The exception
-// is 2x2, which has specialization for det, inverse, etc.
+// like multiplication and addition.  The division routines (det, inverse,
+// and solving with / and %) are done inline with the decomposition
+// stored on the stack, so they never allocate memory on the heap.
+// Square matrices use LU decomposition, and non-square matrices use QR.
+// To use a different decomposition for a square matrix, give it to
+// m.makeInverse(minv,dt), m.LDivEq(x,dt) or m.RDivEq(x,dt).
+// There are closed-form specializations for 2x2 and 3x3 det and inverse.
 
 
 #ifndef TMV_SmallMatrix_H
@@ -72,9 +76,13 @@ namespace tmv {
     template <typename T, ptrdiff_t M, ptrdiff_t N, int A>
     inline T DoDet(const SmallMatrix<T,M,N,A>& m);
 
+    template <typename T, ptrdiff_t M, ptrdiff_t N, int A>
+    inline TMV_RealType(T) DoLogDet(const SmallMatrix<T,M,N,A>& m, T* sign);
+
     template <typename T, typename T2, ptrdiff_t M, ptrdiff_t N, int A, int A2>
     inline void DoInverse(
-        const SmallMatrix<T,M,N,A>& m, SmallMatrix<T2,N,M,A2>& minv);
+        const SmallMatrix<T,M,N,A>& m, SmallMatrix<T2,N,M,A2>& minv,
+        DivType dt=XX);
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, int A, int A2>
     inline void DoInverseATA(
@@ -488,7 +496,8 @@ namespace tmv {
                 }
                 return TMV_LOG(absd);
             }
-            else return view().logDet(sign);
+            else if (Traits<T>::isinteger) return view().logDet(sign);
+            else return DoLogDet(*this,sign);
         }
         inline RT norm2() const
         { return view().doNorm2(); }
@@ -505,6 +514,34 @@ namespace tmv {
         // Division Control
         //
 
+        // The division operations (/, %, inverse) use LU decomposition 
+        // for square matrices and QR for non-square matrices.  
+        // The decomposition is not saved; it is redone for each division
+        // statement, but it is done entirely on the stack.
+        //
+        // makeInverse, LDivEq and RDivEq can be given a different 
+        // decomposition to use.  Only LU, CH and QR are available 
+        // (and only QR for a non-square matrix).  For CH, only the lower
+        // triangle of the matrix is used, and it is taken to be hermitian.
+
+        // x = m^-1 x
+        template <typename T2, int A2>
+        inline void LDivEq(SmallVector<T2,N,A2>& x, DivType dt=XX) const
+        { TMVAssert(M == N); DoLDivEq(*this,x,dt); }
+
+        template <typename T2, ptrdiff_t K, int A2>
+        inline void LDivEq(SmallMatrix<T2,N,K,A2>& x, DivType dt=XX) const
+        { TMVAssert(M == N); DoLDivEq(*this,x,dt); }
+
+        // x = x m^-1
+        template <typename T2, int A2>
+        inline void RDivEq(SmallVector<T2,M,A2>& x, DivType dt=XX) const
+        { TMVAssert(M == N); DoRDivEq(*this,x,dt); }
+
+        template <typename T2, ptrdiff_t K, int A2>
+        inline void RDivEq(SmallMatrix<T2,K,M,A2>& x, DivType dt=XX) const
+        { TMVAssert(M == N); DoRDivEq(*this,x,dt); }
+
         inline QuotXm_1<T,T,M,N,A> inverse() const
         { return QuotXm_1<T,T,M,N,A>(T(1),*this); }
 
@@ -527,8 +564,9 @@ namespace tmv {
         { view().makeInverseATA(ata); }
 
         template <typename T2, int A2>
-        inline void makeInverse(SmallMatrix<T2,N,M,A2>& minv) const
-        { DoInverse(*this,minv); }
+        inline void makeInverse(
+            SmallMatrix<T2,N,M,A2>& minv, DivType dt=XX) const
+        { DoInverse(*this,minv,dt); }
 
         template <typename T2, int A2>
         inline void makeInverseATA(SmallMatrix<T2,N,N,A2>& ata) const
@@ -63,8 +63,32 @@ namespace tmv {
         inline void write(std::ostream& os) const throw()
         { Singular::write(os); os<<m<<std::endl; }
     };
+
+    template <typename T, ptrdiff_t M, ptrdiff_t N, int A>
+    class NonPosDefSmallMatrix : public NonPosDef
+    {
+    public:
+        SmallMatrix<T,M,N,A> m;
+
+        inline NonPosDefSmallMatrix(const SmallMatrix<T,M,N,A>& _m) :
+            NonPosDef("SmallMatrix Cholesky decomposition."), m(_m) {}
+        inline ~NonPosDefSmallMatrix() throw() {}
+        inline void write(std::ostream& os) const throw()
+        { NonPosDef::write(os); os<<m<<std::endl; }
+    };
 #endif
 
+    // The decomposition to use for a SmallMatrix division.
+    // XX means the default, which is LU for square matrices and QR 
+    // for non-square matrices.
+    template <ptrdiff_t M, ptrdiff_t N>
+    inline DivType SmallMatrixDivType(DivType dt)
+    {
+        TMVAssert(dt == XX || dt == LU || dt == CH || dt == QR);
+        TMVAssert(M == N || dt == XX || dt == QR);
+        return dt == XX ? (M == N ? LU : QR) : dt;
+    }
+
     template <ptrdiff_t N2, ptrdiff_t K, StorageType S2, typename T, typename T2, ptrdiff_t N, ptrdiff_t M>
     inline void LDivEq_L(const SmallMatrix<T,N,M,ColMajor>& L, T2* m)
     // SmallMatrix<T2,N2,K,S2>& m
@@ -163,6 +187,29 @@ namespace tmv {
         }
     }
 
+    template <ptrdiff_t N2, ptrdiff_t K, StorageType S2, typename T, typename T2, ptrdiff_t N>
+    inline void LDivEq_CH(const SmallMatrix<T,N,N,ColMajor>& L, T2* m)
+    // SmallMatrix<T2,N2,K,S2>& m
+    {
+        TMVAssert(N2 >= N);
+        //m.view() /= L.lowerTri();
+        //m.view() /= L.lowerTri().adjoint();
+        for(ptrdiff_t k=0;k<K;++k) {
+            for(ptrdiff_t j=0;j<N;++j) {
+                T2 temp = TMV_Val(m,N2,K,S2,j,k);
+                for(ptrdiff_t i=0;i<j;++i)
+                    temp -= L.cref(j,i) * TMV_Val(m,N2,K,S2,i,k);
+                TMV_Val(m,N2,K,S2,j,k) = temp / TMV_REAL(L.cref(j,j));
+            }
+            for(ptrdiff_t j=N-1;j>=0;--j) {
+                T2 temp = TMV_Val(m,N2,K,S2,j,k);
+                for(ptrdiff_t i=j+1;i<N;++i)
+                    temp -= TMV_CONJ(L.cref(i,j)) * TMV_Val(m,N2,K,S2,i,k);
+                TMV_Val(m,N2,K,S2,j,k) = temp / TMV_REAL(L.cref(j,j));
+            }
+        }
+    }
+
     template <typename T, ptrdiff_t M, ptrdiff_t N>
     inline void InvertU(SmallMatrix<T,M,N,ColMajor>& U)
     {
@@ -204,7 +251,7 @@ namespace tmv {
                          const T* beta, T2* m)
     // SmallMatrix<T2,M,K,S2>& m
     {
-        TMVAssert(M > N);
+        TMVAssert(M >= N);
         for(ptrdiff_t j=0;j<N;++j) if (beta[j] != T(0)) {
             //HouseholderLMult(Q.col(j,j+1,M),beta(j),m.rowRange(j,M));
             for(ptrdiff_t k=0;k<K;++k) {
@@ -229,7 +276,7 @@ namespace tmv {
                          const T* beta, T2* m)
     //SmallMatrix<T2,K,M,S2>& m
     {
-        TMVAssert(M > N);
+        TMVAssert(M >= N);
         for(ptrdiff_t j=N-1;j>=0;--j) if (beta[j] != T(0)) {
             //HouseholderLMult(Q.col(j,j+1,M).conjugate(),beta(j),
             //    m.colRange(j,M).transpose());
@@ -310,19 +357,67 @@ namespace tmv {
         }
     }
 
-    // This isn't really worth inlining.  We just call the regular
-    // Reflect function.
+    // This is the regular HouseholderReflect function, inlined and
+    // without the determinant calculation.  x[0] is the element that is
+    // to be kept, and x[1..n-1] are zeroed by the reflection and get
+    // overwritten with the Householder vector.
     template <typename T>
-    T HouseholderReflect(T& x0, VectorView<T> x, T& det);
+    inline T SMHouseholderReflect(T* x, ptrdiff_t n)
+    {
+        typedef TMV_RealType(T) RT;
+
+        // Scale by the maximum abs value to avoid overflow and underflow.
+        RT scale = TMV_ABS(x[0]);
+        for(ptrdiff_t i=1;i<n;++i) {
+            RT absxi = TMV_ABS2(x[i]);
+            if (absxi > scale) scale = absxi;
+        }
+        if (TMV_Underflow(scale)) {
+            for(ptrdiff_t i=0;i<n;++i) x[i] = T(0);
+            return T(0);
+        }
+        RT invscale = TMV_InverseOf(scale);
+        RT normsqx(0);
+        for(ptrdiff_t i=1;i<n;++i) normsqx += TMV_NORM(x[i]*invscale);
+
+        // if all of x other than first element are 0, H is identity
+        if (normsqx == RT(0) && TMV_IMAG(x[0]) == RT(0)) {
+            for(ptrdiff_t i=1;i<n;++i) x[i] = T(0);
+            return T(0);
+        }
+
+        T x0 = x[0] * invscale;
+        RT absx0 = TMV_ABS(x0);
+        normsqx += absx0*absx0;
+        RT normx = TMV_SQRT(normsqx);
+        RT y =  TMV_REAL(x0) > 0 ? -normx : normx;
+
+        // beta = 1 / (|x|^2 + |x| x0)
+        // H = I - beta v vt
+        // with v = x - y e0 in first column
+        // Renormalize beta,v so that v(0) = 1
+        T v0 = x0-y;
+        RT normv0 = TMV_NORM(v0);
+        T beta = TMV_Divide(normv0 , (normsqx - y * x0));
+        T invv0 = TMV_InverseOf(v0);
+        T scaled_invv0 = invv0 * invscale;
+        if ((TMV_REAL(invv0)!=RT(0) && TMV_Underflow(TMV_REAL(scaled_invv0))) ||
+            (TMV_IMAG(invv0)!=RT(0) && TMV_Underflow(TMV_IMAG(scaled_invv0)))) {
+            for(ptrdiff_t i=1;i<n;++i) { x[i] *= invscale; x[i] *= invv0; }
+        } else {
+            for(ptrdiff_t i=1;i<n;++i) x[i] *= scaled_invv0;
+        }
+        x[0] = y*scale;
+        return beta;
+    }
 
     // Again, this is just the normal QR_Decompose with everything inlined.
     template <typename T, ptrdiff_t M, ptrdiff_t N>
     inline void DoQRD(SmallMatrix<T,M,N,ColMajor>& QR, T* beta)
     {
         TMVAssert(M >= N);
-        T det(0);
         for(ptrdiff_t j=0;j<N;++j) {
-            beta[j] = HouseholderReflect(QR.ref(j,j),QR.col(j,j+1,M),det);
+            beta[j] = SMHouseholderReflect(QR.ptr()+j+j*M,M-j);
             if (beta[j] != T(0) && j<N-1) {
                 //HouseholderLMult(v,beta,QR.SubMatrix(j,M,j+1,N));
                 for(ptrdiff_t k=j+1;k<N;++k) {
@@ -338,6 +433,37 @@ namespace tmv {
         }
     }
 
+    // The Cholesky decomposition of a hermitian matrix.  Only the lower
+    // triangle is used, and it is overwritten with L.
+    template <typename T, ptrdiff_t N>
+    inline void DoCHD(SmallMatrix<T,N,N,ColMajor>& LL)
+    {
+        typedef TMV_RealType(T) RT;
+        for(ptrdiff_t j=0;j<N;++j) {
+            //L(j,j) = sqrt(LL(j,j) - NormSq(L.row(j,0,j)))
+            RT ljj = TMV_REAL(LL.cref(j,j));
+            for(ptrdiff_t k=0;k<j;++k) ljj -= TMV_NORM(LL.cref(j,k));
+            // Written this way so nan is also caught.
+            if (!(ljj > RT(0)))
+#ifdef NOTHROW
+            { std::cerr<<"Non-positive-definite SmallMatrix found\n"; exit(1); }
+#else
+            { throw NonPosDef("SmallMatrix CH decomposition"); }
+#endif
+            ljj = TMV_SQRT(ljj);
+            LL.ref(j,j) = ljj;
+            //L.col(j,j+1,N) = (LL.col(j,j+1,N) -
+            //    L.subMatrix(j+1,N,0,j) * L.row(j,0,j).conjugate()) / L(j,j)
+            RT invljj = RT(1)/ljj;
+            for(ptrdiff_t i=j+1;i<N;++i) {
+                T temp = LL.cref(i,j);
+                for(ptrdiff_t k=0;k<j;++k)
+                    temp -= LL.cref(i,k) * TMV_CONJ(LL.cref(j,k));
+                LL.ref(i,j) = temp * invljj;
+            }
+        }
+    }
+
     //
     // Determinant
     //
@@ -416,7 +542,7 @@ namespace tmv {
         static T det(const T* m)
         {
             typedef typename Helper<T>::longdouble_type DT;
-            SimpleMatrix<DT> A(N,N);
+            SmallMatrix<DT,N,N,ColMajor> A;
             // A = m;
             SmallMatrixCopy<N,N,S,ColMajor>(m,A.ptr());
             // This is the 1x1 Bareiss algorithm
@@ -467,6 +593,32 @@ namespace tmv {
         return SMDet<algo,T,M,N,S>::det(m.cptr());
     }
 
+    template <typename T, ptrdiff_t M, ptrdiff_t N, int A>
+    inline TMV_RealType(T) DoLogDet(const SmallMatrix<T,M,N,A>& m, T* sign)
+    {
+        typedef TMV_RealType(T) RT;
+        const StorageType S = static_cast<StorageType>(A & AllStorageType);
+        SmallMatrix<T,N,N,ColMajor> LU;
+        // LU = m;
+        SmallMatrixCopy<N,N,S,ColMajor>(m.cptr(),LU.ptr());
+        ptrdiff_t P[N];
+        DoLUD(LU,P);
+        RT logdet(0);
+        T s(1);
+        for(ptrdiff_t i=0;i<N;++i) {
+            const RT absuii = TMV_ABS(LU.cref(i,i));
+            if (absuii == RT(0)) {
+                if (sign) *sign = T(0);
+                return TMV_LOG(absuii);
+            }
+            logdet += TMV_LOG(absuii);
+            s *= TMV_SIGN(LU.cref(i,i),absuii);
+            if (P[i] != i) s = -s;
+        }
+        if (sign) *sign = s;
+        return logdet;
+    }
+
     //
     // Matrix Inverse
     //
@@ -475,7 +627,7 @@ namespace tmv {
     inline void SMQRInv(SmallMatrix<T,M,N,ColMajor>& QR, T2* minv)
     //SmallMatrix<T2,N,M,S2> minv
     {
-        TMVAssert(M > N);
+        TMVAssert(M >= N);
         T beta[N];
         DoQRD(QR,beta);
         InvertU(QR);
@@ -489,10 +641,24 @@ namespace tmv {
         Q_RDivEq<N,S2>(QR,beta,minv);
     }
 
+    template <StorageType S2, typename T, typename T2, ptrdiff_t N>
+    inline void SMCHInv(SmallMatrix<T,N,N,ColMajor>& LL, T2* minv)
+    //SmallMatrix<T2,N,N,S2> minv
+    {
+        DoCHD(LL);
+
+        //minv.setToIdentity();
+        for(ptrdiff_t i=0;i<N*N;++i) minv[i] = T2(0);
+        for(ptrdiff_t i=0;i<N;++i) TMV_Val(minv,N,N,S2,i,i) = T2(1);
+        //minv /= L;
+        //minv /= L.adjoint();
+        LDivEq_CH<N,N,S2>(LL,minv);
+    }
+
     template <typename T, typename T2, ptrdiff_t M, ptrdiff_t N, bool MltN, StorageType S, StorageType S2>
     struct SMInv
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T2,N,M,S2> minv
         {
@@ -508,7 +674,7 @@ namespace tmv {
     template <typename T, typename T2, ptrdiff_t M, ptrdiff_t N, StorageType S, StorageType S2>
     struct SMInv<T,T2,M,N,true,S,S2>
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T2,N,M,S2> minv
         {
@@ -523,24 +689,37 @@ namespace tmv {
     template <typename T, ptrdiff_t M, ptrdiff_t N, bool MltN, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,M,N,MltN,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,M,N,true,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T2, ptrdiff_t N, StorageType S, StorageType S2>
     struct SMInv<T,T2,N,N,false,S,S2>
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType dt)
             //SmallMatrix<T,N,N,S> m
             //SmallMatrix<T2,N,N,S2> minv
         {
+            if (dt == CH) {
+                SmallMatrix<T,N,N,ColMajor> LL;
+                // LL = m;
+                SmallMatrixCopy<N,N,S,ColMajor>(m,LL.ptr());
+                SMCHInv<S2>(LL,minv);
+                return;
+            } else if (dt == QR) {
+                SmallMatrix<T,N,N,ColMajor> QR;
+                // QR = m;
+                SmallMatrixCopy<N,N,S,ColMajor>(m,QR.ptr());
+                SMQRInv<S2>(QR,minv);
+                return;
+            }
             SmallMatrix<T,N,N,ColMajor> LU;
             // LU = m;
             SmallMatrixCopy<N,N,S,ColMajor>(m,LU.ptr());
@@ -576,7 +755,7 @@ namespace tmv {
     template <typename T, ptrdiff_t N, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,N,N,false,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
@@ -584,7 +763,7 @@ namespace tmv {
     template <typename T, typename T2, StorageType S, StorageType S2>
     struct SMInv<T,T2,1,1,false,S,S2>
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType )
         {
             if (*m == T(0))
 #ifdef NOTHROW
@@ -599,7 +778,7 @@ namespace tmv {
     template <typename T, typename T2, StorageType S, StorageType S2>
     struct SMInv<T,T2,2,2,false,S,S2>
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType )
         {
             T det = SMDet<2,T,2,2,S>::det(m);
             if (det == T(0))
@@ -627,7 +806,7 @@ namespace tmv {
     template <typename T, typename T2, StorageType S, StorageType S2>
     struct SMInv<T,T2,3,3,false,S,S2>
     {
-        static void inv(const T* m, T2* minv)
+        static void inv(const T* m, T2* minv, DivType )
         {
             T det = SMDet<3,T,3,3,S>::det(m);
             if (det == T(0))
@@ -660,37 +839,41 @@ namespace tmv {
     template <typename T, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,1,1,false,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,2,2,false,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, StorageType S, StorageType S2>
     struct SMInv<std::complex<T>,T,3,3,false,S,S2>
     {
-        static void inv(const std::complex<T>*, T*)
+        static void inv(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T2, ptrdiff_t M, ptrdiff_t N, int A, int A2>
     inline void DoInverse(
-        const SmallMatrix<T,M,N,A>& m, SmallMatrix<T2,N,M,A2>& minv)
+        const SmallMatrix<T,M,N,A>& m, SmallMatrix<T2,N,M,A2>& minv,
+        DivType dt)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         const StorageType S2 = static_cast<StorageType>(A2 & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
-            SMInv<T,T2,M,N,M<N,S,S2>::inv(m.cptr(),minv.ptr());
+            SMInv<T,T2,M,N,M<N,S,S2>::inv(
+                m.cptr(),minv.ptr(),SmallMatrixDivType<M,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,M,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,M,N,A>(m);
         }
 #endif
     }
@@ -704,7 +887,7 @@ namespace tmv {
     //SmallMatrix<T1,M,K,S1> m1
     //SmallMatrix<T2,N,K,S2> m2
     {
-        TMVAssert(M > N);
+        TMVAssert(M >= N);
         T beta[N];
         DoQRD(QR,beta);
 
@@ -775,6 +958,24 @@ namespace tmv {
         //std::cout<<"After LDivEq_U"<<std::endl;
     }
 
+    template <ptrdiff_t K, StorageType S2, typename T, typename T2, ptrdiff_t N>
+    inline void SMCHLDivEq(SmallMatrix<T,N,N,ColMajor>& LL, T2* m2)
+    //SmallMatrix<T2,N,K,S2> m2
+    {
+        DoCHD(LL);
+        // m2 = L^-H L^-1 m2
+        LDivEq_CH<N,K,S2>(LL,m2);
+    }
+
+    template <ptrdiff_t K, StorageType S2, typename T, typename T2, ptrdiff_t N>
+    inline void SMQRLDivEq(SmallMatrix<T,N,N,ColMajor>& QR, T2* m2)
+    //SmallMatrix<T2,N,K,S2> m2
+    {
+        // SMQRLDiv copies m1 to a temporary before writing to m2,
+        // so it is safe to use the same storage for both.
+        SMQRLDiv<K,S2,S2>(QR,m2,m2);
+    }
+
 
     //
     // Matrix LDiv
@@ -783,7 +984,7 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM
     {
-        static void ldiv(const T* m, const T1* m1, T2* m2)
+        static void ldiv(const T* m, const T1* m1, T2* m2, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T1,M,K,S1> m1
             //SmallMatrix<T2,N,K,S2> m2
@@ -800,7 +1001,7 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<T,T1,T2,M,N,true,K,S,S1,S2>
     {
-        static void ldiv(const T* m, const T1* m1, T2* m2)
+        static void ldiv(const T* m, const T1* m1, T2* m2, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T1,M,K,S1> m1
             //SmallMatrix<T2,N,K,S2> m2
@@ -818,35 +1019,35 @@ namespace tmv {
     template <typename T, typename T1, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<std::complex<T>,T1,T,M,N,MltN,K,S,S1,S2>
     {
-        static void ldiv(const std::complex<T>*, const T1*, T* )
+        static void ldiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<T,std::complex<T>,T,M,N,MltN,K,S,S1,S2>
     {
-        static void ldiv(const T*, const std::complex<T>*, T*)
+        static void ldiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T1, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<std::complex<T>,T1,T,M,N,true,K,S,S1,S2>
     {
-        static void ldiv(const std::complex<T>*, const T1*, T* )
+        static void ldiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<T,std::complex<T>,T,M,N,true,K,S,S1,S2>
     {
-        static void ldiv(const T*, const std::complex<T>*, T*)
+        static void ldiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T2, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S2>
     struct SMLDivEqM
     {
-        static void ldiveq(const T* m, T2* m2)
+        static void ldiveq(const T* m, T2* m2, DivType dt)
             //SmallMatrix<T,N,N,S> m
             //SmallMatrix<T2,N,K,S2> m2
         {
@@ -862,7 +1063,9 @@ namespace tmv {
             // LU = m;
             SmallMatrixCopy<N,N,S,ColMajor>(m,LU.ptr());
             //std::cout<<"LU = "<<LU<<std::endl;
-            SMLULDivEq<K,S2>(LU,m2);
+            if (dt == CH) SMCHLDivEq<K,S2>(LU,m2);
+            else if (dt == QR) SMQRLDivEq<K,S2>(LU,m2);
+            else SMLULDivEq<K,S2>(LU,m2);
             //std::cout<<"After LULDivEq\n";
         }
     };
@@ -870,14 +1073,14 @@ namespace tmv {
     template <typename T, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S2>
     struct SMLDivEqM<std::complex<T>,T,N,K,S,S2>
     {
-        static void ldiveq(const std::complex<T>*, T*)
+        static void ldiveq(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T1, typename T2, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<T,T1,T2,N,N,false,K,S,S1,S2>
     {
-        static void ldiv(const T* m, const T1* m1, T2* m2)
+        static void ldiv(const T* m, const T1* m1, T2* m2, DivType dt)
             //SmallMatrix<T,N,N,S> m
             //SmallMatrix<T1,N,K,S1> m1
             //SmallMatrix<T2,N,K,S2> m2
@@ -896,7 +1099,7 @@ namespace tmv {
             //m2 = m1;
             SmallMatrixCopy<N,K,S1,S2>(m1,m2);
             //std::cout<<"After copy\n";
-            SMLDivEqM<T,T2,N,K,S,S2>::ldiveq(m,m2);
+            SMLDivEqM<T,T2,N,K,S,S2>::ldiveq(m,m2,dt);
             //std::cout<<"After ldiveq\n";
         }
     };
@@ -904,31 +1107,35 @@ namespace tmv {
     template <typename T, typename T1, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<std::complex<T>,T1,T,N,N,false,K,S,S1,S2>
     {
-        static void ldiv(const std::complex<T>*, const T1*, T*)
+        static void ldiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMLDivM<T,std::complex<T>,T,N,N,false,K,S,S1,S2>
     {
-        static void ldiv(const T*, const std::complex<T>*, T*)
+        static void ldiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     // m2 = m^-1 m2
     template <typename T, typename T2, ptrdiff_t N, ptrdiff_t K, int A, int A2>
     inline void DoLDivEq(
-        const SmallMatrix<T,N,N,A>& m, SmallMatrix<T2,N,K,A2>& m2)
+        const SmallMatrix<T,N,N,A>& m, SmallMatrix<T2,N,K,A2>& m2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         const StorageType S2 = static_cast<StorageType>(A2 & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
-            SMLDivEqM<T,T2,N,K,S,S2>::ldiveq(m.cptr(),m2.ptr());
+            SMLDivEqM<T,T2,N,K,S,S2>::ldiveq(
+                m.cptr(),m2.ptr(),SmallMatrixDivType<N,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,N,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,N,N,A>(m);
         }
 #endif
     }
@@ -937,7 +1144,8 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, int A, int A1, int A2>
     inline void DoLDiv(
         const SmallMatrix<T,M,N,A>& m,
-        const SmallMatrix<T1,M,K,A1>& m1, SmallMatrix<T2,N,K,A2>& m2)
+        const SmallMatrix<T1,M,K,A1>& m1, SmallMatrix<T2,N,K,A2>& m2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         const StorageType S1 = static_cast<StorageType>(A1 & AllStorageType);
@@ -945,10 +1153,13 @@ namespace tmv {
 #ifndef NOTHROW
         try {
 #endif
-            SMLDivM<T,T1,T2,M,N,M<N,K,S,S1,S2>::ldiv(m.cptr(),m1.cptr(),m2.ptr());
+            SMLDivM<T,T1,T2,M,N,M<N,K,S,S1,S2>::ldiv(
+                m.cptr(),m1.cptr(),m2.ptr(),SmallMatrixDivType<M,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,M,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,M,N,A>(m);
         }
 #endif
     }
@@ -961,16 +1172,20 @@ namespace tmv {
     // v2 = m^-1 v2
     template <typename T, typename T2, ptrdiff_t N, int A, int A2>
     inline void DoLDivEq(
-        const SmallMatrix<T,N,N,A>& m, SmallVector<T2,N,A2>& v2)
+        const SmallMatrix<T,N,N,A>& m, SmallVector<T2,N,A2>& v2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
-            SMLDivEqM<T,T2,N,1,S,ColMajor>::ldiveq(m.cptr(),v2.ptr());
+            SMLDivEqM<T,T2,N,1,S,ColMajor>::ldiveq(
+                m.cptr(),v2.ptr(),SmallMatrixDivType<N,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,N,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,N,N,A>(m);
         }
 #endif
     }
@@ -979,7 +1194,8 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, int A, int A1, int A2>
     inline void DoLDiv(
         const SmallMatrix<T,M,N,A>& m,
-        const SmallVector<T1,M,A1>& v1, SmallVector<T2,N,A2>& v2)
+        const SmallVector<T1,M,A1>& v1, SmallVector<T2,N,A2>& v2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         //std::cout<<"Start DoLDiv:\n";
@@ -992,10 +1208,12 @@ namespace tmv {
         try {
 #endif
             SMLDivM<T,T1,T2,M,N,M<N,1,S,ColMajor,ColMajor>::ldiv(
-                m.cptr(),v1.cptr(),v2.ptr());
+                m.cptr(),v1.cptr(),v2.ptr(),SmallMatrixDivType<M,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,M,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,M,N,A>(m);
         }
 #endif
     }
@@ -1008,7 +1226,7 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM
     {
-        static void rdiv(const T* m, const T1* m1, T2* m2)
+        static void rdiv(const T* m, const T1* m1, T2* m2, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T1,K,N,S1> m1
             //SmallMatrix<T2,K,M,S2> m2
@@ -1025,7 +1243,7 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<T,T1,T2,M,N,true,K,S,S1,S2>
     {
-        static void rdiv(const T* m, const T1* m1, T2* m2)
+        static void rdiv(const T* m, const T1* m1, T2* m2, DivType )
             //SmallMatrix<T,M,N,S> m
             //SmallMatrix<T1,K,N,S1> m1
             //SmallMatrix<T2,K,M,S2> m2
@@ -1043,58 +1261,68 @@ namespace tmv {
     template <typename T, typename T1, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<std::complex<T>,T1,T,M,N,MltN,K,S,S1,S2>
     {
-        static void rdiv(const std::complex<T>*, const T1*, T*)
+        static void rdiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, bool MltN, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<T,std::complex<T>,T,M,N,MltN,K,S,S1,S2>
     {
-        static void rdiv(const T*, const std::complex<T>*, T*)
+        static void rdiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T1, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<std::complex<T>,T1,T,M,N,true,K,S,S1,S2>
     {
-        static void rdiv(const std::complex<T>*, const T1*, T*)
+        static void rdiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<T,std::complex<T>,T,M,N,true,K,S,S1,S2>
     {
-        static void rdiv(const T*, const std::complex<T>*, T*)
+        static void rdiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T2, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S2>
     struct SMRDivEqM
     {
-        static void rdiveq(const T* m, T2* m2)
+        static void rdiveq(const T* m, T2* m2, DivType dt)
             //SmallMatrix<T,N,N,S> m
             //SmallMatrix<T2,K,N,S2> m2
         {
             // m2 = m2 m^-1
             // m2t = mt^-1 m2t
             SmallMatrix<T,N,N,ColMajor> LU;
-            // LU = m.transpose()
-            SmallMatrixCopy<N,N,S,RowMajor>(m,LU.ptr());
-            SMLULDivEq<K,TMV_TransOf(S2)>(LU,m2);
+            if (dt == CH) {
+                // m is hermitian, so mt = m.conjugate().  This way we 
+                // still only use the lower triangle of m.
+                SmallMatrixCopy<N,N,S,ColMajor>(m,LU.ptr());
+                if (isComplex(T()))
+                    for(ptrdiff_t i=0;i<N*N;++i) LU.ptr()[i] = TMV_CONJ(LU.ptr()[i]);
+                SMCHLDivEq<K,TMV_TransOf(S2)>(LU,m2);
+            } else {
+                // LU = m.transpose()
+                SmallMatrixCopy<N,N,S,RowMajor>(m,LU.ptr());
+                if (dt == QR) SMQRLDivEq<K,TMV_TransOf(S2)>(LU,m2);
+                else SMLULDivEq<K,TMV_TransOf(S2)>(LU,m2);
+            }
         }
     };
 
     template <typename T, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S2>
     struct SMRDivEqM<std::complex<T>,T,N,K,S,S2>
     {
-        static void rdiveq(const std::complex<T>*, T*)
+        static void rdiveq(const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, typename T1, typename T2, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<T,T1,T2,N,N,false,K,S,S1,S2>
     {
-        static void rdiv(const T* m, const T1* m1, T2* m2)
+        static void rdiv(const T* m, const T1* m1, T2* m2, DivType dt)
             //SmallMatrix<T,N,N,S> m
             //SmallMatrix<T1,K,N,S1> m1
             //SmallMatrix<T2,K,N,S2> m2
@@ -1102,38 +1330,42 @@ namespace tmv {
             //m2 = m1;
             SmallMatrixCopy<K,N,S1,S2>(m1,m2);
             //DoRDivEq(m,m2);
-            SMRDivEqM<T,T2,N,K,S,S2>::rdiveq(m,m2);
+            SMRDivEqM<T,T2,N,K,S,S2>::rdiveq(m,m2,dt);
         }
     };
 
     template <typename T, typename T1, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<std::complex<T>,T1,T,N,N,false,K,S,S1,S2>
     {
-        static void rdiv(const std::complex<T>*, const T1*, T*)
+        static void rdiv(const std::complex<T>*, const T1*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     template <typename T, ptrdiff_t N, ptrdiff_t K, StorageType S, StorageType S1, StorageType S2>
     struct SMRDivM<T,std::complex<T>,T,N,N,false,K,S,S1,S2>
     {
-        static void rdiv(const T*, const std::complex<T>*, T*)
+        static void rdiv(const T*, const std::complex<T>*, T*, DivType )
         { TMVAssert(TMV_FALSE); }
     };
 
     // m2 = m2 m^-1
     template <typename T, typename T2, ptrdiff_t N, ptrdiff_t K, int A, int A2>
     inline void DoRDivEq(
-        const SmallMatrix<T,N,N,A>& m, SmallMatrix<T2,K,N,A2>& m2)
+        const SmallMatrix<T,N,N,A>& m, SmallMatrix<T2,K,N,A2>& m2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         const StorageType S2 = static_cast<StorageType>(A2 & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
-            SMRDivEqM<T,T2,N,K,S,S2>::rdiveq(m.cptr(),m2.ptr());
+            SMRDivEqM<T,T2,N,K,S,S2>::rdiveq(
+                m.cptr(),m2.ptr(),SmallMatrixDivType<N,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,N,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,N,N,A>(m);
         }
 #endif
     }
@@ -1142,7 +1374,8 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, ptrdiff_t K, int A, int A1, int A2>
     inline void DoRDiv(
         const SmallMatrix<T,M,N,A>& m,
-        const SmallMatrix<T1,K,N,A1>& m1, SmallMatrix<T2,K,M,A2>& m2)
+        const SmallMatrix<T1,K,N,A1>& m1, SmallMatrix<T2,K,M,A2>& m2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
         const StorageType S1 = static_cast<StorageType>(A1 & AllStorageType);
@@ -1151,10 +1384,12 @@ namespace tmv {
         try {
 #endif
             SMRDivM<T,T1,T2,M,N,M<N,K,S,S1,S2>::rdiv(
-                m.cptr(),m1.cptr(),m2.ptr());
+                m.cptr(),m1.cptr(),m2.ptr(),SmallMatrixDivType<M,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,M,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,M,N,A>(m);
         }
 #endif
     }
@@ -1166,16 +1401,20 @@ namespace tmv {
     // v2 = v2 m^-1
     template <typename T, typename T2, ptrdiff_t N, int A, int A2>
     inline void DoRDivEq(
-        const SmallMatrix<T,N,N,A>& m, SmallVector<T2,N,A2>& v2)
+        const SmallMatrix<T,N,N,A>& m, SmallVector<T2,N,A2>& v2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
-            SMRDivEqM<T,T2,N,1,S,RowMajor>::rdiveq(m.cptr(),v2.ptr());
+            SMRDivEqM<T,T2,N,1,S,RowMajor>::rdiveq(
+                m.cptr(),v2.ptr(),SmallMatrixDivType<N,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,N,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,N,N,A>(m);
         }
 #endif
     }
@@ -1184,17 +1423,20 @@ namespace tmv {
     template <typename T, typename T1, typename T2, ptrdiff_t M, ptrdiff_t N, int A, int A1, int A2>
     inline void DoRDiv(
         const SmallMatrix<T,M,N,A>& m,
-        const SmallVector<T1,N,A1>& v1, SmallVector<T2,M,A2>& v2)
+        const SmallVector<T1,N,A1>& v1, SmallVector<T2,M,A2>& v2,
+        DivType dt=XX)
     {
         const StorageType S = static_cast<StorageType>(A & AllStorageType);
 #ifndef NOTHROW
         try {
 #endif
             SMRDivM<T,T1,T2,M,N,M<N,1,S,RowMajor,RowMajor>::rdiv(
-                m.cptr(),v1.cptr(),v2.ptr());
+                m.cptr(),v1.cptr(),v2.ptr(),SmallMatrixDivType<M,N>(dt));
 #ifndef NOTHROW
-        } catch (tmv::Singular) {
+        } catch (tmv::Singular&) {
             throw SingularSmallMatrix<T,M,N,A>(m);
+        } catch (tmv::NonPosDef&) {
+            throw NonPosDefSmallMatrix<T,M,N,A>(m);
         }
 #endif
     }
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//---------------------------------------------------------------------------
+//
+// This file defines the SolveQueue class, which collects right hand 
+// sides that are to be divided by the same Factorization into panels,
+// so they can be solved together.
+//
+// When many threads each need to solve A x = b for one b (or a few), 
+// it is much more efficient to solve them together as the columns of 
+// a single matrix, since the triangular solves can then use blocked, 
+// matrix-matrix operations rather than matrix-vector operations.
+//
+// Each call to LDivEq adds its right hand sides to the current panel 
+// and waits for the result.  The call that starts a panel is its 
+// leader, and it solves the panel once the panel has maxBatch columns,
+// or once maxWait seconds have passed since the panel was started and
+// fewer panels are being solved than there are hardware threads.  
+// Until then, later requests collect into the same panel.  Full panels
+// are solved right away, so several panels may be solved at once, and 
+// each call only waits for its own panel.  If a solve throws an 
+// exception, every caller in that panel rethrows the same exception.
+//
+// The maxWait parameter is the knob between latency and throughput.
+// With maxWait = 0, there is no added latency when a thread is free,
+// and when they are all busy, a panel collects the requests that 
+// arrive until one of the running solves finishes.  Larger values let
+// the panels fill up more, which improves the throughput when there 
+// are many concurrent requests, at the cost of up to maxWait seconds 
+// of extra latency for each one.
+//
+// Batching requires C++11 threads.  Without C++11, each call is solved
+// immediately in the calling thread.
+//
+// Constructor:
+//
+//    SolveQueue<T>(const Factorization<T>& f, 
+//        ptrdiff_t maxBatch=64, double maxWait=0.)
+//        f must be a factorization of a square matrix.
+//
+// Division:
+//
+//    void LDivEq(VectorView<T> v)
+//    void LDivEq(MatrixView<T> m)
+//        m = A^-1 m
+//
+//    void LDiv(const GenVector<T>& v, VectorView<T> x)
+//    void LDiv(const GenMatrix<T>& m, MatrixView<T> x)
+//        x = A^-1 m
+//
+//    These may be called concurrently from any number of threads.
+//    A call with at least maxBatch right hand sides is solved directly.
+//
+// Access:
+//
+//    const Factorization<T>& getFactorization() const
+//    ptrdiff_t getMaxBatch() const
+//    void setMaxBatch(ptrdiff_t maxBatch)
+//    double getMaxWait() const
+//    void setMaxWait(double maxWait)
+//
+//    ptrdiff_t getNumSolved() const
+//        The number of right hand sides that have been solved.
+//    ptrdiff_t getNumPanels() const
+//        The number of panels that have been solved.
+//
+
+
+#ifndef TMV_SolveQueue_H
+#define TMV_SolveQueue_H
+
+#include "tmv/TMV_Factorization.h"
+
+namespace tmv {
+
+    template <typename T>
+    class SolveQueue
+    {
+    public :
+
+        //
+        // Constructors
+        //
+
+        explicit SolveQueue(
+            const Factorization<T>& f, ptrdiff_t maxBatch=64,
+            double maxWait=0.);
+        ~SolveQueue();
+
+        //
+        // Division
+        //
+
+        void LDivEq(MatrixView<T> m);
+        void LDivEq(VectorView<T> v);
+        void LDiv(const GenMatrix<T>& m, MatrixView<T> x);
+        void LDiv(const GenVector<T>& v, VectorView<T> x);
+
+        //
+        // Access
+        //
+
+        const Factorization<T>& getFactorization() const;
+        ptrdiff_t getMaxBatch() const;
+        void setMaxBatch(ptrdiff_t maxBatch);
+        double getMaxWait() const;
+        void setMaxWait(double maxWait);
+        ptrdiff_t getNumSolved() const;
+        ptrdiff_t getNumPanels() const;
+
+    private :
+
+        struct SolveQueue_Impl;
+        auto_ptr<SolveQueue_Impl> pimpl;
+
+        SolveQueue(const SolveQueue<T>&);
+        SolveQueue<T>& operator=(const SolveQueue<T>&);
+
+    };
+
+} // namespace tmv
+
+#endif
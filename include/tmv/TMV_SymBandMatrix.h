@@ -1050,6 +1050,7 @@ namespace tmv {
         { return (j+nlo() >= i && i+nlo() >= j); }
 
         inline const BaseMatrix<T>& getMatrix() const { return *this; }
+        Divider<T>* newDiv() const;
 
     private :
 
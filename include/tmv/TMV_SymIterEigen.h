@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//---------------------------------------------------------------------------
+//
+// This file declares iterative solvers for a few of the extremal 
+// eigenvalues and eigenvectors of a large hermitian matrix.
+// Unlike Eigen, these only need to be able to multiply a vector by
+// the matrix, and they only use O(nk) memory.
+//
+// The matrix is given to the solvers as a SymOperator, which 
+// just needs to define size() and a matrix-vector product.
+// SymMatrixOperator turns any TMV matrix into a SymOperator, so
+// SymMatrix, SymBandMatrix, etc. can be used directly.
+//
+// LanczosEigen(A, V, lambda, smallest, tol, ncv, maxiter)
+//
+//    Implicitly restarted Lanczos algorithm (Sorensen, 1992; Lehoucq & 
+//    Sorensen, 1996) with full reorthogonalization.  A Krylov basis of 
+//    ncv vectors is built, and the unwanted Ritz values are used as 
+//    exact shifts to restart it.  The small tridiagonal problem is 
+//    solved with EigenFromTridiagonal.
+//    ncv defaults to max(2k+1,k+20) (or n if that is smaller).
+//
+// LOBPCGEigen(A, Prec, V, lambda, smallest, tol, maxiter)
+//
+//    Locally optimal block preconditioned conjugate gradient algorithm
+//    (Knyazev, 2001).  Prec is a SymOperator that approximates A^-1 
+//    (or 0 for no preconditioning).  With a good preconditioner, this 
+//    converges much faster than Lanczos.  
+//    If V is non-zero on input, it is used as the initial guess.
+//
+// For both, lambda.size() = k is the number of eigenvalues to find, 
+// and V is n x k.  If smallest is true, the k smallest eigenvalues are
+// found, otherwise the k largest.  Either way, they are returned in 
+// increasing order.  The tolerance is on the norm of the residual
+// |A v - lambda v| relative to |lambda| for Lanczos, and relative to 
+// the largest |lambda| found (an estimate of |A|) for LOBPCG, which 
+// calculates the residuals explicitly.  tol = 0 means the default,
+// which is epsilon for Lanczos and sqrt(epsilon) for LOBPCG.
+// If the iteration doesn't converge within maxiter iterations 
+// (restarts for Lanczos), a warning is written and the current 
+// best approximations are returned.
+//
+
+#ifndef TMV_SymIterEigen_H
+#define TMV_SymIterEigen_H
+
+#include "tmv/TMV_BaseSymMatrix.h"
+#include "tmv/TMV_BaseSymBandMatrix.h"
+
+namespace tmv {
+
+    template <typename T>
+    class SymOperator
+    {
+    public :
+        virtual ~SymOperator() {}
+
+        virtual ptrdiff_t size() const = 0;
+
+        // y = A x
+        virtual void mult(const GenVector<T>& x, VectorView<T> y) const = 0;
+
+        // Y = A X
+        // The default is to multiply one column at a time, but this may
+        // be overridden if there is a more efficient way.
+        virtual void mult(const GenMatrix<T>& x, MatrixView<T> y) const
+        { for(ptrdiff_t j=0;j<x.rowsize();++j) mult(x.col(j),y.col(j)); }
+    };
+
+    template <typename T, typename M>
+    class SymMatrixOperator : public SymOperator<T>
+    {
+    public :
+        explicit SymMatrixOperator(const M& _A) : A(_A) {}
+
+        ptrdiff_t size() const { return A.colsize(); }
+        void mult(const GenVector<T>& x, VectorView<T> y) const
+        { y = A * x; }
+        void mult(const GenMatrix<T>& x, MatrixView<T> y) const
+        { y = A * x; }
+
+    private :
+        const M& A;
+    };
+
+    template <typename T>
+    void LanczosEigen(
+        const SymOperator<T>& A, MatrixView<T> V, 
+        VectorView<TMV_RealType(T)> lambda, bool smallest=true,
+        TMV_RealType(T) tol=0, ptrdiff_t ncv=0, ptrdiff_t maxiter=1000);
+
+    template <typename T>
+    void LOBPCGEigen(
+        const SymOperator<T>& A, const SymOperator<T>* Prec,
+        MatrixView<T> V, VectorView<TMV_RealType(T)> lambda, 
+        bool smallest=true, TMV_RealType(T) tol=0, ptrdiff_t maxiter=1000);
+
+    template <typename T>
+    inline void LanczosEigen(
+        const GenSymMatrix<T>& A, MatrixView<T> V, 
+        VectorView<TMV_RealType(T)> lambda, bool smallest=true,
+        TMV_RealType(T) tol=0, ptrdiff_t ncv=0, ptrdiff_t maxiter=1000)
+    {
+        LanczosEigen(
+            SymMatrixOperator<T,GenSymMatrix<T> >(A),V,lambda,
+            smallest,tol,ncv,maxiter);
+    }
+
+    template <typename T>
+    inline void LanczosEigen(
+        const GenSymBandMatrix<T>& A, MatrixView<T> V, 
+        VectorView<TMV_RealType(T)> lambda, bool smallest=true,
+        TMV_RealType(T) tol=0, ptrdiff_t ncv=0, ptrdiff_t maxiter=1000)
+    {
+        LanczosEigen(
+            SymMatrixOperator<T,GenSymBandMatrix<T> >(A),V,lambda,
+            smallest,tol,ncv,maxiter);
+    }
+
+    template <typename T>
+    inline void LOBPCGEigen(
+        const GenSymMatrix<T>& A, MatrixView<T> V, 
+        VectorView<TMV_RealType(T)> lambda, bool smallest=true,
+        TMV_RealType(T) tol=0, ptrdiff_t maxiter=1000)
+    {
+        LOBPCGEigen(
+            SymMatrixOperator<T,GenSymMatrix<T> >(A),
+            (const SymOperator<T>*)(0),V,lambda,smallest,tol,maxiter);
+    }
+
+    template <typename T>
+    inline void LOBPCGEigen(
+        const GenSymBandMatrix<T>& A, MatrixView<T> V, 
+        VectorView<TMV_RealType(T)> lambda, bool smallest=true,
+        TMV_RealType(T) tol=0, ptrdiff_t maxiter=1000)
+    {
+        LOBPCGEigen(
+            SymMatrixOperator<T,GenSymBandMatrix<T> >(A),
+            (const SymOperator<T>*)(0),V,lambda,smallest,tol,maxiter);
+    }
+
+} // namespace tmv
+
+#endif
@@ -831,6 +831,7 @@ namespace tmv {
     protected :
 
         inline const BaseMatrix<T>& getMatrix() const { return *this; }
+        Divider<T>* newDiv() const;
 
     private :
 
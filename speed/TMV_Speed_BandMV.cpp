@@ -0,0 +1,119 @@
+#include "TMV.h"
+#include "TMV_Band.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This compares the speed of band matrix-vector products for the 
+// three storage orders.  For each bandwidth, nlo = nhi = 1,2,4,...,32, 
+// it times y = A x, y = At x and x = U x (U = A.upperBand(), which 
+// is done in place) for A stored as DiagMajor, ColMajor and RowMajor.
+// The DiagMajor products go along the diagonals, which have unit step
+// and use the SIMD kernels.  The ColMajor and RowMajor products use 
+// the column and row algorithms (ColMultMV and RowMultMV).
+// Each is run with 1, 2, 4, ... threads up to the maximum number.
+
+const int NLOOPS = 20;
+const int N = 1<<18;
+
+static double Now()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+template <class T, class M>
+static void TimeMV(
+    const M& A, const tmv::Vector<T>& x, tmv::Vector<T>& y,
+    double& t1, double& t2, double& t3)
+{
+    t1 = t2 = t3 = 1.e100;
+    for(int i=0;i<NLOOPS;i++) {
+        double ta = Now();
+        y = A * x;
+        double tb = Now();
+        y = A.transpose() * x;
+        double tc = Now();
+        y = A.upperBand() * x;
+        double td = Now();
+        if (tb-ta < t1) t1 = tb-ta;
+        if (tc-tb < t2) t2 = tc-tb;
+        if (td-tc < t3) t3 = td-tc;
+    }
+}
+
+template <class T>
+static void Speed_BandMV(const char* file)
+{
+    std::cout<<tmv::TMV_Text(T())<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# nlo=nhi  nthreads  ";
+    os<<"dm_Ax  dm_Atx  dm_Ux  cm_Ax  cm_Atx  cm_Ux  rm_Ax  rm_Atx  rm_Ux\n";
+
+    for(int nb=1;nb<=32;nb*=2) {
+        std::cout<<"nlo = nhi = "<<nb<<std::endl;
+
+        tmv::BandMatrix<T,tmv::DiagMajor> Adm(N,N,nb,nb);
+        for(int i=0;i<N;i++) {
+            for(int j=i-nb;j<=i+nb;j++) if (j >= 0 && j < N) {
+                Adm(i,j) = T(1.-2.*((i+j)%17)+3.*((i*j)%5))/T(11.);
+            }
+        }
+        tmv::BandMatrix<T,tmv::ColMajor> Acm = Adm;
+        tmv::BandMatrix<T,tmv::RowMajor> Arm = Adm;
+        tmv::Vector<T> x(N);
+        for(int i=0;i<N;i++) x(i) = T(1.+(i%23));
+        tmv::Vector<T> ydm(N), ycm(N), yrm(N);
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            double t[9];
+            TimeMV(Adm,x,ydm,t[0],t[1],t[2]);
+            TimeMV(Acm,x,ycm,t[3],t[4],t[5]);
+            TimeMV(Arm,x,yrm,t[6],t[7],t[8]);
+            assert(Norm(ydm-ycm) <= 1.e-4*Norm(ycm));
+            assert(Norm(ydm-yrm) <= 1.e-4*Norm(yrm));
+
+            std::cout<<"  "<<nthreads<<" threads:\n";
+            std::cout<<"    DiagMajor: "<<t[0]<<"  "<<t[1]<<"  "<<t[2]<<"\n";
+            std::cout<<"    ColMajor:  "<<t[3]<<"  "<<t[4]<<"  "<<t[5]<<"\n";
+            std::cout<<"    RowMajor:  "<<t[6]<<"  "<<t[7]<<"  "<<t[8]<<"\n";
+            os<<nb<<"  "<<nthreads;
+            for(int k=0;k<9;++k) os<<"  "<<t[k];
+            os<<std::endl;
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+int main() try
+{
+    Speed_BandMV<double>("speed_bandmv_double.data");
+    Speed_BandMV<float>("speed_bandmv_float.data");
+    Speed_BandMV<std::complex<double> >("speed_bandmv_complexdouble.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
@@ -0,0 +1,119 @@
+#include "TMV.h"
+#include "TMV_Band.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This compares the speed of the partitioned (SPIKE) band LU solver
+// with the regular serial algorithm for narrow band matrices.
+// For each bandwidth, nlo = nhi = 1..8, it times the decomposition
+// and a solve with one right hand side.  With one thread, it uses
+// the serial algorithm (UseBandSpike(0)).  With more, it uses the 
+// partitioned algorithm with one partition per thread.
+
+const int NLOOPS = 3;
+const int N = 1<<20;
+
+static double Now()
+{
+    timeval tp;
+    gettimeofday(&tp,0);
+    return tp.tv_sec + tp.tv_usec/1.e6;
+}
+
+template <class T>
+static void Speed_BandSpike(const char* file)
+{
+    std::cout<<tmv::TMV_Text(T())<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# nlo=nhi  nthreads  decomp_time  solve_time  speedup\n";
+
+    for(int nb=1;nb<=8;++nb) {
+        std::cout<<"nlo = nhi = "<<nb<<std::endl;
+
+        tmv::BandMatrix<T> A(N,N,nb,nb);
+        for(int i=0;i<N;i++) {
+            for(int j=i-nb;j<=i+nb;j++) if (j >= 0 && j < N) {
+                A(i,j) = T(1.-2.*((i+j)%17)+3.*((i*j)%5))/T(11.);
+            }
+        }
+        A.diag().addToAll(T(4*nb));
+        tmv::Vector<T> b(N);
+        for(int i=0;i<N;i++) b(i) = T(1.+(i%23));
+
+        tmv::Vector<T> x1(N);
+        double time1 = 0.;
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            if (nthreads == 1) tmv::UseBandSpike(0);
+            else tmv::UseBandSpike(1,nthreads);
+
+            double dtime=1.e100, stime=1.e100;
+            tmv::Vector<T> x(N);
+
+            for(int i=0;i<NLOOPS;i++) {
+                tmv::BandMatrix<T> A1 = A;
+                A1.divideUsing(tmv::LU);
+
+                double t1 = Now();
+                A1.setDiv();
+                double t2 = Now();
+                x = b/A1;
+                double t3 = Now();
+
+                if (t2-t1 < dtime) dtime = t2-t1;
+                if (t3-t2 < stime) stime = t3-t2;
+                std::cout<<t2-t1<<" "<<t3-t2<<"  ";
+                if (nthreads > 1) assert(A1.lud().isPartitioned());
+            }
+            std::cout<<dtime<<"  "<<stime<<"  ("<<
+                nthreads<<" threads)\n";
+
+            if (nthreads == 1) {
+                time1 = dtime + stime;
+                x1 = x;
+            } else {
+                std::cout<<"Norm(x1-x2) = "<<Norm(x1-x)<<
+                    "  Norm(x) = "<<Norm(x1)<<std::endl;
+                assert(Norm(x1-x) < 1.e-4*Norm(x1));
+            }
+            os<<nb<<"  "<<nthreads<<"  "<<dtime<<"  "<<stime<<"  "<<
+                time1/(dtime+stime)<<std::endl;
+        }
+        tmv::UseBandSpike();
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+int main() try
+{
+    Speed_BandSpike<double>("speed_bandspike_double.data");
+    Speed_BandSpike<float>("speed_bandspike_float.data");
+    Speed_BandSpike<std::complex<double> >(
+        "speed_bandspike_complexdouble.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
@@ -0,0 +1,111 @@
+#include "TMV.h"
+#include "TMV_Sym.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This compares the speed of the Cholesky decomposition for different
+// numbers of threads.  With one thread, CH_Decompose uses the serial
+// recursive algorithm.  With more, it uses the tiled OpenMP algorithm.
+
+const int NLOOPS = 3;
+
+static void ClearCache()
+{
+    tmv::Matrix<double> M(2000,2000,8.);
+    for(int i=0;i<2000;i++) for(int j=0;j<2000;j++) {
+        M(i,j) = 8.*i-6.*j-748.;
+    }
+}
+
+template <class T, tmv::StorageType S>
+static void Speed_CH(const char* file)
+{
+    std::cout<<tmv::TMV_Text(T())<<"  "<<TMV_Text(S)<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# N  nthreads  time  speedup\n";
+
+    for(int N=512;N<=16384;N*=2) {
+        std::cout<<N<<std::endl;
+
+        tmv::HermMatrix<T,tmv::Lower|S> A0(N);
+        for(int i=0;i<N;i++) for(int j=0;j<=i;j++) {
+            A0(i,j) = T(1.-2.*i+3.*j)/T(i+j+11.);
+        }
+        A0.diag().addToAll(T(N));
+
+        tmv::HermMatrix<T,tmv::Lower|S> A1(N);
+        tmv::HermMatrix<T,tmv::Lower|S> A2(N);
+        timeval tp;
+        double time1 = 0.;
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            double chtime=1.e100;
+
+            for(int i=0;i<NLOOPS;i++) {
+                A1 = A0;
+                ClearCache();
+
+                gettimeofday(&tp,0);
+                double t1 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                tmv::CH_Decompose(A1);
+
+                gettimeofday(&tp,0);
+                double t2 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                double time = t2-t1;
+                if (time < chtime) chtime = time;
+                std::cout<<time<<"  ";
+            }
+            std::cout<<chtime<<"  ("<<nthreads<<" threads)\n";
+
+            if (nthreads == 1) {
+                time1 = chtime;
+                A2 = A1;
+            } else {
+                std::cout<<"Norm(L1-L2) = "<<
+                    Norm(A1.lowerTri()-A2.lowerTri())<<
+                    "  Norm(L) = "<<Norm(A2.lowerTri())<<std::endl;
+                assert(Norm(A1.lowerTri()-A2.lowerTri()) <
+                       1.e-4*Norm(A2.lowerTri()));
+            }
+            os<<N<<"  "<<nthreads<<"  "<<chtime<<"  "<<time1/chtime<<std::endl;
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+int main() try
+{
+    Speed_CH<double,tmv::ColMajor>("speed_ch_double_c.data");
+    Speed_CH<float,tmv::ColMajor>("speed_ch_float_c.data");
+    Speed_CH<double,tmv::RowMajor>("speed_ch_double_r.data");
+    Speed_CH<std::complex<double>,tmv::ColMajor>(
+        "speed_ch_complexdouble_c.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
@@ -0,0 +1,182 @@
+#include "TMV.h"
+#include "TMV_Sym.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <cstdlib>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This compares the speed of the symmetric eigenvalue decomposition and
+// the SVD for different numbers of threads.  Both use the divide and
+// conquer algorithm after reducing the matrix to tridiagonal (or 
+// bidiagonal) form, and with more than one thread, the divide and 
+// conquer recursion is done with OpenMP tasks.
+//
+// The largest N to use can be given on the command line.  The default
+// is 8192.
+
+const int NLOOPS = 2;
+
+template <class T, tmv::StorageType S>
+static void Speed_Eigen(int maxN, const char* file)
+{
+    std::cout<<"Eigen: "<<tmv::TMV_Text(T())<<"  "<<TMV_Text(S)<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# N  nthreads  time  speedup\n";
+
+    for(int N=512;N<=maxN;N*=2) {
+        std::cout<<N<<std::endl;
+
+        tmv::HermMatrix<T,tmv::Lower|S> A(N);
+        for(int i=0;i<N;i++) for(int j=0;j<=i;j++) {
+            A(i,j) = T(1.-2.*i+3.*j)/T(i+j+11.);
+        }
+        A.diag().addToAll(T(1));
+
+        tmv::Matrix<T,tmv::ColMajor> V(N,N);
+        tmv::Vector<TMV_RealType(T)> lam(N);
+        tmv::Vector<TMV_RealType(T)> lam1(N);
+        timeval tp;
+        double time1 = 0.;
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            double eigtime=1.e100;
+
+            for(int i=0;i<NLOOPS;i++) {
+                gettimeofday(&tp,0);
+                double t1 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                tmv::Eigen(A,V.view(),lam.view());
+
+                gettimeofday(&tp,0);
+                double t2 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                double time = t2-t1;
+                if (time < eigtime) eigtime = time;
+                std::cout<<time<<"  ";
+            }
+            std::cout<<eigtime<<"  ("<<nthreads<<" threads)\n";
+
+            if (nthreads == 1) {
+                time1 = eigtime;
+                lam1 = lam;
+            } else {
+                std::cout<<"Norm(lam1-lam) = "<<Norm(lam1-lam)<<
+                    "  Norm(lam) = "<<Norm(lam)<<std::endl;
+                assert(Norm(lam1-lam) < 1.e-4*Norm(lam));
+            }
+            std::cout<<"Norm(AV-VL) = "<<
+                Norm(A*V-V*DiagMatrixViewOf(lam))<<std::endl;
+            os<<N<<"  "<<nthreads<<"  "<<eigtime<<"  "<<
+                time1/eigtime<<std::endl;
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+template <class T, tmv::StorageType S>
+static void Speed_SVD(int maxN, const char* file)
+{
+    std::cout<<"SVD: "<<tmv::TMV_Text(T())<<"  "<<TMV_Text(S)<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# N  nthreads  time  speedup\n";
+
+    for(int N=512;N<=maxN;N*=2) {
+        std::cout<<N<<std::endl;
+
+        tmv::Matrix<T,S> A0(N,N);
+        for(int i=0;i<N;i++) for(int j=0;j<N;j++) {
+            A0(i,j) = T(1.-2.*i+3.*j)/T(i+j+11.);
+        }
+        A0.diag().addToAll(T(1));
+
+        tmv::Matrix<T,tmv::ColMajor> U(N,N);
+        tmv::DiagMatrix<TMV_RealType(T)> SS(N);
+        tmv::DiagMatrix<TMV_RealType(T)> SS1(N);
+        tmv::Matrix<T,tmv::ColMajor> Vt(N,N);
+        timeval tp;
+        double time1 = 0.;
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            double svdtime=1.e100;
+
+            for(int i=0;i<NLOOPS;i++) {
+                U = A0;
+
+                gettimeofday(&tp,0);
+                double t1 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                tmv::SV_Decompose(U.view(),SS.view(),Vt.view());
+
+                gettimeofday(&tp,0);
+                double t2 = tp.tv_sec + tp.tv_usec/1.e6;
+
+                double time = t2-t1;
+                if (time < svdtime) svdtime = time;
+                std::cout<<time<<"  ";
+            }
+            std::cout<<svdtime<<"  ("<<nthreads<<" threads)\n";
+
+            if (nthreads == 1) {
+                time1 = svdtime;
+                SS1 = SS;
+            } else {
+                std::cout<<"Norm(S1-S) = "<<Norm(SS1-SS)<<
+                    "  Norm(S) = "<<Norm(SS)<<std::endl;
+                assert(Norm(SS1-SS) < 1.e-4*Norm(SS));
+            }
+            std::cout<<"Norm(A-USVt) = "<<Norm(A0-U*SS*Vt)<<std::endl;
+            os<<N<<"  "<<nthreads<<"  "<<svdtime<<"  "<<
+                time1/svdtime<<std::endl;
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+int main(int argc, char** argv) try
+{
+    int maxN = 8192;
+    if (argc > 1) maxN = std::atoi(argv[1]);
+
+    Speed_Eigen<double,tmv::ColMajor>(maxN,"speed_eigen_double.data");
+    Speed_Eigen<std::complex<double>,tmv::ColMajor>(
+        maxN,"speed_eigen_complexdouble.data");
+    Speed_SVD<double,tmv::ColMajor>(maxN,"speed_svd_double.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
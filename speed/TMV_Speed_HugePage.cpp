@@ -0,0 +1,157 @@
+#include "TMV.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <assert.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#endif
+
+// This compares the speed of a large matrix multiplication with and
+// without huge pages backing the matrix memory.  The default size is
+// 10000 x 10000, which can be changed with a command line argument.
+//
+// On Linux, it also counts the data TLB misses for each run using 
+// perf_event_open.  Transparent huge pages need to be enabled for
+// madvise (or always) in /sys/kernel/mm/transparent_hugepage/enabled
+// for there to be any difference.  And the perf counters need to be 
+// accessible, which may require setting
+// /proc/sys/kernel/perf_event_paranoid to 1 or less.
+
+const int NLOOPS = 2;
+
+#ifdef __linux__
+class TLBCounter
+{
+public :
+    TLBCounter() 
+    {
+        perf_event_attr pe;
+        std::memset(&pe,0,sizeof(pe));
+        pe.type = PERF_TYPE_HW_CACHE;
+        pe.size = sizeof(pe);
+        pe.config = PERF_COUNT_HW_CACHE_DTLB |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        pe.disabled = 1;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        pe.inherit = 1;
+        fd = syscall(__NR_perf_event_open,&pe,0,-1,-1,0);
+        if (fd < 0) 
+            std::cout<<"Unable to open the dTLB miss counter.\n";
+    }
+    ~TLBCounter() { if (fd >= 0) close(fd); }
+    void start() 
+    {
+        if (fd < 0) return;
+        ioctl(fd,PERF_EVENT_IOC_RESET,0);
+        ioctl(fd,PERF_EVENT_IOC_ENABLE,0);
+    }
+    long long stop()
+    {
+        if (fd < 0) return -1;
+        ioctl(fd,PERF_EVENT_IOC_DISABLE,0);
+        long long count;
+        if (read(fd,&count,sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+private :
+    int fd;
+};
+#else
+class TLBCounter
+{
+public :
+    void start() {}
+    long long stop() { return -1; }
+};
+#endif
+
+template <class T>
+static void Speed_HugePage(int N, const char* file)
+{
+    std::cout<<tmv::TMV_Text(T())<<"  N = "<<N<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+    os<<"# N  hugepages  time  dTLB_misses\n";
+
+    const size_t thresh0 = tmv::GetHugePageThreshold();
+    TLBCounter tlb;
+    tmv::Matrix<T> C1(N,N);
+
+    for(int huge=0;huge<=1;++huge) {
+        // The threshold is applied when the memory is allocated, so
+        // make the matrices inside the loop.
+        tmv::SetHugePageThreshold(huge ? thresh0 : 0);
+        if (huge && thresh0 == 0) 
+            tmv::SetHugePageThreshold(TMV_HUGEPAGE_THRESHOLD);
+
+        tmv::Matrix<T> A(N,N);
+        tmv::Matrix<T> B(N,N);
+        tmv::Matrix<T> C(N,N);
+        for(int i=0;i<N;i++) for(int j=0;j<N;j++) {
+            A(i,j) = T(1.-2.*i+3.*j)/T(i+j+11.);
+            B(i,j) = T(3.+i-2.*j)/T(2.*i+j+5.);
+        }
+
+        timeval tp;
+        double besttime = 1.e100;
+        long long bestmiss = -1;
+
+        for(int k=0;k<NLOOPS;k++) {
+            C.setZero();
+
+            tlb.start();
+            gettimeofday(&tp,0);
+            double t1 = tp.tv_sec + tp.tv_usec/1.e6;
+
+            C = A * B;
+
+            gettimeofday(&tp,0);
+            double t2 = tp.tv_sec + tp.tv_usec/1.e6;
+            long long nmiss = tlb.stop();
+
+            double time = t2-t1;
+            std::cout<<time<<" ("<<nmiss<<")  ";
+            if (time < besttime) besttime = time;
+            if (bestmiss < 0 || (nmiss >= 0 && nmiss < bestmiss)) 
+                bestmiss = nmiss;
+        }
+        std::cout<<besttime<<"  dTLB misses = "<<bestmiss<<
+            (huge ? "  (huge pages)\n" : "  (normal pages)\n");
+
+        if (huge) {
+            std::cout<<"Norm(C1-C) = "<<Norm(C1-C)<<
+                "  Norm(C) = "<<Norm(C)<<std::endl;
+            assert(Norm(C1-C) <= 1.e-4*Norm(C));
+        } else {
+            C1 = C;
+        }
+        os<<N<<"  "<<huge<<"  "<<besttime<<"  "<<bestmiss<<std::endl;
+    }
+    tmv::SetHugePageThreshold(thresh0);
+}
+
+int main(int argc, char** argv) try
+{
+    int N = 10000;
+    if (argc > 1) N = std::atoi(argv[1]);
+
+    Speed_HugePage<double>(N,"speed_hugepage_double.data");
+    Speed_HugePage<float>(N,"speed_hugepage_float.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
@@ -115,7 +115,8 @@ static void Complexify(tmv::Matrix<std::complex<T>,S>& M)
 
 
 template <class T, tmv::StorageType SA, tmv::StorageType SB>
-static void Speed_MultMM(int Mmult, int Nmult, int Kmult, const char* file)
+static void Speed_MultMM(
+    int Mmult, int Nmult, int Kmult, const char* file, int Imax=2048)
 {
     std::cout<<tmv::TMV_Text(T())<<"  "<<
         TMV_Text(SA)<<"  "<<TMV_Text(SB)<<std::endl;
@@ -124,7 +125,7 @@ static void Speed_MultMM(int Mmult, int Nmult, int Kmult, const char* file)
 
     os<<"# N  TMV  BLAS\n";
 
-    for(int I=2;I<=2048;I*=2) {
+    for(int I=2;I<=Imax;I*=2) {
         std::cout<<I<<std::endl;
 
         const int M = Mmult*I+3;
@@ -245,6 +246,15 @@ int main() try
     Speed_MultMM<std::complex<float>,tmv::RowMajor,tmv::RowMajor>(
         1,1,1, "speed_multmm_complexfloat_sq_rrc.data");
 
+    // Small M,N with very large K.  This is the case where the OpenMP
+    // version needs to split along K to keep all of the threads busy.
+    Speed_MultMM<double,tmv::ColMajor,tmv::ColMajor>(
+        1,1,1024, "speed_multmm_double_bigk_ccc.data",64);
+    Speed_MultMM<double,tmv::RowMajor,tmv::ColMajor>(
+        1,1,1024, "speed_multmm_double_bigk_rcc.data",64);
+    Speed_MultMM<std::complex<double>,tmv::ColMajor,tmv::ColMajor>(
+        1,1,1024, "speed_multmm_complexdouble_bigk_ccc.data",64);
+
     return 0;
 
 } catch (tmv::Error& e) {
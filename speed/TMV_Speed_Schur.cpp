@@ -0,0 +1,117 @@
+#include "TMV.h"
+
+#include <iostream>
+#include <sys/time.h>
+#include <fstream>
+#include <cstdlib>
+#include <assert.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// This compares the speed of the Schur decomposition of a general matrix
+// using the multishift QR algorithm with aggressive early deflation
+// against the classic double-shift QR algorithm, for different numbers 
+// of threads.  Only the multishift algorithm uses multiple threads.
+//
+// The largest N to use can be given on the command line.  The default
+// is 4096.
+
+const int NLOOPS = 2;
+
+template <class T>
+static double TimeSchur(
+    const tmv::Matrix<T>& A0, tmv::Matrix<T>& A, tmv::Matrix<T>& Z,
+    tmv::Vector<std::complex<TMV_RealType(T)> >& lam, bool multishift)
+{
+    timeval tp;
+    double besttime = 1.e100;
+    for(int i=0;i<NLOOPS;i++) {
+        A = A0;
+
+        gettimeofday(&tp,0);
+        double t1 = tp.tv_sec + tp.tv_usec/1.e6;
+
+        tmv::Schur_Decompose(A.view(),Z.view(),lam.view(),multishift);
+
+        gettimeofday(&tp,0);
+        double t2 = tp.tv_sec + tp.tv_usec/1.e6;
+
+        double time = t2-t1;
+        if (time < besttime) besttime = time;
+        std::cout<<time<<"  ";
+    }
+    return besttime;
+}
+
+template <class T>
+static void Speed_Schur(int maxN, const char* file)
+{
+    typedef std::complex<TMV_RealType(T)> CT;
+    std::cout<<"Schur: "<<tmv::TMV_Text(T())<<std::endl;
+    std::cout<<file<<std::endl;
+    std::ofstream os(file);
+
+#ifdef _OPENMP
+    const int maxthreads = omp_get_max_threads();
+#else
+    const int maxthreads = 1;
+#endif
+
+    os<<"# N  nthreads  time  speedup_vs_doubleshift\n";
+
+    for(int N=256;N<=maxN;N*=2) {
+        std::cout<<N<<std::endl;
+
+        tmv::Matrix<T> A0(N,N);
+        for(int i=0;i<N;i++) for(int j=0;j<N;j++) {
+            A0(i,j) = T(1.-2.*i+3.*j)/T(i+j+11.) + T(((i+1)*(j+3))%17)/T(N);
+        }
+
+        tmv::Matrix<T> A(N,N);
+        tmv::Matrix<T> Z(N,N);
+        tmv::Vector<CT> lam(N);
+
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        double dstime = TimeSchur(A0,A,Z,lam,false);
+        std::cout<<dstime<<"  (double shift)\n";
+        std::cout<<"Norm(A-ZTZt) = "<<Norm(A0-Z*A*Z.adjoint())<<std::endl;
+        const CT sumlam = lam.sumElements();
+        os<<N<<"  0  "<<dstime<<"  1"<<std::endl;
+
+        for(int nthreads=1;nthreads<=maxthreads;nthreads*=2) {
+#ifdef _OPENMP
+            omp_set_num_threads(nthreads);
+#endif
+            double mstime = TimeSchur(A0,A,Z,lam,true);
+            std::cout<<mstime<<"  (multishift, "<<nthreads<<" threads)\n";
+            std::cout<<"Norm(A-ZTZt) = "<<Norm(A0-Z*A*Z.adjoint())<<
+                "  sum(lambda) - trace(A) = "<<
+                std::abs(lam.sumElements()-sumlam)<<std::endl;
+            assert(std::abs(lam.sumElements()-sumlam) < 1.e-4*Norm(A0));
+            os<<N<<"  "<<nthreads<<"  "<<mstime<<"  "<<
+                dstime/mstime<<std::endl;
+        }
+#ifdef _OPENMP
+        omp_set_num_threads(maxthreads);
+#endif
+    }
+}
+
+int main(int argc, char** argv) try
+{
+    int maxN = 4096;
+    if (argc > 1) maxN = std::atoi(argv[1]);
+
+    Speed_Schur<double>(maxN,"speed_schur_double.data");
+    Speed_Schur<std::complex<double> >(maxN,"speed_schur_complexdouble.data");
+
+    return 0;
+
+} catch (tmv::Error& e) {
+    std::cerr<<e<<std::endl;
+    exit(1);
+}
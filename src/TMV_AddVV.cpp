@@ -24,6 +24,7 @@
 
 
 #include "TMV_Blas.h"
+#include "TMV_SIMD.h"
 #include "tmv/TMV_VectorArithFunc.h"
 #include "tmv/TMV_Vector.h"
 
@@ -284,6 +285,34 @@ namespace tmv {
     }
 #endif
 #endif // BLAS
+#ifdef TMV_SIMD_DISPATCH
+#ifdef INST_DOUBLE
+    template <> 
+    void DoAddVV(
+        const double x,
+        const GenVector<double>& v1, VectorView<double> v2)
+    { 
+        if (v1.step() == 1 && v2.step() == 1 && 
+            GetSIMDLevel() != SIMD_Baseline)
+            SIMD_AddVV(v2.size(),x,v1.cptr(),v2.ptr());
+        else
+            NonBlasAddVV<false>(x,v1,v2);
+    }
+#endif
+#ifdef INST_FLOAT
+    template <> 
+    void DoAddVV(
+        const float x,
+        const GenVector<float>& v1, VectorView<float> v2)
+    { 
+        if (v1.step() == 1 && v2.step() == 1 && 
+            GetSIMDLevel() != SIMD_Baseline)
+            SIMD_AddVV(v2.size(),x,v1.cptr(),v2.ptr());
+        else
+            NonBlasAddVV<false>(x,v1,v2);
+    }
+#endif
+#endif // TMV_SIMD_DISPATCH
 
     template <class T, class T1> 
     void AddVV(const T x, const GenVector<T1>& v1, VectorView<T> v2)
@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+
+#include "tmv/TMV_Base.h"
+#include "tmv/TMV_Array.h"
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TMV_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define TMV_THREAD_LOCAL __declspec(thread)
+#elif __cplusplus >= 201103L
+#define TMV_THREAD_LOCAL thread_local
+#else
+#define TMV_THREAD_LOCAL
+#endif
+
+namespace tmv {
+
+    //
+    // The per-thread state
+    //
+
+    static TMV_THREAD_LOCAL Allocator* current_alloc = 0;
+    static TMV_THREAD_LOCAL ptrdiff_t nalloc = 0;
+    static TMV_THREAD_LOCAL ptrdiff_t nheap = 0;
+
+    Allocator* GetAllocator()
+    { return current_alloc; }
+
+    Allocator* SetAllocator(Allocator* alloc)
+    {
+        Allocator* prev = current_alloc;
+        current_alloc = alloc;
+        return prev;
+    }
+
+    ptrdiff_t AllocationCount() 
+    { return nalloc; }
+
+    ptrdiff_t HeapAllocationCount() 
+    { return nheap; }
+
+    void ResetAllocationCounts()
+    { nalloc = 0; nheap = 0; }
+
+    //
+    // The global alignment settings
+    //
+
+    static size_t alignment = TMV_ALIGNMENT;
+    static size_t hugepage_threshold = TMV_HUGEPAGE_THRESHOLD;
+
+    size_t GetAlignment()
+    { return alignment; }
+
+    void SetAlignment(size_t align)
+    {
+        // Must be a power of 2.
+        TMVAssert(align > 0 && (align & (align-1)) == 0);
+        alignment = align < 16 ? 16 : align;
+    }
+
+    size_t GetHugePageThreshold()
+    { return hugepage_threshold; }
+
+    void SetHugePageThreshold(size_t nbytes)
+    { hugepage_threshold = nbytes; }
+
+    void* HeapAllocate(size_t nbytes, size_t align)
+    {
+        ++nheap;
+        const bool huge = hugepage_threshold > 0 && 
+            nbytes >= hugepage_threshold;
+        if (huge) {
+            // Use whole huge pages, so none of them are shared with
+            // other (possibly small page) allocations.
+            if (align < TMV_HugePageSize) align = TMV_HugePageSize;
+            nbytes = (nbytes + TMV_HugePageSize-1) & ~(TMV_HugePageSize-1);
+        }
+        void* p;
+#ifdef _WIN32
+        p = _aligned_malloc(nbytes,align);
+        if (!p) throw std::bad_alloc();
+#else
+        if (posix_memalign(&p,align,nbytes) != 0) throw std::bad_alloc();
+#endif
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        // This is only advice, so don't worry if it fails (e.g. if the 
+        // kernel doesn't have transparent huge pages enabled).
+        if (huge) madvise(p,nbytes,MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+
+    void HeapDeallocate(void* p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    void* AllocateBytes(size_t nbytes, Allocator*& alloc)
+    {
+        ++nalloc;
+        alloc = current_alloc;
+        if (alloc) return alloc->allocate(nbytes,alignment);
+        else return HeapAllocate(nbytes,alignment);
+    }
+
+    void DeallocateBytes(void* p, size_t nbytes, Allocator* alloc)
+    {
+        if (alloc) alloc->deallocate(p,nbytes);
+        else HeapDeallocate(p);
+    }
+
+    //
+    // PoolAllocator
+    //
+
+    // The smallest size class is 2^MINCLASS = 64 bytes.
+    static const int MINCLASS = 6;
+
+    static int SizeClass(size_t nbytes)
+    {
+        int k = MINCLASS;
+        while ((size_t(1)<<k) < nbytes) ++k;
+        return k;
+    }
+
+    PoolAllocator::PoolAllocator()
+    { for(int k=0;k<NCLASS;++k) itsfree[k] = 0; }
+
+    PoolAllocator::~PoolAllocator()
+    { release(); }
+
+    void* PoolAllocator::allocate(size_t nbytes, size_t align)
+    {
+        const int k = SizeClass(nbytes);
+        void* p = itsfree[k];
+        if (p) {
+            // The first bytes of a free block hold the next free block.
+            itsfree[k] = *static_cast<void**>(p);
+            // If the alignment has been increased since this block was
+            // made, it might not be good enough anymore.
+            if ((reinterpret_cast<size_t>(p) & (align-1)) == 0) return p;
+            HeapDeallocate(p);
+        }
+        return HeapAllocate(size_t(1)<<k,align);
+    }
+
+    void PoolAllocator::deallocate(void* p, size_t nbytes)
+    {
+        const int k = SizeClass(nbytes);
+        *static_cast<void**>(p) = itsfree[k];
+        itsfree[k] = p;
+    }
+
+    void PoolAllocator::release()
+    {
+        for(int k=0;k<NCLASS;++k) {
+            void* p = itsfree[k];
+            while (p) {
+                void* next = *static_cast<void**>(p);
+                HeapDeallocate(p);
+                p = next;
+            }
+            itsfree[k] = 0;
+        }
+    }
+
+    //
+    // ArenaAllocator
+    //
+
+    struct ArenaAllocator::Chunk
+    {
+        char* mem;
+        size_t size;
+        size_t used;
+        Chunk* prev;
+    };
+
+    // Pieces of the arena are at least 64 byte aligned.
+    static const size_t ARENA_ALIGN = 64;
+
+    static inline size_t RoundUp(size_t n, size_t align) 
+    { return (n + align-1) & ~(align-1); }
+
+    ArenaAllocator::ArenaAllocator(size_t chunksize) :
+        itschunk(0), itschunksize(chunksize), itstotal(0), itsused(0),
+        itsnlive(0) {}
+
+    ArenaAllocator::~ArenaAllocator()
+    { freeChunks(); }
+
+    void ArenaAllocator::newChunk(size_t nbytes)
+    {
+        Chunk* c = new Chunk;
+        c->size = RoundUp(std::max(nbytes,itschunksize),ARENA_ALIGN);
+        c->mem = static_cast<char*>(
+            HeapAllocate(c->size,std::max(alignment,ARENA_ALIGN)));
+        c->used = 0;
+        c->prev = itschunk;
+        itschunk = c;
+        itstotal += c->size;
+    }
+
+    void ArenaAllocator::freeChunks()
+    {
+        while (itschunk) {
+            Chunk* prev = itschunk->prev;
+            HeapDeallocate(itschunk->mem);
+            delete itschunk;
+            itschunk = prev;
+        }
+        itstotal = 0;
+    }
+
+    void* ArenaAllocator::allocate(size_t nbytes, size_t align)
+    {
+        if (align < ARENA_ALIGN) align = ARENA_ALIGN;
+        // The amount of the chunk used, including any padding needed
+        // to get the requested alignment.
+        size_t start=0, end=0;
+        if (itschunk) {
+            const size_t base = reinterpret_cast<size_t>(itschunk->mem);
+            start = RoundUp(base + itschunk->used, align) - base;
+            end = start + RoundUp(nbytes,ARENA_ALIGN);
+        }
+        if (!itschunk || end > itschunk->size) {
+            newChunk(nbytes + align);
+            const size_t base = reinterpret_cast<size_t>(itschunk->mem);
+            start = RoundUp(base, align) - base;
+            end = start + RoundUp(nbytes,ARENA_ALIGN);
+        }
+        itschunk->used = end;
+        // Keep track of how much room we would need to do all of the
+        // current allocations in a single chunk.  The padding for the 
+        // alignment might be different there, so allow for the most 
+        // it could be.  (The chunks and the used sizes are always
+        // multiples of ARENA_ALIGN, so that is align-ARENA_ALIGN.)
+        itsused += RoundUp(nbytes,ARENA_ALIGN) + (align - ARENA_ALIGN);
+        ++itsnlive;
+        return itschunk->mem + start;
+    }
+
+    void ArenaAllocator::deallocate(void* , size_t )
+    {
+        TMVAssert(itsnlive > 0);
+        if (--itsnlive == 0) {
+            // Everything has been returned, so we can start over.
+            // If we needed more than one chunk, replace them with one
+            // that is large enough to hold everything next time.
+            if (itschunk->prev) {
+                const size_t total = itsused;
+                freeChunks();
+                newChunk(total);
+            }
+            itschunk->used = 0;
+            itsused = 0;
+        }
+    }
+
+} // namespace tmv
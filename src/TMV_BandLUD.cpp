@@ -24,6 +24,7 @@
 
 #include "tmv/TMV_BandLUD.h"
 #include "TMV_BandLUDiv.h"
+#include "TMV_BandSpike.h"
 #include "tmv/TMV_BandMatrix.h"
 #include "tmv/TMV_Permutation.h"
 #include "tmv/TMV_TriMatrix.h"
@@ -34,6 +35,11 @@
 #include "tmv/TMV_BandMatrixArith.h"
 #include <ostream>
 
+#if __cplusplus >= 201103L
+#include <mutex>
+#include <atomic>
+#endif
+
 namespace tmv {
 
 #define RT TMV_RealType(T)
@@ -45,6 +51,8 @@ namespace tmv {
         BandLUDiv_Impl(const GenBandMatrix<T>& A, bool _inplace);
         BandLUDiv_Impl(const AssignableToBandMatrix<T>& A);
 
+        void setLU();
+
         const bool istrans;
         const bool inplace;
         AlignedArray<T> Aptr1;
@@ -54,13 +62,26 @@ namespace tmv {
         mutable RT logdet;
         mutable T signdet;
         mutable bool donedet;
+
+        // If spike is set, then LUx just holds a copy of A until
+        // something other than LDivEq needs the regular decomposition.
+        auto_ptr<BandSpikeLU<T> > spike;
+        ptrdiff_t Anhi;
+#if __cplusplus >= 201103L
+        std::atomic<bool> donelu;
+        std::mutex lumutex;
+#else
+        bool donelu;
+#endif
     };
 
 #define NEWLO TMV_MIN(A.nlo(),A.nhi())
 #define NEWHI TMV_MIN(A.nlo()+A.nhi(),A.colsize()-1)
 #define APTR1 (inplace ? 0 : \
                BandStorageLength(ColMajor,A.colsize(),A.colsize(),NEWLO,NEWHI))
-#define TRID (A.nlo() == 1 && A.nhi() == 1)
+// A 2x2 tridiagonal matrix doesn't have room for the extra 
+// superdiagonal that the DiagMajor LU algorithm needs.
+#define TRID (A.nlo() == 1 && A.nhi() == 1 && A.colsize() > 2)
 #define APTR (inplace ? A.nonConst().ptr() : Aptr1.get())
 
 #define LUX (istrans ? \
@@ -91,7 +112,8 @@ namespace tmv {
                  ((A.isrm() && istrans) || (A.iscm() && !istrans) || 
                   (A.isdm() && TRID)))),
         Aptr1(APTR1), Aptr(APTR), LUx(LUX),
-        P(A.colsize()), logdet(0), signdet(1), donedet(false) 
+        P(A.colsize()), logdet(0), signdet(1), donedet(false),
+        Anhi(0), donelu(true)
     {
         //std::cout<<"BandLUDiv_Impl constructor\n";
         //std::cout<<"A = "<<TMV_Text(A)<<" = "<<A<<std::endl;
@@ -146,7 +168,16 @@ namespace tmv {
             if (Anhi < pimpl->LUx.nhi())
                 pimpl->LUx.diagRange(Anhi+1,pimpl->LUx.nhi()+1).setZero();
             //std::cout<<"LUx => "<<pimpl->LUx<<std::endl;
-            LU_Decompose(pimpl->LUx,pimpl->P,Anhi);
+            pimpl->Anhi = Anhi;
+            int nparts = pimpl->inplace ? 0 : BandSpike_NParts(A);
+            if (nparts > 0) {
+                pimpl->spike.reset(new BandSpikeLU<T>(A,nparts));
+                // If any of the partitions are singular, we need to use
+                // the regular algorithm after all.
+                if (pimpl->spike->isSingular()) pimpl->spike.reset();
+            }
+            if (pimpl->spike.get()) pimpl->donelu = false;
+            else LU_Decompose(pimpl->LUx,pimpl->P,Anhi);
             //std::cout<<"LUx => "<<pimpl->LUx<<std::endl;
         }
     }
@@ -165,7 +196,8 @@ namespace tmv {
         const AssignableToBandMatrix<T>& A) :
         istrans(A.nhi()<A.nlo()), inplace(false),
         Aptr1(APTR1), Aptr(APTR), LUx(LUX),
-        P(A.colsize()), logdet(0), signdet(1), donedet(false) 
+        P(A.colsize()), logdet(0), signdet(1), donedet(false),
+        Anhi(0), donelu(true)
     {
         //std::cout<<"BandLUDivImpl Assignable constructor\n";
         //std::cout<<"A = "<<TMV_Text(A)<<" = "<<BandMatrix<T>(A)<<std::endl;
@@ -210,13 +242,42 @@ namespace tmv {
         }
     }
 
+    template <class T> 
+    void BandLUDiv<T>::BandLUDiv_Impl::setLU()
+    {
+        // Several threads may need the regular decomposition at once, 
+        // so make sure that only one of them calculates it.
+#if __cplusplus >= 201103L
+        if (!donelu) {
+            std::lock_guard<std::mutex> lock(lumutex);
+            if (!donelu) {
+                LU_Decompose(LUx,P,Anhi);
+                donelu = true;
+            }
+        }
+#else
+        // Without std::atomic, a read of donelu outside the critical 
+        // section is a data race, so always take the lock.
+#ifdef _OPENMP
+#pragma omp critical (TMV_BandLU_SetLU)
+#endif
+        {
+            if (!donelu) {
+                LU_Decompose(LUx,P,Anhi);
+                donelu = true;
+            }
+        }
+#endif
+    }
+
     template <class T> 
     BandLUDiv<T>::~BandLUDiv() {}
 
     template <class T> template <class T1> 
     void BandLUDiv<T>::doLDivEq(MatrixView<T1> m) const
     {
-        if (pimpl->istrans) 
+        if (pimpl->spike.get()) BandSpike_LDivEq(*pimpl->spike,m);
+        else if (pimpl->istrans) 
             LU_RDivEq(pimpl->LUx,pimpl->P.getValues(),m.transpose());
         else LU_LDivEq(pimpl->LUx,pimpl->P.getValues(),m);
     }
@@ -224,6 +285,7 @@ namespace tmv {
     template <class T> template <class T1> 
     void BandLUDiv<T>::doRDivEq(MatrixView<T1> m) const
     {
+        pimpl->setLU();
         if (pimpl->istrans) 
             LU_LDivEq(pimpl->LUx,pimpl->P.getValues(),m.transpose());
         else LU_RDivEq(pimpl->LUx,pimpl->P.getValues(),m);
@@ -233,7 +295,8 @@ namespace tmv {
     void BandLUDiv<T>::doLDiv(
         const GenMatrix<T1>& m, MatrixView<T2> x) const
     {
-        if (pimpl->istrans) 
+        if (pimpl->spike.get()) BandSpike_LDivEq(*pimpl->spike,x=m);
+        else if (pimpl->istrans) 
             LU_RDivEq(pimpl->LUx,pimpl->P.getValues(),(x=m).transpose());
         else LU_LDivEq(pimpl->LUx,pimpl->P.getValues(),x=m);
     }
@@ -242,6 +305,7 @@ namespace tmv {
     void BandLUDiv<T>::doRDiv(
         const GenMatrix<T1>& m, MatrixView<T2> x) const
     {
+        pimpl->setLU();
         if (pimpl->istrans) 
             LU_LDivEq(pimpl->LUx,pimpl->P.getValues(),(x=m).transpose());
         else LU_RDivEq(pimpl->LUx,pimpl->P.getValues(),x=m);
@@ -249,6 +313,7 @@ namespace tmv {
 
     template <class T> T BandLUDiv<T>::det() const
     {
+        pimpl->setLU();
         if (!pimpl->donedet) {
             T s;
             pimpl->logdet = DiagMatrixViewOf(pimpl->LUx.diag()).logDet(&s);
@@ -262,6 +327,7 @@ namespace tmv {
     template <class T> 
     RT BandLUDiv<T>::logDet(T* sign) const
     {
+        pimpl->setLU();
         if (!pimpl->donedet) {
             T s;
             pimpl->logdet = DiagMatrixViewOf(pimpl->LUx.diag()).logDet(&s);
@@ -275,6 +341,7 @@ namespace tmv {
     template <class T> template <class T1> 
     void BandLUDiv<T>::doMakeInverse(MatrixView<T1> minv) const
     {
+        pimpl->setLU();
         if (pimpl->istrans)
             LU_Inverse(pimpl->LUx,pimpl->P.getValues(),minv.transpose());
         else
@@ -285,6 +352,7 @@ namespace tmv {
     void BandLUDiv<T>::doMakeInverseATA(MatrixView<T> ata) const
     {
         // See corresponding routine in TMV_LUD.cpp
+        pimpl->setLU();
         if (pimpl->istrans) {
             UpperTriMatrixView<T> uinv = ata.upperTri();
             uinv = getU();
@@ -316,6 +384,9 @@ namespace tmv {
     template <class T> 
     bool BandLUDiv<T>::isSingular() const 
     { 
+        // The partitioned algorithm is only used if none of the 
+        // partitions are singular, in which case neither is A.
+        if (pimpl->spike.get()) return false;
         return pimpl->LUx.diag().minAbs2Element() <=
             TMV_Epsilon<T>() * pimpl->LUx.diag().maxAbs2Element(); 
     }
@@ -324,13 +395,21 @@ namespace tmv {
     bool BandLUDiv<T>::isTrans() const 
     { return pimpl->istrans; }
 
+    template <class T> 
+    bool BandLUDiv<T>::isPartitioned() const 
+    { return pimpl->spike.get() != 0; }
+
     template <class T> 
     ConstBandMatrixView<T> BandLUDiv<T>::getU() const
-    { return BandMatrixViewOf(pimpl->LUx,0,pimpl->LUx.nhi()); }
+    { 
+        pimpl->setLU();
+        return BandMatrixViewOf(pimpl->LUx,0,pimpl->LUx.nhi()); 
+    }
 
     template <class T> 
     LowerTriMatrix<T,UnitDiag> BandLUDiv<T>::getL() const
     {
+        pimpl->setLU();
         LowerTriMatrix<T,UnitDiag> L(pimpl->LUx.colsize());
         LU_PackedPL_Unpack(pimpl->LUx,pimpl->P.getValues(),L.view());
         return L;
@@ -338,11 +417,17 @@ namespace tmv {
 
     template <class T> 
     const GenBandMatrix<T>& BandLUDiv<T>::getLU() const 
-    { return pimpl->LUx; }
+    { 
+        pimpl->setLU();
+        return pimpl->LUx; 
+    }
 
     template <class T> 
     const Permutation& BandLUDiv<T>::getP() const
-    { return pimpl->P; }
+    { 
+        pimpl->setLU();
+        return pimpl->P; 
+    }
 
     template <class T> 
     bool BandLUDiv<T>::checkDecomp(
@@ -59,27 +59,37 @@ namespace tmv {
         return RefHelper<T>::makeRef(mi,ct());
     }
 
+    template <class T> 
+    Divider<T>* GenBandMatrix<T>::newDiv() const
+    {
+        DivType dt = this->divtype & tmv::DivTypeFlags;
+        TMVAssert(dt == tmv::LU || dt == tmv::QR || dt == tmv::SV);
+        switch (dt) {
+          case LU : 
+               return new BandLUDiv<T>(*this,this->divIsInPlace());
+          case QR : 
+               return new BandQRDiv<T>(*this,this->divIsInPlace());
+          case SV : 
+               return new BandSVDiv<T>(*this);
+          default : 
+               // The above assert should have already failed
+               // so go ahead and fall through.
+               break;
+        }
+        return 0;
+    }
+
     template <class T> 
     void GenBandMatrix<T>::setDiv() const
     {
-        if (!this->divIsSet()) {
-            DivType dt = this->getDivType();
-            TMVAssert(dt == tmv::LU || dt == tmv::QR || dt == tmv::SV);
-            switch (dt) {
-              case LU : 
-                   this->divider.reset(
-                       new BandLUDiv<T>(*this,this->divIsInPlace())); break;
-              case QR : 
-                   this->divider.reset(
-                       new BandQRDiv<T>(*this,this->divIsInPlace())); break;
-              case SV : 
-                   this->divider.reset(new BandSVDiv<T>(*this)); break;
-              default : 
-                   // The above assert should have already failed
-                   // so go ahead and fall through.
-                   break;
-            }
-        }
+#if __cplusplus >= 201103L
+        if (this->divIsSet()) return;
+#endif
+        // Make sure only one thread does the decomposition.
+        DivLock<T> lock(*this);
+        if (this->divIsSet()) return;
+        this->setDefaultDivType();
+        this->divider.reset(newDiv());
     }
 
 #ifdef INST_INT
@@ -87,8 +97,15 @@ namespace tmv {
     void GenBandMatrix<int>::setDiv() const
     { TMVAssert(TMV_FALSE); }
     template <>
+    Divider<int>* GenBandMatrix<int>::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
+    template <>
     void GenBandMatrix<std::complex<int> >::setDiv() const
     { TMVAssert(TMV_FALSE); }
+    template <>
+    Divider<std::complex<int> >*
+    GenBandMatrix<std::complex<int> >::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
 #endif
 
     template <class T>
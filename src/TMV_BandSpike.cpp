@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "TMV_BandSpike.h"
+#include "TMV_BandLUDiv.h"
+#include "tmv/TMV_BandLUD.h"
+#include "tmv/TMV_BandMatrix.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_MatrixArith.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    template <class T> 
+    int BandSpike_NParts(const GenBandMatrix<T>& A)
+    {
+        const ptrdiff_t N = A.colsize();
+        const ptrdiff_t minrows = BandSpike_MinRows();
+        if (minrows <= 0 || !A.isSquare()) return 0;
+        if (A.nlo() < 1 || A.nhi() < 1) return 0;
+        if (A.nlo() > TMV_BANDSPIKE_MAXBAND) return 0;
+        if (A.nhi() > TMV_BANDSPIKE_MAXBAND) return 0;
+        // Each partition needs to be large enough to hold the top nhi
+        // and bottom nlo rows separately (with some room to spare).
+        const ptrdiff_t minpart = TMV_MAX(minrows,2*(A.nlo()+A.nhi()));
+        int nparts = BandSpike_NumParts();
+        if (nparts == 0) {
+#ifdef _OPENMP
+            if (omp_in_parallel()) return 0;
+            // The partitioned algorithm does about 3 times as much work
+            // as the serial one, so it's not worth it for 2 threads.
+            nparts = omp_get_max_threads();
+            if (nparts < 3) return 0;
+#else
+            return 0;
+#endif
+        }
+        if (nparts > N/minpart) nparts = int(N/minpart);
+        return nparts >= 2 ? nparts : 0;
+    }
+
+    template <class T> 
+    BandSpikeLU<T>::BandSpikeLU(const GenBandMatrix<T>& A, int _nparts) :
+        N(A.colsize()), nlo(A.nlo()), nhi(A.nhi()), nparts(_nparts),
+        start(nparts+1), lustart(nparts+1), P(N), 
+        V(N,nhi,T(0)), W(N,nlo,T(0)), singular(false)
+    {
+        TMVAssert(A.isSquare());
+        TMVAssert(nparts >= 2);
+        TMVAssert(nlo > 0 && nhi > 0);
+        TMVAssert(N >= 2*nparts*(nlo+nhi));
+
+        // Split the rows as evenly as possible.
+        // The storage for each LU_k is the same as for a BandLUDiv.
+        const bool trid = nlo == 1 && nhi == 1;
+        start[0] = 0;
+        lustart[0] = 0;
+        for(int k=0;k<nparts;++k) {
+            start[k+1] = (N*(k+1))/nparts;
+            const ptrdiff_t nk = start[k+1]-start[k];
+            lustart[k+1] = lustart[k] + 
+                BandStorageLength(ColMajor,nk,nk,nlo,nlo+nhi);
+        }
+        LUptr.resize(lustart[nparts]);
+
+        // Decompose each block and calculate its spikes.
+        AlignedArray<bool> sing(nparts);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(int k=0;k<nparts;++k) {
+            const ptrdiff_t i1 = start[k];
+            const ptrdiff_t i2 = start[k+1];
+            const ptrdiff_t nk = i2-i1;
+            BandMatrixView<T> LUk = BandMatrixViewOf(
+                LUptr.get()+lustart[k],nk,nk,nlo,nlo+nhi,
+                trid ? DiagMajor : ColMajor);
+            BandMatrixViewOf(LUk,nlo,nhi) = A.subBandMatrix(i1,i2,i1,i2);
+            LUk.diagRange(nhi+1,nlo+nhi+1).setZero();
+            ptrdiff_t* Pk = P.get()+i1;
+            LU_Decompose(LUk,Pk,nhi);
+            sing[k] = LUk.diag().minAbs2Element() <=
+                TMV_Epsilon<T>() * LUk.diag().maxAbs2Element();
+            if (sing[k]) continue;
+
+            // V_k = A_k^-1 [ 0 ; B_k ]
+            if (k < nparts-1) {
+                MatrixView<T> Vk = V.rowRange(i1,i2);
+                for(ptrdiff_t j=0;j<nhi;++j) {
+                    const ptrdiff_t c = i2+j;
+                    const ptrdiff_t r1 = c-nhi;
+                    Vk.col(j,r1-i1,nk) = A.col(c,r1,i2);
+                }
+                LU_LDivEq(LUk,Pk,Vk);
+            }
+            // W_k = A_k^-1 [ C_k ; 0 ]
+            if (k > 0) {
+                MatrixView<T> Wk = W.rowRange(i1,i2);
+                for(ptrdiff_t j=0;j<nlo;++j) {
+                    const ptrdiff_t c = i1-nlo+j;
+                    const ptrdiff_t r2 = c+nlo+1;
+                    Wk.col(j,0,r2-i1) = A.col(c,i1,r2);
+                }
+                LU_LDivEq(LUk,Pk,Wk);
+            }
+        }
+        for(int k=0;k<nparts;++k) if (sing[k]) singular = true;
+        if (singular) return;
+
+        // The reduced system.  The unknowns are ordered:
+        // xbot_0, xtop_1, xbot_1, xtop_2, ... xbot_p-2, xtop_p-1
+        // where xtop_k is the first nhi elements of partition k, and 
+        // xbot_k is the last nlo elements.
+        const ptrdiff_t nr = (nparts-1)*(nlo+nhi);
+        const ptrdiff_t rlo = TMV_MIN(2*nlo+nhi-1,nr-1);
+        const ptrdiff_t rhi = TMV_MIN(nlo+2*nhi-1,nr-1);
+        BandMatrix<T,ColMajor> R(nr,nr,rlo,rhi,T(0));
+        R.diag().setAllTo(T(1));
+        for(int k=0;k<nparts;++k) {
+            const ptrdiff_t nk = start[k+1]-start[k];
+            const ptrdiff_t bot = k*(nlo+nhi);  // xbot_k
+            const ptrdiff_t top = bot-nhi;      // xtop_k
+            ConstMatrixView<T> Vk = V.rowRange(start[k],start[k+1]);
+            ConstMatrixView<T> Wk = W.rowRange(start[k],start[k+1]);
+            // Top rows: xtop_k + Vtop_k xtop_k+1 + Wtop_k xbot_k-1 = gtop_k
+            if (k > 0) {
+                for(ptrdiff_t i=0;i<nhi;++i) {
+                    for(ptrdiff_t j=0;j<nlo;++j)
+                        R(top+i,top-nlo+j) = Wk(i,j);
+                    if (k < nparts-1) 
+                        for(ptrdiff_t j=0;j<nhi;++j)
+                            R(top+i,bot+nlo+j) = Vk(i,j);
+                }
+            }
+            // Bottom rows: xbot_k + Vbot_k xtop_k+1 + Wbot_k xbot_k-1 = gbot_k
+            if (k < nparts-1) {
+                for(ptrdiff_t i=0;i<nlo;++i) {
+                    if (k > 0) 
+                        for(ptrdiff_t j=0;j<nlo;++j)
+                            R(bot+i,top-nlo+j) = Wk(nk-nlo+i,j);
+                    for(ptrdiff_t j=0;j<nhi;++j)
+                        R(bot+i,bot+nlo+j) = Vk(nk-nlo+i,j);
+                }
+            }
+        }
+        reduced.reset(new BandLUDiv<T>(R,false));
+        singular = reduced->isSingular();
+    }
+
+    template <class T> 
+    BandSpikeLU<T>::~BandSpikeLU() {}
+
+    template <class T> 
+    ConstBandMatrixView<T> BandSpikeLU<T>::getLU(int k) const
+    {
+        const ptrdiff_t nk = start[k+1]-start[k];
+        return BandMatrixViewOf(
+            LUptr.get()+lustart[k],nk,nk,nlo,nlo+nhi,
+            (nlo == 1 && nhi == 1) ? DiagMajor : ColMajor);
+    }
+
+    template <class T, class T1> 
+    void BandSpike_LDivEq(const BandSpikeLU<T1>& S, MatrixView<T> m)
+    {
+        TMVAssert(m.colsize() == S.N);
+        TMVAssert(!S.isSingular());
+        const int nparts = S.nparts;
+        const ptrdiff_t nlo = S.nlo;
+        const ptrdiff_t nhi = S.nhi;
+        const ptrdiff_t K = m.rowsize();
+
+        // g = D^-1 m
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(int k=0;k<nparts;++k) {
+            const ptrdiff_t i1 = S.start[k];
+            const ptrdiff_t i2 = S.start[k+1];
+            LU_LDivEq(S.getLU(k),S.P.get()+i1,m.rowRange(i1,i2));
+        }
+
+        // Solve the reduced system for the xtop and xbot values.
+        Matrix<T,ColMajor> y((nparts-1)*(nlo+nhi),K);
+        for(int k=0;k<nparts-1;++k) {
+            const ptrdiff_t bot = k*(nlo+nhi);
+            const ptrdiff_t i2 = S.start[k+1];
+            y.rowRange(bot,bot+nlo) = m.rowRange(i2-nlo,i2);
+            y.rowRange(bot+nlo,bot+nlo+nhi) = m.rowRange(i2,i2+nhi);
+        }
+        S.reduced->LDivEq(y.view());
+
+        // x_k = g_k - V_k xtop_k+1 - W_k xbot_k-1
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(int k=0;k<nparts;++k) {
+            const ptrdiff_t i1 = S.start[k];
+            const ptrdiff_t i2 = S.start[k+1];
+            const ptrdiff_t bot = k*(nlo+nhi);
+            MatrixView<T> mk = m.rowRange(i1,i2);
+            if (k < nparts-1) 
+                mk -= S.V.rowRange(i1,i2) * y.rowRange(bot+nlo,bot+nlo+nhi);
+            if (k > 0) 
+                mk -= S.W.rowRange(i1,i2) * y.rowRange(bot-nhi-nlo,bot-nhi);
+        }
+    }
+
+#define InstFile "TMV_BandSpike.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TMV_BandSpike_H
+#define TMV_BandSpike_H
+
+#include "tmv/TMV_BaseBandMatrix.h"
+#include "tmv/TMV_Matrix.h"
+
+namespace tmv {
+
+    template <typename T>
+    class BandLUDiv;
+
+    // A partitioned (SPIKE) LU decomposition of a square band matrix
+    // with small bandwidth, which lets both the decomposition and the
+    // solutions be split across OpenMP threads.
+    //
+    // The rows are split into p partitions, and A is written as D S, 
+    // where D = diag(A_0, A_1, ... A_p-1) is the block diagonal part of A.
+    // Each A_k is LU decomposed (with partial pivoting within the 
+    // block) independently.  S is the identity plus the "spikes":
+    //
+    // V_k = A_k^-1 [ 0 ; B_k ]   W_k = A_k^-1 [ C_k ; 0 ]
+    //
+    // where B_k (nhi x nhi) is the coupling of partition k to the
+    // first columns of partition k+1, and C_k (nlo x nlo) is the 
+    // coupling to the last columns of partition k-1.
+    //
+    // To solve A x = b, we first solve D g = b for each partition, 
+    // then solve the small reduced system, which involves just the
+    // top nhi and bottom nlo elements of each partition of x.  
+    // Finally, x_k = g_k - V_k xtop_k+1 - W_k xbot_k-1 for each partition.
+    //
+    // The first and last steps are done in parallel, and the reduced
+    // system, which only has (p-1)(nlo+nhi) rows, is done serially.
+    //
+    // Since the pivoting is only done within the partitions, this 
+    // requires each A_k to be nonsingular.  If any of them is (nearly)
+    // singular, or if the reduced system is, then isSingular() returns 
+    // true, and the regular serial algorithm should be used instead.
+    // 
+    template <typename T>
+    class BandSpikeLU
+    {
+    public :
+
+        BandSpikeLU(const GenBandMatrix<T>& A, int nparts);
+        ~BandSpikeLU();
+
+        bool isSingular() const { return singular; }
+
+        // The decomposition of A_k.
+        ConstBandMatrixView<T> getLU(int k) const;
+
+        const ptrdiff_t N;
+        const ptrdiff_t nlo;
+        const ptrdiff_t nhi;
+        const int nparts;
+        AlignedArray<ptrdiff_t> start;  // Partition k is start[k]..start[k+1]
+        AlignedArray<ptrdiff_t> lustart; // And LU_k starts at LUptr+lustart[k]
+        AlignedArray<T> LUptr;
+        AlignedArray<ptrdiff_t> P;
+        Matrix<T,ColMajor> V;
+        Matrix<T,ColMajor> W;
+        auto_ptr<BandLUDiv<T> > reduced;
+        bool singular;
+
+    private :
+
+        BandSpikeLU(const BandSpikeLU<T>&);
+        BandSpikeLU<T>& operator=(const BandSpikeLU<T>&);
+    };
+
+    // The partitioned algorithm is only used if nlo and nhi are 
+    // at most this large.  Otherwise the reduced system gets too big.
+#define TMV_BANDSPIKE_MAXBAND 16
+
+    // The number of partitions to use for a BandLUDiv of A, or 0 if
+    // the regular serial algorithm should be used.
+    template <typename T>
+    int BandSpike_NParts(const GenBandMatrix<T>& A);
+
+    // Solve A x = m, where A is the matrix decomposed by S.
+    template <typename T, typename T1> 
+    void BandSpike_LDivEq(const BandSpikeLU<T1>& S, MatrixView<T> m);
+
+    // Specialize disallowed complex combinations:
+#define CT std::complex<T>
+    template <typename T>
+    inline void BandSpike_LDivEq(const BandSpikeLU<CT>& , MatrixView<T> )
+    { TMVAssert(TMV_FALSE); }
+#undef CT
+
+}
+
+#endif
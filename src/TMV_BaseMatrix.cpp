@@ -26,8 +26,111 @@
 #include "tmv/TMV_Matrix.h"
 #include "tmv/TMV_Divider.h"
 
+#if __cplusplus >= 201103L
+#include <mutex>
+#elif defined(_OPENMP)
+#include <omp.h>
+#endif
+
 namespace tmv {
 
+    // The locks used to create the Dividers.  Rather than give each 
+    // matrix its own mutex, which would make every matrix quite a bit 
+    // larger, matrices share a fixed set of mutexes according to their
+    // address.  The only cost of sharing is that two threads creating 
+    // Dividers for different matrices might occasionally have to wait 
+    // for each other.
+#ifndef TMV_NDIVLOCKS
+#define TMV_NDIVLOCKS 64
+#endif
+
+#if __cplusplus >= 201103L
+    static std::recursive_mutex& GetDivMutex(const void* p)
+    {
+        static std::recursive_mutex divlocks[TMV_NDIVLOCKS];
+        const size_t i = (reinterpret_cast<size_t>(p) >> 4) % TMV_NDIVLOCKS;
+        return divlocks[i];
+    }
+#elif defined(_OPENMP)
+    // Without C++11, use OpenMP nestable locks, which are recursive
+    // like std::recursive_mutex.
+    struct DivLockArray
+    {
+        DivLockArray() 
+        { for(int i=0;i<TMV_NDIVLOCKS;++i) omp_init_nest_lock(locks+i); }
+        ~DivLockArray() 
+        { for(int i=0;i<TMV_NDIVLOCKS;++i) omp_destroy_nest_lock(locks+i); }
+        omp_nest_lock_t locks[TMV_NDIVLOCKS];
+    };
+
+    static omp_nest_lock_t* GetDivMutex(const void* p)
+    {
+        static DivLockArray divlocks;
+        const size_t i = (reinterpret_cast<size_t>(p) >> 4) % TMV_NDIVLOCKS;
+        return divlocks.locks + i;
+    }
+#endif
+
+    template <class T>
+    void DivHelper<T>::lockDiv() const
+    {
+#if __cplusplus >= 201103L
+        GetDivMutex(this).lock();
+#elif defined(_OPENMP)
+        omp_set_nest_lock(GetDivMutex(this));
+#endif
+    }
+
+    template <class T>
+    void DivHelper<T>::unlockDiv() const
+    {
+#if __cplusplus >= 201103L
+        GetDivMutex(this).unlock();
+#elif defined(_OPENMP)
+        omp_unset_nest_lock(GetDivMutex(this));
+#endif
+    }
+
+    template <class T>
+    const Divider<T>* DivHelper<T>::acquireDiv(
+        auto_ptr<Divider<T> >& temp) const
+    {
+#if __cplusplus >= 201103L
+        // The usual case when a matrix is shared by several threads.
+        // Once the Divider is set, this is the only code that runs.
+        // divtype is only read once the Divider has been seen, so it
+        // can't race with setDefaultDivType() below.
+        const Divider<T>* d = divider.get();
+        if (d && divIsSaved()) return d;
+#endif
+        // Without C++11, neither divider nor divtype may be read outside
+        // the lock, so always take it here.  The default DivType is also 
+        // set here, so that newDiv() doesn't need to write anything.
+        {
+            DivLock<T> lock(*this);
+            setDefaultDivType();
+            if (divIsSaved()) {
+                setDiv();
+                return divider.get();
+            }
+            if (divIsInPlace() || divider.get()) {
+                setDiv();
+                temp.reset(divider.release());
+                return temp.get();
+            }
+        }
+        // Not saved: unless the decomposition overwrites the matrix, 
+        // each thread can decompose into its own Divider without 
+        // touching this object, so the decomposition itself doesn't 
+        // need the lock.
+        temp.reset(newDiv());
+        if (temp.get()) return temp.get();
+        DivLock<T> lock(*this);
+        setDiv();
+        temp.reset(divider.release());
+        return temp.get();
+    }
+
     template <class T>
     DivHelper<T>::DivHelper() : divider(), divtype(tmv::XX) {}
 
@@ -38,9 +141,8 @@ namespace tmv {
     T DivHelper<T>::doDet() const
     {
         TMVAssert(colsize() == rowsize());
-        setDiv();
-        T det = divider->det();
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        T det = acquireDiv(temp)->det();
         return det;
     }
 
@@ -48,9 +150,8 @@ namespace tmv {
     TMV_RealType(T) DivHelper<T>::doLogDet(T* sign) const
     {
         TMVAssert(colsize() == rowsize());
-        setDiv();
-        TMV_RealType(T) logdet = divider->logDet(sign);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        TMV_RealType(T) logdet = acquireDiv(temp)->logDet(sign);
         return logdet;
     }
 
@@ -64,9 +165,8 @@ namespace tmv {
     {
         TMVAssert(minv.colsize() == rowsize());
         TMVAssert(minv.rowsize() == colsize());
-        setDiv();
-        DoMakeInverse1(*divider,minv);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoMakeInverse1(*acquireDiv(temp),minv);
     }
 
     template <class T>
@@ -74,17 +174,15 @@ namespace tmv {
     {
         TMVAssert(minv.colsize() == TMV_MIN(rowsize(),colsize()));
         TMVAssert(minv.rowsize() == TMV_MIN(rowsize(),colsize()));
-        setDiv();
-        divider->makeInverseATA(minv);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        acquireDiv(temp)->makeInverseATA(minv);
     }
 
     template <class T>
     bool DivHelper<T>::doIsSingular() const
     {
-        setDiv();
-        bool s = divider->isSingular();
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        bool s = acquireDiv(temp)->isSingular();
         return s;
     }
 
@@ -131,9 +229,8 @@ namespace tmv {
     {
         TMVAssert(colsize() == rowsize());
         TMVAssert(colsize() == v.size());
-        setDiv();
-        DoLDivEq1(*divider,ColVectorViewOf(v));
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoLDivEq1(*acquireDiv(temp),ColVectorViewOf(v));
     }
 
     template <class T> template <class T1> 
@@ -141,9 +238,8 @@ namespace tmv {
     {
         TMVAssert(colsize() == rowsize());
         TMVAssert(colsize() == m.colsize());
-        setDiv();
-        DoLDivEq1(*divider,m);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoLDivEq1(*acquireDiv(temp),m);
     }
 
     template <class T> template <class T1> 
@@ -151,9 +247,8 @@ namespace tmv {
     {
         TMVAssert(colsize() == rowsize());
         TMVAssert(colsize() == v.size());
-        setDiv();
-        DoRDivEq1(*divider,RowVectorViewOf(v));
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoRDivEq1(*acquireDiv(temp),RowVectorViewOf(v));
     }
 
     template <class T> template <class T1> 
@@ -161,9 +256,8 @@ namespace tmv {
     {
         TMVAssert(colsize() == rowsize());
         TMVAssert(colsize() == m.rowsize());
-        setDiv();
-        DoRDivEq1(*divider,m);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoRDivEq1(*acquireDiv(temp),m);
     }
 
     template <class T> template <class T1, class T0> 
@@ -172,9 +266,8 @@ namespace tmv {
     {
         TMVAssert(rowsize() == v0.size());
         TMVAssert(colsize() == v1.size());
-        setDiv();
-        DoLDiv1(*divider,ColVectorViewOf(v1),ColVectorViewOf(v0));
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoLDiv1(*acquireDiv(temp),ColVectorViewOf(v1),ColVectorViewOf(v0));
     }
 
     template <class T> template <class T1, class T0> 
@@ -184,9 +277,8 @@ namespace tmv {
         TMVAssert(rowsize() == m0.colsize());
         TMVAssert(colsize() == m1.colsize());
         TMVAssert(m1.rowsize() == m0.rowsize());
-        setDiv();
-        DoLDiv1(*divider,m1,m0);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoLDiv1(*acquireDiv(temp),m1,m0);
     }
 
     template <class T> template <class T1, class T0> 
@@ -195,9 +287,8 @@ namespace tmv {
     {
         TMVAssert(rowsize() == v1.size());
         TMVAssert(colsize() == v0.size());
-        setDiv();
-        DoRDiv1(*divider,RowVectorViewOf(v1),RowVectorViewOf(v0));
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoRDiv1(*acquireDiv(temp),RowVectorViewOf(v1),RowVectorViewOf(v0));
     }
 
     template <class T> template <class T1, class T0> 
@@ -207,9 +298,8 @@ namespace tmv {
         TMVAssert(rowsize() == m1.rowsize());
         TMVAssert(colsize() == m0.rowsize());
         TMVAssert(m1.colsize() == m0.colsize());
-        setDiv();
-        DoRDiv1(*divider,m1,m0);
-        doneDiv();
+        auto_ptr<Divider<T> > temp;
+        DoRDiv1(*acquireDiv(temp),m1,m0);
     }
 
     template <class T>
@@ -225,10 +315,14 @@ namespace tmv {
     template <class T>
     DivType DivHelper<T>::getDivType() const 
     {
-        if ((divtype & tmv::DivTypeFlags) == tmv::XX) resetDivType();
+        setDefaultDivType();
         return divtype & tmv::DivTypeFlags;
     }
 
+    template <class T>
+    void DivHelper<T>::setDefaultDivType() const
+    { if ((divtype & tmv::DivTypeFlags) == tmv::XX) resetDivType(); }
+
     template <class T>
     void DivHelper<T>::resetDivType() const
     { divideUsing(getMatrix().isSquare() ? tmv::LU : tmv::QR); }
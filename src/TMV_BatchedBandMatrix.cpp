@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "tmv/TMV_BatchedBandMatrix.h"
+#include "tmv/TMV_Matrix.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    //
+    // The kernels.
+    // Each of these solves nk consecutive systems in the batch.
+    // A is the start of the first matrix, with stride sa, and B is the
+    // start of the first right hand side, with element i of each 
+    // vector at B + i*sb.  W is the working space for this chunk.
+    //
+
+    // The Thomas algorithm:
+    // c'_0 = c_0/b_0, c'_i = c_i / (b_i - a_i c'_i-1)
+    // d'_0 = d_0/b_0, d'_i = (d_i - a_i d'_i-1) / (b_i - a_i c'_i-1)
+    // x_N-1 = d'_N-1, x_i = d'_i - c'_i x_i+1
+    // where a, b, c are the sub-, main and super-diagonals.
+    // c' is stored in W, and d' and then x are stored in B.
+    template <class T> 
+    static void BatchTridiagKernel(
+        const T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, T* W,
+        ptrdiff_t N, ptrdiff_t nk)
+    {
+        const ptrdiff_t sw = TMV_BATCHBAND_CHUNK;
+        const T* b0 = A + sa;
+        const T* c0 = A + 2*sa;
+        for(ptrdiff_t k=0;k<nk;++k) {
+            const T invb = T(1) / b0[k];
+            W[k] = c0[k] * invb;
+            B[k] *= invb;
+        }
+        for(ptrdiff_t i=1;i<N;++i) {
+            const T* ai = A + 3*i*sa;
+            const T* bi = ai + sa;
+            const T* ci = ai + 2*sa;
+            const T* cp = W + (i-1)*sw;
+            const T* dp = B + (i-1)*sb;
+            T* Wi = W + i*sw;
+            T* Bi = B + i*sb;
+            for(ptrdiff_t k=0;k<nk;++k) {
+                const T invm = T(1) / (bi[k] - ai[k] * cp[k]);
+                Wi[k] = ci[k] * invm;
+                Bi[k] = (Bi[k] - ai[k] * dp[k]) * invm;
+            }
+        }
+        for(ptrdiff_t i=N-2;i>=0;--i) {
+            const T* Wi = W + i*sw;
+            const T* x = B + (i+1)*sb;
+            T* Bi = B + i*sb;
+            for(ptrdiff_t k=0;k<nk;++k) Bi[k] -= Wi[k] * x[k];
+        }
+    }
+
+    // Band LU decomposition with partial pivoting, applying the same
+    // row operations to B, and then back substitution with U.
+    // Row i of the working copy of A holds the elements (i,i-nlo) ..
+    // (i,i+nlo+nhi), since the row swaps can extend U to have 
+    // nlo+nhi superdiagonals.
+    template <class T> 
+    static void BatchBandLUKernel(
+        const T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, T* W,
+        ptrdiff_t N, ptrdiff_t nlo, ptrdiff_t nhi, ptrdiff_t nk)
+    {
+        typedef TMV_RealType(T) RT;
+        const ptrdiff_t sw = TMV_BATCHBAND_CHUNK;
+        const ptrdiff_t wa = nlo+nhi+1;    // The row length in A
+        const ptrdiff_t ww = 2*nlo+nhi+1;  // The row length in W
+        ptrdiff_t ip[TMV_BATCHBAND_CHUNK];
+        RT piv[TMV_BATCHBAND_CHUNK];
+        TMVAssert(nk <= TMV_BATCHBAND_CHUNK);
+
+        // Copy A into W, setting the elements outside the matrix and
+        // the extra superdiagonals to 0.
+        for(ptrdiff_t i=0;i<N;++i) {
+            for(ptrdiff_t d=0;d<ww;++d) {
+                const ptrdiff_t j = i-nlo+d;
+                T* Wij = W + (i*ww+d)*sw;
+                if (d < wa && j >= 0 && j < N) {
+                    const T* Aij = A + (i*wa+d)*sa;
+                    for(ptrdiff_t k=0;k<nk;++k) Wij[k] = Aij[k];
+                } else {
+                    for(ptrdiff_t k=0;k<nk;++k) Wij[k] = T(0);
+                }
+            }
+        }
+
+        // Element (i,j) of the working copy.  j-i must be in [-nlo,nlo+nhi]
+#define Wel(i,j) (W + ((i)*ww+(j)-(i)+nlo)*sw)
+
+        for(ptrdiff_t j=0;j<N;++j) {
+            const ptrdiff_t r2 = TMV_MIN(j+nlo+1,N);     // rows j..r2-1
+            const ptrdiff_t c2 = TMV_MIN(j+nlo+nhi+1,N); // cols j..c2-1
+
+            // Find the pivot for each system.  The comparisons are done
+            // with conditional assignments, so the loop vectorizes.
+            const T* Wjj = Wel(j,j);
+            for(ptrdiff_t k=0;k<nk;++k) {
+                ip[k] = j;
+                piv[k] = TMV_ABS2(Wjj[k]);
+            }
+            for(ptrdiff_t r=j+1;r<r2;++r) {
+                const T* Wrj = Wel(r,j);
+                for(ptrdiff_t k=0;k<nk;++k) {
+                    const RT x = TMV_ABS2(Wrj[k]);
+                    const bool bigger = x > piv[k];
+                    piv[k] = bigger ? x : piv[k];
+                    ip[k] = bigger ? r : ip[k];
+                }
+            }
+
+            // Swap row j with row ip in each system, again by blending
+            // each row below j with row j.
+            if (r2 > j+1) {
+                for(ptrdiff_t c=j;c<=c2;++c) {
+                    // c == c2 means B.
+                    T* Wjc = c<c2 ? Wel(j,c) : B + j*sb;
+                    for(ptrdiff_t k=0;k<nk;++k) {
+                        const T aj = Wjc[k];
+                        T newj = aj;
+                        for(ptrdiff_t r=j+1;r<r2;++r) {
+                            T* Wrc = c<c2 ? Wel(r,c) : B + r*sb;
+                            const T ar = Wrc[k];
+                            const bool swap = ip[k] == r;
+                            newj = swap ? ar : newj;
+                            Wrc[k] = swap ? aj : ar;
+                        }
+                        Wjc[k] = newj;
+                    }
+                }
+            }
+
+            // Eliminate the elements below the diagonal.
+            const T* Bj = B + j*sb;
+            for(ptrdiff_t r=j+1;r<r2;++r) {
+                T* Wrj = Wel(r,j);
+                for(ptrdiff_t k=0;k<nk;++k) Wrj[k] /= Wjj[k];
+                for(ptrdiff_t c=j+1;c<c2;++c) {
+                    T* Wrc = Wel(r,c);
+                    const T* Wjc = Wel(j,c);
+                    for(ptrdiff_t k=0;k<nk;++k) Wrc[k] -= Wrj[k] * Wjc[k];
+                }
+                T* Br = B + r*sb;
+                for(ptrdiff_t k=0;k<nk;++k) Br[k] -= Wrj[k] * Bj[k];
+            }
+        }
+
+        // Back substitute with U.
+        for(ptrdiff_t j=N-1;j>=0;--j) {
+            const ptrdiff_t c2 = TMV_MIN(j+nlo+nhi+1,N);
+            T* Bj = B + j*sb;
+            for(ptrdiff_t c=j+1;c<c2;++c) {
+                const T* Wjc = Wel(j,c);
+                const T* Bc = B + c*sb;
+                for(ptrdiff_t k=0;k<nk;++k) Bj[k] -= Wjc[k] * Bc[k];
+            }
+            const T* Wjj = Wel(j,j);
+            for(ptrdiff_t k=0;k<nk;++k) Bj[k] /= Wjj[k];
+        }
+#undef Wel
+    }
+
+#ifdef __PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
+
+    // Run the kernel on each chunk of the batch, in parallel if possible.
+    // Each thread gets its own part of the workspace, of size wsize.
+    template <class T, class F> 
+    static void BatchBandSolve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B,
+        BatchBandWorkspace<T>& work, ptrdiff_t wsize, F kernel)
+    {
+        TMVAssert(B.colsize() == A.nbatch());
+        TMVAssert(B.rowsize() == A.colsize());
+        if (!B.iscm() || B.isconj()) {
+            // The kernels need B to have the interleaved storage.
+            Matrix<T,ColMajor> B2 = B;
+            BatchBandSolve(A,B2.view(),work,wsize,kernel);
+            B = B2;
+            return;
+        }
+        const ptrdiff_t nb = A.nbatch();
+        if (nb == 0 || A.colsize() == 0) return;
+        const ptrdiff_t nchunks = 
+            (nb + TMV_BATCHBAND_CHUNK-1) / TMV_BATCHBAND_CHUNK;
+#ifdef _OPENMP
+        const bool par = nchunks > 1 && !omp_in_parallel();
+        const int nthreads = par ? omp_get_max_threads() : 1;
+#else
+        const int nthreads = 1;
+#endif
+        T* W = work.get(nthreads*wsize);
+        const T* Ap = A.cptr();
+        const ptrdiff_t sa = A.stride();
+        T* Bp = B.ptr();
+        const ptrdiff_t sb = B.stepj();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nthreads) if (par)
+#endif
+        for(TMV_INT_OMP c=0;c<nchunks;++c) {
+#ifdef _OPENMP
+            T* Wt = W + (par ? omp_get_thread_num() : 0)*wsize;
+#else
+            T* Wt = W;
+#endif
+            const ptrdiff_t k1 = c*TMV_BATCHBAND_CHUNK;
+            const ptrdiff_t nk = TMV_MIN(TMV_BATCHBAND_CHUNK,nb-k1);
+            kernel(Ap+k1,sa,Bp+k1,sb,Wt,nk);
+        }
+    }
+
+#undef TMV_INT_OMP
+
+    template <class T> 
+    struct BatchTridiagFunc
+    {
+        ptrdiff_t N;
+        BatchTridiagFunc(ptrdiff_t _N) : N(_N) {}
+        void operator()(
+            const T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, T* W, 
+            ptrdiff_t nk) const
+        { BatchTridiagKernel(A,sa,B,sb,W,N,nk); }
+    };
+
+    template <class T> 
+    struct BatchBandLUFunc
+    {
+        ptrdiff_t N, nlo, nhi;
+        BatchBandLUFunc(ptrdiff_t _N, ptrdiff_t _nlo, ptrdiff_t _nhi) :
+            N(_N), nlo(_nlo), nhi(_nhi) {}
+        void operator()(
+            const T* A, ptrdiff_t sa, T* B, ptrdiff_t sb, T* W, 
+            ptrdiff_t nk) const
+        { BatchBandLUKernel(A,sa,B,sb,W,N,nlo,nhi,nk); }
+    };
+
+    template <class T> 
+    void BatchTridiag_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B,
+        BatchBandWorkspace<T>& work)
+    {
+        TMVAssert(A.nlo() == 1 && A.nhi() == 1);
+        const ptrdiff_t N = A.colsize();
+        BatchBandSolve(
+            A,B,work,N*TMV_BATCHBAND_CHUNK,BatchTridiagFunc<T>(N));
+    }
+
+    template <class T> 
+    void BatchBandLU_Solve(
+        const BatchedBandMatrix<T>& A, MatrixView<T> B,
+        BatchBandWorkspace<T>& work)
+    {
+        const ptrdiff_t N = A.colsize();
+        const ptrdiff_t ww = 2*A.nlo()+A.nhi()+1;
+        BatchBandSolve(
+            A,B,work,N*ww*TMV_BATCHBAND_CHUNK,
+            BatchBandLUFunc<T>(N,A.nlo(),A.nhi()));
+    }
+
+#define InstFile "TMV_BatchedBandMatrix.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
@@ -0,0 +1,51 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "tmv/TMV_Base.h"
+#include "tmv/TMV_BatchedSmallMatrix.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tmv {
+
+    void BatchForEachChunk(ptrdiff_t nb, BatchChunkFunction f, void* data)
+    {
+        const ptrdiff_t nchunks = (nb + TMV_BATCH_CHUNK-1) / TMV_BATCH_CHUNK;
+#ifdef __PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
+#ifdef _OPENMP
+#pragma omp parallel for if (nchunks > 1 && !omp_in_parallel())
+#endif
+        for(TMV_INT_OMP c=0;c<nchunks;++c) {
+            const ptrdiff_t k1 = c*TMV_BATCH_CHUNK;
+            const ptrdiff_t nk = TMV_MIN(TMV_BATCH_CHUNK,nb-k1);
+            f(k1,nk,data);
+        }
+#undef TMV_INT_OMP
+    }
+
+} // namespace tmv
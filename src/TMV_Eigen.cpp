@@ -0,0 +1,191 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//#define XDEBUG
+
+// This file has the driver routines for the eigenvalues and eigenvectors
+// of general (non-hermitian) square matrices:
+//
+// 1) Reduce A to upper Hessenberg form: A = U H Ut (TMV_Eigen_Hessenberg.cpp)
+// 2) Reduce H to Schur form with the QR algorithm: H = Q T Qt, 
+//    so A = Z T Zt with Z = U Q.  (TMV_Eigen_QR.cpp)
+// 3) If eigenvectors are requested, find the eigenvectors of T by 
+//    back substitution, and multiply them by Z.
+
+#include "tmv/TMV_Schur.h"
+#include "TMV_Eigen.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_VectorArith.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_TriMatrixArith.h"
+#include <limits>
+
+#ifdef XDEBUG
+#include "tmv/TMV_DiagMatrix.h"
+#include "tmv/TMV_DiagMatrixArith.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#endif
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+#define CT std::complex<RT>
+
+    template <class T> 
+    static void DoSchur(
+        MatrixView<T> H, MatrixView<T> Z, bool wantZ, bool multishift)
+    {
+        // H is input as A, and output as T.
+        // If wantZ, Z is set to the Schur vectors.
+        TMVAssert(H.iscm());
+        TMVAssert(H.ct() == NonConj);
+        const ptrdiff_t N = H.colsize();
+        if (N > 1) {
+            Vector<T> Ubeta(N-1);
+            Hessenberg(H,Ubeta.view());
+            if (wantZ) GetQFromHessenberg(H,Ubeta,Z);
+            H.lowerTri().offDiag(2).setZero();
+        } else if (wantZ) {
+            Z.setToIdentity();
+        }
+        if (wantZ) SchurFromHessenberg(H,Z,true,multishift);
+        else {
+            MatrixView<T> Z0(0,0,0,1,1,NonConj);
+            SchurFromHessenberg(H,Z0,false,multishift);
+        }
+    }
+
+    template <class T> 
+    void Schur_Decompose(
+        MatrixView<T> A, MatrixView<T> Z, VectorView<CT> lambda, 
+        bool multishift)
+    {
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(Z.colsize() == A.colsize());
+        TMVAssert(Z.rowsize() == A.rowsize());
+        TMVAssert(lambda.size() == A.colsize());
+        const ptrdiff_t N = A.colsize();
+        if (N == 0) return;
+
+        // Work on column major copies, since the algorithm needs 
+        // direct access to the storage.  The O(N^2) copies are 
+        // negligible compared to the O(N^3) work.
+        Matrix<T,ColMajor> H = A;
+        Matrix<T,ColMajor> Q(N,N);
+        DoSchur(H.view(),Q.view(),true,multishift);
+        SchurEigenValues(H,lambda);
+        A = H;
+        Z = Q;
+    }
+
+    template <class T> 
+    void Eigen(const GenMatrix<T>& A, VectorView<CT> lambda)
+    {
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(lambda.size() == A.colsize());
+        const ptrdiff_t N = A.colsize();
+        if (N == 0) return;
+
+        Matrix<T,ColMajor> H = A;
+        MatrixView<T> Z0(0,0,0,1,1,NonConj);
+        DoSchur(H.view(),Z0,false,true);
+        SchurEigenValues(H,lambda);
+    }
+
+    template <class T> 
+    void Eigen(
+        const GenMatrix<T>& A, MatrixView<CT> V, VectorView<CT> lambda)
+    {
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(V.colsize() == A.colsize());
+        TMVAssert(V.rowsize() == A.rowsize());
+        TMVAssert(lambda.size() == A.colsize());
+        const ptrdiff_t N = A.colsize();
+        if (N == 0) return;
+
+        Matrix<T,ColMajor> H = A;
+        Matrix<T,ColMajor> Z(N,N);
+        DoSchur(H.view(),Z.view(),true,true);
+
+        // For real matrices, the 2x2 blocks of the real Schur form need 
+        // to be split up into the complex Schur form.  The QR algorithm 
+        // will do this with a single rotation for each block.
+        Matrix<CT,ColMajor> TT = H;
+        Matrix<CT,ColMajor> ZZ = Z;
+        if (isReal(T())) 
+            SchurFromHessenberg(TT.view(),ZZ.view(),true,false);
+        lambda = TT.diag();
+
+        // The eigenvectors of the upper triangular TT are found by 
+        // back substitution: (T(0:k,0:k) - lambda_k) y = -T(0:k,k), 
+        // with y(k) = 1.
+        // Small diagonal elements are perturbed, so that degenerate
+        // eigenvalues still give a (nearly parallel) eigenvector.
+        const RT eps = TMV_Epsilon<T>();
+        const RT smlnum = std::numeric_limits<RT>::min() * RT(N) / eps;
+        const RT smin = TMV_MAX(eps * NormF(TT),smlnum);
+        Matrix<CT,ColMajor> Y(N,N,CT(0));
+        for(ptrdiff_t k=0;k<N;++k) {
+            const CT lk = TT(k,k);
+            Y(k,k) = CT(1);
+            for(ptrdiff_t i=0;i<k;++i) Y(i,k) = -TT(i,k);
+            for(ptrdiff_t i=k-1;i>=0;--i) {
+                CT d = TT(i,i) - lk;
+                if (TMV_ABS(d) < smin) d = CT(smin);
+                const CT yi = Y(i,k) / d;
+                Y(i,k) = yi;
+                // Rescale if the solution is getting too large.
+                const RT ayi = TMV_ABS(yi);
+                if (ayi > RT(1) / smlnum) {
+                    Y.col(k,0,k+1) /= ayi;
+                }
+                if (yi != CT(0)) Y.col(k,0,i) -= Y(i,k) * TT.col(i,0,i);
+            }
+        }
+        V = ZZ * Y.upperTri();
+        for(ptrdiff_t k=0;k<N;++k) {
+            const RT norm = Norm(V.col(k));
+            if (norm > RT(0)) V.col(k) /= norm;
+        }
+
+#ifdef XDEBUG
+        Matrix<CT> AV = A*V;
+        Matrix<CT> VL = V*DiagMatrixViewOf(lambda);
+        cout<<"Eigen: Norm(AV-VL) = "<<Norm(AV-VL)<<endl;
+#endif
+    }
+
+#undef RT
+#undef CT
+
+#define InstFile "TMV_Eigen.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TMV_Eigen_H
+#define TMV_Eigen_H
+
+#include "tmv/TMV_BaseMatrix.h"
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+#define CT std::complex<RT>
+
+    // Reduce A to upper Hessenberg form: A = U H Ut.
+    // On output, H is stored in the upper Hessenberg part of A, and
+    // U is stored in compact form in the rest of A along with Ubeta.
+    template <typename T> 
+    void Hessenberg(MatrixView<T> A, VectorView<T> Ubeta);
+
+    // Form the unitary matrix U from the output of Hessenberg.
+    template <typename T> 
+    void GetQFromHessenberg(
+        const GenMatrix<T>& A, const GenVector<T>& Ubeta, MatrixView<T> U);
+
+    // Reduce the upper Hessenberg matrix H to Schur form with the 
+    // QR algorithm.  For real T, this is the real Schur form, with 
+    // 2x2 blocks on the diagonal for complex conjugate pairs of 
+    // eigenvalues.  If Z.cptr() != 0, Z is multiplied by the 
+    // Schur vectors.
+    // If wantT is false, only the parts of H needed to find the 
+    // eigenvalues are updated.
+    // If multishift is false, the classic Francis double-shift QR 
+    // algorithm is used for all sizes.
+    template <typename T> 
+    void SchurFromHessenberg(
+        MatrixView<T> H, MatrixView<T> Z, bool wantT, bool multishift);
+
+    // Read the eigenvalues off the diagonal (blocks) of the Schur form.
+    template <typename T> 
+    void SchurEigenValues(const GenMatrix<T>& H, VectorView<CT> lambda);
+
+#undef RT
+#undef CT
+
+}
+
+#endif
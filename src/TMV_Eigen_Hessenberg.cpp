@@ -21,12 +21,20 @@
 
 
 
-#include "TMV_Blas.h"
-#include "TMV_Eigen.h"
-#include "TMV_Matrix.h"
 
 //#define XDEBUG
 
+#include "TMV_Blas.h"
+#include "TMV_Eigen.h"
+#include "TMV_QRDiv.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_Householder.h"
+#include "tmv/TMV_VectorArith.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_TriMatrixArith.h"
+
 #ifdef XDEBUG
 #include <iostream>
 using std::cout;
@@ -39,9 +47,11 @@ namespace tmv {
 #ifdef TMV_BLOCKSIZE
 #define HESS_BLOCKSIZE TMV_BLOCKSIZE
 #else
-#define HESS_BLOCKSIZE 16
+#define HESS_BLOCKSIZE 32
 #endif
 
+#define RT TMV_RealType(T)
+
     //
     // Reduce Matrix to Hessenberg Form (upper tri with one lower sub-diag)
     //
@@ -52,7 +62,6 @@ namespace tmv {
     {
 #ifdef XDEBUG
         cout<<"Start NonBlock Hessenberg Reduction: A = "<<A<<endl;
-        Matrix<T> A0(A);
 #endif
         // Decompose A into U H Ut
         // H is a Hessenberg Matrix
@@ -65,203 +74,134 @@ namespace tmv {
         TMVAssert(A.colsize() == A.rowsize());
         TMVAssert(N > 0);
         TMVAssert(Ubeta.size() == N-1);
-        TMVAssert(A.iscm() || A.isrm());
         TMVAssert(!Ubeta.isconj());
         TMVAssert(Ubeta.step()==1);
 
         // We use Householder reflections to reduce A to the Hessenberg form:
         T* Uj = Ubeta.ptr();
-        T det = 0; // Ignore Householder det calculations
+        T det(0); // Ignore Householder det calculations
         for(ptrdiff_t j=0;j<N-1;++j,++Uj) {
 #ifdef TMVFLDEBUG
             TMVAssert(Uj >= Ubeta._first);
             TMVAssert(Uj < Ubeta._last);
 #endif
-            *Uj = Householder_Reflect(A.subMatrix(j+1,N,j,N),det);
-            if (*Uj != T(0))
-                Householder_LMult(A.col(j+2,N),*Uj,A.subMatrix(0,N,j+1,N).adjoint());
-        }
-
-#ifdef XDEBUG
-        Matrix<T> U(N,N,T(0));
-        U.subMatrix(1,N,1,N) = A.subMatrix(1,N,0,N-1);
-        U.upperTri().setZero();
-        Vector<T> Ubeta2(N);
-        Ubeta2.subVector(1,N) = Ubeta;
-        Ubeta2(0) = T(0);
-        GetQFromQR(U.view(),Ubeta2);
-        Matrix<T> H = A;
-        if (N>2) LowerTriMatrixViewOf(H).offDiag(2).setZero();
-        Matrix<T> AA = U*H*U.adjoint();
-        if (Norm(A0-AA) > 0.001*Norm(A0)) {
-            cerr<<"NonBlock Hessenberg: A = "<<Type(A)<<"  "<<A0<<endl;
-            cerr<<"A = "<<A<<endl;
-            cerr<<"Ubeta = "<<Ubeta<<endl;
-            cerr<<"U = "<<U<<endl;
-            cerr<<"H = "<<H<<endl;
-            cerr<<"UHUt = "<<AA<<endl;
-            abort();
+            *Uj = HouseholderReflect(A.col(j,j+1,N),det);
+            if (*Uj != T(0)) {
+                // A <- H A Ht
+                HouseholderLMult(
+                    A.col(j,j+2,N),*Uj,A.subMatrix(j+1,N,j+1,N));
+                HouseholderLMult(
+                    A.col(j,j+2,N),*Uj,A.subMatrix(0,N,j+1,N).adjoint());
+            }
         }
-#endif
     }
 
     template <class T> 
     static void BlockHessenberg(
         MatrixView<T> A, VectorView<T> Ubeta)
     {
-        // Much like the block version of Bidiagonalize, we try to maintain
-        // the operation of several successive Householder matrices in
-        // a block form, where the net Block Householder is I - YZYt.
+        // This is the blocked algorithm of Quintana-Orti & van de Geijn
+        // (2006, ACM TOMS, 32, 180), which is also used by LAPACK's 
+        // xGEHRD.
         //
-        // But as with the bidiagonlization algorithm (and unlike a simple
-        // block QR decomposition), we update the matrix from both the left 
-        // and the right, so we also need to keep track of the product
-        // ZYtm in addition.
-        //
-        // The block update at the end of the block loop is
-        // m' = (I-YZYt) m (I-YZtYt)
-        //
-        // The Y matrix is stored in the first K columns of m,
-        // and the Hessenberg portion of these columns is updated as we go.
-        // For the right-hand-side update, m -= mYZtYt, the m on the right
-        // needs to be the full original matrix m, including the original
-        // versions of these K columns.  Therefore, we can't wait until 
-        // the end for this calculation.  
-        //
-        // Instead, we keep track of mYZt as we progress, so the final update
-        // is:
-        //
-        // m' = (I-YZYt) (m - mYZt Y)
-        //
-        // We also need to do this same calculation for each column as we
-        // progress through the block.
+        // The Householder matrices for a panel of columns j1..j2 are 
+        // accumulated into a block Householder matrix Q = I - Y Z Yt.
+        // The update of the rest of the matrix is then A <- Qt A Q,
+        // which is done with matrix products at the end of the panel.
         //
+        // The complication is that each column in the panel needs 
+        // to have the previous Householder matrices applied to it from
+        // both sides before we can find its Householder vector.
+        // The left side is easy.  For the right side, we keep track
+        // of AY = A Y as we go, since A Q = A - AY Z Yt.
+        // (Here A is the matrix at the start of the panel.)
+        // This means that half of the flops are matrix-vector products
+        // rather than matrix-matrix products, but the other half, the 
+        // trailing update, can use the fast (and multithreaded) 
+        // matrix-matrix routines.
         const ptrdiff_t N = A.rowsize();
 
-#ifdef XDEBUG
-        Matrix<T> A0(A);
-#endif
-
         TMVAssert(A.rowsize() == A.colsize());
         TMVAssert(N > 0);
         TMVAssert(Ubeta.size() == N-1);
         TMVAssert(!Ubeta.isconj());
         TMVAssert(Ubeta.step()==1);
 
-        ptrdiff_t ncolmax = MIN(HESS_BLOCKSIZE,N-1);
-        Matrix<T,RowMajor> mYZt_full(N,ncolmax);
-        UpperTriMatrix<T,NonUnitDiag|ColMajor> Z_full(ncolmax);
-
-        T det(0); // Ignore Householder Determinant calculations
-        T* Uj = Ubeta.ptr();
-        for(ptrdiff_t j1=0;j1<N-1;) {
-            ptrdiff_t j2 = MIN(N-1,j1+HESS_BLOCKSIZE);
-            ptrdiff_t ncols = j2-j1;
-            MatrixView<T> mYZt = mYZt_full.subMatrix(0,N-j1,0,ncols);
-            UpperTriMatrixView<T> Z = Z_full.subTriMatrix(0,ncols);
-
-            for(ptrdiff_t j=j1,jj=0;j<j2;++j,++jj,++Uj) { // jj = j-j1
-
-                // Update current column of A
-                //
-                // m' = (I - YZYt) (m - mYZt Yt)
-                // A(0:N,j)' = A(0:N,j) - mYZt(0:N,0:j) Y(j,0:j)t
-                A.col(j,j1+1,N) -= mYZt.Cols(0,j) * A.row(j,0,j).Conjugate();
-                //
-                // A(0:N,j)'' = A(0:N,j) - Y Z Yt A(0:N,j)'
-                // 
-                // Let Y = (L)     where L is unit-diagonal, lower-triangular,
-                //         (M)     and M is rectangular
-                //
-                LowerTriMatrixView<T> L = 
-                    LowerTriMatrixViewOf(A.subMatrix(j1+1,j+1,j1,j),UnitDiag);
-                MatrixView<T> M = A.subMatrix(j+1,N,j1,j);
-                // Use the last column of Z as temporary storage for Yt A(0:N,j)'
-                VectorView<T> YtAj = Z.col(jj,0,jj);
-                YtAj = L.adjoint() * A.col(j,j1+1,j+1);
-                YtAj += M.adjoint() * A.col(j,j+1,N);
-                YtAj = Z.subTriMatrix(0,jj) * YtAj;
-                A.col(j,j1+1,j+1) -= L * YtAj;
-                A.col(j,j+1,N) -= M * YtAj;
-
-                // Do the Householder reflection 
-                VectorView<T> u = A.col(j,j+1,N);
-                T bu = Householder_Reflect(u,det);
-#ifdef TMVFLDEBUG
-                TMVAssert(Uj >= Ubeta._first);
-                TMVAssert(Uj < Ubeta._last);
-#endif
-                *Uj = bu;
-
-                // Save the top of the u vector, which isn't actually part of u
-                T& Atemp = *u.cptr();
-                TMVAssert(IMAG(Atemp) == RealType(T)(0));
-                RealType(T) Aorig = REAL(Atemp);
-                Atemp = RealType(T)(1);
-
-                // Update Z
-                VectorView<T> Zj = Z.col(jj,0,jj);
-                Zj = -bu * M.adjoint() * u;
-                Zj = Z * Zj;
-                Z(jj,jj) = -bu;
-
-                // Update mYtZt:
-                //
-                // mYZt(0:N,j) = m(0:N,0:N) Y(0:N,0:j) Zt(0:j,j)
-                //             = m(0:N,j+1:N) Y(j+1:N,j) Zt(j,j)
-                //             = bu* m(0:N,j+1:N) u 
-                //
-                mYZt.col(jj) = CONJ(bu) * A.subMatrix(j1,N,j+1,N) * u;
-
-                // Restore Aorig, which is actually part of the Hessenberg matrix.
-                Atemp = Aorig;
+        const ptrdiff_t nbmax = TMV_MIN(ptrdiff_t(HESS_BLOCKSIZE),N-1);
+        Matrix<T,ColMajor> AY_full(N,nbmax);
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> Z_full(nbmax);
+        Vector<T> yrow(nbmax);
+
+        T det(0); // Ignore Householder det calculations
+        ptrdiff_t j1=0;
+        // Leave the last few columns for the non-blocked algorithm,
+        // since there is no trailing matrix left to update.
+        for(;j1+nbmax<N-1;) {
+            const ptrdiff_t j2 = j1+nbmax;
+            const ptrdiff_t nb = j2-j1;
+            MatrixView<T> AY = AY_full.colRange(0,nb);
+            UpperTriMatrixView<T> Z = Z_full.subTriMatrix(0,nb);
+
+            for(ptrdiff_t j=j1,jj=0;j<j2;++j,++jj) {
+                if (jj > 0) {
+                    // A(:,j) <- (A Q)(:,j) = A(:,j) - AY Z Y(j,:)t
+                    // Y(j,:) is the stored part of A(j,j1:j-1), except that
+                    // the last element is the unit diagonal of Y.
+                    VectorView<T> yr = yrow.subVector(0,jj);
+                    yr.subVector(0,jj-1) = A.row(j,j1,j-1).conjugate();
+                    yr(jj-1) = T(1);
+                    yr = Z.subTriMatrix(0,jj) * yr;
+                    A.col(j) -= AY.colRange(0,jj) * yr;
+
+                    // A(:,j) <- Qt A(:,j)
+                    BlockHouseholderLDiv(
+                        A.subMatrix(j1+1,N,j1,j),Z.subTriMatrix(0,jj),
+                        A.subMatrix(j1+1,N,j,j+1));
+                }
+
+                // Find the Householder matrix for this column.
+                T bu = HouseholderReflect(A.col(j,j+1,N),det);
+                Ubeta(j) = bu;
+                BlockHouseholderAugment(
+                    A.subMatrix(j1+1,N,j1,j+1),Z.subTriMatrix(0,jj+1),
+                    TMV_CONJ(bu));
+
+                // AY(:,jj) = A(:,j+1:N) u
+                // The first element of u is 1, which is temporarily
+                // stored in place of the subdiagonal element.
+                T Ajj = A(j+1,j);
+                A.ref(j+1,j) = T(1);
+                AY.col(jj) = A.colRange(j+1,N) * A.col(j,j+1,N);
+                A.ref(j+1,j) = Ajj;
             }
 
             // Update the rest of the matrix:
-            // A(j2,j2-1) needs to be temporarily changed to 1 for use in Y
-            T& Atemp = *(A.ptr() + j2*A.stepi() + (j2-1)*A.stepj());
-            TMVAssert(IMAG(Atemp) == RealType(T)(0));
-            RealType(T) Aorig = Atemp;
-            Atemp = RealType(T)(1);
-
-            // m' = (I-YZYt) (m - mYZt Y)
-            MatrixView<T> m = A.subMatrix(j1,N,j2,N);
-            ConstMatrixView<T> Y = A.subMatrix(j2+1,N,j1,j2);
-            m -= mYZt * Y.adjoint();
-            BlockHouseholder_LMult(Y,Z,m);
-
-            // Restore A(j2,j2-1)
-            Atemp = Aorig;
+            // A(:,j2:N) <- (A Q)(:,j2:N) = A(:,j2:N) - AY Z Y(j2:N,:)t
+            T Aj2 = A(j2,j2-1);
+            A.ref(j2,j2-1) = T(1);
+            Matrix<T,ColMajor> ZYt = Z * A.subMatrix(j2,N,j1,j2).adjoint();
+            A.ref(j2,j2-1) = Aj2;
+            A.colRange(j2,N) -= AY * ZYt;
+
+            // A(j1+1:N,j2:N) <- Qt A(j1+1:N,j2:N)
+            BlockHouseholderLDiv(
+                A.subMatrix(j1+1,N,j1,j2),Z,A.subMatrix(j1+1,N,j2,N));
+
             j1 = j2;
         }
-
-#ifdef XDEBUG
-        Matrix<T> U(N,N,T(0));
-        U.subMatrix(1,N,1,N) = A.subMatrix(1,N,0,N-1);
-        U.upperTri().setZero();
-        U(0,0) = T(1);
-        Vector<T> Ubeta2(N);
-        Ubeta2.subVector(1,N) = Ubeta;
-        Ubeta2(0) = T(0);
-        GetQFromQR(U.view(),Ubeta2);
-        Matrix<T> H = A;
-        if (N>2) LowerTriMatrixViewOf(H).offDiag(2).setZero();
-        Matrix<T> AA = U*H*U.adjoint();
-        if (Norm(A0-AA) > 0.001*Norm(A0)) {
-            cerr<<"NonBlock Hessenberg: A = "<<Type(A)<<"  "<<A0<<endl;
-            cerr<<"A = "<<A<<endl;
-            cerr<<"Ubeta = "<<Ubeta<<endl;
-            cerr<<"U = "<<U<<endl;
-            cerr<<"H = "<<H<<endl;
-            cerr<<"UHUt = "<<AA<<endl;
-            Matrix<T,ColMajor> A2 = A0;
-            Vector<T> Ub2(Ubeta.size());
-            NonBlockHessenberg(A2.view(),Ub2.view());
-            cerr<<"cf NonBlock: A -> "<<A2<<endl;
-            cerr<<"Ubeta = "<<Ub2<<endl;
-            abort();
+        if (j1 < N-1) {
+            // The last few columns:
+            T* Uj = Ubeta.ptr() + j1;
+            for(ptrdiff_t j=j1;j<N-1;++j,++Uj) {
+                *Uj = HouseholderReflect(A.col(j,j+1,N),det);
+                if (*Uj != T(0)) {
+                    HouseholderLMult(
+                        A.col(j,j+2,N),*Uj,A.subMatrix(j+1,N,j+1,N));
+                    HouseholderLMult(
+                        A.col(j,j+2,N),*Uj,A.subMatrix(0,N,j+1,N).adjoint());
+                }
+            }
         }
-#endif
     }
 
     template <class T> 
@@ -272,11 +212,9 @@ namespace tmv {
         TMVAssert(A.rowsize() > 0);
         TMVAssert(Ubeta.size() == A.rowsize()-1);
 
-#if 0
-        if (A.rowsize() > HESS_BLOCKSIZE)
-            BlockHessenberg(A,Ubeta,Vbeta,D,E,det);
+        if (A.rowsize() > 2*HESS_BLOCKSIZE)
+            BlockHessenberg(A,Ubeta);
         else
-#endif
             NonBlockHessenberg(A,Ubeta);
     }
 
@@ -284,9 +222,10 @@ namespace tmv {
     template <class T> 
     static inline void LapHessenberg(
         MatrixView<T> A, VectorView<T> Ubeta)
-    { NonLapHessenberg(A,Ubeta,Vbeta,D,E,det); }
+    { NonLapHessenberg(A,Ubeta); }
 #ifdef INST_DOUBLE
-    template <> void LapHessenberg(
+    template <> 
+    void LapHessenberg(
         MatrixView<double> A, VectorView<double> Ubeta)
     {
         TMVAssert(A.iscm());
@@ -301,19 +240,21 @@ namespace tmv {
         int Lap_info=0;
 #ifndef LAPNOWORK
         int lwork = n*LAP_BLOCKSIZE;
-        double* work = LAP_DWork(lwork);
+        AlignedArray<double> work(lwork);
+        VectorViewOf(work.get(),lwork).setZero();
 #endif
         LAPNAME(dgehrd) (
             LAPCM LAPV(n),LAPV(ilo),LAPV(ihi),
             LAPP(A.ptr()),LAPV(lda),LAPP(Ubeta.ptr())
-            LAPWK(work) LAPVWK(lwork) LAPINFO);
+            LAPWK(work.get()) LAPVWK(lwork) LAPINFO);
 #ifdef LAPNOWORK
         LAP_Results(Lap_info,"dgehrd");
 #else
-        LAP_Results(Lap_info,int(work[0]),m,n,lwork,"dgehrd");
+        LAP_Results(Lap_info,int(work[0]),n,n,lwork,"dgehrd");
 #endif
     }
-    template <> void LapHessenberg(
+    template <> 
+    void LapHessenberg(
         MatrixView<std::complex<double> > A, 
         VectorView<std::complex<double> > Ubeta)
     {
@@ -329,22 +270,24 @@ namespace tmv {
         int Lap_info=0;
 #ifndef LAPNOWORK
         int lwork = n*LAP_BLOCKSIZE;
-        std::complex<double>* work = LAP_ZWork(lwork);
+        AlignedArray<std::complex<double> > work(lwork);
+        VectorViewOf(work.get(),lwork).setZero();
 #endif
         LAPNAME(zgehrd) (
             LAPCM LAPV(n),LAPV(ilo),LAPV(ihi),
             LAPP(A.ptr()),LAPV(lda),LAPP(Ubeta.ptr())
-            LAPWK(work) LAPVWK(lwork) LAPINFO);
-        Ubeta.ConjugateSelf();
+            LAPWK(work.get()) LAPVWK(lwork) LAPINFO);
+        Ubeta.conjugateSelf();
 #ifdef LAPNOWORK
         LAP_Results(Lap_info,"zgehrd");
 #else
-        LAP_Results(Lap_info,int(REAL(work[0])),m,n,lwork,"zgehrd");
+        LAP_Results(Lap_info,int(TMV_REAL(work[0])),n,n,lwork,"zgehrd");
 #endif
     }
 #endif
 #ifdef INST_FLOAT
-    template <> void LapHessenberg(
+    template <> 
+    void LapHessenberg(
         MatrixView<float> A, VectorView<float> Ubeta)
     {
         TMVAssert(A.iscm());
@@ -359,25 +302,27 @@ namespace tmv {
         int Lap_info=0;
 #ifndef LAPNOWORK
         int lwork = n*LAP_BLOCKSIZE;
-        float* work = LAP_SWork(lwork);
+        AlignedArray<float> work(lwork);
+        VectorViewOf(work.get(),lwork).setZero();
 #endif
-        LAPNAME(sgebrd) (
+        LAPNAME(sgehrd) (
             LAPCM LAPV(n),LAPV(ilo),LAPV(ihi),
             LAPP(A.ptr()),LAPV(lda),LAPP(Ubeta.ptr())
-            LAPWK(work) LAPVWK(lwork) LAPINFO);
+            LAPWK(work.get()) LAPVWK(lwork) LAPINFO);
 #ifdef LAPNOWORK
         LAP_Results(Lap_info,"sgehrd");
 #else
-        LAP_Results(Lap_info,int(work[0]),m,n,lwork,"sgehrd");
+        LAP_Results(Lap_info,int(work[0]),n,n,lwork,"sgehrd");
 #endif
     }
-    template <> void LapHessenberg(
+    template <> 
+    void LapHessenberg(
         MatrixView<std::complex<float> > A, 
         VectorView<std::complex<float> > Ubeta) 
     {
         TMVAssert(A.iscm());
-        TMVAssert(A.colsize() >= A.rowsize());
-        TMVAssert(Ubeta.size() == A.rowsize());
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(Ubeta.size() == A.rowsize()-1);
         TMVAssert(A.ct()==NonConj);
 
         int n = A.rowsize();
@@ -387,25 +332,25 @@ namespace tmv {
         int Lap_info=0;
 #ifndef LAPNOWORK
         int lwork = n*LAP_BLOCKSIZE;
-        std::complex<float>* work = LAP_CWork(lwork);
+        AlignedArray<std::complex<float> > work(lwork);
+        VectorViewOf(work.get(),lwork).setZero();
 #endif
         LAPNAME(cgehrd) (
             LAPCM LAPV(n),LAPV(ilo),LAPV(ihi),
             LAPP(A.ptr()),LAPV(lda),LAPP(Ubeta.ptr())
-            LAPWK(work) LAPVWK(lwork) LAPINFO);
-        Ubeta.ConjugateSelf();
+            LAPWK(work.get()) LAPVWK(lwork) LAPINFO);
+        Ubeta.conjugateSelf();
 #ifdef LAPNOWORK
         LAP_Results(Lap_info,"cgehrd");
 #else
-        LAP_Results(Lap_info,int(REAL(work[0])),m,n,lwork,"cgehrd");
+        LAP_Results(Lap_info,int(TMV_REAL(work[0])),n,n,lwork,"cgehrd");
 #endif
     }
 #endif 
 #endif // LAP
 
     template <class T> 
-    static inline void Hessenberg(
-        MatrixView<T> A, VectorView<T> Ubeta)
+    void Hessenberg(MatrixView<T> A, VectorView<T> Ubeta)
     {
         TMVAssert(A.colsize() == A.rowsize());
         TMVAssert(Ubeta.size() == A.rowsize()-1);
@@ -413,7 +358,10 @@ namespace tmv {
         TMVAssert(A.ct()==NonConj);
         TMVAssert(Ubeta.step() == 1);
 
-        if (A.rowsize() > 0) {
+#ifdef XDEBUG
+        Matrix<T> A0(A);
+#endif
+        if (A.rowsize() > 1) {
 #ifdef LAP
             if (A.iscm()) 
                 LapHessenberg(A,Ubeta);
@@ -421,20 +369,55 @@ namespace tmv {
 #endif
                 NonLapHessenberg(A,Ubeta);
         }
+#ifdef XDEBUG
+        const ptrdiff_t N = A.rowsize();
+        Matrix<T> U(N,N);
+        GetQFromHessenberg(A,Ubeta,U.view());
+        Matrix<T> H = A;
+        if (N>2) H.lowerTri().offDiag(2).setZero();
+        Matrix<T> AA = U*H*U.adjoint();
+        cout<<"Hessenberg: Norm(A0-UHUt) = "<<Norm(A0-AA)<<endl;
+        if (!(Norm(A0-AA) <= 0.001*Norm(A0))) {
+            cerr<<"Hessenberg: A = "<<TMV_Text(A)<<"  "<<A0<<endl;
+            cerr<<"A = "<<A<<endl;
+            cerr<<"Ubeta = "<<Ubeta<<endl;
+            cerr<<"U = "<<U<<endl;
+            cerr<<"H = "<<H<<endl;
+            cerr<<"UHUt = "<<AA<<endl;
+            abort();
+        }
+#endif
     }
 
-    //
-    // Schur_From_Hessenberg: QR method
-    //
+    template <class T> 
+    void GetQFromHessenberg(
+        const GenMatrix<T>& A, const GenVector<T>& Ubeta, MatrixView<T> U)
+    {
+        // The Householder vectors are stored below the subdiagonal of A.
+        // U = [ 1 0  ]
+        //     [ 0 U1 ]
+        // where U1 is the Q matrix of the corresponding QR decomposition.
+        const ptrdiff_t N = A.rowsize();
+        TMVAssert(A.colsize() == A.rowsize());
+        TMVAssert(U.colsize() == N);
+        TMVAssert(U.rowsize() == N);
+        TMVAssert(Ubeta.size() == N-1);
 
-#ifdef INST_INT
-#undef INST_INT
-#endif
+        U.setZero();
+        U(0,0) = T(1);
+        if (N > 1) {
+            U.subMatrix(1,N,1,N).lowerTri().offDiag() = 
+                A.subMatrix(1,N,0,N-1).lowerTri().offDiag();
+            GetQFromQR(U.subMatrix(1,N,1,N),Ubeta);
+        }
+    }
+
+#undef RT
 
-#define InstFile "TMV_Eigen.inst"
+#define InstFile "TMV_Eigen_Hessenberg.inst"
 #include "TMV_Inst.h"
 #undef InstFile
 
-} // namespace mv
+} // namespace tmv
 
 
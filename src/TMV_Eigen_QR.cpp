@@ -0,0 +1,757 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+
+//#define XDEBUG
+
+// This file implements the QR algorithm to reduce an upper Hessenberg 
+// matrix to Schur form.
+//
+// For small matrices (or if multishift = false), we use the classic
+// Francis double-shift QR algorithm (e.g. Golub and van Loan, 7.5), 
+// where each sweep chases a single 3x3 bulge down the matrix.
+//
+// For larger matrices, we use the small-bulge multishift QR algorithm 
+// with aggressive early deflation of Braman, Byers & Mathias 
+// (2002, SIAM J. Matrix Anal. Appl., 23, 929 and 948), which is also 
+// what LAPACK's xHSEQR uses.  
+//
+// Multishift: Each sweep uses many shifts, two per bulge, and a chain of 
+// closely spaced bulges is chased down the matrix together.  
+// The reflections are applied to a window on the diagonal that 
+// contains the chain, and are accumulated into an orthogonal matrix U.
+// Then the rest of the rows and columns that intersect the window
+// are updated with U using matrix products, which is much faster than
+// applying the 3x3 reflectors one at a time, and is done in parallel 
+// with OpenMP.
+//
+// Aggressive early deflation: Before each sweep, a trailing window of
+// the active matrix is reduced to Schur form.  The similarity 
+// transformation turns the single subdiagonal element to the left of
+// the window into a "spike" along the column.  Eigenvalues at the 
+// bottom of the window whose spike elements are negligible may be
+// deflated, which usually finds many more converged eigenvalues than
+// the normal check of the subdiagonal elements.  The eigenvalues that 
+// can't be deflated are good shifts for the next sweep.
+//
+// Both algorithms work for real and complex matrices.  For real matrices,
+// the shifts come in complex conjugate pairs, so all the arithmetic is
+// real, and the result is the real Schur form, which has 2x2 blocks 
+// on the diagonal for each complex conjugate pair of eigenvalues.
+
+#include "TMV_Eigen.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_VectorArith.h"
+#include <vector>
+#include <limits>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef XDEBUG
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#endif
+
+namespace tmv {
+
+// Below this size, the double-shift algorithm is used.
+#ifndef EIGEN_MULTISHIFT_LIMIT
+#define EIGEN_MULTISHIFT_LIMIT 75
+#endif
+
+// If aggressive early deflation deflates more than this percentage of
+// the window, skip the sweep and do another deflation.
+#ifndef EIGEN_NIBBLE
+#define EIGEN_NIBBLE 14
+#endif
+
+#define RT TMV_RealType(T)
+
+    template <class T> 
+    static inline RT Abs1(const T& x)
+    { return TMV_ABS(TMV_REAL(x)) + TMV_ABS(TMV_IMAG(x)); }
+
+    //
+    // Householder reflectors
+    //
+    // These are a bit different than the ones in TMV_Householder.h.  
+    // P = I - tau v vt with tau real, so P is hermitian as well as unitary.
+    // This means that the similarity transformation is just P H P.
+    // Also, these are usually just 3x3, so it is worth doing them 
+    // with simple loops.
+    //
+
+    template <class T> 
+    static RT MakeReflector(T* x, const ptrdiff_t n, T& alpha)
+    {
+        // Find P such that P x = alpha e0.
+        // On output, x is the vector v (with v0 = 1).
+        RT scale(0);
+        for(ptrdiff_t i=0;i<n;++i) scale = TMV_MAX(scale,Abs1(x[i]));
+        if (scale == RT(0)) { alpha = T(0); x[0] = T(1); return RT(0); }
+        RT xnormsq(0);
+        for(ptrdiff_t i=1;i<n;++i) xnormsq += TMV_NORM(x[i]/scale);
+        if (xnormsq == RT(0)) { alpha = x[0]; x[0] = T(1); return RT(0); }
+        const T x0 = x[0]/scale;
+        const RT absx0 = TMV_ABS(x0);
+        const RT norm = TMV_SQRT(TMV_NORM(x0) + xnormsq);
+        const T phase = absx0 == RT(0) ? T(1) : x0/absx0;
+        // v0 = x0 - alpha = phase (|x0| + norm)
+        const T v0 = phase*(absx0+norm);
+        for(ptrdiff_t i=1;i<n;++i) x[i] = (x[i]/scale) / v0;
+        x[0] = T(1);
+        alpha = -phase*norm*scale;
+        return RT(2) / (RT(1) + xnormsq/TMV_NORM(v0));
+    }
+
+    template <class T> 
+    static void ReflectLeft(
+        T* H, const ptrdiff_t si, const ptrdiff_t sj,
+        const ptrdiff_t k, const ptrdiff_t n, const T* v, const RT tau, 
+        const ptrdiff_t c1, const ptrdiff_t c2)
+    {
+        // H(k:k+n,c1:c2) <- P H(k:k+n,c1:c2)
+        for(ptrdiff_t c=c1;c<c2;++c) {
+            T* Hc = H + k*si + c*sj;
+            T s = Hc[0];
+            for(ptrdiff_t i=1;i<n;++i) s += TMV_CONJ(v[i]) * Hc[i*si];
+            s *= tau;
+            Hc[0] -= s;
+            for(ptrdiff_t i=1;i<n;++i) Hc[i*si] -= v[i] * s;
+        }
+    }
+
+    template <class T> 
+    static void ReflectRight(
+        T* H, const ptrdiff_t si, const ptrdiff_t sj,
+        const ptrdiff_t k, const ptrdiff_t n, const T* v, const RT tau, 
+        const ptrdiff_t r1, const ptrdiff_t r2)
+    {
+        // H(r1:r2,k:k+n) <- H(r1:r2,k:k+n) P
+        for(ptrdiff_t r=r1;r<r2;++r) {
+            T* Hr = H + r*si + k*sj;
+            T s = Hr[0];
+            for(ptrdiff_t j=1;j<n;++j) s += Hr[j*sj] * v[j];
+            s *= tau;
+            Hr[0] -= s;
+            for(ptrdiff_t j=1;j<n;++j) Hr[j*sj] -= s * TMV_CONJ(v[j]);
+        }
+    }
+
+    //
+    // Updates of the parts of the matrix outside of a window
+    //
+
+    template <class T> 
+    static void DoWindowLMult(const GenMatrix<T>& U, MatrixView<T> B)
+    {
+        // B <- Ut B
+        Matrix<T,ColMajor> temp = U.adjoint() * B;
+        B = temp;
+    }
+
+    template <class T> 
+    static void WindowLMult(const GenMatrix<T>& U, MatrixView<T> B)
+    {
+        if (B.rowsize() == 0) return;
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            const ptrdiff_t N = B.rowsize();
+#pragma omp parallel
+            {
+                const ptrdiff_t nthreads = omp_get_num_threads();
+                const ptrdiff_t mythread = omp_get_thread_num();
+                const ptrdiff_t j1 = (mythread * N) / nthreads;
+                const ptrdiff_t j2 = ((mythread+1) * N) / nthreads;
+                if (j2 > j1) DoWindowLMult(U,B.colRange(j1,j2));
+            }
+        } else 
+#endif
+        {
+            DoWindowLMult(U,B);
+        }
+    }
+
+    template <class T> 
+    static void DoWindowRMult(const GenMatrix<T>& U, MatrixView<T> B)
+    {
+        // B <- B U
+        Matrix<T,ColMajor> temp = B * U;
+        B = temp;
+    }
+
+    template <class T> 
+    static void WindowRMult(const GenMatrix<T>& U, MatrixView<T> B)
+    {
+        if (B.colsize() == 0) return;
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            const ptrdiff_t M = B.colsize();
+#pragma omp parallel
+            {
+                const ptrdiff_t nthreads = omp_get_num_threads();
+                const ptrdiff_t mythread = omp_get_thread_num();
+                const ptrdiff_t i1 = (mythread * M) / nthreads;
+                const ptrdiff_t i2 = ((mythread+1) * M) / nthreads;
+                if (i2 > i1) DoWindowRMult(U,B.rowRange(i1,i2));
+            }
+        } else 
+#endif
+        {
+            DoWindowRMult(U,B);
+        }
+    }
+
+    template <class T> 
+    static void UpdateOffWindow(
+        MatrixView<T> H, MatrixView<T> Z, const GenMatrix<T>& U,
+        const ptrdiff_t w1, const ptrdiff_t w2, 
+        const ptrdiff_t istart, const ptrdiff_t iend)
+    {
+        // The window H(w1:w2,w1:w2) has been transformed to Ut H U.
+        // Update the rest of H(istart:iend,istart:iend) and Z to match.
+        if (w2 < iend) WindowLMult(U,H.subMatrix(w1,w2,w2,iend));
+        if (istart < w1) WindowRMult(U,H.subMatrix(istart,w1,w1,w2));
+        if (Z.cptr()) WindowRMult(U,Z.colRange(w1,w2));
+    }
+
+    //
+    // The bulge chasing step
+    //
+
+    template <class T> 
+    static void BulgeStep(
+        T* H, const ptrdiff_t si, const ptrdiff_t sj,
+        const ptrdiff_t k, const ptrdiff_t ilo, const ptrdiff_t ihi,
+        const T sum, const T prod, const ptrdiff_t rstart, 
+        const ptrdiff_t cend, T* Q, const ptrdiff_t qsi, 
+        const ptrdiff_t qsj, const ptrdiff_t qrows)
+    {
+        // Move the bulge from position k-1 to position k.
+        // If k == ilo, this introduces a new bulge from the shifts 
+        // s1, s2, given as sum = s1+s2, prod = s1*s2.
+        // The reflector is applied to columns k..cend from the left,
+        // and rows rstart..k+4 from the right.  
+        // It is also applied to Q from the right if Q != 0.
+        const ptrdiff_t nr = TMV_MIN(ptrdiff_t(3),ihi-k+1);
+        T v[3];
+        T alpha;
+        RT tau;
+        if (k == ilo) {
+            // The first column of (H-s1)(H-s2).
+            const T h00 = H[k*si+k*sj];
+            const T h10 = H[(k+1)*si+k*sj];
+            const T h01 = H[k*si+(k+1)*sj];
+            const T h11 = H[(k+1)*si+(k+1)*sj];
+            const T h21 = H[(k+2)*si+(k+1)*sj];
+            // Scale to avoid overflow.  (Doesn't change the reflector.)
+            RT s = Abs1(h00) + Abs1(h10) + TMV_SQRT(Abs1(prod));
+            if (s == RT(0)) s = RT(1);
+            const T h10s = h10/s;
+            v[0] = (h00/s)*h00 + h01*h10s - sum*(h00/s) + prod/s;
+            v[1] = h10s*(h00 + h11 - sum);
+            v[2] = h10s*h21;
+            tau = MakeReflector(v,nr,alpha);
+        } else {
+            T* Hk = H + k*si + (k-1)*sj;
+            for(ptrdiff_t i=0;i<nr;++i) v[i] = Hk[i*si];
+            tau = MakeReflector(v,nr,alpha);
+            Hk[0] = alpha;
+            for(ptrdiff_t i=1;i<nr;++i) Hk[i*si] = T(0);
+        }
+        if (tau == RT(0)) return;
+        ReflectLeft(H,si,sj,k,nr,v,tau,k,cend);
+        ReflectRight(H,si,sj,k,nr,v,tau,rstart,TMV_MIN(k+4,ihi+1));
+        if (Q) ReflectRight(Q,qsi,qsj,k,nr,v,tau,ptrdiff_t(0),qrows);
+    }
+
+    template <class T> 
+    static void MultiShiftSweep(
+        MatrixView<T> H, MatrixView<T> Z, 
+        const ptrdiff_t ilo, const ptrdiff_t ihi, 
+        const ptrdiff_t istart, const ptrdiff_t iend,
+        const std::vector<T>& sums, const std::vector<T>& prods, 
+        bool accumulate)
+    {
+        // Chase nb = sums.size() bulges from ilo to ihi.
+        // Bulge b is introduced at step 4b, so at step t it is at 
+        // position k = ilo + t - 4b.
+        const ptrdiff_t nb = sums.size();
+        TMVAssert(ihi-ilo >= 2);
+        TMVAssert(nb > 0);
+        const ptrdiff_t tend = (ihi-1-ilo) + 4*(nb-1);
+
+        if (!accumulate) {
+            T* Hp = H.ptr();
+            const ptrdiff_t si = H.stepi();
+            const ptrdiff_t sj = H.stepj();
+            T* Zp = Z.ptr();
+            const ptrdiff_t zsi = Z.cptr() ? Z.stepi() : 0;
+            const ptrdiff_t zsj = Z.cptr() ? Z.stepj() : 0;
+            const ptrdiff_t zn = Z.cptr() ? Z.colsize() : 0;
+            for(ptrdiff_t t=0;t<=tend;++t) {
+                for(ptrdiff_t b=0;b<nb;++b) {
+                    const ptrdiff_t k = ilo + t - 4*b;
+                    if (k < ilo || k > ihi-1) continue;
+                    BulgeStep(Hp,si,sj,k,ilo,ihi,sums[b],prods[b],
+                              istart,iend+1,Zp,zsi,zsj,zn);
+                }
+            }
+        } else {
+            // Chase the bulges nstep steps at a time in a window that
+            // contains them, accumulating the reflections in U.
+            const ptrdiff_t nstep = TMV_MAX(4*nb,ptrdiff_t(12));
+            const ptrdiff_t maxw = 4*(nb-1) + nstep + 4;
+            Matrix<T,ColMajor> Hw_full(maxw,maxw);
+            Matrix<T,ColMajor> U_full(maxw,maxw);
+            for(ptrdiff_t t1=0;t1<=tend;t1+=nstep) {
+                const ptrdiff_t t2 = TMV_MIN(t1+nstep,tend+1);
+                const ptrdiff_t kmin = TMV_MAX(ilo,ilo+t1-4*(nb-1));
+                const ptrdiff_t kmax = TMV_MIN(ihi-1,ilo+t2-1);
+                const ptrdiff_t wlo = kmin > ilo ? kmin-1 : ilo;
+                const ptrdiff_t whi = TMV_MIN(ihi,kmax+3);
+                const ptrdiff_t nw = whi-wlo+1;
+                TMVAssert(nw <= maxw);
+                MatrixView<T> Hw = Hw_full.subMatrix(0,nw,0,nw);
+                MatrixView<T> U = U_full.subMatrix(0,nw,0,nw);
+                Hw = H.subMatrix(wlo,whi+1,wlo,whi+1);
+                U.setToIdentity();
+                T* Hp = Hw.ptr();
+                const ptrdiff_t sj = Hw.stepj();
+                T* Up = U.ptr();
+                const ptrdiff_t usj = U.stepj();
+                for(ptrdiff_t t=t1;t<t2;++t) {
+                    for(ptrdiff_t b=0;b<nb;++b) {
+                        const ptrdiff_t k = ilo + t - 4*b;
+                        if (k < ilo || k > ihi-1) continue;
+                        BulgeStep(Hp,1,sj,k-wlo,ilo-wlo,ihi-wlo,
+                                  sums[b],prods[b],0,nw,Up,1,usj,nw);
+                    }
+                }
+                H.subMatrix(wlo,whi+1,wlo,whi+1) = Hw;
+                UpdateOffWindow(H,Z,U,wlo,whi+1,istart,iend+1);
+            }
+        }
+    }
+
+    //
+    // Small blocks and eigenvalues
+    //
+
+    template <class T> 
+    static void TwoByTwoEigenValues(
+        const T a, const T b, const T c, const T d,
+        std::complex<RT>& l1, std::complex<RT>& l2)
+    {
+        // The eigenvalues of [ a b ]
+        //                    [ c d ]
+        const std::complex<RT> p = std::complex<RT>((a-d)/RT(2));
+        const std::complex<RT> disc = p*p + std::complex<RT>(b*c);
+        std::complex<RT> sq = std::sqrt(disc);
+        if (std::real(std::conj(p)*sq) < RT(0)) sq = -sq;
+        const std::complex<RT> mid = std::complex<RT>((a+d)/RT(2));
+        l1 = mid + sq;
+        // l2 = (ad-bc)/l1 is more accurate if |l2| << |l1|.
+        const std::complex<RT> det = std::complex<RT>(a*d-b*c);
+        l2 = (l1 == std::complex<RT>(0)) ? mid - sq : det / l1;
+    }
+
+    template <class T> 
+    static void Standardize2x2(
+        MatrixView<T> H, MatrixView<T> Z, const ptrdiff_t k, 
+        const ptrdiff_t istart, const ptrdiff_t iend)
+    {
+        // Triangularize the 2x2 block H(k:k+2,k:k+2) with a rotation,
+        // unless H is real and the eigenvalues are a complex pair.
+        const T a = H(k,k);
+        const T b = H(k,k+1);
+        const T c = H(k+1,k);
+        const T d = H(k+1,k+1);
+        if (c == T(0)) return;
+
+        const T p = (a-d)/RT(2);
+        const T disc = p*p + b*c;
+        T sq;
+        if (isReal(T())) {
+            if (TMV_REAL(disc) < RT(0)) return;
+            sq = T(TMV_SQRT(TMV_REAL(disc)));
+        } else {
+            sq = TMV_SQRT(disc);
+        }
+        if (TMV_REAL(TMV_CONJ(p)*sq) < RT(0)) sq = -sq;
+        // The eigenvector for lambda = (a+d)/2 + sq is (lambda-d, c).
+        T x0 = p + sq;
+        T x1 = c;
+        const RT norm = TMV_SQRT(TMV_NORM(x0)+TMV_NORM(x1));
+        const T cs = x0/norm;
+        const T sn = x1/norm;
+        // G = [ cs -sn* ]
+        //     [ sn  cs* ]
+        // H <- Gt H G
+        const ptrdiff_t N = H.rowsize();
+        for(ptrdiff_t j=k;j<=iend && j<N;++j) {
+            const T h0 = H(k,j);
+            const T h1 = H(k+1,j);
+            H(k,j) = TMV_CONJ(cs)*h0 + TMV_CONJ(sn)*h1;
+            H(k+1,j) = -sn*h0 + cs*h1;
+        }
+        for(ptrdiff_t i=istart;i<=k+1;++i) {
+            const T h0 = H(i,k);
+            const T h1 = H(i,k+1);
+            H(i,k) = cs*h0 + sn*h1;
+            H(i,k+1) = -TMV_CONJ(sn)*h0 + TMV_CONJ(cs)*h1;
+        }
+        if (Z.cptr()) {
+            for(ptrdiff_t i=0;i<Z.colsize();++i) {
+                const T z0 = Z(i,k);
+                const T z1 = Z(i,k+1);
+                Z(i,k) = cs*z0 + sn*z1;
+                Z(i,k+1) = -TMV_CONJ(sn)*z0 + TMV_CONJ(cs)*z1;
+            }
+        }
+        H(k+1,k) = T(0);
+    }
+
+    template <class T> 
+    static bool SmallSubDiag(
+        const GenMatrix<T>& H, const ptrdiff_t k, 
+        const ptrdiff_t ilo, const ptrdiff_t ihi)
+    {
+        // Check if H(k,k-1) is negligible.  This is the conservative
+        // criterion of Ahues & Tisseur (1997, LAPACK Working Note 122).
+        const RT ulp = TMV_Epsilon<T>();
+        const RT smlnum = std::numeric_limits<RT>::min() * 
+            (RT(H.colsize())/ulp);
+        const RT hk = Abs1(H.cref(k,k-1));
+        if (hk <= smlnum) return true;
+        RT tst = Abs1(H.cref(k-1,k-1)) + Abs1(H.cref(k,k));
+        if (tst == RT(0)) {
+            if (k-2 >= ilo) tst += Abs1(H.cref(k-1,k-2));
+            if (k+1 <= ihi) tst += Abs1(H.cref(k+1,k));
+        }
+        if (hk > ulp*tst) return false;
+        const RT hkk = Abs1(H.cref(k-1,k));
+        const RT ab = TMV_MAX(hk,hkk);
+        const RT ba = TMV_MIN(hk,hkk);
+        const RT d1 = Abs1(H.cref(k,k));
+        const RT d2 = Abs1(H.cref(k-1,k-1)-H.cref(k,k));
+        const RT aa = TMV_MAX(d1,d2);
+        const RT bb = TMV_MIN(d1,d2);
+        const RT s = aa+ab;
+        return ba*(ab/s) <= TMV_MAX(smlnum,ulp*(bb*(aa/s)));
+    }
+
+    template <class T> 
+    static void FrancisShifts(
+        const GenMatrix<T>& H, const ptrdiff_t ilo, const ptrdiff_t ihi, 
+        bool exceptional, std::vector<T>& sums, std::vector<T>& prods)
+    {
+        // The double shift of the trailing 2x2 block.  
+        // Occasionally, an "exceptional" shift is used instead to break
+        // out of cycles that would otherwise not converge.
+        // (These are the same values that LAPACK uses.)
+        T sum, prod;
+        if (exceptional) {
+            RT s = Abs1(H.cref(ihi,ihi-1));
+            if (ihi-2 >= ilo) s += Abs1(H.cref(ihi-1,ihi-2));
+            const T h11 = RT(0.75)*s + H.cref(ihi,ihi);
+            const RT h12 = RT(-0.4375)*s;
+            sum = RT(2)*h11;
+            prod = h11*h11 - h12*s;
+        } else {
+            const T a = H.cref(ihi-1,ihi-1);
+            const T b = H.cref(ihi-1,ihi);
+            const T c = H.cref(ihi,ihi-1);
+            const T d = H.cref(ihi,ihi);
+            sum = a+d;
+            prod = a*d-b*c;
+        }
+        sums.push_back(sum);
+        prods.push_back(prod);
+    }
+
+    //
+    // Aggressive early deflation
+    //
+
+    template <class T> 
+    static ptrdiff_t AggressiveDeflation(
+        MatrixView<T> H, MatrixView<T> Z, 
+        const ptrdiff_t ilo, const ptrdiff_t ihi, const ptrdiff_t nw,
+        const ptrdiff_t istart, const ptrdiff_t iend, 
+        const ptrdiff_t maxpairs, std::vector<T>& sums, std::vector<T>& prods)
+    {
+        // Returns the number of deflated eigenvalues.
+        // The undeflated eigenvalues in the window are returned as shift
+        // pairs in sums, prods, starting from the bottom of the window.
+        const ptrdiff_t kwtop = ihi-nw+1;
+        TMVAssert(kwtop >= ilo);
+        const RT ulp = TMV_Epsilon<T>();
+        const RT smlnum = std::numeric_limits<RT>::min() * 
+            (RT(H.colsize())/ulp);
+        const T s = kwtop > ilo ? H(kwtop,kwtop-1) : T(0);
+
+        // Find the Schur form of the window: Tw = Zwt Hw Zw
+        Matrix<T,ColMajor> Tw = H.subMatrix(kwtop,ihi+1,kwtop,ihi+1);
+        Matrix<T,ColMajor> Zw(nw,nw);
+        Zw.setToIdentity();
+        SchurFromHessenberg(Tw.view(),Zw.view(),true,true);
+
+        // The spike is s Zw.row(0)t
+        Vector<T> spike = s * Zw.row(0).conjugate();
+
+        // Check for converged eigenvalues at the bottom of the window.
+        ptrdiff_t nu = nw;
+        while (nu > 0) {
+            const ptrdiff_t j = nu-1;
+            if (isReal(T()) && j > 0 && Tw(j,j-1) != T(0)) {
+                RT foo = Abs1(Tw(j,j)) + 
+                    TMV_SQRT(Abs1(Tw(j,j-1))) * TMV_SQRT(Abs1(Tw(j-1,j)));
+                if (foo == RT(0)) foo = Abs1(s);
+                const RT sp = TMV_MAX(Abs1(spike(j)),Abs1(spike(j-1)));
+                if (sp > TMV_MAX(smlnum,ulp*foo)) break;
+                nu -= 2;
+            } else {
+                RT foo = Abs1(Tw(j,j));
+                if (foo == RT(0)) foo = Abs1(s);
+                if (Abs1(spike(j)) > TMV_MAX(smlnum,ulp*foo)) break;
+                nu -= 1;
+            }
+        }
+        const ptrdiff_t ndefl = nw-nu;
+
+        // The undeflated eigenvalues are the shifts for the next sweep.
+        // (Pair them up from the bottom.)
+        bool havesingle = false;
+        T single(0);
+        for(ptrdiff_t j=nu-1; j>=0 && ptrdiff_t(sums.size())<maxpairs; --j) {
+            if (isReal(T()) && j > 0 && Tw(j,j-1) != T(0)) {
+                sums.push_back(Tw(j-1,j-1)+Tw(j,j));
+                prods.push_back(Tw(j-1,j-1)*Tw(j,j)-Tw(j-1,j)*Tw(j,j-1));
+                --j;
+            } else if (havesingle) {
+                sums.push_back(single+Tw(j,j));
+                prods.push_back(single*Tw(j,j));
+                havesingle = false;
+            } else {
+                single = Tw(j,j);
+                havesingle = true;
+            }
+        }
+
+        if (ndefl == 0) return 0;
+
+#ifdef XDEBUG
+        cout<<"AED: ilo,ihi = "<<ilo<<','<<ihi<<", nw = "<<nw<<
+            ", ndefl = "<<ndefl<<endl;
+#endif
+
+        // Return the undeflated part to Hessenberg form.
+        spike.subVector(nu,nw).setZero();
+        T* Tp = Tw.ptr();
+        const ptrdiff_t tsj = Tw.stepj();
+        T* Zp = Zw.ptr();
+        const ptrdiff_t zsj = Zw.stepj();
+        if (nu > 1) {
+            // First make the spike a multiple of e0.
+            Vector<T> v = spike.subVector(0,nu);
+            T alpha;
+            RT tau = MakeReflector(v.ptr(),nu,alpha);
+            spike.subVector(0,nu).setZero();
+            spike(0) = alpha;
+            if (tau != RT(0)) {
+                ReflectLeft(Tp,1,tsj,0,nu,v.cptr(),tau,0,nw);
+                ReflectRight(Tp,1,tsj,0,nu,v.cptr(),tau,0,nu);
+                ReflectRight(Zp,1,zsj,0,nu,v.cptr(),tau,0,nw);
+            }
+            // Then reduce Tw(0:nu,0:nu) to Hessenberg form.
+            for(ptrdiff_t j=0;j<nu-2;++j) {
+                const ptrdiff_t nr = nu-j-1;
+                VectorView<T> x = Tw.col(j,j+1,nu);
+                v.subVector(0,nr) = x;
+                tau = MakeReflector(v.ptr(),nr,alpha);
+                x.setZero();
+                x(0) = alpha;
+                if (tau != RT(0)) {
+                    ReflectLeft(Tp,1,tsj,j+1,nr,v.cptr(),tau,j+1,nw);
+                    ReflectRight(Tp,1,tsj,j+1,nr,v.cptr(),tau,0,nu);
+                    ReflectRight(Zp,1,zsj,j+1,nr,v.cptr(),tau,0,nw);
+                }
+            }
+        }
+
+        // Copy the window back into H, and update the rest of H and Z.
+        if (kwtop > ilo) H.col(kwtop-1,kwtop,ihi+1) = spike;
+        H.subMatrix(kwtop,ihi+1,kwtop,ihi+1) = Tw;
+        UpdateOffWindow(H,Z,Zw,kwtop,ihi+1,istart,iend+1);
+
+        return ndefl;
+    }
+
+    static ptrdiff_t EigenNumShifts(ptrdiff_t nh)
+    {
+        // The number of shifts to use for each sweep.
+        // These are the values recommended by Braman, Byers & Mathias
+        // and used by LAPACK.
+        if (nh < 150) return 10;
+        else if (nh < 590) {
+            ptrdiff_t lg = 0;
+            while ((ptrdiff_t(1) << (lg+1)) <= nh) ++lg;
+            ptrdiff_t ns = nh/lg;
+            return TMV_MAX(ptrdiff_t(10),ns - ns%2);
+        }
+        else if (nh < 3000) return 64;
+        else if (nh < 6000) return 128;
+        else return 256;
+    }
+
+    template <class T> 
+    void SchurFromHessenberg(
+        MatrixView<T> H, MatrixView<T> Z, bool wantT, bool multishift)
+    {
+        const ptrdiff_t N = H.colsize();
+        TMVAssert(H.rowsize() == N);
+        TMVAssert(!Z.cptr() || Z.rowsize() == N);
+        TMVAssert(!Z.cptr() || wantT);
+        TMVAssert(H.ct() == NonConj);
+        TMVAssert(!Z.cptr() || Z.ct() == NonConj);
+        if (N == 0) return;
+
+#ifdef XDEBUG
+        cout<<"Start SchurFromHessenberg: N = "<<N<<endl;
+        Matrix<T> H0 = H;
+        Matrix<T> Z0(N,N);
+        if (Z.cptr()) Z0 = Z;
+#endif
+
+        const ptrdiff_t maxits = 30*TMV_MAX(ptrdiff_t(10),N);
+        ptrdiff_t its = 0;
+        ptrdiff_t totits = 0;
+        std::vector<T> sums, prods;
+        ptrdiff_t ihi = N-1;
+        while (ihi >= 0) {
+            // Find the active block ilo..ihi.
+            ptrdiff_t ilo = ihi;
+            for(;ilo>0;--ilo) {
+                if (SmallSubDiag(H,ilo,ilo,ihi)) {
+                    H(ilo,ilo-1) = T(0);
+                    break;
+                }
+            }
+            const ptrdiff_t istart = wantT ? 0 : ilo;
+            const ptrdiff_t iend = wantT ? N-1 : ihi;
+
+            if (ilo == ihi) {
+                --ihi; its = 0; continue;
+            }
+            if (ilo == ihi-1) {
+                Standardize2x2(H,Z,ilo,istart,iend);
+                ihi -= 2; its = 0; continue;
+            }
+            if (++totits > maxits) {
+                std::ostringstream s;
+                s << "SchurFromHessenberg did not converge after "<<maxits<<
+                    " iterations.";
+                TMV_Warning(s.str());
+                break;
+            }
+            ++its;
+
+            sums.clear();
+            prods.clear();
+            const ptrdiff_t nh = ihi-ilo+1;
+            if (multishift && nh >= EIGEN_MULTISHIFT_LIMIT) {
+                const ptrdiff_t ns = EigenNumShifts(nh);
+                const ptrdiff_t nw = TMV_MIN(nh <= 500 ? ns : 3*ns/2, nh);
+                const ptrdiff_t ndefl = AggressiveDeflation(
+                    H,Z,ilo,ihi,nw,istart,iend,ns/2,sums,prods);
+                if (ndefl > 0) { ihi -= ndefl; its = 0; }
+                if (100*ndefl > EIGEN_NIBBLE*nw || ihi-ilo < 2) continue;
+                if (its % 6 == 0 || sums.empty()) {
+                    sums.clear();
+                    prods.clear();
+                    FrancisShifts(H,ilo,ihi,its%6==0,sums,prods);
+                }
+                MultiShiftSweep(H,Z,ilo,ihi,istart,iend,sums,prods,true);
+            } else {
+                FrancisShifts(H,ilo,ihi,its%10==0,sums,prods);
+                MultiShiftSweep(H,Z,ilo,ihi,istart,iend,sums,prods,false);
+            }
+        }
+
+#ifdef XDEBUG
+        if (Z.cptr()) {
+            Matrix<T> H1 = H;
+            for(ptrdiff_t j=0;j<N;++j) for(ptrdiff_t i=j+2;i<N;++i) 
+                H1(i,j) = T(0);
+            Matrix<T> A0 = Z0 * H0 * Z0.adjoint();
+            Matrix<T> A1 = Z * H1 * Z.adjoint();
+            cout<<"SchurFromHessenberg: Norm(A0-A1) = "<<Norm(A0-A1)<<endl;
+            if (!(Norm(A0-A1) <= 0.001*Norm(A0))) {
+                cerr<<"SchurFromHessenberg: H0 = "<<H0<<endl;
+                cerr<<"H = "<<H<<endl;
+                abort();
+            }
+        }
+#endif
+    }
+
+    template <class T> 
+    void SchurEigenValues(
+        const GenMatrix<T>& H, VectorView<std::complex<RT> > lambda)
+    {
+        const ptrdiff_t N = H.colsize();
+        TMVAssert(lambda.size() == N);
+        for(ptrdiff_t k=0;k<N;++k) {
+            if (isReal(T()) && k < N-1 && H.cref(k+1,k) != T(0)) {
+                std::complex<RT> l1, l2;
+                TwoByTwoEigenValues(
+                    H.cref(k,k),H.cref(k,k+1),H.cref(k+1,k),H.cref(k+1,k+1),
+                    l1,l2);
+                // Put the one with positive imaginary part first.
+                if (std::imag(l1) < RT(0)) std::swap(l1,l2);
+                lambda(k) = l1;
+                lambda(k+1) = l2;
+                ++k;
+            } else {
+                lambda(k) = H.cref(k,k);
+            }
+        }
+    }
+
+#undef RT
+
+#define InstFile "TMV_Eigen_QR.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
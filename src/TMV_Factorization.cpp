@@ -0,0 +1,770 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "tmv/TMV_Factorization.h"
+#include "tmv/TMV_LUD.h"
+#include "tmv/TMV_QRD.h"
+#include "tmv/TMV_QRPD.h"
+#include "tmv/TMV_SVD.h"
+#include "tmv/TMV_SymCHD.h"
+#include "tmv/TMV_SymLDLD.h"
+#include "TMV_LUDiv.h"
+#include "TMV_QRDiv.h"
+#include "TMV_SVDiv.h"
+#include "TMV_SymCHDiv.h"
+#include "TMV_SymLDLDiv.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_DiagMatrix.h"
+#include "tmv/TMV_SymMatrix.h"
+#include "tmv/TMV_Permutation.h"
+#include <cstring>
+#include <limits>
+#include <istream>
+#include <ostream>
+#include <iostream>
+
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// When a division has at least this many right hand sides per thread,
+// they are split up and solved in parallel.
+#define TMV_FACT_MINBLOCK 32
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    //
+    // The binary layout of a Factorization:
+    //
+    // The blob starts with a Factorization_Header, which is followed by
+    // up to five arrays, each starting on a 64 byte boundary:
+    //
+    // D: 2 T values: logdet and signdet
+    // F: The main factor matrix, stored in column major order.
+    //    LU: LUx.  QR, QRP: QRx.  SV: U.  CH, LDL: L in the lower triangle.
+    // V: QR, QRP: beta.  SV: Vt.  LDL: the off-diagonal of D.
+    // S: SV: the singular values (as RT).
+    // P: LU, QRP, LDL: the permutation.
+    //
+
+    static const char fact_magic[8] = { 'T','M','V','F','A','C','T','\0' };
+    static const int fact_version = 1;
+    static const int fact_endian = 0x01020304;
+
+    struct Factorization_Header
+    {
+        char magic[8];
+        int endian;
+        int version;
+        int sizeT;
+        int sizeP;
+        int iscomplex;
+        int dt;
+        int istrans;
+        int sym;          // LDL or CH
+        int herm;
+        ptrdiff_t M, N;   // The size of the original matrix
+        ptrdiff_t N1;     // The effective rank for QRP and SV
+        ptrdiff_t nF, nV, nS, nP;
+    };
+
+    static size_t FactorizationAlign(size_t n)
+    { return (n + 63) & ~size_t(63); }
+
+    static void FactorizationReadError(const std::string& s)
+    {
+#ifdef NOTHROW
+        std::cerr<<"Factorization Read Error: "<<s<<std::endl;
+        exit(1);
+#else
+        throw ReadError("Factorization: "+s);
+#endif
+    }
+
+    template <typename T>
+    struct Factorization<T>::Factorization_Impl
+    {
+        // Allocate new memory for the layout given in h.
+        Factorization_Impl(const Factorization_Header& h);
+
+        // Use the blob at buf directly.
+        Factorization_Impl(const char* buf);
+
+        void setPointers();
+        ptrdiff_t fsize1() const { return h.istrans ? h.N : h.M; }
+        ptrdiff_t fsize2() const { return h.istrans ? h.M : h.N; }
+
+        static Factorization_Impl* make(const GenMatrix<T>& A, DivType dt);
+        static Factorization_Impl* make(const GenSymMatrix<T>& A, DivType dt);
+
+        // The real work of division.  If m is null, x is divided in place.
+        void solve(bool left, const GenMatrix<T>* m, MatrixView<T> x) const;
+        void blockSolve(bool left, const GenMatrix<T>* m, MatrixView<T> x) const;
+
+        void incRef();
+        bool decRef();
+
+        Factorization_Header h;
+        size_t nbytes;
+        AlignedArray<double> mem;
+        const char* buf;
+
+        // The factors are only written during construction, and only
+        // when mem is owned by this object.
+        T* D;
+        T* F;
+        T* V;
+        RT* S;
+        ptrdiff_t* P;
+
+#if __cplusplus >= 201103L
+        std::atomic<ptrdiff_t> count;
+#else
+        ptrdiff_t count;
+#endif
+    };
+
+    template <typename T>
+    static size_t FactorizationLayout(
+        const Factorization_Header& h, size_t* off)
+    {
+        off[0] = FactorizationAlign(sizeof(Factorization_Header));
+        off[1] = FactorizationAlign(off[0] + 2*sizeof(T));
+        off[2] = FactorizationAlign(off[1] + h.nF*sizeof(T));
+        off[3] = FactorizationAlign(off[2] + h.nV*sizeof(T));
+        off[4] = FactorizationAlign(off[3] + h.nS*sizeof(RT));
+        return off[4] + h.nP*sizeof(ptrdiff_t);
+    }
+
+    template <typename T>
+    static void FactorizationInitHeader(
+        Factorization_Header& h, DivType dt, ptrdiff_t M, ptrdiff_t N,
+        bool istrans, bool sym, bool herm)
+    {
+        std::memset(&h,0,sizeof(h));
+        std::memcpy(h.magic,fact_magic,sizeof(fact_magic));
+        h.endian = fact_endian;
+        h.version = fact_version;
+        h.sizeT = sizeof(T);
+        h.sizeP = sizeof(ptrdiff_t);
+        h.iscomplex = isComplex(T());
+        h.dt = dt;
+        h.istrans = istrans;
+        h.sym = sym;
+        h.herm = herm;
+        h.M = M;
+        h.N = N;
+        h.N1 = istrans ? M : N;
+    }
+
+    template <typename T>
+    static void FactorizationCheckHeader(const Factorization_Header& h)
+    {
+        if (std::memcmp(h.magic,fact_magic,sizeof(fact_magic)) != 0)
+            FactorizationReadError("not a Factorization blob");
+        if (h.endian != fact_endian)
+            FactorizationReadError("wrong byte order");
+        if (h.version != fact_version)
+            FactorizationReadError("unknown version");
+        if (h.sizeT != int(sizeof(T)) || h.iscomplex != int(isComplex(T())))
+            FactorizationReadError("wrong value type");
+        if (h.sizeP != int(sizeof(ptrdiff_t)))
+            FactorizationReadError("wrong size of ptrdiff_t");
+        if (h.dt != LU && h.dt != CH && h.dt != QR && h.dt != QRP &&
+            h.dt != SV)
+            FactorizationReadError("unknown DivType");
+        if (h.istrans != 0 && h.istrans != 1)
+            FactorizationReadError("invalid header");
+        if (h.sym != 0 && h.sym != 1)
+            FactorizationReadError("invalid header");
+        if (h.herm != 0 && h.herm != 1)
+            FactorizationReadError("invalid header");
+        if (h.M < 0 || h.N < 0)
+            FactorizationReadError("invalid sizes");
+
+        // Everything else in the header is determined by M, N and the
+        // DivType, so recompute it the same way make() does, rather than
+        // trusting sizes that will be used to index the blob.
+        const DivType dt = DivType(h.dt);
+        bool istrans, lowrank;
+        if (h.sym) {
+            if (h.M != h.N || (dt != LU && dt != CH))
+                FactorizationReadError("invalid header");
+            if (dt == CH && isComplex(T()) && !h.herm)
+                FactorizationReadError("invalid header");
+            istrans = false;
+            lowrank = false;
+        } else {
+            if (h.herm || dt == CH || (dt == LU && h.M != h.N))
+                FactorizationReadError("invalid header");
+            istrans = dt != LU && h.M < h.N;
+            lowrank = dt == QRP || dt == SV;
+        }
+        if (bool(h.istrans) != istrans)
+            FactorizationReadError("invalid header");
+        const ptrdiff_t m = istrans ? h.N : h.M;
+        const ptrdiff_t n = istrans ? h.M : h.N;
+        // Leave room for the other sections so the byte count of the
+        // whole layout cannot overflow.  (n <= m, so this covers n*n too.)
+        const ptrdiff_t maxF =
+            std::numeric_limits<ptrdiff_t>::max() / ptrdiff_t(4*sizeof(T));
+        if (n > 0 && m > maxF / n)
+            FactorizationReadError("invalid sizes");
+
+        ptrdiff_t nF = m*n, nV, nS, nP;
+        if (h.sym) {
+            nV = (dt == LU && n > 0) ? n-1 : 0;
+            nS = 0;
+            nP = dt == LU ? n : 0;
+        } else {
+            nV = (dt == QR || dt == QRP) ? n : dt == SV ? n*n : 0;
+            nS = dt == SV ? n : 0;
+            nP = (dt == LU || dt == QRP) ? n : 0;
+        }
+        if (h.nF != nF || h.nV != nV || h.nS != nS || h.nP != nP)
+            FactorizationReadError("invalid sizes");
+        if (lowrank ? (h.N1 < 0 || h.N1 > n) : h.N1 != n)
+            FactorizationReadError("invalid rank");
+    }
+
+    template <typename T>
+    Factorization<T>::Factorization_Impl::Factorization_Impl(
+        const Factorization_Header& _h) :
+        h(_h), nbytes(0), buf(0), count(1)
+    {
+        size_t off[5];
+        nbytes = FactorizationLayout<T>(h,off);
+        const ptrdiff_t ndouble = (nbytes + sizeof(double)-1)/sizeof(double);
+        mem.resize(ndouble);
+        std::memset(mem.get(),0,ndouble*sizeof(double));
+        buf = reinterpret_cast<const char*>(mem.get());
+        std::memcpy(const_cast<char*>(buf),&h,sizeof(h));
+        setPointers();
+    }
+
+    template <typename T>
+    Factorization<T>::Factorization_Impl::Factorization_Impl(
+        const char* _buf) :
+        nbytes(0), buf(_buf), count(1)
+    {
+        std::memcpy(&h,buf,sizeof(h));
+        size_t off[5];
+        nbytes = FactorizationLayout<T>(h,off);
+        setPointers();
+    }
+
+    template <typename T>
+    void Factorization<T>::Factorization_Impl::setPointers()
+    {
+        size_t off[5];
+        FactorizationLayout<T>(h,off);
+        char* b = const_cast<char*>(buf);
+        D = reinterpret_cast<T*>(b + off[0]);
+        F = reinterpret_cast<T*>(b + off[1]);
+        V = reinterpret_cast<T*>(b + off[2]);
+        S = reinterpret_cast<RT*>(b + off[3]);
+        P = reinterpret_cast<ptrdiff_t*>(b + off[4]);
+    }
+
+    template <typename T>
+    void Factorization<T>::Factorization_Impl::incRef()
+    {
+#if __cplusplus >= 201103L
+        count.fetch_add(1,std::memory_order_relaxed);
+#else
+#ifdef _OPENMP
+#pragma omp critical (tmv_factorization_count)
+#endif
+        ++count;
+#endif
+    }
+
+    template <typename T>
+    bool Factorization<T>::Factorization_Impl::decRef()
+    {
+#if __cplusplus >= 201103L
+        return count.fetch_sub(1,std::memory_order_acq_rel) == 1;
+#else
+        ptrdiff_t c;
+#ifdef _OPENMP
+#pragma omp critical (tmv_factorization_count)
+#endif
+        c = --count;
+        return c == 0;
+#endif
+    }
+
+    //
+    // Decomposition
+    //
+
+    template <typename T>
+    typename Factorization<T>::Factorization_Impl*
+    Factorization<T>::Factorization_Impl::make(
+        const GenMatrix<T>& A, DivType dt)
+    {
+        TMVAssert(dt == LU || dt == QR || dt == QRP || dt == SV);
+        TMVAssert(dt != LU || A.isSquare());
+
+        // Like the Divider classes, decompose the transpose of A if it
+        // has more columns than rows.
+        const bool istrans = dt != LU && A.colsize() < A.rowsize();
+        const ptrdiff_t m = istrans ? A.rowsize() : A.colsize();
+        const ptrdiff_t n = istrans ? A.colsize() : A.rowsize();
+
+        Factorization_Header h;
+        FactorizationInitHeader<T>(
+            h,dt,A.colsize(),A.rowsize(),istrans,false,false);
+        h.nF = m*n;
+        h.nV = (dt == QR || dt == QRP) ? n : dt == SV ? n*n : 0;
+        h.nS = dt == SV ? n : 0;
+        h.nP = (dt == LU || dt == QRP) ? n : 0;
+
+        auto_ptr<Factorization_Impl> p(new Factorization_Impl(h));
+        MatrixView<T> F = MatrixViewOf(p->F,m,n,ColMajor);
+        if (istrans) F = A.transpose();
+        else F = A;
+
+        RT logdet(0);
+        T signdet(1);
+        T s;
+        switch (dt) {
+          case LU :
+               LU_Decompose(F,p->P);
+               logdet = DiagMatrixViewOf(F.diag()).logDet(&s);
+               signdet = RT(Permutation(n,p->P,true).det()) * s;
+               break;
+          case QR :
+               QR_Decompose(F,VectorViewOf(p->V,n),signdet);
+               logdet = DiagMatrixViewOf(F.diag()).logDet(&s);
+               signdet *= s;
+               break;
+          case QRP :
+               QRP_Decompose(
+                   F,VectorViewOf(p->V,n),p->P,signdet,QRP_IsStrict());
+               logdet = DiagMatrixViewOf(F.diag()).logDet(&s);
+               signdet *= s;
+               // Exclude any exactly zero diagonal elements from
+               // the division, as QRPDiv does.
+               while (p->h.N1 > 0 && F(p->h.N1-1,p->h.N1-1) == T(0))
+                   --p->h.N1;
+               break;
+          case SV :
+               {
+                   SV_Decompose<T>(
+                       F,DiagMatrixViewOf(p->S,n),
+                       MatrixViewOf(p->V,n,n,ColMajor),
+                       logdet,signdet,true);
+                   // Use the same threshold as SVDiv.
+                   const RT thresh = n > 0 ? p->S[0]*TMV_Epsilon<T>() : RT(0);
+                   while (p->h.N1 > 0 && p->S[p->h.N1-1] <= thresh)
+                       --p->h.N1;
+               }
+               break;
+          default :
+               TMVAssert(TMV_FALSE);
+        }
+        p->D[0] = logdet;
+        p->D[1] = signdet;
+        std::memcpy(const_cast<char*>(p->buf),&p->h,sizeof(p->h));
+        return p.release();
+    }
+
+    template <typename T>
+    typename Factorization<T>::Factorization_Impl*
+    Factorization<T>::Factorization_Impl::make(
+        const GenSymMatrix<T>& A, DivType dt)
+    {
+        TMVAssert(dt == LU || dt == CH || dt == SV);
+
+        // There is no need for a separate symmetric SV layout, since
+        // the general one works just as well for division.
+        if (dt == SV) return make(Matrix<T,ColMajor>(A),dt);
+
+        TMVAssert(dt != CH || isReal(T()) || A.isherm());
+        const ptrdiff_t n = A.size();
+        const bool herm = isReal(T()) || A.isherm();
+
+        Factorization_Header h;
+        FactorizationInitHeader<T>(h,dt,n,n,false,true,herm);
+        h.nF = n*n;
+        h.nV = (dt == LU && n > 0) ? n-1 : 0;
+        h.nP = dt == LU ? n : 0;
+
+        auto_ptr<Factorization_Impl> p(new Factorization_Impl(h));
+        SymMatrixView<T> L = herm ?
+            HermMatrixViewOf(p->F,n,Lower,ColMajor) :
+            SymMatrixViewOf(p->F,n,Lower,ColMajor);
+        L = A;
+
+        RT logdet(0);
+        T signdet(1);
+        T s;
+        if (dt == CH) {
+            CH_Decompose(L);
+            logdet = RT(2) * DiagMatrixViewOf(L.diag()).logDet(&s);
+            if (s == T(0)) signdet = T(0);
+        } else if (n > 0) {
+            LDL_Decompose(L,VectorViewOf(p->V,n-1),p->P,logdet,signdet);
+        }
+        p->D[0] = logdet;
+        p->D[1] = signdet;
+        return p.release();
+    }
+
+    //
+    // Division
+    //
+
+    template <typename T>
+    void Factorization<T>::Factorization_Impl::solve(
+        bool left, const GenMatrix<T>* m, MatrixView<T> x) const
+    {
+        // For square matrices, all the methods can divide in place.
+        if (m && h.M == h.N) { x = *m; m = 0; }
+
+        const DivType dt = DivType(h.dt);
+        const ptrdiff_t m1 = fsize1();
+        const ptrdiff_t n1 = fsize2();
+        if (dt == LU && h.sym) {
+            ConstSymMatrixView<T> LLx = h.herm ?
+                HermMatrixViewOf(F,n1,Lower,ColMajor) :
+                SymMatrixViewOf(F,n1,Lower,ColMajor);
+            ConstVectorView<T> xD = VectorViewOf(V,h.nV);
+            if (n1 == 0) return;
+            if (left) LDL_LDivEq(LLx,xD,P,x);
+            else LDL_RDivEq(LLx,xD,P,x);
+        } else if (dt == LU) {
+            ConstMatrixView<T> LUx = MatrixViewOf(F,n1,n1,ColMajor);
+            if (left) LU_LDivEq(LUx,P,x);
+            else LU_RDivEq(LUx,P,x);
+        } else if (dt == CH) {
+            ConstSymMatrixView<T> LLx = HermMatrixViewOf(F,n1,Lower,ColMajor);
+            if (left) CH_LDivEq(LLx,x);
+            else CH_RDivEq(LLx,x);
+        } else if (dt == QR || dt == QRP) {
+            ConstMatrixView<T> QRx = MatrixViewOf(F,m1,n1,ColMajor);
+            ConstVectorView<T> beta = VectorViewOf(V,n1);
+            const ptrdiff_t* QP = dt == QRP ? P : 0;
+            if (!m) {
+                if (left) QR_LDivEq(QRx,beta,QP,x,h.N1);
+                else QR_RDivEq(QRx,beta,QP,x,h.N1);
+            } else if (h.istrans) {
+                // A = QRx^T, so left and right division switch places.
+                if (left) QR_RDiv(QRx,beta,QP,m->transpose(),
+                                  x.transpose(),h.N1);
+                else QR_LDiv(QRx,beta,QP,m->transpose(),x.transpose(),h.N1);
+            } else {
+                if (left) QR_LDiv(QRx,beta,QP,*m,x,h.N1);
+                else QR_RDiv(QRx,beta,QP,*m,x,h.N1);
+            }
+        } else {
+            TMVAssert(dt == SV);
+            ConstMatrixView<T> U = MatrixViewOf(F,m1,n1,ColMajor);
+            ConstDiagMatrixView<RT> SS = DiagMatrixViewOf(S,n1);
+            ConstMatrixView<T> Vt = MatrixViewOf(V,n1,n1,ColMajor);
+            if (!m) {
+                if (left) SV_LDiv(U,SS,Vt,h.N1,x,x);
+                else SV_RDiv(U,SS,Vt,h.N1,x,x);
+            } else if (h.istrans) {
+                if (left) SV_RDiv(U,SS,Vt,h.N1,m->transpose(),x.transpose());
+                else SV_LDiv(U,SS,Vt,h.N1,m->transpose(),x.transpose());
+            } else {
+                if (left) SV_LDiv(U,SS,Vt,h.N1,*m,x);
+                else SV_RDiv(U,SS,Vt,h.N1,*m,x);
+            }
+        }
+    }
+
+    template <typename T>
+    void Factorization<T>::Factorization_Impl::blockSolve(
+        bool left, const GenMatrix<T>* m, MatrixView<T> x) const
+    {
+        // Each column of x (or row for right division) is an independent
+        // right hand side, so large batches can be split up among threads.
+        // The factors are never written, so sharing them is safe.
+#ifdef _OPENMP
+        const ptrdiff_t nrhs = left ? x.rowsize() : x.colsize();
+        const ptrdiff_t nb = TMV_MIN(
+            ptrdiff_t(omp_get_max_threads()), nrhs / TMV_FACT_MINBLOCK);
+        if (nb > 1 && !omp_in_parallel()) {
+#pragma omp parallel for schedule(static)
+            for(ptrdiff_t k=0; k<nb; ++k) {
+                const ptrdiff_t j1 = k*nrhs/nb;
+                const ptrdiff_t j2 = (k+1)*nrhs/nb;
+                if (left) {
+                    if (m) {
+                        ConstMatrixView<T> mk = m->colRange(j1,j2);
+                        solve(true,&mk,x.colRange(j1,j2));
+                    } else {
+                        solve(true,0,x.colRange(j1,j2));
+                    }
+                } else {
+                    if (m) {
+                        ConstMatrixView<T> mk = m->rowRange(j1,j2);
+                        solve(false,&mk,x.rowRange(j1,j2));
+                    } else {
+                        solve(false,0,x.rowRange(j1,j2));
+                    }
+                }
+            }
+            return;
+        }
+#endif
+        solve(left,m,x);
+    }
+
+    //
+    // Constructors
+    //
+
+    template <typename T>
+    Factorization<T>::Factorization() : pimpl(0) {}
+
+    template <typename T>
+    Factorization<T>::Factorization(const GenMatrix<T>& A, DivType dt) :
+        pimpl(Factorization_Impl::make(A,dt)) {}
+
+    template <typename T>
+    Factorization<T>::Factorization(const GenSymMatrix<T>& A, DivType dt) :
+        pimpl(Factorization_Impl::make(A,dt)) {}
+
+    template <typename T>
+    Factorization<T>::Factorization(const Factorization<T>& rhs) :
+        pimpl(rhs.pimpl)
+    { if (pimpl) pimpl->incRef(); }
+
+    template <typename T>
+    Factorization<T>& Factorization<T>::operator=(
+        const Factorization<T>& rhs)
+    {
+        if (rhs.pimpl) rhs.pimpl->incRef();
+        if (pimpl && pimpl->decRef()) delete pimpl;
+        pimpl = rhs.pimpl;
+        return *this;
+    }
+
+#if __cplusplus >= 201103L
+    template <typename T>
+    Factorization<T>::Factorization(Factorization<T>&& rhs) :
+        pimpl(rhs.pimpl)
+    { rhs.pimpl = 0; }
+
+    template <typename T>
+    Factorization<T>& Factorization<T>::operator=(Factorization<T>&& rhs)
+    {
+        if (this != &rhs) {
+            if (pimpl && pimpl->decRef()) delete pimpl;
+            pimpl = rhs.pimpl;
+            rhs.pimpl = 0;
+        }
+        return *this;
+    }
+#endif
+
+    template <typename T>
+    Factorization<T>::~Factorization()
+    { if (pimpl && pimpl->decRef()) delete pimpl; }
+
+    //
+    // Access
+    //
+
+    template <typename T>
+    DivType Factorization<T>::getDivType() const
+    { return pimpl ? DivType(pimpl->h.dt) : XX; }
+
+    template <typename T>
+    bool Factorization<T>::isSym() const
+    { return pimpl && pimpl->h.sym; }
+
+    template <typename T>
+    ptrdiff_t Factorization<T>::colsize() const
+    { return pimpl ? pimpl->h.M : 0; }
+
+    template <typename T>
+    ptrdiff_t Factorization<T>::rowsize() const
+    { return pimpl ? pimpl->h.N : 0; }
+
+    template <typename T>
+    bool Factorization<T>::isSingular() const
+    {
+        TMVAssert(pimpl);
+        if (pimpl->h.dt == QRP || pimpl->h.dt == SV)
+            return pimpl->h.N1 < TMV_MIN(pimpl->h.M,pimpl->h.N);
+        else
+            return pimpl->D[1] == T(0);
+    }
+
+    template <typename T>
+    T Factorization<T>::det() const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(pimpl->h.M == pimpl->h.N);
+        const T signdet = pimpl->D[1];
+        if (signdet == T(0)) return T(0);
+        else return signdet * TMV_EXP(TMV_REAL(pimpl->D[0]));
+    }
+
+    template <typename T>
+    RT Factorization<T>::logDet(T* sign) const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(pimpl->h.M == pimpl->h.N);
+        if (sign) *sign = pimpl->D[1];
+        return TMV_REAL(pimpl->D[0]);
+    }
+
+    //
+    // Division
+    //
+
+    template <typename T>
+    void Factorization<T>::LDivEq(MatrixView<T> m) const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(colsize() == rowsize());
+        TMVAssert(m.colsize() == colsize());
+        pimpl->blockSolve(true,0,m);
+    }
+
+    template <typename T>
+    void Factorization<T>::RDivEq(MatrixView<T> m) const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(colsize() == rowsize());
+        TMVAssert(m.rowsize() == rowsize());
+        pimpl->blockSolve(false,0,m);
+    }
+
+    template <typename T>
+    void Factorization<T>::LDiv(const GenMatrix<T>& m, MatrixView<T> x) const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(m.colsize() == colsize());
+        TMVAssert(x.colsize() == rowsize());
+        TMVAssert(m.rowsize() == x.rowsize());
+        pimpl->blockSolve(true,&m,x);
+    }
+
+    template <typename T>
+    void Factorization<T>::RDiv(const GenMatrix<T>& m, MatrixView<T> x) const
+    {
+        TMVAssert(pimpl);
+        TMVAssert(m.rowsize() == rowsize());
+        TMVAssert(x.rowsize() == colsize());
+        TMVAssert(m.colsize() == x.colsize());
+        pimpl->blockSolve(false,&m,x);
+    }
+
+    template <typename T>
+    void Factorization<T>::LDivEq(VectorView<T> v) const
+    { LDivEq(ColVectorViewOf(v)); }
+
+    template <typename T>
+    void Factorization<T>::RDivEq(VectorView<T> v) const
+    { RDivEq(RowVectorViewOf(v)); }
+
+    template <typename T>
+    void Factorization<T>::LDiv(const GenVector<T>& v, VectorView<T> x) const
+    { LDiv(ColVectorViewOf(v),ColVectorViewOf(x)); }
+
+    template <typename T>
+    void Factorization<T>::RDiv(const GenVector<T>& v, VectorView<T> x) const
+    { RDiv(RowVectorViewOf(v),RowVectorViewOf(x)); }
+
+    //
+    // Serialization
+    //
+
+    template <typename T>
+    size_t Factorization<T>::blobSize() const
+    {
+        TMVAssert(pimpl);
+        return pimpl->nbytes;
+    }
+
+    template <typename T>
+    void Factorization<T>::writeBlob(char* buf) const
+    {
+        TMVAssert(pimpl);
+        std::memcpy(buf,pimpl->buf,pimpl->nbytes);
+    }
+
+    template <typename T>
+    void Factorization<T>::writeBlob(std::ostream& os) const
+    {
+        TMVAssert(pimpl);
+        os.write(pimpl->buf,pimpl->nbytes);
+    }
+
+    template <typename T>
+    Factorization<T> Factorization<T>::readBlob(
+        const char* buf, size_t n, bool copy)
+    {
+        if (n < sizeof(Factorization_Header))
+            FactorizationReadError("blob is too small");
+        Factorization_Header h;
+        std::memcpy(&h,buf,sizeof(h));
+        FactorizationCheckHeader<T>(h);
+        size_t off[5];
+        if (n < FactorizationLayout<T>(h,off))
+            FactorizationReadError("blob is too small");
+        Factorization_Impl* p;
+        if (copy) {
+            p = new Factorization_Impl(h);
+            std::memcpy(const_cast<char*>(p->buf),buf,p->nbytes);
+        } else {
+            p = new Factorization_Impl(buf);
+        }
+        return Factorization<T>(p);
+    }
+
+    template <typename T>
+    Factorization<T> Factorization<T>::readBlob(std::istream& is)
+    {
+        Factorization_Header h;
+        if (!is.read(reinterpret_cast<char*>(&h),sizeof(h)))
+            FactorizationReadError("unexpected end of stream");
+        FactorizationCheckHeader<T>(h);
+        auto_ptr<Factorization_Impl> p(new Factorization_Impl(h));
+        char* b = const_cast<char*>(p->buf);
+        if (!is.read(b+sizeof(h),p->nbytes-sizeof(h)))
+            FactorizationReadError("unexpected end of stream");
+        return Factorization<T>(p.release());
+    }
+
+#undef RT
+
+#define InstFile "TMV_Factorization.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
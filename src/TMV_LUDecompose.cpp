@@ -33,6 +33,11 @@
 #include "tmv/TMV_MatrixArith.h"
 #include "tmv/TMV_TriMatrixArith.h"
 
+#ifdef _OPENMP
+#include "TMV_MultMM.h"
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #include "tmv/TMV_MatrixArith.h"
 #include "tmv/TMV_TriMatrixArith.h"
@@ -406,12 +411,108 @@ namespace tmv {
 #endif
     }
 
+#ifdef _OPENMP
+    // The OpenMP version is a right-looking blocked algorithm.
+    // The matrix is split into column blocks of width LU_BLOCKSIZE.
+    // At each step k, the panel A(k1:M,k1:k2) has already been 
+    // decomposed, and the rest of the matrix to the right needs to be 
+    // updated by it.  Each column block to the right is a separate task:
+    // apply the row swaps, solve for U(k1:k2,j1:j2), and then 
+    // subtract L(k2:M,k1:k2) U(k1:k2,j1:j2) from the trailing part.
+    //
+    // The task that updates the next column block also decomposes it
+    // as soon as it is done with the update.  This lets the next panel
+    // (which is on the critical path) get done while the other threads 
+    // are still working on the larger trailing update.  i.e. we do one 
+    // level of lookahead.
+
+    template <class T> 
+    static void OpenMPLUPanel(
+        MatrixView<T> A, ptrdiff_t* P, ptrdiff_t k1, ptrdiff_t k2)
+    {
+        // Decompose the panel A(k1:M,k1:k2).
+        // The returned P values are made to be relative to the full A.
+        const ptrdiff_t M = A.colsize();
+        NonBlockLUDecompose(A.subMatrix(k1,M,k1,k2),P+k1);
+        for(ptrdiff_t i=k1;i<k2;++i) P[i]+=k1;
+    }
+
+    template <class T> 
+    static void OpenMPLUUpdate(
+        MatrixView<T> A, const ptrdiff_t* P, 
+        ptrdiff_t k1, ptrdiff_t k2, ptrdiff_t j1, ptrdiff_t j2)
+    {
+        // Update the column block A(0:M,j1:j2) by the panel at k1:k2.
+        const ptrdiff_t M = A.colsize();
+        MatrixView<T> Aj = A.colRange(j1,j2);
+        Aj.permuteRows(P,k1,k2);
+        Aj.rowRange(k1,k2) /= A.subMatrix(k1,k2,k1,k2).lowerTri(UnitDiag);
+        if (k2 < M) {
+#ifdef BLAS
+            // BlockMultMM isn't instantiated when we have BLAS.
+            Aj.rowRange(k2,M) -= 
+                A.subMatrix(k2,M,k1,k2) * Aj.rowRange(k1,k2);
+#else
+            BlockMultMM<true>(
+                T(-1),A.subMatrix(k2,M,k1,k2),Aj.rowRange(k1,k2),
+                Aj.rowRange(k2,M));
+#endif
+        }
+    }
+
+    template <class T> 
+    static void OpenMPLUDecompose(MatrixView<T> A, ptrdiff_t* P)
+    {
+        TMVAssert(A.ct()==NonConj);
+        TMVAssert(A.iscm());
+
+        const ptrdiff_t N = A.rowsize();
+        const ptrdiff_t R = TMV_MIN(N,A.colsize());
+        const ptrdiff_t NB = LU_BLOCKSIZE;
+
+        OpenMPLUPanel(A,P,0,TMV_MIN(NB,R));
+
+#pragma omp parallel
+        {
+#pragma omp single
+            {
+                for(ptrdiff_t k1=0;k1<R;k1+=NB) {
+                    const ptrdiff_t k2 = TMV_MIN(k1+NB,R);
+                    const ptrdiff_t k3 = TMV_MIN(k2+NB,R);
+                    for(ptrdiff_t j1=k2;j1<N;j1+=NB) {
+                        const ptrdiff_t j2 = TMV_MIN(j1+NB,N);
+#pragma omp task firstprivate(j1,j2)
+                        {
+                            OpenMPLUUpdate(A,P,k1,k2,j1,j2);
+                            // The lookahead step:
+                            if (j1 == k2 && k2 < R) 
+                                OpenMPLUPanel(A,P,k2,k3);
+                        }
+                    }
+                    // Apply the permutations from this panel to the 
+                    // left columns, which are otherwise done.
+                    if (k1 > 0) A.colRange(0,k1).permuteRows(P,k1,k2);
+#pragma omp taskwait
+                }
+            }
+        }
+    }
+#endif
+
     template <class T> 
     static inline void NonLapLUDecompose(MatrixView<T> A, ptrdiff_t* P)
     {
         TMVAssert(A.ct()==NonConj);
         TMVAssert(A.iscm());
 
+#ifdef _OPENMP
+        // Only worth the overhead if there are at least a few panels.
+        if (TMV_MIN(A.colsize(),A.rowsize()) > 2*LU_BLOCKSIZE &&
+            !omp_in_parallel() && omp_get_max_threads() > 1) {
+            OpenMPLUDecompose(A,P);
+            return;
+        }
+#endif
         RecursiveLUDecompose(A,P);
     }
 
@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "tmv/TMV_LUMixedD.h"
+#include "tmv/TMV_LUD.h"
+#include "TMV_LUDiv.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_TriMatrixArith.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_PermutationArith.h"
+#include <ostream>
+#include <limits>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    // The maximum number of refinement steps before giving up and
+    // using the full precision decomposition.  (Same as LAPACK's dsgesv.)
+    const int LUMIXED_MAXITER = 30;
+
+    // The precision in which to do the decomposition.
+    // Only use types that are instantiated in the library.
+    template <class T> 
+    struct LUMixedType { typedef T type; };
+#ifdef INST_FLOAT
+    template <> 
+    struct LUMixedType<double> { typedef float type; };
+#endif
+#ifdef INST_DOUBLE
+    template <> 
+    struct LUMixedType<long double> { typedef double type; };
+#endif
+    template <class T> 
+    struct LUMixedType<std::complex<T> >
+    { typedef std::complex<typename LUMixedType<T>::type> type; };
+
+    // Copy m1 into m2, converting between the two precisions.
+    template <class T1, class T2> 
+    static void MixedCopy(const GenMatrix<T1>& m1, MatrixView<T2> m2)
+    {
+        TMVAssert(m1.colsize() == m2.colsize());
+        TMVAssert(m1.rowsize() == m2.rowsize());
+        const ptrdiff_t M = m1.colsize();
+        const ptrdiff_t N = m1.rowsize();
+        for(ptrdiff_t j=0;j<N;++j) {
+            ConstVectorView<T1> c1 = m1.col(j);
+            VectorView<T2> c2 = m2.col(j);
+            for(ptrdiff_t i=0;i<M;++i) c2.ref(i) = T2(c1.cref(i));
+        }
+    }
+
+    // m2 += m1, converting m1 to the precision of m2.
+    template <class T1, class T2> 
+    static void MixedAdd(const GenMatrix<T1>& m1, MatrixView<T2> m2)
+    {
+        TMVAssert(m1.colsize() == m2.colsize());
+        TMVAssert(m1.rowsize() == m2.rowsize());
+        const ptrdiff_t M = m1.colsize();
+        const ptrdiff_t N = m1.rowsize();
+        for(ptrdiff_t j=0;j<N;++j) {
+            ConstVectorView<T1> c1 = m1.col(j);
+            VectorView<T2> c2 = m2.col(j);
+            for(ptrdiff_t i=0;i<M;++i) c2.ref(i) += T2(c1.cref(i));
+        }
+    }
+
+    // r = b - A x
+    template <class T, class T1> 
+    static void Residual(
+        const GenMatrix<T>& A, const GenMatrix<T1>& x,
+        const GenMatrix<T1>& b, MatrixView<T1> r)
+    { r = b; r -= A*x; }
+
+    // A complex matrix never divides a real one, but the Divider
+    // interface requires this to compile.
+    template <class T> 
+    static void Residual(
+        const GenMatrix<std::complex<T> >& , const GenMatrix<T>& ,
+        const GenMatrix<T>& , MatrixView<T> )
+    { TMVAssert(TMV_FALSE); }
+
+    template <class T> 
+    struct LUMixedDiv<T>::LUMixedDiv_Impl
+    {
+    public :
+        typedef typename LUMixedType<T>::type TL;
+        typedef TMV_RealType(TL) RTL;
+
+        LUMixedDiv_Impl(const GenMatrix<T>& A);
+
+        // Whether values of this size can be converted to TL.
+        bool inRange(RT x) const
+        { return x <= RT(std::numeric_limits<RTL>::max()); }
+
+        const Divider<T>& getFull() const;
+
+        template <class T1> 
+        bool refine(
+            const GenMatrix<T1>& b, MatrixView<T1> x, bool trans) const;
+
+        template <class T1> 
+        void solve(
+            const GenMatrix<T1>& b, MatrixView<T1> x, bool trans) const;
+
+        void addIter(ptrdiff_t n) const
+        {
+#if __cplusplus >= 201103L
+            niter += n;
+#else
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            niter += n;
+#endif
+        }
+
+        const GenMatrix<T>& A0;
+        const ptrdiff_t N;
+        Matrix<TL,ColMajor> LUx;
+        Permutation P;
+        RT normInfA;
+        RT norm1A;
+        bool lowok;
+        mutable DivPtr<T> full;
+#if __cplusplus >= 201103L
+        mutable std::mutex fullmutex;
+        mutable std::atomic<ptrdiff_t> niter;
+#else
+        mutable ptrdiff_t niter;
+#endif
+    };
+
+    template <class T> 
+    LUMixedDiv<T>::LUMixedDiv_Impl::LUMixedDiv_Impl(const GenMatrix<T>& A) :
+        A0(A), N(A.colsize()), LUx(N,N), P(N), 
+        normInfA(A.normInf()), norm1A(A.norm1()), lowok(false), niter(0)
+    {
+        if (inRange(A.maxAbsElement())) {
+            MixedCopy(A,LUx.view());
+            LU_Decompose(LUx.view(),P);
+            // If the low precision decomposition is (nearly) singular, 
+            // refinement won't converge, so don't bother trying.
+            RTL dmax = LUx.diag().maxAbsElement();
+            RTL dmin = LUx.diag().minAbsElement();
+            lowok = dmin > TMV_Epsilon<TL>() * dmax;
+        }
+        if (!lowok) full.reset(new LUDiv<T>(A0,false));
+    }
+
+    template <class T> 
+    const Divider<T>& LUMixedDiv<T>::LUMixedDiv_Impl::getFull() const
+    {
+        // Several threads may need the fallback at once, so make sure
+        // that only one of them calculates it.
+        if (!full.get()) {
+#if __cplusplus >= 201103L
+            std::lock_guard<std::mutex> lock(fullmutex);
+            if (!full.get()) full.reset(new LUDiv<T>(A0,false));
+#else
+#ifdef _OPENMP
+#pragma omp critical (TMV_LUMixed_Fallback)
+#endif
+            {
+                if (!full.get()) full.reset(new LUDiv<T>(A0,false));
+            }
+#endif
+        }
+        return *full;
+    }
+
+    // Solve A x = b (or At x = b if trans) by iterative refinement
+    // using the low precision decomposition.
+    // Returns whether the refinement converged.
+    template <class T> template <class T1> 
+    bool LUMixedDiv<T>::LUMixedDiv_Impl::refine(
+        const GenMatrix<T1>& b, MatrixView<T1> x, bool trans) const
+    {
+        typedef typename LUMixedType<T1>::type TL1;
+        const ptrdiff_t K = b.rowsize();
+        ConstMatrixView<T> A = trans ? A0.transpose() : A0.view();
+        const RT tol = TMV_SQRT(RT(N)) * TMV_Epsilon<T>() *
+            (trans ? norm1A : normInfA);
+
+        Matrix<TL1,ColMajor> y(N,K);
+        Matrix<T1,ColMajor> r = b;
+        x.setZero();
+        RT rprev = 0;
+        for(int iter=0;iter<=LUMIXED_MAXITER;++iter) {
+            // r holds b - A x.  Check if x is converged.
+            bool done = true;
+            for(ptrdiff_t j=0;j<K && done;++j) {
+                if (r.col(j).maxAbsElement() > tol * x.col(j).maxAbsElement())
+                    done = false;
+            }
+            if (done) { addIter(iter); return true; }
+
+            // Give up if there is not much improvement.
+            RT rnorm = r.maxAbsElement();
+            if (iter > 1 && rnorm > RT(0.5) * rprev) break;
+            if (!inRange(rnorm)) break;
+            rprev = rnorm;
+
+            // x += A^-1 r, using the low precision decomposition.
+            MixedCopy(r.view(),y.view());
+            if (trans) LU_RDivEq(LUx,P.getValues(),y.transpose());
+            else LU_LDivEq(LUx,P.getValues(),y.view());
+            MixedAdd(y.view(),x);
+
+            Residual(A,x,b,r.view());
+        }
+        addIter(LUMIXED_MAXITER);
+        return false;
+    }
+
+    template <class T> template <class T1> 
+    void LUMixedDiv<T>::LUMixedDiv_Impl::solve(
+        const GenMatrix<T1>& b, MatrixView<T1> x, bool trans) const
+    {
+        TMVAssert(b.colsize() == N);
+        TMVAssert(x.colsize() == N);
+        TMVAssert(b.rowsize() == x.rowsize());
+        if (!(lowok && refine(b,x,trans))) {
+            x = b;
+            if (trans) getFull().RDivEq(x.transpose());
+            else getFull().LDivEq(x);
+        }
+    }
+
+    template <class T> 
+    LUMixedDiv<T>::LUMixedDiv(const GenMatrix<T>& A, bool ) :
+        pimpl(new LUMixedDiv_Impl(A)) 
+    { TMVAssert(A.isSquare()); }
+
+    template <class T> 
+    LUMixedDiv<T>::~LUMixedDiv() {}
+
+    template <class T> template <class T1> 
+    void LUMixedDiv<T>::doLDivEq(MatrixView<T1> m) const
+    {
+        TMVAssert(pimpl->N == m.colsize());
+        Matrix<T1,ColMajor> b = m;
+        pimpl->solve(b,m,false);
+    }
+
+    template <class T> template <class T1> 
+    void LUMixedDiv<T>::doRDivEq(MatrixView<T1> m) const
+    {
+        TMVAssert(pimpl->N == m.rowsize());
+        Matrix<T1,ColMajor> b = m.transpose();
+        pimpl->solve(b,m.transpose(),true);
+    }
+
+    template <class T> template <class T1, class T2> 
+    void LUMixedDiv<T>::doLDiv(
+        const GenMatrix<T1>& m1, MatrixView<T2> m0) const
+    {
+        TMVAssert(m1.colsize() == m0.colsize());
+        TMVAssert(m1.rowsize() == m0.rowsize());
+        TMVAssert(pimpl->N == m1.colsize());
+        Matrix<T2,ColMajor> b = m1;
+        pimpl->solve(b,m0,false);
+    }
+
+    template <class T> template <class T1, class T2> 
+    void LUMixedDiv<T>::doRDiv(
+        const GenMatrix<T1>& m1, MatrixView<T2> m0) const
+    {
+        TMVAssert(m1.colsize() == m0.colsize());
+        TMVAssert(m1.rowsize() == m0.rowsize());
+        TMVAssert(pimpl->N == m1.rowsize());
+        Matrix<T2,ColMajor> b = m1.transpose();
+        pimpl->solve(b,m0.transpose(),true);
+    }
+
+    template <class T> 
+    T LUMixedDiv<T>::det() const
+    { return pimpl->getFull().det(); }
+
+    template <class T> 
+    RT LUMixedDiv<T>::logDet(T* sign) const
+    { return pimpl->getFull().logDet(sign); }
+
+    template <class T> template <class T1> 
+    void LUMixedDiv<T>::doMakeInverse(MatrixView<T1> minv) const
+    {
+        TMVAssert(minv.colsize() == pimpl->N);
+        TMVAssert(minv.rowsize() == pimpl->N);
+        minv.setToIdentity();
+        doLDivEq(minv);
+    }
+
+    template <class T> 
+    void LUMixedDiv<T>::doMakeInverseATA(MatrixView<T> ata) const
+    {
+        TMVAssert(ata.colsize() == pimpl->N);
+        TMVAssert(ata.rowsize() == pimpl->N);
+        // (At A)^-1 = A^-1 (A^-1)t
+        Matrix<T,ColMajor> minv(pimpl->N,pimpl->N);
+        doMakeInverse(minv.view());
+        ata = minv * minv.adjoint();
+    }
+
+    template <class T> 
+    bool LUMixedDiv<T>::isSingular() const 
+    {
+        // If the low precision decomposition were nearly singular,
+        // the full precision one would already have been calculated.
+        const Divider<T>* full = pimpl->full.get();
+        return full ? full->isSingular() : false;
+    }
+
+    template <class T> 
+    bool LUMixedDiv<T>::usedFallback() const 
+    { return pimpl->full.get() != 0; }
+
+    template <class T> 
+    ptrdiff_t LUMixedDiv<T>::getNumIter() const 
+    { return pimpl->niter; }
+
+    template <class T> 
+    bool LUMixedDiv<T>::checkDecomp(
+        const BaseMatrix<T>& m, std::ostream* fout) const
+    {
+        typedef typename LUMixedDiv_Impl::TL TL;
+        Matrix<T> mm = m;
+        if (fout) {
+            *fout << "LUMixedDiv:\n";
+            *fout << "M = "<<mm<<std::endl;
+            *fout << "usedFallback = "<<usedFallback()<<std::endl;
+            *fout << "numIter = "<<getNumIter()<<std::endl;
+        }
+        if (!pimpl->lowok) {
+            return pimpl->getFull().checkDecomp(m,fout);
+        }
+        Matrix<TL> mx(pimpl->N,pimpl->N);
+        MixedCopy(mm.view(),mx.view());
+        ConstLowerTriMatrixView<TL> L = pimpl->LUx.lowerTri(UnitDiag);
+        ConstUpperTriMatrixView<TL> U = pimpl->LUx.upperTri(NonUnitDiag);
+        Matrix<TL> lu = pimpl->P*L*U;
+        RT nm = Norm(lu-mx);
+        nm /= Norm(L)*Norm(U);
+        if (fout) {
+            *fout << "L = "<<L<<std::endl;
+            *fout << "U = "<<U<<std::endl;
+            *fout << "P = "<<pimpl->P<<std::endl;
+            *fout << "PLU = "<<lu<<std::endl;
+            *fout << "Norm(M-PLU)/Norm(PLU) = "<<nm<<std::endl;
+        }
+        return nm < mm.doCondition()*RT(mm.colsize())*TMV_Epsilon<TL>();
+    }
+
+    template <class T> 
+    ptrdiff_t LUMixedDiv<T>::colsize() const
+    { return pimpl->N; }
+
+    template <class T> 
+    ptrdiff_t LUMixedDiv<T>::rowsize() const
+    { return pimpl->N; }
+
+#ifdef INST_INT
+#undef INST_INT
+#endif
+
+#define InstFile "TMV_LUMixedD.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
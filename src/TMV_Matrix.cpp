@@ -27,6 +27,7 @@
 #include "tmv/TMV_DiagMatrix.h"
 #include "tmv/TMV_Divider.h"
 #include "tmv/TMV_LUD.h"
+#include "tmv/TMV_LUMixedD.h"
 #include "tmv/TMV_QRD.h"
 #include "tmv/TMV_QRPD.h"
 #include "tmv/TMV_SVD.h"
@@ -64,35 +65,45 @@ namespace tmv {
     }
 
     template <class T>
-    void GenMatrix<T>::setDiv() const
+    Divider<T>* GenMatrix<T>::newDiv() const
     {
-        if (!this->divIsSet()) {
-            DivType dt = this->getDivType();
-            TMVAssert(dt == tmv::LU || dt == tmv::QR ||
-                      dt == tmv::QRP || dt == tmv::SV);
-            switch (dt) {
-              case LU : 
-                   this->divider.reset(
-                       new LUDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case QR : 
-                   this->divider.reset(
-                       new QRDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case QRP : 
-                   this->divider.reset(
-                       new QRPDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case SV : 
-                   this->divider.reset(
-                       new SVDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              default : 
-                   // The above assert should have already failed
-                   // so go ahead and fall through.
-                   break;
-            }
+        // setDefaultDivType() has already been called under the lock,
+        // so this only needs to read divtype.
+        DivType dt = this->divtype & tmv::DivTypeFlags;
+        TMVAssert(dt == tmv::LU || dt == tmv::QR ||
+                  dt == tmv::QRP || dt == tmv::SV || dt == tmv::LUMixed);
+        switch (dt) {
+          case LU : 
+               return new LUDiv<T>(*this,this->divIsInPlace());
+          case LUMixed : 
+               return new LUMixedDiv<T>(*this,this->divIsInPlace());
+          case QR : 
+               return new QRDiv<T>(*this,this->divIsInPlace());
+          case QRP : 
+               return new QRPDiv<T>(*this,this->divIsInPlace());
+          case SV : 
+               return new SVDiv<T>(*this,this->divIsInPlace());
+          default : 
+               // The above assert should have already failed
+               // so go ahead and fall through.
+               break;
         }
+        return 0;
+    }
+
+    template <class T>
+    void GenMatrix<T>::setDiv() const
+    {
+#if __cplusplus >= 201103L
+        if (this->divIsSet()) return;
+#endif
+        // Make sure only one thread does the decomposition.
+        // (Without C++11, the divider isn't atomic, so it may only be
+        // read while holding the lock.)
+        DivLock<T> lock(*this);
+        if (this->divIsSet()) return;
+        this->setDefaultDivType();
+        this->divider.reset(newDiv());
     }
 
 #ifdef INST_INT
@@ -100,8 +111,15 @@ namespace tmv {
     void GenMatrix<int>::setDiv() const
     { TMVAssert(TMV_FALSE); }
     template <>
+    Divider<int>* GenMatrix<int>::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
+    template <>
     void GenMatrix<std::complex<int> >::setDiv() const
     { TMVAssert(TMV_FALSE); }
+    template <>
+    Divider<std::complex<int> >*
+    GenMatrix<std::complex<int> >::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
 #endif
 
     // Note: These need to be in the .cpp file, not the .h file for
@@ -116,6 +134,10 @@ namespace tmv {
     bool GenMatrix<T>::divIsLUDiv() const
     { return dynamic_cast<const LUDiv<T>*>(this->getDiv()); }
 
+    template <class T>
+    bool GenMatrix<T>::divIsLUMixedDiv() const
+    { return dynamic_cast<const LUMixedDiv<T>*>(this->getDiv()); }
+
     template <class T>
     bool GenMatrix<T>::divIsQRDiv() const
     { return dynamic_cast<const QRDiv<T>*>(this->getDiv()); }
@@ -134,6 +156,9 @@ namespace tmv {
     bool GenMatrix<int>::divIsLUDiv() const
     { return false; }
     template <>
+    bool GenMatrix<int>::divIsLUMixedDiv() const
+    { return false; }
+    template <>
     bool GenMatrix<int>::divIsQRDiv() const
     { return false; }
     template <>
@@ -147,6 +172,9 @@ namespace tmv {
     bool GenMatrix<std::complex<int> >::divIsLUDiv() const
     { return false; }
     template <>
+    bool GenMatrix<std::complex<int> >::divIsLUMixedDiv() const
+    { return false; }
+    template <>
     bool GenMatrix<std::complex<int> >::divIsQRDiv() const
     { return false; }
     template <>
@@ -157,6 +185,28 @@ namespace tmv {
     { return false; }
 #endif
 
+    template <class T>
+    void GenMatrix<T>::setRandomSVDiv(
+        ptrdiff_t k, ptrdiff_t oversample, ptrdiff_t niter) const
+    {
+        TMVAssert(k > 0 && k <= TMV_MIN(colsize(),rowsize()));
+        DivLock<T> lock(*this);
+        this->divideUsing(SV);
+        this->saveDiv();
+        this->divider.reset(new SVDiv<T>(*this,k,oversample,niter));
+    }
+
+#ifdef INST_INT
+    template <>
+    void GenMatrix<int>::setRandomSVDiv(
+        ptrdiff_t , ptrdiff_t , ptrdiff_t ) const
+    { TMVAssert(TMV_FALSE); }
+    template <>
+    void GenMatrix<std::complex<int> >::setRandomSVDiv(
+        ptrdiff_t , ptrdiff_t , ptrdiff_t ) const
+    { TMVAssert(TMV_FALSE); }
+#endif
+
     //
     // OK? (SubMatrix, SubVector)
     //
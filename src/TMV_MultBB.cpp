@@ -27,9 +27,15 @@
 #include "tmv/TMV_BandMatrixArithFunc.h"
 #include "tmv/TMV_BandMatrix.h"
 #include "tmv/TMV_BandMatrixArith.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "TMV_MultBandMM.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef XDEBUG
-#include "tmv/TMV_MatrixArith.h"
 #include <iostream>
 using std::cout;
 using std::cerr;
@@ -38,6 +44,12 @@ using std::endl;
 
 namespace tmv {
 
+#ifdef TMV_BLOCKSIZE
+#define MM_BLOCKSIZE TMV_BLOCKSIZE
+#else
+#define MM_BLOCKSIZE 64
+#endif
+
     //
     // MultMM (Band * Band)
     //
@@ -387,6 +399,100 @@ namespace tmv {
         }
     }
 
+    template <bool add, class T, class Ta, class Tb> 
+    static void RowBlockMultMM(
+        const T alpha, const GenBandMatrix<Ta>& A, const GenBandMatrix<Tb>& B,
+        BandMatrixView<T> C, ptrdiff_t i1, ptrdiff_t i2)
+    {
+        // C.rowRange(i1,i2) (+)= alpha * A.rowRange(i1,i2) * B
+        //
+        // The nonzero columns of these rows of A are k1..k2-1, and the
+        // nonzero columns of C are j1..j2-1.  Since C.nlo and C.nhi are
+        // exactly A.nlo+B.nlo and A.nhi+B.nhi (unless they are limited
+        // by the size of C), these are the same columns that are 
+        // nonzero in B.rowRange(k1,k2).  
+        //
+        // We copy A.subMatrix(i1,i2,k1,k2) into a dense matrix, with 
+        // zeros outside the band.  Then for each tile of columns of C,
+        // we copy the part of B that contributes to it, and do the 
+        // product with the dense MultMM.  Only the elements of the 
+        // result that are inside the band of C are then copied into C.
+        // The others are zero.
+        const ptrdiff_t N = C.rowsize();
+        const ptrdiff_t K = A.rowsize();
+        const ptrdiff_t nb = MM_BLOCKSIZE;
+        const ptrdiff_t k1 = TMV_MAX(ptrdiff_t(0),i1-A.nlo());
+        const ptrdiff_t k2 = TMV_MIN(K,i2+A.nhi());
+        const ptrdiff_t j1 = TMV_MAX(ptrdiff_t(0),i1-C.nlo());
+        const ptrdiff_t j2 = TMV_MIN(N,i2+C.nhi());
+        TMVAssert(k1 < k2);
+
+        Matrix<Ta,ColMajor> A1(i2-i1,k2-k1);
+        CopyBandBlock(A,i1,k1,A1.view());
+        Matrix<T,ColMajor> C1(i2-i1,TMV_MIN(nb,j2-j1));
+
+        for(ptrdiff_t jj1=j1;jj1<j2;jj1+=nb) {
+            const ptrdiff_t jj2 = TMV_MIN(jj1+nb,j2);
+            // B(k,j) is nonzero for j-B.nhi() <= k <= j+B.nlo().
+            const ptrdiff_t kk1 = TMV_MAX(k1,jj1-B.nhi());
+            const ptrdiff_t kk2 = TMV_MIN(k2,jj2+B.nlo());
+            MatrixView<T> C1j = C1.colRange(0,jj2-jj1);
+            if (kk1 < kk2) {
+                Matrix<Tb,ColMajor> B1(kk2-kk1,jj2-jj1);
+                CopyBandBlock(B,kk1,jj1,B1.view());
+                MultMM<false>(T(1),A1.colRange(kk1-k1,kk2-k1),B1,C1j);
+            } else {
+                C1j.setZero();
+            }
+            for(ptrdiff_t i=i1;i<i2;++i) {
+                const ptrdiff_t ja = TMV_MAX(jj1,i-C.nlo());
+                const ptrdiff_t jb = TMV_MIN(jj2,i+C.nhi()+1);
+                if (ja < jb) {
+                    if (add) 
+                        C.row(i,ja,jb) += alpha * C1j.row(i-i1,ja-jj1,jb-jj1);
+                    else 
+                        C.row(i,ja,jb) = alpha * C1j.row(i-i1,ja-jj1,jb-jj1);
+                }
+            }
+        }
+    }
+
+    template <bool add, class T, class Ta, class Tb> 
+    static void BlockBandMultMM(
+        const T alpha, const GenBandMatrix<Ta>& A, const GenBandMatrix<Tb>& B,
+        BandMatrixView<T> C)
+    {
+        // When A and B both have wide bands, we split C into blocks of 
+        // rows, and do each one with the dense MultMM (see RowBlockMultMM).
+        // The row blocks are independent, so they are done in parallel 
+        // with OpenMP.
+        TMVAssert(A.colsize() == C.colsize());
+        TMVAssert(A.rowsize() == B.colsize());
+        TMVAssert(B.rowsize() == C.rowsize());
+        TMVAssert(C.nhi() == TMV_MIN((C.rowsize()-1),A.nhi()+B.nhi()));
+        TMVAssert(C.nlo() == TMV_MIN((C.colsize()-1),A.nlo()+B.nlo()));
+        TMVAssert(alpha!= T(0));
+        TMVAssert(A.rowsize() > 0);
+        TMVAssert(C.rowsize() > 0);
+        TMVAssert(C.colsize() > 0);
+        TMVAssert(C.ct()==NonConj);
+        TMVAssert(A.colsize() <= A.rowsize()+A.nlo());
+
+        const ptrdiff_t M = C.colsize();
+        const ptrdiff_t nb = MM_BLOCKSIZE;
+        const int nblocks = int((M-1)/nb+1);
+#ifdef _OPENMP
+        const bool par = nblocks > 1 && !omp_in_parallel() && 
+            omp_get_max_threads() > 1;
+#pragma omp parallel for schedule(dynamic) if (par)
+#endif
+        for(int b=0;b<nblocks;++b) {
+            const ptrdiff_t i1 = b*nb;
+            const ptrdiff_t i2 = TMV_MIN(i1+nb,M);
+            RowBlockMultMM<add>(alpha,A,B,C,i1,i2);
+        }
+    }
+
     template <bool add, class T, class Ta, class Tb> 
     static void DoMultMM(
         const T alpha, const GenBandMatrix<Ta>& A, const GenBandMatrix<Tb>& B,
@@ -442,7 +548,9 @@ namespace tmv {
         } 
 #endif
 
-        if (A.isrm() && C.isrm()) RowMultMM<add>(alpha,A,B,C);
+        if (TMV_MIN(A.nlo()+A.nhi(),B.nlo()+B.nhi())+1 >= BANDMM_MINWIDTH)
+            BlockBandMultMM<add>(alpha,A,B,C);
+        else if (A.isrm() && C.isrm()) RowMultMM<add>(alpha,A,B,C);
         else if (A.iscm() && B.isrm()) OPMultMM<add>(alpha,A,B,C);
         else if (B.iscm() && C.iscm()) 
             RowMultMM<add>(alpha,B.transpose(),A.transpose(),C.transpose());
@@ -525,8 +633,8 @@ namespace tmv {
             } else if (B.colsize() > B.rowsize()+B.nlo()) {
                 ConstBandMatrixView<Tb> BB = B.rowRange(0,B.rowsize()+B.nlo());
                 ConstBandMatrixView<Ta> AA = A.subBandMatrix(
-                    0,A.colsize(),0,BB.rowsize(),
-                    A.nlo(),TMV_MIN(A.nhi(),BB.rowsize()-1));
+                    0,A.colsize(),0,BB.colsize(),
+                    A.nlo(),TMV_MIN(A.nhi(),BB.colsize()-1));
                 MultMM<add>(alpha,AA,BB,C);
             } else if (B.rowsize() > B.colsize()+B.nhi()) {
                 ConstBandMatrixView<Tb> BB = B.colRange(0,B.colsize()+B.nhi());
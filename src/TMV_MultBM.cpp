@@ -29,6 +29,11 @@
 #include "tmv/TMV_Matrix.h"
 #include "tmv/TMV_VectorArith.h"
 #include "tmv/TMV_MatrixArith.h"
+#include "TMV_MultBandMM.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef XDEBUG
 #include "tmv/TMV_MatrixArith.h"
@@ -344,7 +349,100 @@ namespace tmv {
         }
     }
 
-    // TODO: Put in a recursive block calculation here.  (Also in Band*Band)
+    template <bool add, class T, class Ta, class Tb> 
+    static void RowBlockMultMM(
+        const T alpha, const GenBandMatrix<Ta>& A, const GenMatrix<Tb>& B,
+        MatrixView<T> C, ptrdiff_t i1, ptrdiff_t i2)
+    {
+        // C.rowRange(i1,i2) (+)= alpha * A.rowRange(i1,i2) * B
+        //
+        // The nonzero columns of these rows of A are j1..j2-1.
+        // Columns jm1..jm2-1 are inside the band for all of the rows,
+        // so that part is a regular dense matrix.  On either side 
+        // of it is a triangle, which we copy into a dense matrix with 
+        // zeros outside the band.  (If the band is narrower than the 
+        // block, there is no middle part, and the two sides are not 
+        // really triangles, but the algorithm is the same.)
+        //
+        // If A is DiagMajor, the middle part would have to be copied
+        // by the dense MultMM anyway, so we just copy the whole thing.
+        const ptrdiff_t N = A.rowsize();
+        const ptrdiff_t j1 = TMV_MAX(ptrdiff_t(0),i1-A.nlo());
+        const ptrdiff_t j2 = TMV_MIN(N,i2+A.nhi());
+        TMVAssert(j1 < j2);
+        MatrixView<T> Ci = C.rowRange(i1,i2);
+        if (!A.iscm() && !A.isrm()) {
+            Matrix<Ta,ColMajor> A1(i2-i1,j2-j1);
+            CopyBandBlock(A,i1,j1,A1.view());
+            MultMM<add>(alpha,A1,B.rowRange(j1,j2),Ci);
+            return;
+        }
+        const ptrdiff_t jm1 = TMV_MIN(j2,TMV_MAX(j1,i2-1-A.nlo()));
+        const ptrdiff_t jm2 = TMV_MAX(jm1,TMV_MIN(j2,i1+A.nhi()+1));
+
+        bool first = true;
+        if (j1 < jm1) {
+            Matrix<Ta,ColMajor> A1(i2-i1,jm1-j1);
+            CopyBandBlock(A,i1,j1,A1.view());
+            MultMM<add>(alpha,A1,B.rowRange(j1,jm1),Ci);
+            first = false;
+        }
+        if (jm1 < jm2) {
+            if (first) 
+                MultMM<add>(alpha,A.subMatrix(i1,i2,jm1,jm2),
+                            B.rowRange(jm1,jm2),Ci);
+            else
+                MultMM<true>(alpha,A.subMatrix(i1,i2,jm1,jm2),
+                             B.rowRange(jm1,jm2),Ci);
+            first = false;
+        }
+        if (jm2 < j2) {
+            Matrix<Ta,ColMajor> A1(i2-i1,j2-jm2);
+            CopyBandBlock(A,i1,jm2,A1.view());
+            if (first) MultMM<add>(alpha,A1,B.rowRange(jm2,j2),Ci);
+            else MultMM<true>(alpha,A1,B.rowRange(jm2,j2),Ci);
+        }
+    }
+
+    template <bool add, class T, class Ta, class Tb> 
+    static void BlockBandMultMM(
+        const T alpha, const GenBandMatrix<Ta>& A, const GenMatrix<Tb>& B,
+        MatrixView<T> C)
+    {
+        // For wide bands, the row-by-row (or column-by-column) algorithms
+        // above are basically a bunch of MultMV calls, so they don't get
+        // the speed of the blocked dense algorithm.  Instead, we split
+        // C into blocks of rows, and do each block with the dense MultMM
+        // (see RowBlockMultMM).
+        //
+        // The row blocks are independent, so they are done in parallel
+        // with OpenMP.  The dense MultMM calls see that they are already
+        // in a parallel region, so they don't split the work any further.
+        TMVAssert(A.colsize() == C.colsize());
+        TMVAssert(A.rowsize() == B.colsize());
+        TMVAssert(B.rowsize() == C.rowsize());
+        TMVAssert(alpha!= T(0));
+        TMVAssert(A.rowsize() > 0);
+        TMVAssert(C.rowsize() > 0);
+        TMVAssert(C.colsize() > 0);
+        TMVAssert(C.ct()==NonConj);
+        TMVAssert(A.colsize() <= A.rowsize()+A.nlo());
+
+        const ptrdiff_t M = C.colsize();
+        const ptrdiff_t nb = MM_BLOCKSIZE;
+        const int nblocks = int((M-1)/nb+1);
+#ifdef _OPENMP
+        const bool par = nblocks > 1 && !omp_in_parallel() && 
+            omp_get_max_threads() > 1;
+#pragma omp parallel for schedule(dynamic) if (par)
+#endif
+        for(int b=0;b<nblocks;++b) {
+            const ptrdiff_t i1 = b*nb;
+            const ptrdiff_t i2 = TMV_MIN(i1+nb,M);
+            RowBlockMultMM<add>(alpha,A,B,C,i1,i2);
+        }
+    }
+
     template <bool add, class T, class Ta, class Tb> 
     static void DoMultMM(
         const T alpha, const GenBandMatrix<Ta>& A, const GenMatrix<Tb>& B,
@@ -375,7 +473,9 @@ namespace tmv {
         TMVAssert(C.colsize() > 0);
         TMVAssert(C.ct()==NonConj);
 
-        if (A.isrm() && C.isrm()) RowMultMM<add>(alpha,A,B,C);
+        if (A.nlo()+A.nhi()+1 >= BANDMM_MINWIDTH && C.rowsize() >= 16)
+            BlockBandMultMM<add>(alpha,A,B,C);
+        else if (A.isrm() && C.isrm()) RowMultMM<add>(alpha,A,B,C);
         else if (A.iscm() && B.isrm()) OPMultMM<add>(alpha,A,B,C);
         else if (B.iscm() && C.iscm()) ColMultMM<add>(alpha,A,B,C);
         else if (A.nlo() == 1 && A.nhi() == 1) {
@@ -29,12 +29,21 @@
 #include "tmv/TMV_VectorArith.h"
 #include "tmv/TMV_DiagMatrix.h"
 #include "tmv/TMV_DiagMatrixArithFunc.h"
+#include "TMV_SIMD.h"
 #ifdef BLAS
 #include "tmv/TMV_MatrixArith.h"
 #include "tmv/TMV_BandMatrixArith.h"
 #endif
 #include <iostream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// The minimum number of elements in the band of A to split the rows
+// of y = A x among the OpenMP threads.
+#define TMV_BANDMV_OMP_THRESH 65536
+
 // CBLAS trick of using RowMajor with ConjTrans when we have a 
 // case of A.conjugate() * x doesn't seem to be working with MKL 10.2.2.
 // I haven't been able to figure out why.  (e.g. Is it a bug in the MKL
@@ -229,6 +238,70 @@ namespace tmv {
         }
     }
 
+    // y += A.diag(k) * x (elementwise) for a DiagMajor A, where the 
+    // diagonal has unit step.
+    template <bool cx, bool ca, class T, class Ta, class Tx>
+    static inline void DiagElemMultVV(
+        const ptrdiff_t len, const Ta* Aij, const Tx* xj, T* yi)
+    {
+        for(ptrdiff_t i=len;i>0;--i,++yi,++xj,++Aij) {
+            *yi += 
+                (cx ? TMV_CONJ(*xj) : *xj) *
+                (ca ? TMV_CONJ(*Aij) : *Aij);
+        }
+    }
+
+#ifdef TMV_SIMD_DISPATCH
+    // For float and double, and their complex versions, the diagonals
+    // of a DiagMajor A can use the SIMD kernels (see TMV_SIMD.h).
+    // Note: x * conj(a) = conj(x) * a is done by swapping the roles
+    // of x and a.  Only the case with both conjugated doesn't use them.
+    template <bool cx, bool ca, class T>
+    static inline void DoSIMDDiagElemMultVV(
+        const ptrdiff_t len, const T* Aij, const T* xj, T* yi)
+    {
+        if (GetSIMDLevel() == SIMD_Baseline)
+            DiagElemMultVV<cx,ca>(len,Aij,xj,yi);
+        else
+            SIMD_ElemMultVV(len,Aij,xj,yi);
+    }
+
+    template <bool cx, bool ca, class T>
+    static inline void DoSIMDDiagElemMultVV(
+        const ptrdiff_t len, const std::complex<T>* Aij, 
+        const std::complex<T>* xj, std::complex<T>* yi)
+    {
+        if (GetSIMDLevel() == SIMD_Baseline || (cx && ca))
+            DiagElemMultVV<cx,ca>(len,Aij,xj,yi);
+        else if (cx)
+            SIMD_ElemMultVV(len,true,xj,Aij,yi);
+        else
+            SIMD_ElemMultVV(len,ca,Aij,xj,yi);
+    }
+#ifdef INST_DOUBLE
+    template <bool cx, bool ca>
+    static inline void DiagElemMultVV(
+        const ptrdiff_t len, const double* Aij, const double* xj, double* yi)
+    { DoSIMDDiagElemMultVV<cx,ca>(len,Aij,xj,yi); }
+    template <bool cx, bool ca>
+    static inline void DiagElemMultVV(
+        const ptrdiff_t len, const std::complex<double>* Aij, 
+        const std::complex<double>* xj, std::complex<double>* yi)
+    { DoSIMDDiagElemMultVV<cx,ca>(len,Aij,xj,yi); }
+#endif
+#ifdef INST_FLOAT
+    template <bool cx, bool ca>
+    static inline void DiagElemMultVV(
+        const ptrdiff_t len, const float* Aij, const float* xj, float* yi)
+    { DoSIMDDiagElemMultVV<cx,ca>(len,Aij,xj,yi); }
+    template <bool cx, bool ca>
+    static inline void DiagElemMultVV(
+        const ptrdiff_t len, const std::complex<float>* Aij, 
+        const std::complex<float>* xj, std::complex<float>* yi)
+    { DoSIMDDiagElemMultVV<cx,ca>(len,Aij,xj,yi); }
+#endif
+#endif
+
     template <bool add, bool cx, bool ca, bool dm, class T, class Ta, class Tx>
     static void DiagMultMV(
         const GenBandMatrix<Ta>& A, const GenVector<Tx>& x,
@@ -266,17 +339,25 @@ namespace tmv {
         for(ptrdiff_t k=-A.nlo(); k<=hi; ++k) {
             // y.subVector(i1,i2) += DiagMatrixViewOf(A.diag(k)) * 
             //     x.subVector(j1,j2);
-            const Ta* Aij = Ai1j1;
-            const Tx* xj = xj1;
-            T* yi = yi1;
-            for(ptrdiff_t i=len;i>0;--i,++yi,++xj,(dm?++Aij:Aij+=ds)) {
+            if (dm) {
 #ifdef TMVFLDEBUG
-                TMVAssert(yi >= y._first);
-                TMVAssert(yi < y._last);
+                TMVAssert(len == 0 || yi1 >= y._first);
+                TMVAssert(len == 0 || yi1+len-1 < y._last);
+#endif
+                DiagElemMultVV<cx,ca>(len,Ai1j1,xj1,yi1);
+            } else {
+                const Ta* Aij = Ai1j1;
+                const Tx* xj = xj1;
+                T* yi = yi1;
+                for(ptrdiff_t i=len;i>0;--i,++yi,++xj,Aij+=ds) {
+#ifdef TMVFLDEBUG
+                    TMVAssert(yi >= y._first);
+                    TMVAssert(yi < y._last);
 #endif
-                *yi += 
-                    (cx ? TMV_CONJ(*xj) : *xj) *
-                    (ca ? TMV_CONJ(*Aij) : *Aij);
+                    *yi += 
+                        (cx ? TMV_CONJ(*xj) : *xj) *
+                        (ca ? TMV_CONJ(*Aij) : *Aij);
+                }
             }
             if (k<0) { --yi1; ++len; Ai1j1-=si; } 
             else { ++xj1; Ai1j1+=sj; }
@@ -285,7 +366,7 @@ namespace tmv {
     }
 
     template <bool add, bool cx, class T, class Ta, class Tx> 
-    static void UnitAMultMV1(
+    static void DoUnitAMultMV1(
         const GenBandMatrix<Ta>& A, const GenVector<Tx>& x,
         VectorView<T> y)
     {
@@ -321,6 +402,54 @@ namespace tmv {
                 DiagMultMV<add,cx,false,false>(A,x,y);
     }
 
+    template <bool add, bool cx, class T, class Ta, class Tx> 
+    static void UnitAMultMV1(
+        const GenBandMatrix<Ta>& A, const GenVector<Tx>& x,
+        VectorView<T> y)
+    {
+#ifdef _OPENMP
+        // For large matrices, split the rows of A into one block per
+        // thread.  Each block only needs the part of x that is in its 
+        // columns of the band.
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        const ptrdiff_t lo = A.nlo();
+        const ptrdiff_t hi = A.nhi();
+        const int nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+        if (nthreads > 1 && M >= 2*nthreads*(lo+hi+1) &&
+            M*(lo+hi+1) >= TMV_BANDMV_OMP_THRESH) {
+            const ptrdiff_t mb = (M-1)/nthreads+1;
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+            for(int t=0;t<nthreads;++t) {
+                const ptrdiff_t i1 = t*mb;
+                const ptrdiff_t i2 = TMV_MIN(i1+mb,M);
+                if (i1 < i2) {
+                    const ptrdiff_t j1 = i1 > lo ? i1-lo : 0;
+                    const ptrdiff_t j2 = TMV_MIN(i2+hi,N);
+                    if (j1 >= j2) {
+                        if (!add) y.subVector(i1,i2).setZero();
+                    } else {
+                        ptrdiff_t newlo = lo-(i1-j1);
+                        ptrdiff_t newhi = hi+(i1-j1);
+                        if (newhi >= j2-j1) newhi = j2-j1-1;
+                        if (newlo >= i2-i1) newlo = i2-i1-1;
+                        TMVAssert(A.hasSubBandMatrix(
+                                i1,i2,j1,j2,newlo,newhi,1,1));
+                        const Ta* p = A.cptr()+i1*A.stepi()+j1*A.stepj();
+                        ConstBandMatrixView<Ta> Arows(
+                            p,i2-i1,j2-j1,newlo,newhi,
+                            A.stepi(),A.stepj(),A.diagstep(),A.ct());
+                        DoUnitAMultMV1<add,cx>(
+                            Arows,x.subVector(j1,j2),y.subVector(i1,i2));
+                    }
+                }
+            }
+            return;
+        }
+#endif
+        DoUnitAMultMV1<add,cx>(A,x,y);
+    }
+
     template <bool add, bool cx, class T, class Ta, class Tx> 
     static void UnitAMultMV(
         const GenBandMatrix<Ta>& A, const GenVector<Tx>& x,
@@ -1611,7 +1740,13 @@ namespace tmv {
                 BlasMultEqMV(A,x);
             }
 #else
-            if (A.nlo() == 0) NonBlasUpperMultEqMV(A,x);
+            if (A.isdm()) {
+                // The row and column algorithms have to use strided 
+                // access for a DiagMajor A, so it's faster to copy x and
+                // use the (SIMD) diagonal algorithm for x = A * xx.
+                Vector<T> xx = x;
+                UnitAMultMV1<false,false>(A,xx,x);
+            } else if (A.nlo() == 0) NonBlasUpperMultEqMV(A,x);
             else NonBlasLowerMultEqMV(A,x);
 #endif
         }
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TMV_MultBandMM_H
+#define TMV_MultBandMM_H
+
+// Helpers for the blocked band matrix products in TMV_MultBM.cpp 
+// and TMV_MultBB.cpp.
+
+#include "tmv/TMV_BandMatrix.h"
+#include "tmv/TMV_Matrix.h"
+
+// Band matrices with at least this many diagonals use the blocked 
+// algorithm (BlockBandMultMM), which does most of the work with the 
+// regular dense MultMM.  For narrower bands, the overhead of copying 
+// the blocks into dense storage is more than we gain from the faster
+// dense kernels.  (For Band * Band, both A and B need to be this wide.)
+#define BANDMM_MINWIDTH 32
+
+namespace tmv {
+
+    template <class Ta> 
+    inline void CopyBandBlock(
+        const GenBandMatrix<Ta>& A, ptrdiff_t i1, ptrdiff_t j1,
+        MatrixView<Ta> A1)
+    {
+        // A1 = A.subMatrix(i1,i1+A1.colsize(),j1,j1+A1.rowsize()), 
+        // with zeros for the elements that are outside the band.
+        const ptrdiff_t i2 = i1 + A1.colsize();
+        const ptrdiff_t j2 = j1 + A1.rowsize();
+        A1.setZero();
+        for(ptrdiff_t j=j1;j<j2;++j) {
+            const ptrdiff_t ia = TMV_MAX(i1,j-A.nhi());
+            const ptrdiff_t ib = TMV_MIN(i2,j+A.nlo()+1);
+            if (ia < ib) A1.col(j-j1,ia-i1,ib-i1) = A.col(j,ia,ib);
+        }
+    }
+
+} // namespace tmv
+
+#endif
@@ -51,6 +51,13 @@ namespace tmv {
         const T alpha, const GenMatrix<Ta>& A,
         const GenMatrix<Tb>& B, MatrixView<T> C);
 
+    // Like BlockMultMM, but with the blocks split among the OpenMP 
+    // threads, which share a single packed copy of A or B.
+    template <bool add, typename T, typename Ta, typename Tb> 
+    void ParallelBlockMultMM(
+        const T alpha, const GenMatrix<Ta>& A,
+        const GenMatrix<Tb>& B, MatrixView<T> C);
+
     template <bool add, typename T, typename Ta, typename Tb> 
     void RecursiveBlockMultMM(
         const T alpha, const GenMatrix<Ta>& A,
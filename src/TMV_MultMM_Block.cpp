@@ -26,61 +26,73 @@
 #include "tmv/TMV_Array.h"
 #include "tmv/TMV_MatrixArith.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //#include <iostream>
 
 namespace tmv {
 
+    // Copy the rows i1..i2 of A into the block format used by the kernels.
+    template <class RT>
+    static void PackBlockA(
+        const GenMatrix<RT>& A, const ptrdiff_t i1, const ptrdiff_t i2,
+        const ptrdiff_t MB, const ptrdiff_t KB, const ptrdiff_t size1,
+        RT* Ap, const ptrdiff_t K, const ptrdiff_t Kc, const ptrdiff_t Kd)
+    {
+        ptrdiff_t k1 = 0;
+        for (ptrdiff_t k2=KB;k2<=K;k1=k2,k2+=KB,Ap+=size1) {
+            MatrixView<RT> Ax(Ap,MB,KB,KB,1,NonConj,MB*KB 
+                              TMV_FIRSTLAST1(Ap,Ap+MB*KB));
+            Ax = A.subMatrix(i1,i2,k1,k2);
+        }
+        if (Kc) {
+            MatrixView<RT> Ay(Ap,MB,Kc,Kd,1,NonConj,MB*Kc
+                              TMV_FIRSTLAST1(Ap,Ap+MB*Kc));
+            Ay = A.subMatrix(i1,i2,k1,K);
+        }
+    }
+
+    // Copy the columns j1..j2 of B into the block format used by the kernels.
+    template <class RT>
+    static void PackBlockB(
+        const GenMatrix<RT>& B, const ptrdiff_t j1, const ptrdiff_t j2,
+        const ptrdiff_t NB, const ptrdiff_t KB, const ptrdiff_t size2,
+        RT* Bp, const ptrdiff_t K, const ptrdiff_t Kc, const ptrdiff_t Kd)
+    {
+        ptrdiff_t k1 = 0;
+        for (ptrdiff_t k2=KB;k2<=K;k1=k2,k2+=KB,Bp+=size2) {
+            MatrixView<RT> Bx(Bp,KB,NB,1,KB,NonConj,NB*KB 
+                              TMV_FIRSTLAST1(Bp,Bp+NB*KB));
+            Bx = B.subMatrix(k1,k2,j1,j2);
+        }
+        if (Kc) {
+            MatrixView<RT> By(Bp,Kc,NB,1,Kd,NonConj,NB*Kc
+                              TMV_FIRSTLAST1(Bp,Bp+NB*Kc));
+            By = B.subMatrix(k1,K,j1,j2);
+        }
+    }
+
     // Do the MultMM calculation for a single block of C: 
     // C += x * A * B
+    // Ap and Bp hold the packed block row of A and block column of B.
     template <class RT, class T, class Func>
     static void SingleBlockMultMM(
-        bool add, const T& x, const GenMatrix<RT>& A,
-        const GenMatrix<RT>& B, MatrixView<T> C,
+        bool add, const T& x, MatrixView<T> C,
         const ptrdiff_t i1, const ptrdiff_t j1, const ptrdiff_t i2, const ptrdiff_t j2,
         const ptrdiff_t MB, const ptrdiff_t NB, const ptrdiff_t KB,
         const ptrdiff_t size1, const ptrdiff_t size2, const ptrdiff_t size3,
-        RT* Ap, RT* Bp, RT* Cp, bool firstA, bool firstB, 
-        Func* myprod, Func* mycleanup,
-        const ptrdiff_t K, const ptrdiff_t Kc, const ptrdiff_t Kd)
+        const RT* Ap, const RT* Bp, RT* Cp, 
+        Func* myprod, Func* mycleanup, const ptrdiff_t K, const ptrdiff_t Kc)
     {
-        //std::cout<<"Start SingleBlockMultMM:\n";
-        //std::cout<<"i = "<<i1<<','<<i2<<"  j = "<<j1<<','<<j2<<std::endl;
-        //std::cout<<"block sizes = "<<MB<<','<<NB<<','<<KB<<std::endl;
-        //std::cout<<"sizes = "<<size1<<','<<size2<<','<<size3<<std::endl;
-        //std::cout<<"pointers = "<<Ap<<"  "<<Bp<<"  "<<Cp<<std::endl;
-        //std::cout<<"first?  "<<firstA<<"  "<<firstB<<std::endl;
-        //std::cout<<"func = "<<myprod<<"  "<<mycleanup<<std::endl;
-        //std::cout<<"K,Kc,kd = "<<K<<','<<Kc<<','<<Kd<<std::endl;
-
-        //std::cout<<"Cx: "<<Cp<<"..."<<Cp+size3<<std::endl;
         VectorView<RT>(Cp,size3,1,NonConj 
                        TMV_FIRSTLAST1(Cp,Cp+size3)).setZero();
 
-        ptrdiff_t k1 = 0;
-        for (ptrdiff_t k2=KB;k2<=K;k1=k2,k2+=KB,Ap+=size1,Bp+=size2) {
-            //std::cout<<"Ax: "<<Ap<<"..."<<Ap+MB*KB<<std::endl;
-            //std::cout<<"Bx: "<<Bp<<"..."<<Bp+NB*KB<<std::endl;
-            MatrixView<RT> Ax(Ap,MB,KB,KB,1,NonConj,MB*KB 
-                              TMV_FIRSTLAST1(Ap,Ap+MB*KB));
-            MatrixView<RT> Bx(Bp,KB,NB,1,KB,NonConj,NB*KB 
-                              TMV_FIRSTLAST1(Bp,Bp+NB*KB));
-            if (firstA) Ax = A.subMatrix(i1,i2,k1,k2);
-            if (firstB) Bx = B.subMatrix(k1,k2,j1,j2);
+        for (ptrdiff_t k2=KB;k2<=K;k2+=KB,Ap+=size1,Bp+=size2) 
             (*myprod) (MB,NB,KB, Ap,Bp,Cp);
-        }
+        if (Kc) (*mycleanup) (MB,NB,Kc, Ap,Bp,Cp);
 
-        if (Kc) {
-            //std::cout<<"Ay: "<<Ap<<"..."<<Ap+MB*Kc<<std::endl;
-            //std::cout<<"By: "<<Bp<<"..."<<Bp+NB*Kc<<std::endl;
-            MatrixView<RT> Ay(Ap,MB,Kc,Kd,1,NonConj,MB*Kc
-                              TMV_FIRSTLAST1(Ap,Ap+MB*Kc));
-            MatrixView<RT> By(Bp,Kc,NB,1,Kd,NonConj,NB*Kc
-                              TMV_FIRSTLAST1(Bp,Bp+NB*Kc));
-            if (firstA) Ay = A.subMatrix(i1,i2,k1,K);
-            if (firstB) By = B.subMatrix(k1,K,j1,j2);
-            (*mycleanup) (MB,NB,Kc, Ap,Bp,Cp);
-        }
-        //std::cout<<"Cx: "<<Cp<<"..."<<Cp+MB*NB<<std::endl;
         if (add) {
             C.subMatrix(i1,i2,j1,j2) += 
                 x*ConstMatrixView<RT>(Cp,MB,NB,1,MB,NonConj,MB*NB);
@@ -93,6 +105,11 @@ namespace tmv {
         }
     }
 
+    // BlockHelper gives the kernel functions to use for each type, along
+    // with the K size of the blocks (KB = 2^lgKB).  For float and double,
+    // these depend on which SIMD instructions are available.  The SSE 
+    // kernels are selected at compile time, but the AVX2 and AVX-512 
+    // ones are selected at runtime according to what the CPU supports.
     template <class T>
     struct BlockHelper
     {
@@ -100,8 +117,7 @@ namespace tmv {
             const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
             const T* A, const T* B, T* C);
 
-        enum { KB = 16 };
-        enum { lgKB = 4 };
+        static int getLgKB() { return 4; }
         static KernelMultMMFunc* getProdFunc() 
         { return &call_multmm_16_16_16<T>; }
         static KernelMultMMFunc* getProdFuncA() 
@@ -110,6 +126,10 @@ namespace tmv {
         { return &call_multmm_M_16_16<T>; }
         static KernelMultMMFunc* getProdFuncC() 
         { return &call_multmm_M_N_K<T>; }
+        static KernelMultMMFunc* getCleanupFunc() 
+        { return &call_multmm_16_16_K<T>; }
+        static KernelMultMMFunc* getCleanupFuncC() 
+        { return &call_multmm_M_N_K<T>; }
         static ptrdiff_t RoundUp(ptrdiff_t x) { return x; }
     };
 
@@ -124,16 +144,42 @@ namespace tmv {
             const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
             const T* A, const T* B, T* C);
 
-        enum { KB = 32 };
-        enum { lgKB = 5 };
+        // Return the AVX version if the CPU supports it, else f.
+        static KernelMultMMFunc* chooseFunc(
+            KernelMultMMFunc* f, bool cleanup)
+        {
+#ifdef TMV_SIMD_DISPATCH
+            SIMDLevel level = GetSIMDLevel();
+            if (level == SIMD_AVX512) {
+                if (cleanup) return &avx512_multmm_cleanup;
+                else return &avx512_multmm_block;
+            } else if (level == SIMD_AVX2) {
+                if (cleanup) return &avx2_multmm_cleanup;
+                else return &avx2_multmm_block;
+            }
+#endif
+            return f;
+        }
+
+        static int getLgKB() 
+        {
+#ifdef TMV_SIMD_DISPATCH
+            if (GetSIMDLevel() != SIMD_Baseline) return 6;
+#endif
+            return 5;
+        }
         static KernelMultMMFunc* getProdFunc() 
-        { return &call_multmm_16_16_32<T>; }
+        { return chooseFunc(&call_multmm_16_16_32<T>,false); }
         static KernelMultMMFunc* getProdFuncA() 
-        { return &call_multmm_16_N_32<T>; }
+        { return chooseFunc(&call_multmm_16_N_32<T>,false); }
         static KernelMultMMFunc* getProdFuncB() 
-        { return &call_multmm_M_16_32<T>; }
+        { return chooseFunc(&call_multmm_M_16_32<T>,false); }
         static KernelMultMMFunc* getProdFuncC() 
-        { return &call_multmm_M_N_K<T>; }
+        { return chooseFunc(&call_multmm_M_N_K<T>,true); }
+        static KernelMultMMFunc* getCleanupFunc() 
+        { return chooseFunc(&call_multmm_16_16_K<T>,true); }
+        static KernelMultMMFunc* getCleanupFuncC() 
+        { return chooseFunc(&call_multmm_M_N_K<T>,true); }
         static ptrdiff_t RoundUp(ptrdiff_t x) 
         { return (x == 0 ? 0 : (((x-1)>>1)+1)<<1); }
     };
@@ -149,16 +195,42 @@ namespace tmv {
             const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
             const T* A, const T* B, T* C);
 
-        enum { KB = 64 };
-        enum { lgKB = 6 };
+        // Return the AVX version if the CPU supports it, else f.
+        static KernelMultMMFunc* chooseFunc(
+            KernelMultMMFunc* f, bool cleanup)
+        {
+#ifdef TMV_SIMD_DISPATCH
+            SIMDLevel level = GetSIMDLevel();
+            if (level == SIMD_AVX512) {
+                if (cleanup) return &avx512_multmm_cleanup;
+                else return &avx512_multmm_block;
+            } else if (level == SIMD_AVX2) {
+                if (cleanup) return &avx2_multmm_cleanup;
+                else return &avx2_multmm_block;
+            }
+#endif
+            return f;
+        }
+
+        static int getLgKB() 
+        {
+#ifdef TMV_SIMD_DISPATCH
+            if (GetSIMDLevel() != SIMD_Baseline) return 7;
+#endif
+            return 6;
+        }
         static KernelMultMMFunc* getProdFunc() 
-        { return &call_multmm_16_16_64<T>; }
+        { return chooseFunc(&call_multmm_16_16_64<T>,false); }
         static KernelMultMMFunc* getProdFuncA() 
-        { return &call_multmm_16_N_64<T>; }
+        { return chooseFunc(&call_multmm_16_N_64<T>,false); }
         static KernelMultMMFunc* getProdFuncB() 
-        { return &call_multmm_M_16_64<T>; }
+        { return chooseFunc(&call_multmm_M_16_64<T>,false); }
         static KernelMultMMFunc* getProdFuncC() 
-        { return &call_multmm_M_N_K<T>; }
+        { return chooseFunc(&call_multmm_M_N_K<T>,true); }
+        static KernelMultMMFunc* getCleanupFunc() 
+        { return chooseFunc(&call_multmm_16_16_K<T>,true); }
+        static KernelMultMMFunc* getCleanupFuncC() 
+        { return chooseFunc(&call_multmm_M_N_K<T>,true); }
         static ptrdiff_t RoundUp(ptrdiff_t x) 
         { return (x == 0 ? 0 : (((x-1)>>2)+1)<<2); }
     };
@@ -166,21 +238,35 @@ namespace tmv {
 #endif
 #endif
 
-
+#ifdef __PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
 
     // Do the loops over the full matrix C, breaking up the calculation
     // into blocks.
+    //
+    // The larger of A and B (in the sense that C has more columns than 
+    // rows, or vice versa) is streamed one block column (or row) at a 
+    // time, and the other is packed in full, since each of its blocks
+    // is used once for every block of the streamed one.
+    //
+    // If par is true, the streamed blocks are split among the OpenMP 
+    // threads.  The fully packed matrix is packed once (also in parallel)
+    // and then shared by all the threads, so each thread only packs its
+    // own blocks of the streamed matrix.
     template <class RT, class T>
     static void DoBlockMultMM(
-        bool add, const T& x, const GenMatrix<RT>& A,
+        bool add, bool par, const T& x, const GenMatrix<RT>& A,
         const GenMatrix<RT>& B, MatrixView<T> C)
     {
         const ptrdiff_t M = C.colsize();
         const ptrdiff_t N = C.rowsize();
         const ptrdiff_t K = A.rowsize();
 
-        const ptrdiff_t KB = BlockHelper<RT>::KB;
-        const ptrdiff_t lgKB = BlockHelper<RT>::lgKB;
+        const ptrdiff_t lgKB = BlockHelper<RT>::getLgKB();
+        const ptrdiff_t KB = (1<<lgKB);
 
         typedef typename BlockHelper<RT>::KernelMultMMFunc Func;
         Func* prod = BlockHelper<RT>::getProdFunc();
@@ -188,18 +274,17 @@ namespace tmv {
         Func* prodb = BlockHelper<RT>::getProdFuncB();
         Func* prodc = BlockHelper<RT>::getProdFuncC();
 
-        Func* cleanup = &call_multmm_16_16_K<RT>;
-        Func* cleanupabc = &call_multmm_M_N_K<RT>;
+        Func* cleanup = BlockHelper<RT>::getCleanupFunc();
+        Func* cleanupabc = BlockHelper<RT>::getCleanupFuncC();
 
         const ptrdiff_t Mb = (M>>4); // = M/16
         const ptrdiff_t Nb = (N>>4); // = N/16
         const ptrdiff_t Kb = (K>>lgKB); // = K/KB
         const ptrdiff_t Ma = (Mb<<4); // = M/16*16
         const ptrdiff_t Na = (Nb<<4); // = N/16*16
-        const ptrdiff_t Ka = (Kb<<lgKB); // = K/KB*KB
         const ptrdiff_t Mc = M-Ma; // = M%16
         const ptrdiff_t Nc = N-Na; // = N%16
-        const ptrdiff_t Kc = K-Ka; // = K%KB
+        const ptrdiff_t Kc = K-(Kb<<lgKB); // = K%KB
         const ptrdiff_t Kd = BlockHelper<RT>::RoundUp(Kc);
         // = Kc rounded up to multiple of 2 or 4 as required for SSE commands
         const ptrdiff_t Ktot_d = (Kb<<lgKB) + Kd;
@@ -210,164 +295,161 @@ namespace tmv {
         const ptrdiff_t size2 = 16*KB;
         const ptrdiff_t size2y = Nc*KB;
         const ptrdiff_t size3 = 16*16;
+        const ptrdiff_t fullsize = 16*Ktot_d;
+
+        // The number of block rows of C, and block columns.
+        const ptrdiff_t ni = Mb + (Mc ? 1 : 0);
+        const ptrdiff_t nj = Nb + (Nc ? 1 : 0);
+
+        // Each thread needs its own space for one block of C and for one
+        // packed block of the streamed matrix.  Allocate these here, 
+        // rather than in the parallel region, so that a bad_alloc can
+        // still be caught by BlockMultMM.
+#ifdef _OPENMP
+        const int nthreads = par ? omp_get_max_threads() : 1;
+#else
+        const int nthreads = 1;
+#endif
+        AlignedArray<RT> C_temp(nthreads*size3);
+        AlignedArray<RT> X_temp(nthreads*fullsize);
 
-        AlignedArray<RT> C_temp(size3);
-        RT*const Cp = C_temp;
         if (N >= M) {
             // Then we loop over the columns of B (in blocks).
             // We store a full copy of A in block format.
             // Each block column of B is copied one at a time into 
             // temporary storage.
             AlignedArray<RT> A_temp(M*Ktot_d);
-            AlignedArray<RT> B_temp(16*Ktot_d);
             RT*const Ap0 = A_temp;
-            RT*const Bp0 = B_temp;
-            const ptrdiff_t fullsize1 = 16*Ktot_d;
 
-            for(ptrdiff_t j=0;j<Nb;++j) {
-                RT* Ap = Ap0;
-                for(ptrdiff_t i=0;i<Mb;++i) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        i*16,j*16,(i+1)*16,(j+1)*16,
-                        16,16,KB,
-                        size1,size2,size3,
-                        Ap,Bp0,Cp, j==0,i==0, 
-                        prod, cleanup,
-                        K,Kc,Kd);
-                    Ap += fullsize1;
-                }
-                if (Mc) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        Ma,j*16,M,(j+1)*16,
-                        Mc,16,KB,
-                        size1y,size2,size3,
-                        Ap,Bp0,Cp, j==0,Mb==0, 
-                        prodb, cleanupabc,
-                        K,Kc,Kd);
-                }
+#ifdef _OPENMP
+#pragma omp parallel for if (par && ni > 1)
+#endif
+            for(TMV_INT_OMP i=0;i<ni;++i) {
+                const bool ifull = i < Mb;
+                PackBlockA(A,i*16,ifull?(i+1)*16:M,ifull?16:Mc,KB,
+                           ifull?size1:size1y,Ap0+i*fullsize,K,Kc,Kd);
             }
-            if (Nc) {
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (par && nj > 1)
+#endif
+            for(TMV_INT_OMP j=0;j<nj;++j) {
+#ifdef _OPENMP
+                const int t = omp_get_thread_num();
+#else
+                const int t = 0;
+#endif
+                RT*const Bp = X_temp + t*fullsize;
+                RT*const Cp = C_temp + t*size3;
+                const bool jfull = j < Nb;
+                const ptrdiff_t j1 = j*16;
+                const ptrdiff_t j2 = jfull ? j1+16 : N;
+                const ptrdiff_t NB = jfull ? 16 : Nc;
+                const ptrdiff_t sizeB = jfull ? size2 : size2y;
+                PackBlockB(B,j1,j2,NB,KB,sizeB,Bp,K,Kc,Kd);
                 RT* Ap = Ap0;
-                for(ptrdiff_t i=0;i<Mb;++i) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        i*16,Na,(i+1)*16,N,
-                        16,Nc,KB,
-                        size1,size2y,size3,
-                        Ap,Bp0,Cp, Nb==0,i==0,
-                        proda, cleanupabc,
-                        K,Kc,Kd);
-                    Ap += fullsize1;
-                }
-                if (Mc) {
+                for(ptrdiff_t i=0;i<ni;++i,Ap+=fullsize) {
+                    const bool ifull = i < Mb;
                     SingleBlockMultMM(
-                        add,x,A,B,C,
-                        Ma,Na,M,N,
-                        Mc,Nc,KB,
-                        size1y,size2y,size3,
-                        Ap,Bp0,Cp, Nb==0,Mb==0,
-                        prodc, cleanupabc,
-                        K,Kc,Kd);
+                        add,x,C,
+                        i*16,j1,ifull?(i+1)*16:M,j2,
+                        ifull?16:Mc,NB,KB,
+                        ifull?size1:size1y,sizeB,size3,
+                        Ap,Bp,Cp,
+                        ifull ? (jfull ? prod : proda) : 
+                        (jfull ? prodb : prodc),
+                        ifull && jfull ? cleanup : cleanupabc,
+                        K,Kc);
                 }
             }
         } else {
             // Then we loop over the rows of A and store a full copy of B.
-            AlignedArray<RT> A_temp(16*Ktot_d);
             AlignedArray<RT> B_temp(N*Ktot_d);
-            RT*const Ap0 = A_temp;
             RT*const Bp0 = B_temp;
-            const ptrdiff_t fullsize2 = 16*Ktot_d;
 
-            for(ptrdiff_t i=0;i<Mb;++i) {
-                RT* Bp = Bp0;
-                for(ptrdiff_t j=0;j<Nb;++j) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        i*16,j*16,(i+1)*16,(j+1)*16,
-                        16,16,KB,
-                        size1,size2,size3,
-                        Ap0,Bp,Cp, j==0,i==0,
-                        prod, cleanup,
-                        K,Kc,Kd);
-                    Bp += fullsize2;
-                }
-                if (Nc) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        i*16,Na,(i+1)*16,N,
-                        16,Nc,KB,
-                        size1,size2y,size3,
-                        Ap0,Bp,Cp, Nb==0,i==0, 
-                        proda, cleanupabc,
-                        K,Kc,Kd);
-                }
+#ifdef _OPENMP
+#pragma omp parallel for if (par && nj > 1)
+#endif
+            for(TMV_INT_OMP j=0;j<nj;++j) {
+                const bool jfull = j < Nb;
+                PackBlockB(B,j*16,jfull?(j+1)*16:N,jfull?16:Nc,KB,
+                           jfull?size2:size2y,Bp0+j*fullsize,K,Kc,Kd);
             }
-            if (Mc) {
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (par && ni > 1)
+#endif
+            for(TMV_INT_OMP i=0;i<ni;++i) {
+#ifdef _OPENMP
+                const int t = omp_get_thread_num();
+#else
+                const int t = 0;
+#endif
+                RT*const Ap = X_temp + t*fullsize;
+                RT*const Cp = C_temp + t*size3;
+                const bool ifull = i < Mb;
+                const ptrdiff_t i1 = i*16;
+                const ptrdiff_t i2 = ifull ? i1+16 : M;
+                const ptrdiff_t MB = ifull ? 16 : Mc;
+                const ptrdiff_t sizeA = ifull ? size1 : size1y;
+                PackBlockA(A,i1,i2,MB,KB,sizeA,Ap,K,Kc,Kd);
                 RT* Bp = Bp0;
-                for(ptrdiff_t j=0;j<Nb;++j) {
-                    SingleBlockMultMM(
-                        add,x,A,B,C,
-                        Ma,j*16,M,(j+1)*16,
-                        Mc,16,KB,
-                        size1y,size2,size3,
-                        Ap0,Bp,Cp, j==0,Mb==0, 
-                        prodb, cleanupabc,
-                        K,Kc,Kd);
-                    Bp += fullsize2;
-                }
-                if (Nc) {
+                for(ptrdiff_t j=0;j<nj;++j,Bp+=fullsize) {
+                    const bool jfull = j < Nb;
                     SingleBlockMultMM(
-                        add,x,A,B,C,
-                        Ma,Na,M,N,
-                        Mc,Nc,KB,
-                        size1y,size2y,size3,
-                        Ap0,Bp,Cp, Nb==0,Mb==0, 
-                        prodc, cleanupabc,
-                        K,Kc,Kd);
+                        add,x,C,
+                        i1,j*16,i2,jfull?(j+1)*16:N,
+                        MB,jfull?16:Nc,KB,
+                        sizeA,jfull?size2:size2y,size3,
+                        Ap,Bp,Cp,
+                        ifull ? (jfull ? prod : proda) : 
+                        (jfull ? prodb : prodc),
+                        ifull && jfull ? cleanup : cleanupabc,
+                        K,Kc);
                 }
             }
         }
     }
 
+#undef TMV_INT_OMP
+
     // Turn the various complex varieties into real versions:
 #define CT std::complex<RT>
     template <class RT>
     static void DoBlockMultMM(
-        bool add, const CT x, const GenMatrix<RT>& A,
+        bool add, bool par, const CT x, const GenMatrix<RT>& A,
         const GenMatrix<CT>& B, MatrixView<CT> C)
     {
         bool Bc = B.isconj();
         if (TMV_IMAG(x) == RT(0)) {
             const RT xr = TMV_REAL(x);
-            DoBlockMultMM(add,xr,A,B.realPart(),C.realPart());
-            DoBlockMultMM(add,Bc?-xr:xr,A,B.imagPart(),C.imagPart());
+            DoBlockMultMM(add,par,xr,A,B.realPart(),C.realPart());
+            DoBlockMultMM(add,par,Bc?-xr:xr,A,B.imagPart(),C.imagPart());
         } else {
             CT ix = std::complex<RT>(0,1) * x;
-            DoBlockMultMM(add,x,A,B.realPart(),C);
-            DoBlockMultMM(true,Bc?-ix:ix,A,B.imagPart(),C);
+            DoBlockMultMM(add,par,x,A,B.realPart(),C);
+            DoBlockMultMM(true,par,Bc?-ix:ix,A,B.imagPart(),C);
         }
     }
     template <class RT>
     static void DoBlockMultMM(
-        bool add, const CT x, const GenMatrix<CT>& A,
+        bool add, bool par, const CT x, const GenMatrix<CT>& A,
         const GenMatrix<RT>& B, MatrixView<CT> C)
     {
         bool Ac = A.isconj();
         if (TMV_IMAG(x) == RT(0)) {
             const RT xr = TMV_REAL(x);
-            DoBlockMultMM(add,xr,A.realPart(),B,C.realPart());
-            DoBlockMultMM(add,Ac?-xr:xr,A.imagPart(),B,C.imagPart());
+            DoBlockMultMM(add,par,xr,A.realPart(),B,C.realPart());
+            DoBlockMultMM(add,par,Ac?-xr:xr,A.imagPart(),B,C.imagPart());
         } else {
             CT ix = std::complex<RT>(0,1) * x;
-            DoBlockMultMM(add,x,A.realPart(),B,C);
-            DoBlockMultMM(true,Ac?-ix:ix,A.imagPart(),B,C);
+            DoBlockMultMM(add,par,x,A.realPart(),B,C);
+            DoBlockMultMM(true,par,Ac?-ix:ix,A.imagPart(),B,C);
         }
     }
     template <class RT>
     static void DoBlockMultMM(
-        bool add, const CT x, const GenMatrix<CT>& A,
+        bool add, bool par, const CT x, const GenMatrix<CT>& A,
         const GenMatrix<CT>& B, MatrixView<CT> C)
     {
         bool Ac = A.isconj();
@@ -375,31 +457,31 @@ namespace tmv {
         if (TMV_IMAG(x) == RT(0)) {
             const RT xr = TMV_REAL(x);
             DoBlockMultMM(
-                add,xr,A.realPart(),B.realPart(),C.realPart());
+                add,par,xr,A.realPart(),B.realPart(),C.realPart());
             DoBlockMultMM(
-                true,Ac==Bc?-xr:xr,A.imagPart(),B.imagPart(),C.realPart());
+                true,par,Ac==Bc?-xr:xr,A.imagPart(),B.imagPart(),C.realPart());
             DoBlockMultMM(
-                add,Bc?-xr:xr,A.realPart(),B.imagPart(),C.imagPart());
+                add,par,Bc?-xr:xr,A.realPart(),B.imagPart(),C.imagPart());
             DoBlockMultMM(
-                true,Ac?-xr:xr,A.imagPart(),B.realPart(),C.imagPart());
+                true,par,Ac?-xr:xr,A.imagPart(),B.realPart(),C.imagPart());
         } else {
             CT ix = std::complex<RT>(0,1) * x;
-            DoBlockMultMM(add,x,A.realPart(),B.realPart(),C);
-            DoBlockMultMM(true,Ac==Bc?-x:x,A.imagPart(),B.imagPart(),C);
-            DoBlockMultMM(true,Bc?-ix:ix,A.realPart(),B.imagPart(),C);
-            DoBlockMultMM(true,Ac?-ix:ix,A.imagPart(),B.realPart(),C);
+            DoBlockMultMM(add,par,x,A.realPart(),B.realPart(),C);
+            DoBlockMultMM(true,par,Ac==Bc?-x:x,A.imagPart(),B.imagPart(),C);
+            DoBlockMultMM(true,par,Bc?-ix:ix,A.realPart(),B.imagPart(),C);
+            DoBlockMultMM(true,par,Ac?-ix:ix,A.imagPart(),B.realPart(),C);
         }
     }
 #undef CT
 
     template <bool add, class T, class Ta, class Tb>
-    void BlockMultMM(
-        const T x, const GenMatrix<Ta>& A,
+    static void BlockMultMM1(
+        bool par, const T x, const GenMatrix<Ta>& A,
         const GenMatrix<Tb>& B, MatrixView<T> C)
     { 
         try {
-            DoBlockMultMM(add,x,A,B,C); 
-        } catch (std::bad_alloc) {
+            DoBlockMultMM(add,par,x,A,B,C); 
+        } catch (std::bad_alloc&) {
             TMV_Warning(
                 "Caught bad_alloc error in MultMM.\n"
                 "Using (slower) algorithm that doesn't allocate temporary "
@@ -439,6 +521,20 @@ namespace tmv {
         }
     }
 
+    template <bool add, class T, class Ta, class Tb>
+    void BlockMultMM(
+        const T x, const GenMatrix<Ta>& A,
+        const GenMatrix<Tb>& B, MatrixView<T> C)
+    { BlockMultMM1<add>(false,x,A,B,C); }
+
+#ifdef _OPENMP
+    template <bool add, class T, class Ta, class Tb>
+    void ParallelBlockMultMM(
+        const T x, const GenMatrix<Ta>& A,
+        const GenMatrix<Tb>& B, MatrixView<T> C)
+    { BlockMultMM1<add>(true,x,A,B,C); }
+#endif
+
 #ifdef BLAS
 #define INST_SKIP_BLAS
 #endif
@@ -32,6 +32,13 @@
 #include "xmmintrin.h"
 #endif
 
+// The AVX2 and AVX-512 kernels are selected at runtime.  
+// See TMV_SIMD.h.
+#include "TMV_SIMD.h"
+#ifdef TMV_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
 namespace tmv {
 
     // First the generic implementations for any type T.
@@ -3363,6 +3370,663 @@ namespace tmv {
 #endif
 
 #endif
+
+#ifdef TMV_SIMD_DISPATCH
+    //
+    // AVX2/FMA and AVX-512 kernels for float and double.
+    //
+    // These are compiled with the target attribute, so they are always
+    // available, regardless of the -m flags used for the rest of the 
+    // library.  BlockHelper checks GetSIMDLevel() at runtime to decide 
+    // whether they may be used.
+    //
+    // Unlike the SSE kernels above, these take M and N as runtime values
+    // (each <= 16), so the same function does all of the blocks.  
+    // The K values can be anything.  The last partial vector in each 
+    // row of A and column of B is read with a masked load, so the 
+    // padding at the end of the rows is never used.
+    //
+    // A is M x K, stored by rows with stride Ks.
+    // B is K x N, stored by columns with stride Ks.
+    // C is M x N, stored by columns with stride M.
+    // C += A * B
+    //
+    // The main loop does a 4 x NR block of C at a time, keeping 
+    // one vector accumulator for each element of C.  NR = 2 for AVX2 
+    // and 4 for AVX-512.  The horizontal sums of 4 accumulators in 
+    // the same column are done together, since they end up 
+    // contiguous in C.
+
+#define TMV_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define TMV_AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+
+#ifdef INST_DOUBLE
+    TMV_AVX2_TARGET
+    static inline __m256i avx2_mask_pd(const ptrdiff_t n)
+    {
+        // The first n lanes are on.
+        return _mm256_cmpgt_epi64(
+            _mm256_set1_epi64x(n),_mm256_set_epi64x(3,2,1,0));
+    }
+
+    TMV_AVX2_TARGET
+    static inline double avx2_hsum_pd(const __m256d x)
+    {
+        __m128d s = _mm_add_pd(
+            _mm256_castpd256_pd128(x),_mm256_extractf128_pd(x,1));
+        return _mm_cvtsd_f64(_mm_add_sd(s,_mm_unpackhi_pd(s,s)));
+    }
+
+    TMV_AVX2_TARGET
+    static inline void avx2_hsum4_pd(
+        const __m256d x0, const __m256d x1, const __m256d x2, 
+        const __m256d x3, double* C)
+    {
+        // C[i] += sum(xi) for i = 0..3
+        __m256d t0 = _mm256_hadd_pd(x0,x1);
+        __m256d t1 = _mm256_hadd_pd(x2,x3);
+        __m256d s = _mm256_add_pd(
+            _mm256_permute2f128_pd(t0,t1,0x20),
+            _mm256_permute2f128_pd(t0,t1,0x31));
+        _mm256_storeu_pd(C,_mm256_add_pd(_mm256_loadu_pd(C),s));
+    }
+
+    TMV_AVX2_TARGET
+    static inline double avx2_dot_pd(
+        const ptrdiff_t Kv, const ptrdiff_t Kr, const __m256i mask,
+        const double* A, const double* B)
+    {
+        __m256d c0 = _mm256_setzero_pd();
+        for(ptrdiff_t k=0;k<Kv;k+=4)
+            c0 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(A+k),_mm256_loadu_pd(B+k),c0);
+        if (Kr)
+            c0 = _mm256_fmadd_pd(
+                _mm256_maskload_pd(A+Kv,mask),
+                _mm256_maskload_pd(B+Kv,mask),c0);
+        return avx2_hsum_pd(c0);
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_multmm(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K, 
+        const ptrdiff_t Ks, const double* A, const double* B, double* C)
+    {
+        const ptrdiff_t Kv = (K>>2)<<2; // = K/4*4
+        const ptrdiff_t Kr = K-Kv; // = K%4
+        const __m256i mask = avx2_mask_pd(Kr);
+        const ptrdiff_t M4 = (M>>2)<<2; // = M/4*4
+        const ptrdiff_t N2 = (N>>1)<<1; // = N/2*2
+
+        ptrdiff_t i,j,k;
+        for(j=0;j<N2;j+=2) {
+            const double* B0 = B + j*Ks;
+            const double* B1 = B0 + Ks;
+            double* C0 = C + j*M;
+            double* C1 = C0 + M;
+            for(i=0;i<M4;i+=4) {
+                const double* A0 = A + i*Ks;
+                const double* A1 = A0 + Ks;
+                const double* A2 = A1 + Ks;
+                const double* A3 = A2 + Ks;
+                __m256d c00 = _mm256_setzero_pd();
+                __m256d c10 = _mm256_setzero_pd();
+                __m256d c20 = _mm256_setzero_pd();
+                __m256d c30 = _mm256_setzero_pd();
+                __m256d c01 = _mm256_setzero_pd();
+                __m256d c11 = _mm256_setzero_pd();
+                __m256d c21 = _mm256_setzero_pd();
+                __m256d c31 = _mm256_setzero_pd();
+                __m256d a0,a1,a2,a3,b;
+                for(k=0;k<Kv;k+=4) {
+                    a0 = _mm256_loadu_pd(A0+k);
+                    a1 = _mm256_loadu_pd(A1+k);
+                    a2 = _mm256_loadu_pd(A2+k);
+                    a3 = _mm256_loadu_pd(A3+k);
+                    b = _mm256_loadu_pd(B0+k);
+                    c00 = _mm256_fmadd_pd(a0,b,c00);
+                    c10 = _mm256_fmadd_pd(a1,b,c10);
+                    c20 = _mm256_fmadd_pd(a2,b,c20);
+                    c30 = _mm256_fmadd_pd(a3,b,c30);
+                    b = _mm256_loadu_pd(B1+k);
+                    c01 = _mm256_fmadd_pd(a0,b,c01);
+                    c11 = _mm256_fmadd_pd(a1,b,c11);
+                    c21 = _mm256_fmadd_pd(a2,b,c21);
+                    c31 = _mm256_fmadd_pd(a3,b,c31);
+                }
+                if (Kr) {
+                    a0 = _mm256_maskload_pd(A0+Kv,mask);
+                    a1 = _mm256_maskload_pd(A1+Kv,mask);
+                    a2 = _mm256_maskload_pd(A2+Kv,mask);
+                    a3 = _mm256_maskload_pd(A3+Kv,mask);
+                    b = _mm256_maskload_pd(B0+Kv,mask);
+                    c00 = _mm256_fmadd_pd(a0,b,c00);
+                    c10 = _mm256_fmadd_pd(a1,b,c10);
+                    c20 = _mm256_fmadd_pd(a2,b,c20);
+                    c30 = _mm256_fmadd_pd(a3,b,c30);
+                    b = _mm256_maskload_pd(B1+Kv,mask);
+                    c01 = _mm256_fmadd_pd(a0,b,c01);
+                    c11 = _mm256_fmadd_pd(a1,b,c11);
+                    c21 = _mm256_fmadd_pd(a2,b,c21);
+                    c31 = _mm256_fmadd_pd(a3,b,c31);
+                }
+                avx2_hsum4_pd(c00,c10,c20,c30,C0+i);
+                avx2_hsum4_pd(c01,c11,c21,c31,C1+i);
+            }
+            for(;i<M;++i) {
+                C0[i] += avx2_dot_pd(Kv,Kr,mask,A+i*Ks,B0);
+                C1[i] += avx2_dot_pd(Kv,Kr,mask,A+i*Ks,B1);
+            }
+        }
+        if (N2 < N) {
+            const double* B0 = B + N2*Ks;
+            double* C0 = C + N2*M;
+            for(i=0;i<M;++i) 
+                C0[i] += avx2_dot_pd(Kv,Kr,mask,A+i*Ks,B0);
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static inline void avx512_hsum4_pd(
+        const __m512d x0, const __m512d x1, const __m512d x2, 
+        const __m512d x3, double* C)
+    {
+        avx2_hsum4_pd(
+            _mm256_add_pd(_mm512_castpd512_pd256(x0),
+                          _mm512_extractf64x4_pd(x0,1)),
+            _mm256_add_pd(_mm512_castpd512_pd256(x1),
+                          _mm512_extractf64x4_pd(x1,1)),
+            _mm256_add_pd(_mm512_castpd512_pd256(x2),
+                          _mm512_extractf64x4_pd(x2,1)),
+            _mm256_add_pd(_mm512_castpd512_pd256(x3),
+                          _mm512_extractf64x4_pd(x3,1)),C);
+    }
+
+    TMV_AVX512_TARGET
+    static inline double avx512_dot_pd(
+        const ptrdiff_t Kv, const ptrdiff_t Kr, const __mmask8 mask,
+        const double* A, const double* B)
+    {
+        __m512d c0 = _mm512_setzero_pd();
+        for(ptrdiff_t k=0;k<Kv;k+=8)
+            c0 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(A+k),_mm512_loadu_pd(B+k),c0);
+        if (Kr)
+            c0 = _mm512_fmadd_pd(
+                _mm512_maskz_loadu_pd(mask,A+Kv),
+                _mm512_maskz_loadu_pd(mask,B+Kv),c0);
+        return avx2_hsum_pd(
+            _mm256_add_pd(_mm512_castpd512_pd256(c0),
+                          _mm512_extractf64x4_pd(c0,1)));
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_multmm(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K, 
+        const ptrdiff_t Ks, const double* A, const double* B, double* C)
+    {
+        const ptrdiff_t Kv = (K>>3)<<3; // = K/8*8
+        const ptrdiff_t Kr = K-Kv; // = K%8
+        const __mmask8 mask = __mmask8((1<<Kr)-1);
+        const ptrdiff_t M4 = (M>>2)<<2; // = M/4*4
+        const ptrdiff_t N4 = (N>>2)<<2; // = N/4*4
+
+        ptrdiff_t i,j,k;
+        for(j=0;j<N4;j+=4) {
+            const double* B0 = B + j*Ks;
+            const double* B1 = B0 + Ks;
+            const double* B2 = B1 + Ks;
+            const double* B3 = B2 + Ks;
+            double* C0 = C + j*M;
+            double* C1 = C0 + M;
+            double* C2 = C1 + M;
+            double* C3 = C2 + M;
+            for(i=0;i<M4;i+=4) {
+                const double* A0 = A + i*Ks;
+                const double* A1 = A0 + Ks;
+                const double* A2 = A1 + Ks;
+                const double* A3 = A2 + Ks;
+                __m512d c00 = _mm512_setzero_pd();
+                __m512d c10 = _mm512_setzero_pd();
+                __m512d c20 = _mm512_setzero_pd();
+                __m512d c30 = _mm512_setzero_pd();
+                __m512d c01 = _mm512_setzero_pd();
+                __m512d c11 = _mm512_setzero_pd();
+                __m512d c21 = _mm512_setzero_pd();
+                __m512d c31 = _mm512_setzero_pd();
+                __m512d c02 = _mm512_setzero_pd();
+                __m512d c12 = _mm512_setzero_pd();
+                __m512d c22 = _mm512_setzero_pd();
+                __m512d c32 = _mm512_setzero_pd();
+                __m512d c03 = _mm512_setzero_pd();
+                __m512d c13 = _mm512_setzero_pd();
+                __m512d c23 = _mm512_setzero_pd();
+                __m512d c33 = _mm512_setzero_pd();
+                __m512d a0,a1,a2,a3,b;
+                for(k=0;k<Kv;k+=8) {
+                    a0 = _mm512_loadu_pd(A0+k);
+                    a1 = _mm512_loadu_pd(A1+k);
+                    a2 = _mm512_loadu_pd(A2+k);
+                    a3 = _mm512_loadu_pd(A3+k);
+                    b = _mm512_loadu_pd(B0+k);
+                    c00 = _mm512_fmadd_pd(a0,b,c00);
+                    c10 = _mm512_fmadd_pd(a1,b,c10);
+                    c20 = _mm512_fmadd_pd(a2,b,c20);
+                    c30 = _mm512_fmadd_pd(a3,b,c30);
+                    b = _mm512_loadu_pd(B1+k);
+                    c01 = _mm512_fmadd_pd(a0,b,c01);
+                    c11 = _mm512_fmadd_pd(a1,b,c11);
+                    c21 = _mm512_fmadd_pd(a2,b,c21);
+                    c31 = _mm512_fmadd_pd(a3,b,c31);
+                    b = _mm512_loadu_pd(B2+k);
+                    c02 = _mm512_fmadd_pd(a0,b,c02);
+                    c12 = _mm512_fmadd_pd(a1,b,c12);
+                    c22 = _mm512_fmadd_pd(a2,b,c22);
+                    c32 = _mm512_fmadd_pd(a3,b,c32);
+                    b = _mm512_loadu_pd(B3+k);
+                    c03 = _mm512_fmadd_pd(a0,b,c03);
+                    c13 = _mm512_fmadd_pd(a1,b,c13);
+                    c23 = _mm512_fmadd_pd(a2,b,c23);
+                    c33 = _mm512_fmadd_pd(a3,b,c33);
+                }
+                if (Kr) {
+                    a0 = _mm512_maskz_loadu_pd(mask,A0+Kv);
+                    a1 = _mm512_maskz_loadu_pd(mask,A1+Kv);
+                    a2 = _mm512_maskz_loadu_pd(mask,A2+Kv);
+                    a3 = _mm512_maskz_loadu_pd(mask,A3+Kv);
+                    b = _mm512_maskz_loadu_pd(mask,B0+Kv);
+                    c00 = _mm512_fmadd_pd(a0,b,c00);
+                    c10 = _mm512_fmadd_pd(a1,b,c10);
+                    c20 = _mm512_fmadd_pd(a2,b,c20);
+                    c30 = _mm512_fmadd_pd(a3,b,c30);
+                    b = _mm512_maskz_loadu_pd(mask,B1+Kv);
+                    c01 = _mm512_fmadd_pd(a0,b,c01);
+                    c11 = _mm512_fmadd_pd(a1,b,c11);
+                    c21 = _mm512_fmadd_pd(a2,b,c21);
+                    c31 = _mm512_fmadd_pd(a3,b,c31);
+                    b = _mm512_maskz_loadu_pd(mask,B2+Kv);
+                    c02 = _mm512_fmadd_pd(a0,b,c02);
+                    c12 = _mm512_fmadd_pd(a1,b,c12);
+                    c22 = _mm512_fmadd_pd(a2,b,c22);
+                    c32 = _mm512_fmadd_pd(a3,b,c32);
+                    b = _mm512_maskz_loadu_pd(mask,B3+Kv);
+                    c03 = _mm512_fmadd_pd(a0,b,c03);
+                    c13 = _mm512_fmadd_pd(a1,b,c13);
+                    c23 = _mm512_fmadd_pd(a2,b,c23);
+                    c33 = _mm512_fmadd_pd(a3,b,c33);
+                }
+                avx512_hsum4_pd(c00,c10,c20,c30,C0+i);
+                avx512_hsum4_pd(c01,c11,c21,c31,C1+i);
+                avx512_hsum4_pd(c02,c12,c22,c32,C2+i);
+                avx512_hsum4_pd(c03,c13,c23,c33,C3+i);
+            }
+            for(;i<M;++i) {
+                const double* Ai = A + i*Ks;
+                C0[i] += avx512_dot_pd(Kv,Kr,mask,Ai,B0);
+                C1[i] += avx512_dot_pd(Kv,Kr,mask,Ai,B1);
+                C2[i] += avx512_dot_pd(Kv,Kr,mask,Ai,B2);
+                C3[i] += avx512_dot_pd(Kv,Kr,mask,Ai,B3);
+            }
+        }
+        for(;j<N;++j) {
+            const double* B0 = B + j*Ks;
+            double* C0 = C + j*M;
+            for(i=0;i<M;++i) 
+                C0[i] += avx512_dot_pd(Kv,Kr,mask,A+i*Ks,B0);
+        }
+    }
+
+    // The versions with the KernelMultMMFunc signature.
+    // For the full K blocks, the stride is K.  For the cleanup block,
+    // the stride is K rounded up to a multiple of 2 (cf. 
+    // BlockHelper<double>::RoundUp).
+    static void avx2_multmm_block(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const double* A0, const double* B0, double* C0)
+    { avx2_multmm(M,N,K,K,A0,B0,C0); }
+
+    static void avx2_multmm_cleanup(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const double* A0, const double* B0, double* C0)
+    {
+        const ptrdiff_t Kd = (((K-1)>>1)+1)<<1;
+        avx2_multmm(M,N,K,Kd,A0,B0,C0); 
+    }
+
+    static void avx512_multmm_block(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const double* A0, const double* B0, double* C0)
+    { avx512_multmm(M,N,K,K,A0,B0,C0); }
+
+    static void avx512_multmm_cleanup(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const double* A0, const double* B0, double* C0)
+    {
+        const ptrdiff_t Kd = (((K-1)>>1)+1)<<1;
+        avx512_multmm(M,N,K,Kd,A0,B0,C0); 
+    }
+#endif
+
+#ifdef INST_FLOAT
+    TMV_AVX2_TARGET
+    static inline __m256i avx2_mask_ps(const ptrdiff_t n)
+    {
+        // The first n lanes are on.
+        return _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(int(n)),_mm256_set_epi32(7,6,5,4,3,2,1,0));
+    }
+
+    TMV_AVX2_TARGET
+    static inline __m128 avx2_half_ps(const __m256 x)
+    {
+        return _mm_add_ps(
+            _mm256_castps256_ps128(x),_mm256_extractf128_ps(x,1));
+    }
+
+    TMV_AVX2_TARGET
+    static inline float avx2_hsum_ps(const __m256 x)
+    {
+        __m128 s = avx2_half_ps(x);
+        s = _mm_hadd_ps(s,s);
+        s = _mm_hadd_ps(s,s);
+        return _mm_cvtss_f32(s);
+    }
+
+    TMV_AVX2_TARGET
+    static inline void avx2_hsum4_ps(
+        const __m128 x0, const __m128 x1, const __m128 x2, 
+        const __m128 x3, float* C)
+    {
+        // C[i] += sum(xi) for i = 0..3
+        __m128 s = _mm_hadd_ps(_mm_hadd_ps(x0,x1),_mm_hadd_ps(x2,x3));
+        _mm_storeu_ps(C,_mm_add_ps(_mm_loadu_ps(C),s));
+    }
+
+    TMV_AVX2_TARGET
+    static inline float avx2_dot_ps(
+        const ptrdiff_t Kv, const ptrdiff_t Kr, const __m256i mask,
+        const float* A, const float* B)
+    {
+        __m256 c0 = _mm256_setzero_ps();
+        for(ptrdiff_t k=0;k<Kv;k+=8)
+            c0 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(A+k),_mm256_loadu_ps(B+k),c0);
+        if (Kr)
+            c0 = _mm256_fmadd_ps(
+                _mm256_maskload_ps(A+Kv,mask),
+                _mm256_maskload_ps(B+Kv,mask),c0);
+        return avx2_hsum_ps(c0);
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_multmm(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K, 
+        const ptrdiff_t Ks, const float* A, const float* B, float* C)
+    {
+        const ptrdiff_t Kv = (K>>3)<<3; // = K/8*8
+        const ptrdiff_t Kr = K-Kv; // = K%8
+        const __m256i mask = avx2_mask_ps(Kr);
+        const ptrdiff_t M4 = (M>>2)<<2; // = M/4*4
+        const ptrdiff_t N2 = (N>>1)<<1; // = N/2*2
+
+        ptrdiff_t i,j,k;
+        for(j=0;j<N2;j+=2) {
+            const float* B0 = B + j*Ks;
+            const float* B1 = B0 + Ks;
+            float* C0 = C + j*M;
+            float* C1 = C0 + M;
+            for(i=0;i<M4;i+=4) {
+                const float* A0 = A + i*Ks;
+                const float* A1 = A0 + Ks;
+                const float* A2 = A1 + Ks;
+                const float* A3 = A2 + Ks;
+                __m256 c00 = _mm256_setzero_ps();
+                __m256 c10 = _mm256_setzero_ps();
+                __m256 c20 = _mm256_setzero_ps();
+                __m256 c30 = _mm256_setzero_ps();
+                __m256 c01 = _mm256_setzero_ps();
+                __m256 c11 = _mm256_setzero_ps();
+                __m256 c21 = _mm256_setzero_ps();
+                __m256 c31 = _mm256_setzero_ps();
+                __m256 a0,a1,a2,a3,b;
+                for(k=0;k<Kv;k+=8) {
+                    a0 = _mm256_loadu_ps(A0+k);
+                    a1 = _mm256_loadu_ps(A1+k);
+                    a2 = _mm256_loadu_ps(A2+k);
+                    a3 = _mm256_loadu_ps(A3+k);
+                    b = _mm256_loadu_ps(B0+k);
+                    c00 = _mm256_fmadd_ps(a0,b,c00);
+                    c10 = _mm256_fmadd_ps(a1,b,c10);
+                    c20 = _mm256_fmadd_ps(a2,b,c20);
+                    c30 = _mm256_fmadd_ps(a3,b,c30);
+                    b = _mm256_loadu_ps(B1+k);
+                    c01 = _mm256_fmadd_ps(a0,b,c01);
+                    c11 = _mm256_fmadd_ps(a1,b,c11);
+                    c21 = _mm256_fmadd_ps(a2,b,c21);
+                    c31 = _mm256_fmadd_ps(a3,b,c31);
+                }
+                if (Kr) {
+                    a0 = _mm256_maskload_ps(A0+Kv,mask);
+                    a1 = _mm256_maskload_ps(A1+Kv,mask);
+                    a2 = _mm256_maskload_ps(A2+Kv,mask);
+                    a3 = _mm256_maskload_ps(A3+Kv,mask);
+                    b = _mm256_maskload_ps(B0+Kv,mask);
+                    c00 = _mm256_fmadd_ps(a0,b,c00);
+                    c10 = _mm256_fmadd_ps(a1,b,c10);
+                    c20 = _mm256_fmadd_ps(a2,b,c20);
+                    c30 = _mm256_fmadd_ps(a3,b,c30);
+                    b = _mm256_maskload_ps(B1+Kv,mask);
+                    c01 = _mm256_fmadd_ps(a0,b,c01);
+                    c11 = _mm256_fmadd_ps(a1,b,c11);
+                    c21 = _mm256_fmadd_ps(a2,b,c21);
+                    c31 = _mm256_fmadd_ps(a3,b,c31);
+                }
+                avx2_hsum4_ps(
+                    avx2_half_ps(c00),avx2_half_ps(c10),
+                    avx2_half_ps(c20),avx2_half_ps(c30),C0+i);
+                avx2_hsum4_ps(
+                    avx2_half_ps(c01),avx2_half_ps(c11),
+                    avx2_half_ps(c21),avx2_half_ps(c31),C1+i);
+            }
+            for(;i<M;++i) {
+                C0[i] += avx2_dot_ps(Kv,Kr,mask,A+i*Ks,B0);
+                C1[i] += avx2_dot_ps(Kv,Kr,mask,A+i*Ks,B1);
+            }
+        }
+        if (N2 < N) {
+            const float* B0 = B + N2*Ks;
+            float* C0 = C + N2*M;
+            for(i=0;i<M;++i) 
+                C0[i] += avx2_dot_ps(Kv,Kr,mask,A+i*Ks,B0);
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static inline __m128 avx512_quarter_ps(const __m512 x)
+    {
+        // Sum the four 128 bit lanes of x.
+        __m256 h = _mm256_add_ps(
+            _mm512_castps512_ps256(x),
+            _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(x),1)));
+        return avx2_half_ps(h);
+    }
+
+    TMV_AVX512_TARGET
+    static inline float avx512_dot_ps(
+        const ptrdiff_t Kv, const ptrdiff_t Kr, const __mmask16 mask,
+        const float* A, const float* B)
+    {
+        __m512 c0 = _mm512_setzero_ps();
+        for(ptrdiff_t k=0;k<Kv;k+=16)
+            c0 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(A+k),_mm512_loadu_ps(B+k),c0);
+        if (Kr)
+            c0 = _mm512_fmadd_ps(
+                _mm512_maskz_loadu_ps(mask,A+Kv),
+                _mm512_maskz_loadu_ps(mask,B+Kv),c0);
+        __m128 s = avx512_quarter_ps(c0);
+        s = _mm_hadd_ps(s,s);
+        s = _mm_hadd_ps(s,s);
+        return _mm_cvtss_f32(s);
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_multmm(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K, 
+        const ptrdiff_t Ks, const float* A, const float* B, float* C)
+    {
+        const ptrdiff_t Kv = (K>>4)<<4; // = K/16*16
+        const ptrdiff_t Kr = K-Kv; // = K%16
+        const __mmask16 mask = __mmask16((1<<Kr)-1);
+        const ptrdiff_t M4 = (M>>2)<<2; // = M/4*4
+        const ptrdiff_t N4 = (N>>2)<<2; // = N/4*4
+
+        ptrdiff_t i,j,k;
+        for(j=0;j<N4;j+=4) {
+            const float* B0 = B + j*Ks;
+            const float* B1 = B0 + Ks;
+            const float* B2 = B1 + Ks;
+            const float* B3 = B2 + Ks;
+            float* C0 = C + j*M;
+            float* C1 = C0 + M;
+            float* C2 = C1 + M;
+            float* C3 = C2 + M;
+            for(i=0;i<M4;i+=4) {
+                const float* A0 = A + i*Ks;
+                const float* A1 = A0 + Ks;
+                const float* A2 = A1 + Ks;
+                const float* A3 = A2 + Ks;
+                __m512 c00 = _mm512_setzero_ps();
+                __m512 c10 = _mm512_setzero_ps();
+                __m512 c20 = _mm512_setzero_ps();
+                __m512 c30 = _mm512_setzero_ps();
+                __m512 c01 = _mm512_setzero_ps();
+                __m512 c11 = _mm512_setzero_ps();
+                __m512 c21 = _mm512_setzero_ps();
+                __m512 c31 = _mm512_setzero_ps();
+                __m512 c02 = _mm512_setzero_ps();
+                __m512 c12 = _mm512_setzero_ps();
+                __m512 c22 = _mm512_setzero_ps();
+                __m512 c32 = _mm512_setzero_ps();
+                __m512 c03 = _mm512_setzero_ps();
+                __m512 c13 = _mm512_setzero_ps();
+                __m512 c23 = _mm512_setzero_ps();
+                __m512 c33 = _mm512_setzero_ps();
+                __m512 a0,a1,a2,a3,b;
+                for(k=0;k<Kv;k+=16) {
+                    a0 = _mm512_loadu_ps(A0+k);
+                    a1 = _mm512_loadu_ps(A1+k);
+                    a2 = _mm512_loadu_ps(A2+k);
+                    a3 = _mm512_loadu_ps(A3+k);
+                    b = _mm512_loadu_ps(B0+k);
+                    c00 = _mm512_fmadd_ps(a0,b,c00);
+                    c10 = _mm512_fmadd_ps(a1,b,c10);
+                    c20 = _mm512_fmadd_ps(a2,b,c20);
+                    c30 = _mm512_fmadd_ps(a3,b,c30);
+                    b = _mm512_loadu_ps(B1+k);
+                    c01 = _mm512_fmadd_ps(a0,b,c01);
+                    c11 = _mm512_fmadd_ps(a1,b,c11);
+                    c21 = _mm512_fmadd_ps(a2,b,c21);
+                    c31 = _mm512_fmadd_ps(a3,b,c31);
+                    b = _mm512_loadu_ps(B2+k);
+                    c02 = _mm512_fmadd_ps(a0,b,c02);
+                    c12 = _mm512_fmadd_ps(a1,b,c12);
+                    c22 = _mm512_fmadd_ps(a2,b,c22);
+                    c32 = _mm512_fmadd_ps(a3,b,c32);
+                    b = _mm512_loadu_ps(B3+k);
+                    c03 = _mm512_fmadd_ps(a0,b,c03);
+                    c13 = _mm512_fmadd_ps(a1,b,c13);
+                    c23 = _mm512_fmadd_ps(a2,b,c23);
+                    c33 = _mm512_fmadd_ps(a3,b,c33);
+                }
+                if (Kr) {
+                    a0 = _mm512_maskz_loadu_ps(mask,A0+Kv);
+                    a1 = _mm512_maskz_loadu_ps(mask,A1+Kv);
+                    a2 = _mm512_maskz_loadu_ps(mask,A2+Kv);
+                    a3 = _mm512_maskz_loadu_ps(mask,A3+Kv);
+                    b = _mm512_maskz_loadu_ps(mask,B0+Kv);
+                    c00 = _mm512_fmadd_ps(a0,b,c00);
+                    c10 = _mm512_fmadd_ps(a1,b,c10);
+                    c20 = _mm512_fmadd_ps(a2,b,c20);
+                    c30 = _mm512_fmadd_ps(a3,b,c30);
+                    b = _mm512_maskz_loadu_ps(mask,B1+Kv);
+                    c01 = _mm512_fmadd_ps(a0,b,c01);
+                    c11 = _mm512_fmadd_ps(a1,b,c11);
+                    c21 = _mm512_fmadd_ps(a2,b,c21);
+                    c31 = _mm512_fmadd_ps(a3,b,c31);
+                    b = _mm512_maskz_loadu_ps(mask,B2+Kv);
+                    c02 = _mm512_fmadd_ps(a0,b,c02);
+                    c12 = _mm512_fmadd_ps(a1,b,c12);
+                    c22 = _mm512_fmadd_ps(a2,b,c22);
+                    c32 = _mm512_fmadd_ps(a3,b,c32);
+                    b = _mm512_maskz_loadu_ps(mask,B3+Kv);
+                    c03 = _mm512_fmadd_ps(a0,b,c03);
+                    c13 = _mm512_fmadd_ps(a1,b,c13);
+                    c23 = _mm512_fmadd_ps(a2,b,c23);
+                    c33 = _mm512_fmadd_ps(a3,b,c33);
+                }
+                avx2_hsum4_ps(
+                    avx512_quarter_ps(c00),avx512_quarter_ps(c10),
+                    avx512_quarter_ps(c20),avx512_quarter_ps(c30),C0+i);
+                avx2_hsum4_ps(
+                    avx512_quarter_ps(c01),avx512_quarter_ps(c11),
+                    avx512_quarter_ps(c21),avx512_quarter_ps(c31),C1+i);
+                avx2_hsum4_ps(
+                    avx512_quarter_ps(c02),avx512_quarter_ps(c12),
+                    avx512_quarter_ps(c22),avx512_quarter_ps(c32),C2+i);
+                avx2_hsum4_ps(
+                    avx512_quarter_ps(c03),avx512_quarter_ps(c13),
+                    avx512_quarter_ps(c23),avx512_quarter_ps(c33),C3+i);
+            }
+            for(;i<M;++i) {
+                const float* Ai = A + i*Ks;
+                C0[i] += avx512_dot_ps(Kv,Kr,mask,Ai,B0);
+                C1[i] += avx512_dot_ps(Kv,Kr,mask,Ai,B1);
+                C2[i] += avx512_dot_ps(Kv,Kr,mask,Ai,B2);
+                C3[i] += avx512_dot_ps(Kv,Kr,mask,Ai,B3);
+            }
+        }
+        for(;j<N;++j) {
+            const float* B0 = B + j*Ks;
+            float* C0 = C + j*M;
+            for(i=0;i<M;++i) 
+                C0[i] += avx512_dot_ps(Kv,Kr,mask,A+i*Ks,B0);
+        }
+    }
+
+    // For the cleanup block, the stride is K rounded up to a multiple 
+    // of 4 (cf. BlockHelper<float>::RoundUp).
+    static void avx2_multmm_block(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const float* A0, const float* B0, float* C0)
+    { avx2_multmm(M,N,K,K,A0,B0,C0); }
+
+    static void avx2_multmm_cleanup(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const float* A0, const float* B0, float* C0)
+    {
+        const ptrdiff_t Kd = (((K-1)>>2)+1)<<2;
+        avx2_multmm(M,N,K,Kd,A0,B0,C0); 
+    }
+
+    static void avx512_multmm_block(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const float* A0, const float* B0, float* C0)
+    { avx512_multmm(M,N,K,K,A0,B0,C0); }
+
+    static void avx512_multmm_cleanup(
+        const ptrdiff_t M, const ptrdiff_t N, const ptrdiff_t K,
+        const float* A0, const float* B0, float* C0)
+    {
+        const ptrdiff_t Kd = (((K-1)>>2)+1)<<2;
+        avx512_multmm(M,N,K,Kd,A0,B0,C0); 
+    }
+#endif
+
+#undef TMV_AVX2_TARGET
+#undef TMV_AVX512_TARGET
+
+#endif // TMV_SIMD_DISPATCH
 #endif
 
 #ifdef INST_INT
@@ -24,45 +24,109 @@
 
 #include "TMV_Blas.h"
 #include "TMV_MultMM.h"
+#include "tmv/TMV_MatrixArith.h"
 #include <omp.h>
+#include <cmath>
 
 namespace tmv {
 
+    // Round x up to a multiple of 16
+    static inline ptrdiff_t RoundUp16(ptrdiff_t x)
+    { return (((x-1)>>4)+1)<<4; }
+
     template <bool add, class T, class Ta, class Tb> 
     void OpenMPMultMM(
         const T x, const GenMatrix<Ta>& A, const GenMatrix<Tb>& B,
         MatrixView<T> C)
     {
+        // Normally, this is just BlockMultMM with its block loops split
+        // among the threads.  One of A or B is packed once into the 
+        // block format and shared by all the threads, and each thread 
+        // packs only the blocks of the other one that it is using.
+        //
+        // However, when K is much larger than M and N, there are not 
+        // enough blocks of C to keep the threads busy.  So if C has fewer
+        // tiles of at least 64 on a side (and about 4 per thread) than 
+        // there are threads, we also split the calculation along K.  
+        // Each thread accumulates its K chunks into its own temporary C,
+        // and these are summed at the end.
         const ptrdiff_t M = C.colsize();
         const ptrdiff_t N = C.rowsize();
+        const ptrdiff_t K = A.rowsize();
+        const ptrdiff_t nthreads = omp_get_max_threads();
+
+        if (nthreads == 1) {
+            BlockMultMM<add>(x,A,B,C);
+            return;
+        }
+
+        const double area = double(M)*double(N)/double(4*nthreads);
+        ptrdiff_t TM, TN;
+        if (M <= N) {
+            TM = TMV_MIN(M,TMV_MAX(ptrdiff_t(64),
+                         RoundUp16(ptrdiff_t(std::sqrt(area)))));
+            TN = TMV_MIN(N,TMV_MAX(ptrdiff_t(64),
+                         RoundUp16(ptrdiff_t(area/TM))));
+        } else {
+            TN = TMV_MIN(N,TMV_MAX(ptrdiff_t(64),
+                         RoundUp16(ptrdiff_t(std::sqrt(area)))));
+            TM = TMV_MIN(M,TMV_MAX(ptrdiff_t(64),
+                         RoundUp16(ptrdiff_t(area/TN))));
+        }
+        const ptrdiff_t mt = (M-1)/TM+1;
+        const ptrdiff_t nt = (N-1)/TN+1;
+        const ptrdiff_t ntiles = mt*nt;
+
+        // Split K if there are fewer tiles than threads, but keep the 
+        // K chunks at least 256 long.
+        ptrdiff_t nk = 1;
+        if (ntiles < nthreads) {
+            nk = TMV_MIN((nthreads-1)/ntiles+1, K/256);
+            if (nk < 1) nk = 1;
+        }
+        const ptrdiff_t TK = (K-1)/nk+1;
+        const ptrdiff_t nwork = ntiles*nk;
 
+#ifdef __PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
+        if (nk == 1) {
+            ParallelBlockMultMM<add>(x,A,B,C);
+        } else {
+            if (!add) C.setZero();
 #pragma omp parallel
-        {
-            ptrdiff_t num_threads = omp_get_num_threads();
-            ptrdiff_t mythread = omp_get_thread_num();
-            if (num_threads == 1) {
-                BlockMultMM<add>(x,A,B,C);
-            } else if (M > N) {
-                ptrdiff_t Mx = M / num_threads;
-                Mx = ((((Mx-1)>>4)+1)<<4); // round up to mult of 16
-                ptrdiff_t i1 = mythread * Mx;
-                ptrdiff_t i2 = (mythread+1) * Mx;
-                if (i2 > M || mythread == num_threads-1) i2 = M;
-                if (i1 < M) {
-                    // Need to make sure, since we rounded up Mx!
-                    BlockMultMM<add>(x,A.rowRange(i1,i2),B,C.rowRange(i1,i2));
+            {
+                // Only allocated if this thread gets any work.
+                Matrix<T,ColMajor>* Ct = 0;
+#pragma omp for schedule(dynamic)
+                for(TMV_INT_OMP w=0;w<nwork;++w) {
+                    const ptrdiff_t tile = w%ntiles;
+                    const ptrdiff_t i1 = (tile%mt)*TM;
+                    const ptrdiff_t i2 = TMV_MIN(i1+TM,M);
+                    const ptrdiff_t j1 = (tile/mt)*TN;
+                    const ptrdiff_t j2 = TMV_MIN(j1+TN,N);
+                    const ptrdiff_t k1 = (w/ntiles)*TK;
+                    const ptrdiff_t k2 = TMV_MIN(k1+TK,K);
+                    if (k1 < k2) {
+                        if (!Ct) Ct = new Matrix<T,ColMajor>(M,N,T(0));
+                        BlockMultMM<true>(
+                            x,A.subMatrix(i1,i2,k1,k2),
+                            B.subMatrix(k1,k2,j1,j2),
+                            Ct->subMatrix(i1,i2,j1,j2));
+                    }
                 }
-            } else {
-                ptrdiff_t Nx = N / num_threads;
-                Nx = ((((Nx-1)>>4)+1)<<4); 
-                ptrdiff_t j1 = mythread * Nx;
-                ptrdiff_t j2 = (mythread+1) * Nx;
-                if (j2 > N || mythread == num_threads-1) j2 = N;
-                if (j1 < N) {
-                    BlockMultMM<add>(x,A,B.colRange(j1,j2),C.colRange(j1,j2));
+                if (Ct) {
+#pragma omp critical
+                    {
+                        C += *Ct;
+                    }
+                    delete Ct;
                 }
             }
         }
+#undef TMV_INT_OMP
     }
 
 #ifdef BLAS
@@ -23,6 +23,7 @@
 //#define XDEBUG
 
 #include "TMV_Blas.h"
+#include "TMV_SIMD.h"
 #include "tmv/TMV_MatrixArithFunc.h"
 #include "TMV_MultMV.h"
 #include "tmv/TMV_Matrix.h"
@@ -180,6 +181,73 @@ namespace tmv {
         }
     }
 
+#ifdef TMV_SIMD_DISPATCH
+    // For real double and float with a row or column major A, we can
+    // use the SIMD kernels (see TMV_SIMD.h).  Each row of a row major A 
+    // is a dot product with x, and each column of a column major A is
+    // added to y.  These return false if the kernels can't be used.
+    template <class T, class Ta, class Tx> 
+    static inline bool SIMDMultMV(
+        bool , const GenMatrix<Ta>& , const GenVector<Tx>& , VectorView<T> )
+    { return false; }
+
+    template <class T> 
+    static bool DoSIMDMultMV(
+        bool add, const GenMatrix<T>& A, const GenVector<T>& x, 
+        VectorView<T> y)
+    {
+        TMVAssert(x.step() == 1);
+        TMVAssert(y.step() == 1);
+        TMVAssert(!SameStorage(x,y));
+
+        if (GetSIMDLevel() == SIMD_Baseline) return false;
+
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        const T* x0 = x.cptr();
+        T* y0 = y.ptr();
+
+        if (A.isrm()) {
+            const ptrdiff_t si = A.stepi();
+            const T* Ai0 = A.cptr();
+            for(ptrdiff_t i=0; i<M; ++i,Ai0+=si) {
+                const T temp = SIMD_MultVV(N,Ai0,x0);
+                if (add) y0[i] += temp;
+                else y0[i] = temp;
+            }
+            return true;
+        } else if (A.iscm()) {
+            const ptrdiff_t sj = A.stepj();
+            const T* A0j = A.cptr();
+            ptrdiff_t j=0;
+            if (!add) {
+                // As in ColMultMV, this works even if y is the same 
+                // storage as the first column of A.
+                if (*x0 == T(0)) y.setZero();
+                else for(ptrdiff_t i=0; i<M; ++i) y0[i] = *x0 * A0j[i];
+                ++j; A0j+=sj;
+            }
+            for(; j<N; ++j,A0j+=sj) 
+                if (x0[j] != T(0)) SIMD_AddVV(M,x0[j],A0j,y0);
+            return true;
+        } else {
+            return false;
+        }
+    }
+#ifdef INST_DOUBLE
+    static inline bool SIMDMultMV(
+        bool add, const GenMatrix<double>& A, const GenVector<double>& x, 
+        VectorView<double> y)
+    { return DoSIMDMultMV(add,A,x,y); }
+#endif
+#ifdef INST_FLOAT
+    static inline bool SIMDMultMV(
+        bool add, const GenMatrix<float>& A, const GenVector<float>& x, 
+        VectorView<float> y)
+    { return DoSIMDMultMV(add,A,x,y); }
+#endif
+#endif
+
     template <bool add, bool cx, class T, class Ta, class Tx> 
     void UnitAMultMV1(
         const GenMatrix<Ta>& A, const GenVector<Tx>& x, VectorView<T> y)
@@ -194,6 +262,10 @@ namespace tmv {
         TMVAssert(!SameStorage(x,y));
         TMVAssert(cx == x.isconj());
 
+#ifdef TMV_SIMD_DISPATCH
+        if (SIMDMultMV(add,A,x,y)) return;
+#endif
+
         if (A.isrm()) 
             if (A.isconj())
                 RowMultMV<add,cx,true,true>(A,x,y);
@@ -24,6 +24,7 @@
 
 
 #include "TMV_Blas.h"
+#include "TMV_SIMD.h"
 #include "tmv/TMV_VectorArithFunc.h"
 #include "tmv/TMV_Vector.h"
 
@@ -246,6 +247,30 @@ namespace tmv {
 #endif
 #endif // BLASNORETURN
 #endif // BLAS
+#ifdef TMV_SIMD_DISPATCH
+#ifdef INST_DOUBLE
+    template <> 
+    double DoMultVV(const GenVector<double>& v1, const GenVector<double>& v2) 
+    { 
+        if (v1.step() == 1 && v2.step() == 1)
+            if (GetSIMDLevel() != SIMD_Baseline)
+                return SIMD_MultVV(v1.size(),v1.cptr(),v2.cptr());
+            else return nonBlasMultVV<true,false>(v1,v2); 
+        else return nonBlasMultVV<false,false>(v1,v2); 
+    }
+#endif
+#ifdef INST_FLOAT
+    template <> 
+    float DoMultVV(const GenVector<float>& v1, const GenVector<float>& v2) 
+    { 
+        if (v1.step() == 1 && v2.step() == 1)
+            if (GetSIMDLevel() != SIMD_Baseline)
+                return SIMD_MultVV(v1.size(),v1.cptr(),v2.cptr());
+            else return nonBlasMultVV<true,false>(v1,v2); 
+        else return nonBlasMultVV<false,false>(v1,v2); 
+    }
+#endif
+#endif // TMV_SIMD_DISPATCH
 
     template <class T, class T2> 
     T MultVV(const GenVector<T>& v1, const GenVector<T2>& v2) 
@@ -33,6 +33,10 @@
 #include "tmv/TMV_VectorArith.h"
 #include "tmv/TMV_MatrixArith.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #include "tmv/TMV_MatrixArith.h"
 #include <iostream>
@@ -243,6 +247,214 @@ namespace tmv {
 #endif
     }
 
+    template <class T> 
+    static void SerialQRDecompose(
+        MatrixView<T> A, VectorView<T> beta, T& det)
+    {
+        if (A.rowsize() > QR_BLOCKSIZE)
+            BlockQRDecompose(A,beta,det);
+        else {
+            UpperTriMatrix<T,NonUnitDiag|ColMajor> Z(A.rowsize());
+            RecursiveQRDecompose(A,Z.view(),det,false);
+            beta = Z.diag().conjugate();
+        }
+    }
+
+#ifdef _OPENMP
+    template <class T> 
+    static void OpenMPBlockQRDecompose(
+        MatrixView<T> A, VectorView<T> beta, T& det)
+    {
+        // This is the same algorithm as BlockQRDecompose, but the update
+        // of the trailing matrix by each block Householder matrix is split
+        // into column blocks, each of which is a separate OpenMP task.
+        // The task that updates the next panel also decomposes it, so the
+        // next panel (which is on the critical path) is done while the 
+        // other threads are still working on the rest of the update.
+        // Since that means two Z matrices are in use at the same time, 
+        // we alternate between two of them.
+        TMVAssert(A.colsize() >= A.rowsize());
+        TMVAssert(A.rowsize() == beta.size());
+        TMVAssert(A.rowsize() > QR_BLOCKSIZE);
+        TMVAssert(A.ct() == NonConj);
+        TMVAssert(A.isrm() || A.iscm());
+        TMVAssert(beta.ct() == NonConj);
+        TMVAssert(beta.step()==1);
+
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        const ptrdiff_t NB = QR_BLOCKSIZE;
+
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> BaseZ0(NB);
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> BaseZ1(NB);
+        UpperTriMatrixView<T> BaseZ[2] = { BaseZ0.view(), BaseZ1.view() };
+
+        RecursiveQRDecompose(A.colRange(0,NB),BaseZ[0],det,true);
+        beta.subVector(0,NB) = BaseZ[0].diag().conjugate();
+
+#pragma omp parallel
+        {
+#pragma omp single
+            {
+                for(ptrdiff_t k1=0,kk=0;k1<N;k1+=NB,kk=1-kk) {
+                    const ptrdiff_t k2 = TMV_MIN(k1+NB,N);
+                    const ptrdiff_t k3 = TMV_MIN(k2+NB,N);
+                    for(ptrdiff_t j1=k2;j1<N;j1+=NB) {
+                        const ptrdiff_t j2 = TMV_MIN(j1+NB,N);
+#pragma omp task firstprivate(j1,j2)
+                        {
+                            BlockHouseholderLDiv(
+                                A.subMatrix(k1,M,k1,k2),
+                                BaseZ[kk].subTriMatrix(0,k2-k1),
+                                A.subMatrix(k1,M,j1,j2));
+                            // The lookahead step:
+                            if (j1 == k2) {
+                                UpperTriMatrixView<T> Z = 
+                                    BaseZ[1-kk].subTriMatrix(0,k3-k2);
+                                RecursiveQRDecompose(
+                                    A.subMatrix(k2,M,k2,k3),Z,det,k3<N);
+                                beta.subVector(k2,k3) = 
+                                    Z.diag().conjugate();
+                            }
+                        }
+                    }
+#pragma omp taskwait
+                }
+            }
+        }
+    }
+
+    template <class T> 
+    static void TSQRDecompose(
+        MatrixView<T> A, VectorView<T> beta, T& det, ptrdiff_t nblocks)
+    {
+        // TSQR is the usual name for the communication-avoiding QR 
+        // algorithm for tall, skinny matrices.  
+        // Each of nblocks row blocks of A is decomposed separately (and 
+        // in parallel), and the resulting R matrices are stacked and 
+        // decomposed to get the final R.
+        //
+        // The problem is that the Q from this algorithm is not in the
+        // form of a regular packed set of Householder vectors, which is 
+        // what the rest of TMV expects to find.  So we use the algorithm
+        // of Ballard et al (2014) to reconstruct the Householder vectors
+        // from the explicit Q:
+        //
+        // If Q = I - Y Z Yt with Y unit lower trapezoidal and Z upper 
+        // triangular, then [ I ; 0 ] - Q1 = Y (Z Y1t), where Q1 is 
+        // the first N columns of Q.  This is an LU decomposition, so 
+        // Y and U = Z Y1t are found by doing an LU decomposition of 
+        // [ I ; 0 ] - Q1.  This doesn't need any pivoting, since we are 
+        // free to change the sign of each column of Q1 (and the 
+        // corresponding row of R).  We choose the sign to make the 
+        // diagonal element of U >= 1 in absolute value.
+        //
+        // Then the beta values are the conjugates of the diagonal 
+        // elements of U (which are the same as those of Z, since Y1t is 
+        // unit upper triangular).
+        //
+        // This means doing about twice the work of the regular algorithm,
+        // but all of the O(MN^2) parts are done in parallel on separate 
+        // row blocks, so it is much faster when M >> N.
+        TMVAssert(A.colsize() >= A.rowsize());
+        TMVAssert(A.rowsize() == beta.size());
+        TMVAssert(A.ct() == NonConj);
+        TMVAssert(A.isrm() || A.iscm());
+        TMVAssert(beta.ct() == NonConj);
+        TMVAssert(beta.step()==1);
+        TMVAssert(nblocks > 1);
+        TMVAssert(A.colsize() >= nblocks * A.rowsize());
+
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+
+        // Step 1: QR decompose each row block separately.
+        Matrix<T,ColMajor> Rs(nblocks*N,N,T(0));
+        Matrix<T,ColMajor> blockbeta(N,nblocks);
+#ifdef __PGI
+#define TMV_INT_OMP int
+#else
+#define TMV_INT_OMP ptrdiff_t
+#endif
+#pragma omp parallel for
+        for(TMV_INT_OMP i=0;i<nblocks;++i) {
+            const ptrdiff_t i1 = i*M/nblocks;
+            const ptrdiff_t i2 = (i+1)*M/nblocks;
+            T d(0);
+            MatrixView<T> Ai = A.rowRange(i1,i2);
+            SerialQRDecompose(Ai,blockbeta.col(i),d);
+            Rs.rowRange(i*N,(i+1)*N).upperTri() = Ai.upperTri();
+        }
+
+        // Step 2: QR decompose the stacked R's, and make the explicit Q.
+        Vector<T> Rsbeta(N);
+        T d(0);
+        SerialQRDecompose(Rs.view(),Rsbeta.view(),d);
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> R = Rs.upperTri();
+        GetQFromQR(Rs.view(),Rsbeta);
+
+        // Step 3: The full Q1 is diag(Q_i) * Rs.
+#pragma omp parallel for
+        for(TMV_INT_OMP i=0;i<nblocks;++i) {
+            const ptrdiff_t i1 = i*M/nblocks;
+            const ptrdiff_t i2 = (i+1)*M/nblocks;
+            MatrixView<T> Ai = A.rowRange(i1,i2);
+            GetQFromQR(Ai,blockbeta.col(i));
+            Matrix<T,ColMajor> Qi = Ai * Rs.rowRange(i*N,(i+1)*N);
+            Ai = Qi;
+        }
+
+        // Step 4: LU decompose the top NxN part of [ I ; 0 ] - Q1 S,
+        // choosing the signs S as we go.
+        // This is a simple version of NonBlockLUDecompose, without 
+        // pivoting.
+        MatrixView<T> A1 = A.rowRange(0,N);
+        Vector<T> S(N);
+        for(ptrdiff_t j=0;j<N;++j) {
+            if (j > 0) {
+                A1.col(j,0,j) /= A1.subMatrix(0,j,0,j).lowerTri(UnitDiag);
+                A1.col(j,j,N) -= A1.subMatrix(j,N,0,j) * A1.col(j,0,j);
+            }
+            const T qjj = A1(j,j);
+            const T sj = TMV_REAL(qjj) > 0 ? T(-1) : T(1);
+            const T ujj = T(1) - sj * qjj;
+            S(j) = sj;
+            A1.col(j,0,j) *= -sj;
+            A1(j,j) = ujj;
+            A1.col(j,j+1,N) *= -sj / ujj;
+        }
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> U = A1.upperTri();
+
+        // Step 5: The rest of Y is -Q1 S U^-1.
+        if (M > N) {
+#pragma omp parallel for
+            for(TMV_INT_OMP i=0;i<nblocks;++i) {
+                const ptrdiff_t i1 = TMV_MAX(N,i*M/nblocks);
+                const ptrdiff_t i2 = (i+1)*M/nblocks;
+                if (i1 < i2) {
+                    MatrixView<T> Ai = A.rowRange(i1,i2);
+                    for(ptrdiff_t j=0;j<N;++j) Ai.col(j) *= -S(j);
+                    Ai %= U;
+                }
+            }
+        }
+#undef TMV_INT_OMP
+
+        // Step 6: beta = conj(diag(U)), and R -> S R.
+        beta = U.diag().conjugate();
+        for(ptrdiff_t j=0;j<N;++j) {
+            A1.row(j,j,N) = S(j) * R.row(j,j,N);
+            if (det != T(0)) {
+                const T bj = beta(j);
+                if (TMV_IMAG(bj) == TMV_RealType(T)(0))
+                    det = -det;
+                else 
+                    det *= -TMV_CONJ(bj*bj)/TMV_NORM(bj);
+            }
+        }
+    }
+#endif
+
     template <class T> 
     static void NonLapQRDecompose(
         MatrixView<T> A, VectorView<T> beta, T& det)
@@ -255,13 +467,24 @@ namespace tmv {
         TMVAssert(beta.ct() == NonConj);
         TMVAssert(beta.step()==1);
 
-        if (A.rowsize() > QR_BLOCKSIZE)
-            BlockQRDecompose(A,beta,det);
-        else {
-            UpperTriMatrix<T,NonUnitDiag|ColMajor> Z(A.rowsize());
-            RecursiveQRDecompose(A,Z.view(),det,false);
-            beta = Z.diag().conjugate();
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            const ptrdiff_t M = A.colsize();
+            const ptrdiff_t N = A.rowsize();
+            // Use TSQR if A is tall enough that we can give each thread
+            // a row block that is at least 2N tall.
+            const ptrdiff_t nblocks = TMV_MIN(
+                ptrdiff_t(omp_get_max_threads()), M/(2*N));
+            if (M >= 4*N && nblocks > 1 && M*N > QR_BLOCKSIZE*QR_BLOCKSIZE) {
+                TSQRDecompose(A,beta,det,nblocks);
+                return;
+            } else if (N > 2*QR_BLOCKSIZE) {
+                OpenMPBlockQRDecompose(A,beta,det);
+                return;
+            }
         }
+#endif
+        SerialQRDecompose(A,beta,det);
     }
 
 #ifdef LAP
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TMV_Random_H
+#define TMV_Random_H
+
+// A simple random number generator for the algorithms that need a random
+// starting point (RandomSV_Decompose, IterEigen).  It doesn't need to be
+// very good.  It just needs to be random enough that the starting vectors
+// aren't orthogonal to anything important.  It is always started with the
+// same seed, so the results are repeatable.
+//
+// This is Marsaglia's two-word xorshift generator (period 2^64-1).
+// The state is kept in two unsigned longs, masked to 32 bits, so 
+// it works the same way everywhere without needing a 64 bit integer type.
+
+#include <cmath>
+
+namespace tmv {
+
+    class XorShiftRandom
+    {
+    public :
+        XorShiftRandom() : 
+            x(123456789UL), y(362436069UL), saved(false), next(0.) {}
+
+        // Return a uniform deviate in [0,1) with 53 random bits.
+        double uniform()
+        {
+            const unsigned long a = step() >> 5;
+            const unsigned long b = step() >> 6;
+            return (double(a)*67108864. + double(b)) * 
+                (1./9007199254740992.);
+        }
+
+        // Return a Gaussian deviate with mean 0 and variance 1 
+        // (Box-Muller).
+        double gaussian()
+        {
+            if (saved) { saved = false; return next; }
+            double u1, u2;
+            do { u1 = uniform(); } while (u1 == 0.);
+            u2 = uniform();
+            const double r = std::sqrt(-2.*std::log(u1));
+            const double theta = 2.*3.14159265358979323846*u2;
+            next = r*std::sin(theta);
+            saved = true;
+            return r*std::cos(theta);
+        }
+
+    private :
+
+        unsigned long step()
+        {
+            const unsigned long t = (x ^ (x << 10)) & 0xffffffffUL;
+            x = y;
+            y = (y ^ (y >> 10)) ^ (t ^ (t >> 13));
+            return y;
+        }
+
+        unsigned long x, y;
+        bool saved;
+        double next;
+    };
+
+} // namespace tmv
+
+#endif
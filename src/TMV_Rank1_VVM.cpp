@@ -24,6 +24,7 @@
 
 
 #include "TMV_Blas.h"
+#include "TMV_SIMD.h"
 #include "tmv/TMV_MatrixArithFunc.h"
 #include "tmv/TMV_Matrix.h"
 #include "tmv/TMV_Vector.h"
@@ -103,6 +104,49 @@ namespace tmv {
         }
     }
 
+#ifdef TMV_SIMD_DISPATCH
+    // For real double and float with a column major A, each column 
+    // update is done with the SIMD kernel (see TMV_SIMD.h).
+    // These return false if the kernel can't be used.
+    template <class T, class Tx, class Ty> 
+    static inline bool SIMDRank1Update(
+        const GenVector<Tx>& , const GenVector<Ty>& , MatrixView<T> )
+    { return false; }
+
+    template <class T> 
+    static bool DoSIMDRank1Update(
+        const GenVector<T>& x, const GenVector<T>& y, MatrixView<T> A)
+    {
+        TMVAssert(x.step() == 1);
+
+        if (!A.iscm() || GetSIMDLevel() == SIMD_Baseline) return false;
+
+        const T* yj = y.cptr();
+        const T* xptr = x.cptr();
+        T* Acolj = A.ptr();
+        const ptrdiff_t sj = A.stepj();
+        const ptrdiff_t ys = y.step();
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+
+        for (ptrdiff_t j=N; j>0; --j,yj+=ys,Acolj+=sj) 
+            if (*yj != T(0)) SIMD_AddVV(M,*yj,xptr,Acolj);
+        return true;
+    }
+#ifdef INST_DOUBLE
+    static inline bool SIMDRank1Update(
+        const GenVector<double>& x, const GenVector<double>& y,
+        MatrixView<double> A)
+    { return DoSIMDRank1Update(x,y,A); }
+#endif
+#ifdef INST_FLOAT
+    static inline bool SIMDRank1Update(
+        const GenVector<float>& x, const GenVector<float>& y,
+        MatrixView<float> A)
+    { return DoSIMDRank1Update(x,y,A); }
+#endif
+#endif
+
     template <bool cx, bool add, class T, class Tx, class Ty> 
     static void UnitARank1Update(
         const GenVector<Tx>& x,
@@ -116,6 +160,10 @@ namespace tmv {
         TMVAssert(x.step() == 1);
         TMVAssert(cx == x.isconj());
 
+#ifdef TMV_SIMD_DISPATCH
+        if (add && SIMDRank1Update(x,y,A)) return;
+#endif
+
         if (A.iscm()) 
             if (y.isconj())
                 ColRank1Update<cx,true,true,add>(x,y,A);
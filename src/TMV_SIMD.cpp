@@ -0,0 +1,922 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "TMV_SIMD.h"
+
+#ifdef TMV_SIMD_DISPATCH
+
+#include "tmv/TMV_Base.h"
+#include <immintrin.h>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+
+namespace tmv {
+
+    //
+    // Choosing the SIMD level
+    //
+
+    static SIMDLevel CPUSIMDLevel()
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+            else return SIMD_AVX2;
+        } else {
+            return SIMD_Baseline;
+        }
+    }
+
+    static SIMDLevel ChooseSIMDLevel()
+    {
+        SIMDLevel level = CPUSIMDLevel();
+        const char* env = std::getenv("TMV_SIMD");
+        if (env && *env) {
+            std::string s(env);
+            for(size_t i=0;i<s.size();++i) s[i] = std::tolower(s[i]);
+            SIMDLevel request;
+            if (s == "baseline" || s == "sse2") request = SIMD_Baseline;
+            else if (s == "avx2") request = SIMD_AVX2;
+            else if (s == "avx512") request = SIMD_AVX512;
+            else {
+                TMV_Warning(
+                    "Unknown value for TMV_SIMD: "+s+"\n"
+                    "Valid values are baseline, sse2, avx2, avx512");
+                return level;
+            }
+            if (request > level) {
+                TMV_Warning(
+                    "TMV_SIMD="+s+" is not supported by this CPU.\n"
+                    "Using the best level that is supported.");
+            } else {
+                level = request;
+            }
+        }
+        return level;
+    }
+
+    SIMDLevel GetSIMDLevel()
+    {
+        static const SIMDLevel level = ChooseSIMDLevel();
+        return level;
+    }
+
+    //
+    // The kernels
+    //
+    // For the sums (MultVV, NormSq) we use 4 independent vector 
+    // accumulators, which helps the accuracy as well as the speed.
+    // For long vectors, we also split the vector in half recursively
+    // until it is no longer than TMV_SIMD_SUMSIZE, as nonBlasMultVV does.
+    // This keeps the rounding errors of the sums closer to a few epsilon.
+    //
+
+#define TMV_SIMD_SUMSIZE 1024
+#define TMV_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define TMV_AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+
+    // Split point for the recursive sums: about half, but a multiple of 64
+    // so the first half doesn't need the masked tail.
+    static inline ptrdiff_t SumSplit(const ptrdiff_t n)
+    { return ((n>>7)<<6); }
+
+#ifdef INST_DOUBLE
+    TMV_AVX2_TARGET
+    static inline __m256i avx2_mask_pd(const ptrdiff_t n)
+    {
+        // The first n lanes are on.
+        return _mm256_cmpgt_epi64(
+            _mm256_set1_epi64x(n),_mm256_set_epi64x(3,2,1,0));
+    }
+
+    TMV_AVX2_TARGET
+    static inline double avx2_hsum_pd(const __m256d x)
+    {
+        __m128d s = _mm_add_pd(
+            _mm256_castpd256_pd128(x),_mm256_extractf128_pd(x,1));
+        return _mm_cvtsd_f64(_mm_add_sd(s,_mm_unpackhi_pd(s,s)));
+    }
+
+    TMV_AVX512_TARGET
+    static inline double avx512_hsum_pd(const __m512d x)
+    {
+        // With gcc, _mm512_castpd512_pd256 and _mm512_extractf64x4_pd
+        // (and the unmasked permutes below) pass an undefined register
+        // through, which -Wmaybe-uninitialized flags.  The zero-masked
+        // versions don't, and they compile to the same instructions.
+        return avx2_hsum_pd(_mm256_add_pd(
+                _mm512_maskz_extractf64x4_pd(0xF,x,0),
+                _mm512_maskz_extractf64x4_pd(0xF,x,1)));
+    }
+
+    TMV_AVX2_TARGET
+    static double avx2_MultVV(
+        const ptrdiff_t n, const double* x, const double* y)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx2_MultVV(n1,x,y) + avx2_MultVV(n-n1,x+n1,y+n1);
+        }
+        __m256d s0 = _mm256_setzero_pd();
+        __m256d s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd();
+        __m256d s3 = _mm256_setzero_pd();
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            s0 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(x+i),_mm256_loadu_pd(y+i),s0);
+            s1 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(x+i+4),_mm256_loadu_pd(y+i+4),s1);
+            s2 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(x+i+8),_mm256_loadu_pd(y+i+8),s2);
+            s3 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(x+i+12),_mm256_loadu_pd(y+i+12),s3);
+        }
+        for(;i+4<=n;i+=4) 
+            s0 = _mm256_fmadd_pd(
+                _mm256_loadu_pd(x+i),_mm256_loadu_pd(y+i),s0);
+        if (i < n) {
+            const __m256i mask = avx2_mask_pd(n-i);
+            s1 = _mm256_fmadd_pd(
+                _mm256_maskload_pd(x+i,mask),
+                _mm256_maskload_pd(y+i,mask),s1);
+        }
+        return avx2_hsum_pd(
+            _mm256_add_pd(_mm256_add_pd(s0,s1),_mm256_add_pd(s2,s3)));
+    }
+
+    TMV_AVX512_TARGET
+    static double avx512_MultVV(
+        const ptrdiff_t n, const double* x, const double* y)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx512_MultVV(n1,x,y) + avx512_MultVV(n-n1,x+n1,y+n1);
+        }
+        __m512d s0 = _mm512_setzero_pd();
+        __m512d s1 = _mm512_setzero_pd();
+        __m512d s2 = _mm512_setzero_pd();
+        __m512d s3 = _mm512_setzero_pd();
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            s0 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(x+i),_mm512_loadu_pd(y+i),s0);
+            s1 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(x+i+8),_mm512_loadu_pd(y+i+8),s1);
+            s2 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(x+i+16),_mm512_loadu_pd(y+i+16),s2);
+            s3 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(x+i+24),_mm512_loadu_pd(y+i+24),s3);
+        }
+        for(;i+8<=n;i+=8) 
+            s0 = _mm512_fmadd_pd(
+                _mm512_loadu_pd(x+i),_mm512_loadu_pd(y+i),s0);
+        if (i < n) {
+            const __mmask8 mask = __mmask8((1<<(n-i))-1);
+            s1 = _mm512_fmadd_pd(
+                _mm512_maskz_loadu_pd(mask,x+i),
+                _mm512_maskz_loadu_pd(mask,y+i),s1);
+        }
+        return avx512_hsum_pd(
+            _mm512_add_pd(_mm512_add_pd(s0,s1),_mm512_add_pd(s2,s3)));
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_AddVV(
+        const ptrdiff_t n, const double alpha, const double* x, double* y)
+    {
+        const __m256d a = _mm256_set1_pd(alpha);
+        ptrdiff_t i=0;
+        for(;i+8<=n;i+=8) {
+            _mm256_storeu_pd(y+i,_mm256_fmadd_pd(
+                    a,_mm256_loadu_pd(x+i),_mm256_loadu_pd(y+i)));
+            _mm256_storeu_pd(y+i+4,_mm256_fmadd_pd(
+                    a,_mm256_loadu_pd(x+i+4),_mm256_loadu_pd(y+i+4)));
+        }
+        for(;i+4<=n;i+=4) 
+            _mm256_storeu_pd(y+i,_mm256_fmadd_pd(
+                    a,_mm256_loadu_pd(x+i),_mm256_loadu_pd(y+i)));
+        if (i < n) {
+            const __m256i mask = avx2_mask_pd(n-i);
+            _mm256_maskstore_pd(y+i,mask,_mm256_fmadd_pd(
+                    a,_mm256_maskload_pd(x+i,mask),
+                    _mm256_maskload_pd(y+i,mask)));
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_AddVV(
+        const ptrdiff_t n, const double alpha, const double* x, double* y)
+    {
+        const __m512d a = _mm512_set1_pd(alpha);
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            _mm512_storeu_pd(y+i,_mm512_fmadd_pd(
+                    a,_mm512_loadu_pd(x+i),_mm512_loadu_pd(y+i)));
+            _mm512_storeu_pd(y+i+8,_mm512_fmadd_pd(
+                    a,_mm512_loadu_pd(x+i+8),_mm512_loadu_pd(y+i+8)));
+        }
+        for(;i+8<=n;i+=8) 
+            _mm512_storeu_pd(y+i,_mm512_fmadd_pd(
+                    a,_mm512_loadu_pd(x+i),_mm512_loadu_pd(y+i)));
+        if (i < n) {
+            const __mmask8 mask = __mmask8((1<<(n-i))-1);
+            _mm512_mask_storeu_pd(y+i,mask,_mm512_fmadd_pd(
+                    a,_mm512_maskz_loadu_pd(mask,x+i),
+                    _mm512_maskz_loadu_pd(mask,y+i)));
+        }
+    }
+
+    TMV_AVX2_TARGET
+    static double avx2_NormSq(
+        const ptrdiff_t n, const double scale, const double* x)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx2_NormSq(n1,scale,x) + avx2_NormSq(n-n1,scale,x+n1);
+        }
+        const __m256d c = _mm256_set1_pd(scale);
+        __m256d s0 = _mm256_setzero_pd();
+        __m256d s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd();
+        __m256d s3 = _mm256_setzero_pd();
+        __m256d v0,v1,v2,v3;
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            v0 = _mm256_mul_pd(c,_mm256_loadu_pd(x+i));
+            v1 = _mm256_mul_pd(c,_mm256_loadu_pd(x+i+4));
+            v2 = _mm256_mul_pd(c,_mm256_loadu_pd(x+i+8));
+            v3 = _mm256_mul_pd(c,_mm256_loadu_pd(x+i+12));
+            s0 = _mm256_fmadd_pd(v0,v0,s0);
+            s1 = _mm256_fmadd_pd(v1,v1,s1);
+            s2 = _mm256_fmadd_pd(v2,v2,s2);
+            s3 = _mm256_fmadd_pd(v3,v3,s3);
+        }
+        for(;i+4<=n;i+=4) {
+            v0 = _mm256_mul_pd(c,_mm256_loadu_pd(x+i));
+            s0 = _mm256_fmadd_pd(v0,v0,s0);
+        }
+        if (i < n) {
+            v1 = _mm256_mul_pd(c,_mm256_maskload_pd(x+i,avx2_mask_pd(n-i)));
+            s1 = _mm256_fmadd_pd(v1,v1,s1);
+        }
+        return avx2_hsum_pd(
+            _mm256_add_pd(_mm256_add_pd(s0,s1),_mm256_add_pd(s2,s3)));
+    }
+
+    TMV_AVX512_TARGET
+    static double avx512_NormSq(
+        const ptrdiff_t n, const double scale, const double* x)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx512_NormSq(n1,scale,x) + avx512_NormSq(n-n1,scale,x+n1);
+        }
+        const __m512d c = _mm512_set1_pd(scale);
+        __m512d s0 = _mm512_setzero_pd();
+        __m512d s1 = _mm512_setzero_pd();
+        __m512d s2 = _mm512_setzero_pd();
+        __m512d s3 = _mm512_setzero_pd();
+        __m512d v0,v1,v2,v3;
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            v0 = _mm512_mul_pd(c,_mm512_loadu_pd(x+i));
+            v1 = _mm512_mul_pd(c,_mm512_loadu_pd(x+i+8));
+            v2 = _mm512_mul_pd(c,_mm512_loadu_pd(x+i+16));
+            v3 = _mm512_mul_pd(c,_mm512_loadu_pd(x+i+24));
+            s0 = _mm512_fmadd_pd(v0,v0,s0);
+            s1 = _mm512_fmadd_pd(v1,v1,s1);
+            s2 = _mm512_fmadd_pd(v2,v2,s2);
+            s3 = _mm512_fmadd_pd(v3,v3,s3);
+        }
+        for(;i+8<=n;i+=8) {
+            v0 = _mm512_mul_pd(c,_mm512_loadu_pd(x+i));
+            s0 = _mm512_fmadd_pd(v0,v0,s0);
+        }
+        if (i < n) {
+            const __mmask8 mask = __mmask8((1<<(n-i))-1);
+            v1 = _mm512_mul_pd(c,_mm512_maskz_loadu_pd(mask,x+i));
+            s1 = _mm512_fmadd_pd(v1,v1,s1);
+        }
+        return avx512_hsum_pd(
+            _mm512_add_pd(_mm512_add_pd(s0,s1),_mm512_add_pd(s2,s3)));
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_ElemMultVV(
+        const ptrdiff_t n, const double* a, const double* x, double* y)
+    {
+        ptrdiff_t i=0;
+        for(;i+8<=n;i+=8) {
+            _mm256_storeu_pd(y+i,_mm256_fmadd_pd(
+                    _mm256_loadu_pd(a+i),_mm256_loadu_pd(x+i),
+                    _mm256_loadu_pd(y+i)));
+            _mm256_storeu_pd(y+i+4,_mm256_fmadd_pd(
+                    _mm256_loadu_pd(a+i+4),_mm256_loadu_pd(x+i+4),
+                    _mm256_loadu_pd(y+i+4)));
+        }
+        for(;i+4<=n;i+=4) 
+            _mm256_storeu_pd(y+i,_mm256_fmadd_pd(
+                    _mm256_loadu_pd(a+i),_mm256_loadu_pd(x+i),
+                    _mm256_loadu_pd(y+i)));
+        if (i < n) {
+            const __m256i mask = avx2_mask_pd(n-i);
+            _mm256_maskstore_pd(y+i,mask,_mm256_fmadd_pd(
+                    _mm256_maskload_pd(a+i,mask),
+                    _mm256_maskload_pd(x+i,mask),
+                    _mm256_maskload_pd(y+i,mask)));
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_ElemMultVV(
+        const ptrdiff_t n, const double* a, const double* x, double* y)
+    {
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            _mm512_storeu_pd(y+i,_mm512_fmadd_pd(
+                    _mm512_loadu_pd(a+i),_mm512_loadu_pd(x+i),
+                    _mm512_loadu_pd(y+i)));
+            _mm512_storeu_pd(y+i+8,_mm512_fmadd_pd(
+                    _mm512_loadu_pd(a+i+8),_mm512_loadu_pd(x+i+8),
+                    _mm512_loadu_pd(y+i+8)));
+        }
+        for(;i+8<=n;i+=8) 
+            _mm512_storeu_pd(y+i,_mm512_fmadd_pd(
+                    _mm512_loadu_pd(a+i),_mm512_loadu_pd(x+i),
+                    _mm512_loadu_pd(y+i)));
+        if (i < n) {
+            const __mmask8 mask = __mmask8((1<<(n-i))-1);
+            _mm512_mask_storeu_pd(y+i,mask,_mm512_fmadd_pd(
+                    _mm512_maskz_loadu_pd(mask,a+i),
+                    _mm512_maskz_loadu_pd(mask,x+i),
+                    _mm512_maskz_loadu_pd(mask,y+i)));
+        }
+    }
+
+#ifdef INST_COMPLEX
+    // The complex products work on the interleaved real and imaginary 
+    // parts.  With ar = (ar,ar), ai = (ai,ai) and xs = (xi,xr):
+    // a * x = ar * x -+ ai * xs
+    // conj(a) * x = ar * x +- ai * xs
+    template <bool ca>
+    TMV_AVX2_TARGET
+    static inline __m256d avx2_cmul_pd(const __m256d a, const __m256d x)
+    {
+        const __m256d t = _mm256_mul_pd(
+            _mm256_permute_pd(a,0xF),_mm256_permute_pd(x,0x5));
+        const __m256d ar = _mm256_movedup_pd(a);
+        return ca ? _mm256_fmsubadd_pd(ar,x,t) : _mm256_fmaddsub_pd(ar,x,t);
+    }
+
+    template <bool ca>
+    TMV_AVX512_TARGET
+    static inline __m512d avx512_cmul_pd(const __m512d a, const __m512d x)
+    {
+        const __m512d t = _mm512_mul_pd(
+            _mm512_maskz_permute_pd(0xFF,a,0xFF),
+            _mm512_maskz_permute_pd(0xFF,x,0x55));
+        const __m512d ar = _mm512_maskz_movedup_pd(0xFF,a);
+        return ca ? _mm512_fmsubadd_pd(ar,x,t) : _mm512_fmaddsub_pd(ar,x,t);
+    }
+
+    template <bool ca>
+    TMV_AVX2_TARGET
+    static void avx2_ElemMultVV(
+        const ptrdiff_t n, const std::complex<double>* ac, 
+        const std::complex<double>* xc, std::complex<double>* yc)
+    {
+        const double* a = reinterpret_cast<const double*>(ac);
+        const double* x = reinterpret_cast<const double*>(xc);
+        double* y = reinterpret_cast<double*>(yc);
+        const ptrdiff_t n2 = 2*n;
+        ptrdiff_t i=0;
+        for(;i+8<=n2;i+=8) {
+            _mm256_storeu_pd(y+i,_mm256_add_pd(_mm256_loadu_pd(y+i),
+                    avx2_cmul_pd<ca>(
+                        _mm256_loadu_pd(a+i),_mm256_loadu_pd(x+i))));
+            _mm256_storeu_pd(y+i+4,_mm256_add_pd(_mm256_loadu_pd(y+i+4),
+                    avx2_cmul_pd<ca>(
+                        _mm256_loadu_pd(a+i+4),_mm256_loadu_pd(x+i+4))));
+        }
+        for(;i+4<=n2;i+=4) 
+            _mm256_storeu_pd(y+i,_mm256_add_pd(_mm256_loadu_pd(y+i),
+                    avx2_cmul_pd<ca>(
+                        _mm256_loadu_pd(a+i),_mm256_loadu_pd(x+i))));
+        if (i < n2) {
+            const __m256i mask = avx2_mask_pd(n2-i);
+            _mm256_maskstore_pd(y+i,mask,_mm256_add_pd(
+                    _mm256_maskload_pd(y+i,mask),
+                    avx2_cmul_pd<ca>(
+                        _mm256_maskload_pd(a+i,mask),
+                        _mm256_maskload_pd(x+i,mask))));
+        }
+    }
+
+    template <bool ca>
+    TMV_AVX512_TARGET
+    static void avx512_ElemMultVV(
+        const ptrdiff_t n, const std::complex<double>* ac, 
+        const std::complex<double>* xc, std::complex<double>* yc)
+    {
+        const double* a = reinterpret_cast<const double*>(ac);
+        const double* x = reinterpret_cast<const double*>(xc);
+        double* y = reinterpret_cast<double*>(yc);
+        const ptrdiff_t n2 = 2*n;
+        ptrdiff_t i=0;
+        for(;i+16<=n2;i+=16) {
+            _mm512_storeu_pd(y+i,_mm512_add_pd(_mm512_loadu_pd(y+i),
+                    avx512_cmul_pd<ca>(
+                        _mm512_loadu_pd(a+i),_mm512_loadu_pd(x+i))));
+            _mm512_storeu_pd(y+i+8,_mm512_add_pd(_mm512_loadu_pd(y+i+8),
+                    avx512_cmul_pd<ca>(
+                        _mm512_loadu_pd(a+i+8),_mm512_loadu_pd(x+i+8))));
+        }
+        for(;i+8<=n2;i+=8) 
+            _mm512_storeu_pd(y+i,_mm512_add_pd(_mm512_loadu_pd(y+i),
+                    avx512_cmul_pd<ca>(
+                        _mm512_loadu_pd(a+i),_mm512_loadu_pd(x+i))));
+        if (i < n2) {
+            const __mmask8 mask = __mmask8((1<<(n2-i))-1);
+            _mm512_mask_storeu_pd(y+i,mask,_mm512_add_pd(
+                    _mm512_maskz_loadu_pd(mask,y+i),
+                    avx512_cmul_pd<ca>(
+                        _mm512_maskz_loadu_pd(mask,a+i),
+                        _mm512_maskz_loadu_pd(mask,x+i))));
+        }
+    }
+#endif
+
+    double SIMD_MultVV(const ptrdiff_t n, const double* x, const double* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) return avx512_MultVV(n,x,y);
+        else return avx2_MultVV(n,x,y);
+    }
+
+    void SIMD_AddVV(
+        const ptrdiff_t n, const double alpha, const double* x, double* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) avx512_AddVV(n,alpha,x,y);
+        else avx2_AddVV(n,alpha,x,y);
+    }
+
+    double SIMD_NormSq(const ptrdiff_t n, const double scale, const double* x)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) return avx512_NormSq(n,scale,x);
+        else return avx2_NormSq(n,scale,x);
+    }
+
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const double* a, const double* x, double* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) avx512_ElemMultVV(n,a,x,y);
+        else avx2_ElemMultVV(n,a,x,y);
+    }
+
+#ifdef INST_COMPLEX
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const bool ca, const std::complex<double>* a, 
+        const std::complex<double>* x, std::complex<double>* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) 
+            if (ca) avx512_ElemMultVV<true>(n,a,x,y);
+            else avx512_ElemMultVV<false>(n,a,x,y);
+        else 
+            if (ca) avx2_ElemMultVV<true>(n,a,x,y);
+            else avx2_ElemMultVV<false>(n,a,x,y);
+    }
+#endif
+#endif
+
+#ifdef INST_FLOAT
+    TMV_AVX2_TARGET
+    static inline __m256i avx2_mask_ps(const ptrdiff_t n)
+    {
+        // The first n lanes are on.
+        return _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(int(n)),_mm256_set_epi32(7,6,5,4,3,2,1,0));
+    }
+
+    TMV_AVX2_TARGET
+    static inline float avx2_hsum_ps(const __m256 x)
+    {
+        __m128 s = _mm_add_ps(
+            _mm256_castps256_ps128(x),_mm256_extractf128_ps(x,1));
+        s = _mm_hadd_ps(s,s);
+        s = _mm_hadd_ps(s,s);
+        return _mm_cvtss_f32(s);
+    }
+
+    TMV_AVX512_TARGET
+    static inline float avx512_hsum_ps(const __m512 x)
+    {
+        return avx2_hsum_ps(_mm256_add_ps(
+                _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(
+                        0xF,_mm512_castps_pd(x),0)),
+                _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(
+                        0xF,_mm512_castps_pd(x),1))));
+    }
+
+    TMV_AVX2_TARGET
+    static float avx2_MultVV(
+        const ptrdiff_t n, const float* x, const float* y)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx2_MultVV(n1,x,y) + avx2_MultVV(n-n1,x+n1,y+n1);
+        }
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        __m256 s2 = _mm256_setzero_ps();
+        __m256 s3 = _mm256_setzero_ps();
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            s0 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x+i),_mm256_loadu_ps(y+i),s0);
+            s1 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x+i+8),_mm256_loadu_ps(y+i+8),s1);
+            s2 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x+i+16),_mm256_loadu_ps(y+i+16),s2);
+            s3 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x+i+24),_mm256_loadu_ps(y+i+24),s3);
+        }
+        for(;i+8<=n;i+=8) 
+            s0 = _mm256_fmadd_ps(
+                _mm256_loadu_ps(x+i),_mm256_loadu_ps(y+i),s0);
+        if (i < n) {
+            const __m256i mask = avx2_mask_ps(n-i);
+            s1 = _mm256_fmadd_ps(
+                _mm256_maskload_ps(x+i,mask),
+                _mm256_maskload_ps(y+i,mask),s1);
+        }
+        return avx2_hsum_ps(
+            _mm256_add_ps(_mm256_add_ps(s0,s1),_mm256_add_ps(s2,s3)));
+    }
+
+    TMV_AVX512_TARGET
+    static float avx512_MultVV(
+        const ptrdiff_t n, const float* x, const float* y)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx512_MultVV(n1,x,y) + avx512_MultVV(n-n1,x+n1,y+n1);
+        }
+        __m512 s0 = _mm512_setzero_ps();
+        __m512 s1 = _mm512_setzero_ps();
+        __m512 s2 = _mm512_setzero_ps();
+        __m512 s3 = _mm512_setzero_ps();
+        ptrdiff_t i=0;
+        for(;i+64<=n;i+=64) {
+            s0 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(x+i),_mm512_loadu_ps(y+i),s0);
+            s1 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(x+i+16),_mm512_loadu_ps(y+i+16),s1);
+            s2 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(x+i+32),_mm512_loadu_ps(y+i+32),s2);
+            s3 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(x+i+48),_mm512_loadu_ps(y+i+48),s3);
+        }
+        for(;i+16<=n;i+=16) 
+            s0 = _mm512_fmadd_ps(
+                _mm512_loadu_ps(x+i),_mm512_loadu_ps(y+i),s0);
+        if (i < n) {
+            const __mmask16 mask = __mmask16((1<<(n-i))-1);
+            s1 = _mm512_fmadd_ps(
+                _mm512_maskz_loadu_ps(mask,x+i),
+                _mm512_maskz_loadu_ps(mask,y+i),s1);
+        }
+        return avx512_hsum_ps(
+            _mm512_add_ps(_mm512_add_ps(s0,s1),_mm512_add_ps(s2,s3)));
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_AddVV(
+        const ptrdiff_t n, const float alpha, const float* x, float* y)
+    {
+        const __m256 a = _mm256_set1_ps(alpha);
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            _mm256_storeu_ps(y+i,_mm256_fmadd_ps(
+                    a,_mm256_loadu_ps(x+i),_mm256_loadu_ps(y+i)));
+            _mm256_storeu_ps(y+i+8,_mm256_fmadd_ps(
+                    a,_mm256_loadu_ps(x+i+8),_mm256_loadu_ps(y+i+8)));
+        }
+        for(;i+8<=n;i+=8) 
+            _mm256_storeu_ps(y+i,_mm256_fmadd_ps(
+                    a,_mm256_loadu_ps(x+i),_mm256_loadu_ps(y+i)));
+        if (i < n) {
+            const __m256i mask = avx2_mask_ps(n-i);
+            _mm256_maskstore_ps(y+i,mask,_mm256_fmadd_ps(
+                    a,_mm256_maskload_ps(x+i,mask),
+                    _mm256_maskload_ps(y+i,mask)));
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_AddVV(
+        const ptrdiff_t n, const float alpha, const float* x, float* y)
+    {
+        const __m512 a = _mm512_set1_ps(alpha);
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            _mm512_storeu_ps(y+i,_mm512_fmadd_ps(
+                    a,_mm512_loadu_ps(x+i),_mm512_loadu_ps(y+i)));
+            _mm512_storeu_ps(y+i+16,_mm512_fmadd_ps(
+                    a,_mm512_loadu_ps(x+i+16),_mm512_loadu_ps(y+i+16)));
+        }
+        for(;i+16<=n;i+=16) 
+            _mm512_storeu_ps(y+i,_mm512_fmadd_ps(
+                    a,_mm512_loadu_ps(x+i),_mm512_loadu_ps(y+i)));
+        if (i < n) {
+            const __mmask16 mask = __mmask16((1<<(n-i))-1);
+            _mm512_mask_storeu_ps(y+i,mask,_mm512_fmadd_ps(
+                    a,_mm512_maskz_loadu_ps(mask,x+i),
+                    _mm512_maskz_loadu_ps(mask,y+i)));
+        }
+    }
+
+    TMV_AVX2_TARGET
+    static float avx2_NormSq(
+        const ptrdiff_t n, const float scale, const float* x)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx2_NormSq(n1,scale,x) + avx2_NormSq(n-n1,scale,x+n1);
+        }
+        const __m256 c = _mm256_set1_ps(scale);
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        __m256 s2 = _mm256_setzero_ps();
+        __m256 s3 = _mm256_setzero_ps();
+        __m256 v0,v1,v2,v3;
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            v0 = _mm256_mul_ps(c,_mm256_loadu_ps(x+i));
+            v1 = _mm256_mul_ps(c,_mm256_loadu_ps(x+i+8));
+            v2 = _mm256_mul_ps(c,_mm256_loadu_ps(x+i+16));
+            v3 = _mm256_mul_ps(c,_mm256_loadu_ps(x+i+24));
+            s0 = _mm256_fmadd_ps(v0,v0,s0);
+            s1 = _mm256_fmadd_ps(v1,v1,s1);
+            s2 = _mm256_fmadd_ps(v2,v2,s2);
+            s3 = _mm256_fmadd_ps(v3,v3,s3);
+        }
+        for(;i+8<=n;i+=8) {
+            v0 = _mm256_mul_ps(c,_mm256_loadu_ps(x+i));
+            s0 = _mm256_fmadd_ps(v0,v0,s0);
+        }
+        if (i < n) {
+            v1 = _mm256_mul_ps(c,_mm256_maskload_ps(x+i,avx2_mask_ps(n-i)));
+            s1 = _mm256_fmadd_ps(v1,v1,s1);
+        }
+        return avx2_hsum_ps(
+            _mm256_add_ps(_mm256_add_ps(s0,s1),_mm256_add_ps(s2,s3)));
+    }
+
+    TMV_AVX512_TARGET
+    static float avx512_NormSq(
+        const ptrdiff_t n, const float scale, const float* x)
+    {
+        if (n > TMV_SIMD_SUMSIZE) {
+            const ptrdiff_t n1 = SumSplit(n);
+            return avx512_NormSq(n1,scale,x) + avx512_NormSq(n-n1,scale,x+n1);
+        }
+        const __m512 c = _mm512_set1_ps(scale);
+        __m512 s0 = _mm512_setzero_ps();
+        __m512 s1 = _mm512_setzero_ps();
+        __m512 s2 = _mm512_setzero_ps();
+        __m512 s3 = _mm512_setzero_ps();
+        __m512 v0,v1,v2,v3;
+        ptrdiff_t i=0;
+        for(;i+64<=n;i+=64) {
+            v0 = _mm512_mul_ps(c,_mm512_loadu_ps(x+i));
+            v1 = _mm512_mul_ps(c,_mm512_loadu_ps(x+i+16));
+            v2 = _mm512_mul_ps(c,_mm512_loadu_ps(x+i+32));
+            v3 = _mm512_mul_ps(c,_mm512_loadu_ps(x+i+48));
+            s0 = _mm512_fmadd_ps(v0,v0,s0);
+            s1 = _mm512_fmadd_ps(v1,v1,s1);
+            s2 = _mm512_fmadd_ps(v2,v2,s2);
+            s3 = _mm512_fmadd_ps(v3,v3,s3);
+        }
+        for(;i+16<=n;i+=16) {
+            v0 = _mm512_mul_ps(c,_mm512_loadu_ps(x+i));
+            s0 = _mm512_fmadd_ps(v0,v0,s0);
+        }
+        if (i < n) {
+            const __mmask16 mask = __mmask16((1<<(n-i))-1);
+            v1 = _mm512_mul_ps(c,_mm512_maskz_loadu_ps(mask,x+i));
+            s1 = _mm512_fmadd_ps(v1,v1,s1);
+        }
+        return avx512_hsum_ps(
+            _mm512_add_ps(_mm512_add_ps(s0,s1),_mm512_add_ps(s2,s3)));
+    }
+
+    TMV_AVX2_TARGET
+    static void avx2_ElemMultVV(
+        const ptrdiff_t n, const float* a, const float* x, float* y)
+    {
+        ptrdiff_t i=0;
+        for(;i+16<=n;i+=16) {
+            _mm256_storeu_ps(y+i,_mm256_fmadd_ps(
+                    _mm256_loadu_ps(a+i),_mm256_loadu_ps(x+i),
+                    _mm256_loadu_ps(y+i)));
+            _mm256_storeu_ps(y+i+8,_mm256_fmadd_ps(
+                    _mm256_loadu_ps(a+i+8),_mm256_loadu_ps(x+i+8),
+                    _mm256_loadu_ps(y+i+8)));
+        }
+        for(;i+8<=n;i+=8) 
+            _mm256_storeu_ps(y+i,_mm256_fmadd_ps(
+                    _mm256_loadu_ps(a+i),_mm256_loadu_ps(x+i),
+                    _mm256_loadu_ps(y+i)));
+        if (i < n) {
+            const __m256i mask = avx2_mask_ps(n-i);
+            _mm256_maskstore_ps(y+i,mask,_mm256_fmadd_ps(
+                    _mm256_maskload_ps(a+i,mask),
+                    _mm256_maskload_ps(x+i,mask),
+                    _mm256_maskload_ps(y+i,mask)));
+        }
+    }
+
+    TMV_AVX512_TARGET
+    static void avx512_ElemMultVV(
+        const ptrdiff_t n, const float* a, const float* x, float* y)
+    {
+        ptrdiff_t i=0;
+        for(;i+32<=n;i+=32) {
+            _mm512_storeu_ps(y+i,_mm512_fmadd_ps(
+                    _mm512_loadu_ps(a+i),_mm512_loadu_ps(x+i),
+                    _mm512_loadu_ps(y+i)));
+            _mm512_storeu_ps(y+i+16,_mm512_fmadd_ps(
+                    _mm512_loadu_ps(a+i+16),_mm512_loadu_ps(x+i+16),
+                    _mm512_loadu_ps(y+i+16)));
+        }
+        for(;i+16<=n;i+=16) 
+            _mm512_storeu_ps(y+i,_mm512_fmadd_ps(
+                    _mm512_loadu_ps(a+i),_mm512_loadu_ps(x+i),
+                    _mm512_loadu_ps(y+i)));
+        if (i < n) {
+            const __mmask16 mask = __mmask16((1<<(n-i))-1);
+            _mm512_mask_storeu_ps(y+i,mask,_mm512_fmadd_ps(
+                    _mm512_maskz_loadu_ps(mask,a+i),
+                    _mm512_maskz_loadu_ps(mask,x+i),
+                    _mm512_maskz_loadu_ps(mask,y+i)));
+        }
+    }
+
+#ifdef INST_COMPLEX
+    template <bool ca>
+    TMV_AVX2_TARGET
+    static inline __m256 avx2_cmul_ps(const __m256 a, const __m256 x)
+    {
+        const __m256 t = _mm256_mul_ps(
+            _mm256_movehdup_ps(a),_mm256_permute_ps(x,0xB1));
+        const __m256 ar = _mm256_moveldup_ps(a);
+        return ca ? _mm256_fmsubadd_ps(ar,x,t) : _mm256_fmaddsub_ps(ar,x,t);
+    }
+
+    template <bool ca>
+    TMV_AVX512_TARGET
+    static inline __m512 avx512_cmul_ps(const __m512 a, const __m512 x)
+    {
+        const __m512 t = _mm512_mul_ps(
+            _mm512_maskz_movehdup_ps(0xFFFF,a),
+            _mm512_maskz_permute_ps(0xFFFF,x,0xB1));
+        const __m512 ar = _mm512_maskz_moveldup_ps(0xFFFF,a);
+        return ca ? _mm512_fmsubadd_ps(ar,x,t) : _mm512_fmaddsub_ps(ar,x,t);
+    }
+
+    template <bool ca>
+    TMV_AVX2_TARGET
+    static void avx2_ElemMultVV(
+        const ptrdiff_t n, const std::complex<float>* ac, 
+        const std::complex<float>* xc, std::complex<float>* yc)
+    {
+        const float* a = reinterpret_cast<const float*>(ac);
+        const float* x = reinterpret_cast<const float*>(xc);
+        float* y = reinterpret_cast<float*>(yc);
+        const ptrdiff_t n2 = 2*n;
+        ptrdiff_t i=0;
+        for(;i+16<=n2;i+=16) {
+            _mm256_storeu_ps(y+i,_mm256_add_ps(_mm256_loadu_ps(y+i),
+                    avx2_cmul_ps<ca>(
+                        _mm256_loadu_ps(a+i),_mm256_loadu_ps(x+i))));
+            _mm256_storeu_ps(y+i+8,_mm256_add_ps(_mm256_loadu_ps(y+i+8),
+                    avx2_cmul_ps<ca>(
+                        _mm256_loadu_ps(a+i+8),_mm256_loadu_ps(x+i+8))));
+        }
+        for(;i+8<=n2;i+=8) 
+            _mm256_storeu_ps(y+i,_mm256_add_ps(_mm256_loadu_ps(y+i),
+                    avx2_cmul_ps<ca>(
+                        _mm256_loadu_ps(a+i),_mm256_loadu_ps(x+i))));
+        if (i < n2) {
+            const __m256i mask = avx2_mask_ps(n2-i);
+            _mm256_maskstore_ps(y+i,mask,_mm256_add_ps(
+                    _mm256_maskload_ps(y+i,mask),
+                    avx2_cmul_ps<ca>(
+                        _mm256_maskload_ps(a+i,mask),
+                        _mm256_maskload_ps(x+i,mask))));
+        }
+    }
+
+    template <bool ca>
+    TMV_AVX512_TARGET
+    static void avx512_ElemMultVV(
+        const ptrdiff_t n, const std::complex<float>* ac, 
+        const std::complex<float>* xc, std::complex<float>* yc)
+    {
+        const float* a = reinterpret_cast<const float*>(ac);
+        const float* x = reinterpret_cast<const float*>(xc);
+        float* y = reinterpret_cast<float*>(yc);
+        const ptrdiff_t n2 = 2*n;
+        ptrdiff_t i=0;
+        for(;i+32<=n2;i+=32) {
+            _mm512_storeu_ps(y+i,_mm512_add_ps(_mm512_loadu_ps(y+i),
+                    avx512_cmul_ps<ca>(
+                        _mm512_loadu_ps(a+i),_mm512_loadu_ps(x+i))));
+            _mm512_storeu_ps(y+i+16,_mm512_add_ps(_mm512_loadu_ps(y+i+16),
+                    avx512_cmul_ps<ca>(
+                        _mm512_loadu_ps(a+i+16),_mm512_loadu_ps(x+i+16))));
+        }
+        for(;i+16<=n2;i+=16) 
+            _mm512_storeu_ps(y+i,_mm512_add_ps(_mm512_loadu_ps(y+i),
+                    avx512_cmul_ps<ca>(
+                        _mm512_loadu_ps(a+i),_mm512_loadu_ps(x+i))));
+        if (i < n2) {
+            const __mmask16 mask = __mmask16((1<<(n2-i))-1);
+            _mm512_mask_storeu_ps(y+i,mask,_mm512_add_ps(
+                    _mm512_maskz_loadu_ps(mask,y+i),
+                    avx512_cmul_ps<ca>(
+                        _mm512_maskz_loadu_ps(mask,a+i),
+                        _mm512_maskz_loadu_ps(mask,x+i))));
+        }
+    }
+#endif
+
+    float SIMD_MultVV(const ptrdiff_t n, const float* x, const float* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) return avx512_MultVV(n,x,y);
+        else return avx2_MultVV(n,x,y);
+    }
+
+    void SIMD_AddVV(
+        const ptrdiff_t n, const float alpha, const float* x, float* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) avx512_AddVV(n,alpha,x,y);
+        else avx2_AddVV(n,alpha,x,y);
+    }
+
+    float SIMD_NormSq(const ptrdiff_t n, const float scale, const float* x)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) return avx512_NormSq(n,scale,x);
+        else return avx2_NormSq(n,scale,x);
+    }
+
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const float* a, const float* x, float* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) avx512_ElemMultVV(n,a,x,y);
+        else avx2_ElemMultVV(n,a,x,y);
+    }
+
+#ifdef INST_COMPLEX
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const bool ca, const std::complex<float>* a, 
+        const std::complex<float>* x, std::complex<float>* y)
+    {
+        if (GetSIMDLevel() == SIMD_AVX512) 
+            if (ca) avx512_ElemMultVV<true>(n,a,x,y);
+            else avx512_ElemMultVV<false>(n,a,x,y);
+        else 
+            if (ca) avx2_ElemMultVV<true>(n,a,x,y);
+            else avx2_ElemMultVV<false>(n,a,x,y);
+    }
+#endif
+#endif
+
+#undef TMV_SIMD_SUMSIZE
+#undef TMV_AVX2_TARGET
+#undef TMV_AVX512_TARGET
+
+} // namespace tmv
+
+#endif // TMV_SIMD_DISPATCH
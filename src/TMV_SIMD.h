@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+// This file declares the runtime selection of the SIMD kernels.
+//
+// The library is normally compiled for the baseline instruction set
+// of the target (e.g. SSE2 on x86-64).  On x86 with gcc >= 5 or clang,
+// we also compile AVX2/FMA and AVX-512 versions of the hot kernels using
+// function-specific target attributes, and pick which ones to use at 
+// runtime according to what the CPU supports.
+//
+// The choice is made the first time it is needed, and it can be 
+// overridden with the environment variable TMV_SIMD, which may be 
+// set to baseline (or sse2), avx2 or avx512.  If the requested level 
+// is not supported by the CPU, the best supported level below it is 
+// used instead.
+//
+// Define TMV_NO_AVX to turn this off.  It is also off when using BLAS,
+// since then the BLAS library is used for all of these calculations.
+
+#ifndef TMV_SIMD_H
+#define TMV_SIMD_H
+
+#include "TMV_Blas.h"
+#include <cstddef>
+#include <complex>
+
+#if !defined(BLAS) && !defined(TMV_NO_AVX) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define TMV_SIMD_DISPATCH
+#endif
+
+#ifdef TMV_SIMD_DISPATCH
+
+namespace tmv {
+
+    enum SIMDLevel { SIMD_Baseline, SIMD_AVX2, SIMD_AVX512 };
+
+    // The SIMD level to use.
+    SIMDLevel GetSIMDLevel();
+
+    // The kernels below are only valid to call when GetSIMDLevel() is
+    // not SIMD_Baseline.  The vectors all have unit step.
+
+    // return x . y
+    double SIMD_MultVV(const ptrdiff_t n, const double* x, const double* y);
+    float SIMD_MultVV(const ptrdiff_t n, const float* x, const float* y);
+
+    // y += alpha * x
+    void SIMD_AddVV(
+        const ptrdiff_t n, const double alpha, const double* x, double* y);
+    void SIMD_AddVV(
+        const ptrdiff_t n, const float alpha, const float* x, float* y);
+
+    // return Sum_i (scale*x_i)^2
+    double SIMD_NormSq(const ptrdiff_t n, const double scale, const double* x);
+    float SIMD_NormSq(const ptrdiff_t n, const float scale, const float* x);
+
+    // y_i += a_i * x_i
+    // For the complex versions, a_i is conjugated if ca is true.
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const double* a, const double* x, double* y);
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const float* a, const float* x, float* y);
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const bool ca, const std::complex<double>* a, 
+        const std::complex<double>* x, std::complex<double>* y);
+    void SIMD_ElemMultVV(
+        const ptrdiff_t n, const bool ca, const std::complex<float>* a, 
+        const std::complex<float>* x, std::complex<float>* y);
+
+}
+
+#endif
+
+#endif
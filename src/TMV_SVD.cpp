@@ -38,6 +38,7 @@ namespace tmv {
     {
     public :
         SVDiv_Impl(const GenMatrix<T>& m, bool inplace); 
+        SVDiv_Impl(const GenMatrix<T>& m, ptrdiff_t k); 
 
         const bool istrans;
         const bool inplace;
@@ -69,6 +70,19 @@ namespace tmv {
 #undef UX
 #undef APTR
 
+#define BIG (TMV_MAX(A.colsize(),A.rowsize()))
+#define SMALL (TMV_MIN(A.colsize(),A.rowsize()))
+
+    template <class T> 
+    SVDiv<T>::SVDiv_Impl::SVDiv_Impl(const GenMatrix<T>& A, ptrdiff_t k) :
+        istrans(A.colsize() < A.rowsize()), inplace(false),
+        Aptr1(BIG*k), Aptr(Aptr1.get()),
+        U(MatrixViewOf(Aptr,BIG,k,ColMajor)), S(k), Vt(k,SMALL), 
+        logdet(0), signdet(0), kmax(0) {}
+
+#undef BIG
+#undef SMALL
+
     template <class T> 
     SVDiv<T>::SVDiv(const GenMatrix<T>& A, bool inplace) :
         pimpl(new SVDiv_Impl(A,inplace))
@@ -90,6 +104,25 @@ namespace tmv {
         thresh(TMV_Epsilon<T>());
     }
 
+    template <class T> 
+    SVDiv<T>::SVDiv(
+        const GenMatrix<T>& A, ptrdiff_t k, 
+        ptrdiff_t oversample, ptrdiff_t niter) :
+        pimpl(new SVDiv_Impl(A,k))
+    {
+        // The determinant is left as 0, since the low rank approximation
+        // is singular (unless k is the full rank).
+        if (pimpl->istrans) 
+            RandomSV_Decompose(
+                A.transpose(),pimpl->U,pimpl->S.view(),pimpl->Vt.view(),
+                oversample,niter);
+        else
+            RandomSV_Decompose(
+                A,pimpl->U,pimpl->S.view(),pimpl->Vt.view(),
+                oversample,niter);
+        thresh(TMV_Epsilon<T>());
+    }
+
     template <class T> 
     SVDiv<T>::~SVDiv() {}
 
@@ -201,7 +234,7 @@ namespace tmv {
 
     template <class T> 
     bool SVDiv<T>::isSingular() const
-    { return pimpl->kmax < pimpl->S.size(); }
+    { return pimpl->kmax < pimpl->Vt.rowsize(); }
 
     template <class T> 
     RT SVDiv<T>::norm2() const 
@@ -294,11 +327,11 @@ namespace tmv {
 
     template <class T> 
     ptrdiff_t SVDiv<T>::colsize() const
-    { return pimpl->istrans ? pimpl->U.rowsize() : pimpl->U.colsize(); }
+    { return pimpl->istrans ? pimpl->Vt.rowsize() : pimpl->U.colsize(); }
 
     template <class T> 
     ptrdiff_t SVDiv<T>::rowsize() const
-    { return pimpl->istrans ? pimpl->U.colsize() : pimpl->U.rowsize(); }
+    { return pimpl->istrans ? pimpl->U.colsize() : pimpl->Vt.rowsize(); }
 
 #undef RT
 
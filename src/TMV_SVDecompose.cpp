@@ -45,6 +45,12 @@ using std::endl;
 #define dbgcout if(false) std::cout
 #endif
 
+// Above this size, the reduction to bidiagonal form is done in two 
+// stages.  See TMV_SVDecompose_TwoStage.cpp.
+#ifndef SVD_TWOSTAGE_LIMIT
+#define SVD_TWOSTAGE_LIMIT 512
+#endif
+
 namespace tmv {
 
 #define RT TMV_RealType(T)
@@ -797,6 +803,22 @@ namespace tmv {
                 if (N > 1) U.rowRange(0,N).lowerTri().offDiag().setZero();
                 SV_Decompose(U.rowRange(0,N),S,Vt,logdet,signdet,StoreU);
             }
+        } else if (N >= SVD_TWOSTAGE_LIMIT) {
+            // For large matrices, reduce A to bidiagonal form in two 
+            // stages.  This forms U and Vt directly (if they are wanted).
+            Vector<RT> E(N-1);
+            TwoStageBidiagonalize(U,S.diag(),E.view(),Vt,StoreU,signdet);
+            if (signdet != T(0)) {
+                RT s;
+                logdet += S.logDet(&s);
+                signdet *= s;
+            }
+            if (StoreU) {
+                SV_DecomposeFromBidiagonal<T>(U,S.diag(),E.view(),Vt);
+            } else {
+                MatrixView<T> U2(0,0,0,1,1,NonConj);
+                SV_DecomposeFromBidiagonal<T>(U2,S.diag(),E.view(),Vt);
+            }
         } else {
             // First we reduce A to bidiagonal form: A = U * B * Vt
             // using a series of Householder transformations.
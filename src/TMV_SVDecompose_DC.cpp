@@ -31,6 +31,10 @@
 #include <iostream>
 using std::endl;
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #ifdef _OPENMP
 
@@ -99,13 +103,72 @@ namespace tmv {
 #endif
 
     // Note about OpenMP here.
-    // Both the divide step (recursing on SV_DecomposeFromBidiagonal_DC) 
-    // and the conquer step (the loop in FindDCSingularValues) are
-    // pontentially parallelizable.  However, recursive functions do not
-    // lend themselves to being parallelized by OPENMP very easily.
-    // So I think I need to rewrite the divide step in a way that does
-    // not rely on recursion before I apply OPENMP pragmas to it.
-    // So for now, we only have recursion in the FindDCSingularValues function.
+    // Both the divide step (recursing on DoSV_DecomposeFromBidiagonal_DC) 
+    // and the conquer step (the loop in FindDCSingularValues and the
+    // updates of U and Vt) are parallelized.
+    //
+    // The recursion is done with OpenMP tasks: SV_DecomposeFromBidiagonal_DC
+    // starts a parallel region, and then each divide step makes a task for
+    // each of the two subproblems.  Once we are in the parallel region,
+    // the conquer steps also split their work into tasks rather than
+    // starting new (nested) parallel regions.  Subproblems smaller than
+    // DC_TASK_LIMIT are done by the current task, since the overhead of
+    // the task is not worth it for them.
+#define DC_TASK_LIMIT 128
+
+#ifdef _OPENMP
+    ptrdiff_t DC_TaskBlockSize(ptrdiff_t n, ptrdiff_t minblock)
+    {
+        // Aim for about 4 tasks per thread, to help with load balancing.
+        const ptrdiff_t nthreads = omp_get_num_threads();
+        ptrdiff_t nb = (n-1)/(4*nthreads) + 1;
+        return nb < minblock ? minblock : nb;
+    }
+#endif
+
+    template <class T>
+    void DC_MultRight(MatrixView<T> U, const GenMatrix<RT>& X)
+    {
+        // U = U * X
+#ifdef _OPENMP
+        const ptrdiff_t M = U.colsize();
+        if (omp_in_parallel() && M > DC_TASK_LIMIT) {
+            // Each task does a block of rows of U.
+            const ptrdiff_t nb = DC_TaskBlockSize(M,DC_TASK_LIMIT/2);
+            for(ptrdiff_t i1=0;i1<M;i1+=nb) {
+                const ptrdiff_t i2 = TMV_MIN(i1+nb,M);
+#pragma omp task default(shared) firstprivate(i1,i2)
+                U.rowRange(i1,i2) *= X;
+            }
+#pragma omp taskwait
+        } else
+#endif
+        {
+            U *= X;
+        }
+    }
+
+    template <class T>
+    void DC_MultLeft(const GenMatrix<RT>& Y, MatrixView<T> Vt)
+    {
+        // Vt = Y * Vt
+#ifdef _OPENMP
+        const ptrdiff_t N = Vt.rowsize();
+        if (omp_in_parallel() && N > DC_TASK_LIMIT) {
+            // Each task does a block of columns of Vt.
+            const ptrdiff_t nb = DC_TaskBlockSize(N,DC_TASK_LIMIT/2);
+            for(ptrdiff_t j1=0;j1<N;j1+=nb) {
+                const ptrdiff_t j2 = TMV_MIN(j1+nb,N);
+#pragma omp task default(shared) firstprivate(j1,j2)
+                Vt.colRange(j1,j2) = Y * Vt.colRange(j1,j2);
+            }
+#pragma omp taskwait
+        } else
+#endif
+        {
+            Vt = Y * Vt;
+        }
+    }
 
     template <class T> 
     static T FindDCSingularValue(
@@ -805,6 +868,25 @@ namespace tmv {
         const T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
+        if (omp_in_parallel()) {
+            // Then we are already inside the divide and conquer recursion,
+            // so split the loop into tasks.
+            const ptrdiff_t nb = DC_TaskBlockSize(N,16);
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
+                {
+                    Vector<T> sum(N);
+                    for(ptrdiff_t k=k1;k<k2;k++) {
+                        S[k] = FindDCSingularValue(
+                            k,N,rho,D.cptr(),z.cptr(),
+                            zsq.cptr(),normsqz,diffmat.col(k).ptr(),
+                            sum.ptr());
+                    }
+                }
+            }
+#pragma omp taskwait
+        } else
 #pragma omp parallel 
         {
             Vector<T> diff(N);
@@ -858,6 +940,23 @@ namespace tmv {
         T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
+        if (omp_in_parallel()) {
+            const ptrdiff_t nb = DC_TaskBlockSize(N,16);
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
+                {
+                    Vector<T> diff(N);
+                    Vector<T> sum(N);
+                    for(ptrdiff_t k=k1;k<k2;k++) {
+                        S[k] = FindDCSingularValue(
+                            k,N,rho,D.cptr(),z.cptr(),
+                            zsq.cptr(),normsqz,diff.ptr(),sum.ptr());
+                    }
+                }
+            }
+#pragma omp taskwait
+        } else
 #pragma omp parallel
         {
             Vector<T> diff(N);
@@ -906,7 +1005,7 @@ namespace tmv {
     }
 
     template <class T> 
-    void SV_DecomposeFromBidiagonal_DC(
+    static void DoSV_DecomposeFromBidiagonal_DC(
         MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, MatrixView<T> Vt,
         bool UisI, bool VisI)
     {
@@ -1079,57 +1178,76 @@ namespace tmv {
             const RT EK = E(K);
             Vector<RT> z(N,RT(0));
 
+            // The two sub-problems use disjoint parts of D, E, U, Vt and z,
+            // so they can be done in parallel.
+#ifdef _OPENMP
+            const bool dotask = omp_in_parallel() && N > DC_TASK_LIMIT;
+#endif
+
             // Do the left sub-problem
-            VectorView<RT> D1 = D.subVector(0,K);
-            VectorView<RT> E1 = E.subVector(0,K);
-            Matrix<RT,RowMajor> Vt1(K+1,Vt.cptr()?K+1:1);
-            if (Vt.cptr()) Vt1.setToIdentity();
-            else Vt1.col(0).makeBasis(K); // only need col(K)
-            BidiagonalZeroLastCol<RT>(D1,E1,Vt1.view());
-            if (U.cptr()) {
-                Matrix<RT,ColMajor> U1(K,K);
-                U1.setToIdentity();
-                SV_DecomposeFromBidiagonal_DC<RT>(
-                    U1.view(),D1,
-                    E1.subVector(0,K-1),Vt1.rowRange(0,K),true,false);
-                if (UisI) U.subMatrix(0,K,0,K) = U1;
-                else U.colRange(0,K) *= U1;
-            } else {
-                MatrixView<RT> U1(0,0,0,1,1,NonConj);
-                SV_DecomposeFromBidiagonal_DC<RT>(
-                    U1,D1,E1.subVector(0,K-1),
-                    Vt1.rowRange(0,K),false,false);
-            }
-            z.subVector(0,K+1) = DK * Vt1.col(Vt.cptr() ? K : 0);
-            if (Vt.cptr()) {
-                if (VisI) Vt.subMatrix(0,K+1,0,K+1) = Vt1;
-                else Vt.rowRange(0,K+1) = Vt1 * Vt.rowRange(0,K+1);
+#ifdef _OPENMP
+#pragma omp task default(shared) if(dotask)
+#endif
+            {
+                VectorView<RT> D1 = D.subVector(0,K);
+                VectorView<RT> E1 = E.subVector(0,K);
+                Matrix<RT,RowMajor> Vt1(K+1,Vt.cptr()?K+1:1);
+                if (Vt.cptr()) Vt1.setToIdentity();
+                else Vt1.col(0).makeBasis(K); // only need col(K)
+                BidiagonalZeroLastCol<RT>(D1,E1,Vt1.view());
+                if (U.cptr()) {
+                    Matrix<RT,ColMajor> U1(K,K);
+                    U1.setToIdentity();
+                    DoSV_DecomposeFromBidiagonal_DC<RT>(
+                        U1.view(),D1,
+                        E1.subVector(0,K-1),Vt1.rowRange(0,K),true,false);
+                    if (UisI) U.subMatrix(0,K,0,K) = U1;
+                    else DC_MultRight(U.colRange(0,K),U1);
+                } else {
+                    MatrixView<RT> U1(0,0,0,1,1,NonConj);
+                    DoSV_DecomposeFromBidiagonal_DC<RT>(
+                        U1,D1,E1.subVector(0,K-1),
+                        Vt1.rowRange(0,K),false,false);
+                }
+                z.subVector(0,K+1) = DK * Vt1.col(Vt.cptr() ? K : 0);
+                if (Vt.cptr()) {
+                    if (VisI) Vt.subMatrix(0,K+1,0,K+1) = Vt1;
+                    else DC_MultLeft(Vt1,Vt.rowRange(0,K+1));
+                }
             }
 
             // Do the right sub-problem
-            VectorView<RT> D2 = D.subVector(K+1,N);
-            VectorView<RT> E2 = E.subVector(K+1,N-1);
-            Matrix<RT,RowMajor> Vt2(N-K-1,Vt.cptr()?N-K-1:1);
-            if (Vt.cptr()) Vt2.setToIdentity();
-            else Vt2.col(0).makeBasis(0); // only need col(0)
-            if (U.cptr()) {
-                Matrix<RT,ColMajor> U2(N-K-1,N-K-1);
-                U2.setToIdentity();
-                SV_DecomposeFromBidiagonal_DC<RT>(
-                    U2.view(),D2,E2,Vt2.view(),true,Vt.cptr());
-                if (UisI) U.subMatrix(K+1,N,K+1,N) = U2;
-                else U.colRange(K+1,N) *= U2;
-            } else {
-                MatrixView<RT> U1(0,0,0,1,1,NonConj);
-                SV_DecomposeFromBidiagonal_DC<RT>(
-                    U1,D2,E2,Vt2.view(),false,Vt.cptr());
+#ifdef _OPENMP
+#pragma omp task default(shared) if(dotask)
+#endif
+            {
+                VectorView<RT> D2 = D.subVector(K+1,N);
+                VectorView<RT> E2 = E.subVector(K+1,N-1);
+                Matrix<RT,RowMajor> Vt2(N-K-1,Vt.cptr()?N-K-1:1);
+                if (Vt.cptr()) Vt2.setToIdentity();
+                else Vt2.col(0).makeBasis(0); // only need col(0)
+                if (U.cptr()) {
+                    Matrix<RT,ColMajor> U2(N-K-1,N-K-1);
+                    U2.setToIdentity();
+                    DoSV_DecomposeFromBidiagonal_DC<RT>(
+                        U2.view(),D2,E2,Vt2.view(),true,Vt.cptr());
+                    if (UisI) U.subMatrix(K+1,N,K+1,N) = U2;
+                    else DC_MultRight(U.colRange(K+1,N),U2);
+                } else {
+                    MatrixView<RT> U1(0,0,0,1,1,NonConj);
+                    DoSV_DecomposeFromBidiagonal_DC<RT>(
+                        U1,D2,E2,Vt2.view(),false,Vt.cptr());
+                }
+                z.subVector(K+1,N) = EK * Vt2.col(0);
+                if (Vt.cptr()) {
+                    if (VisI) Vt.subMatrix(K+1,N,K+1,N) = Vt2;
+                    else DC_MultLeft(Vt2,Vt.rowRange(K+1,N));
+                }
             }
-            z.subVector(K+1,N) = EK * Vt2.col(0);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
             D(K) = RT(0);
-            if (Vt.cptr()) {
-                if (VisI) Vt.subMatrix(K+1,N,K+1,N) = Vt2;
-                else Vt.rowRange(K+1,N) = Vt2 * Vt.rowRange(K+1,N);
-            }
 #ifdef XDEBUG
             dbgcout<<"Done subproblems (N="<<N<<")\n";
             dbgcout<<"D = "<<D<<endl;
@@ -1396,7 +1514,7 @@ namespace tmv {
                             W.col(j) /= (normyj(j) = Norm(W.col(j)));
                         }
                         // Vt = Y * Vt
-                        Vt.rowRange(0,N) = W.transpose() * Vt.rowRange(0,N);
+                        DC_MultLeft(W.transpose(),Vt.rowRange(0,N));
                         if (U.cptr()) for(ptrdiff_t j=0;j<N;j++) W.col(j) *= normyj(j);
                     }
                     if (U.cptr()) {
@@ -1405,7 +1523,7 @@ namespace tmv {
                         for(ptrdiff_t i=1;i<N;i++) W.row(i) *= D(i);
                         for(ptrdiff_t j=0;j<N;j++) W.col(j) /= Norm(W.col(j));
                         // U = U * X
-                        U.colRange(0,N) *= W;
+                        DC_MultRight(U.colRange(0,N),W);
                     }
                 } else {
                     FindDCSingularValues(S,RT(1),DN,zN);
@@ -1516,6 +1634,29 @@ namespace tmv {
 #endif
     }
 
+    template <class T> 
+    void SV_DecomposeFromBidiagonal_DC(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, MatrixView<T> Vt,
+        bool UisI, bool VisI)
+    {
+#ifdef _OPENMP
+        // Start the parallel region for the recursion here, unless we are
+        // already in one.  If we are only calculating S, then we just use
+        // the QR method (see above), so there is nothing to parallelize.
+        if (D.size() > DC_TASK_LIMIT && (U.cptr() || Vt.cptr()) &&
+            !omp_in_parallel() && omp_get_max_threads() > 1) {
+#pragma omp parallel
+            {
+#pragma omp single
+                DoSV_DecomposeFromBidiagonal_DC(U,D,E,Vt,UisI,VisI);
+            }
+        } else 
+#endif
+        {
+            DoSV_DecomposeFromBidiagonal_DC(U,D,E,Vt,UisI,VisI);
+        }
+    }
+
 #undef RT
 
 #ifdef INST_INT
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//#define XDEBUG
+
+// This file implements the randomized truncated SVD of 
+// Halko, Martinsson & Tropp (2011, SIAM Review, 53, 217):
+//
+// 1) Y = A Omega, where Omega is an N x l matrix of Gaussian deviates,
+//    and l = k + oversample.
+// 2) Power iterations: Y = (A At)^q Y, orthonormalizing in between
+//    to avoid losing the smaller singular values to round off error.
+// 3) Q = the orthonormal basis for the range of Y (from a QR 
+//    decomposition).  Then A ~= Q Qt A.
+// 4) The SVD of the small matrix B = Qt A = W S Vt gives A ~= (QW) S Vt.
+//
+// Essentially all of the work is in the matrix products with A, 
+// which are multithreaded with OpenMP.
+
+#include "tmv/TMV_SVD.h"
+#include "TMV_SVDiv.h"
+#include "TMV_QRDiv.h"
+#include "TMV_Random.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_DiagMatrix.h"
+#include "tmv/TMV_MatrixArith.h"
+#include <cmath>
+
+#ifdef XDEBUG
+#include "tmv/TMV_DiagMatrixArith.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#endif
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    template <class T> 
+    static inline void SetGaussian(XorShiftRandom& g, T& x)
+    { x = T(g.gaussian()); }
+
+    template <class T> 
+    static inline void SetGaussian(XorShiftRandom& g, std::complex<T>& x)
+    { T xr = T(g.gaussian()); x = std::complex<T>(xr,T(g.gaussian())); }
+
+    template <class T> 
+    static void Orthonormalize(MatrixView<T> Y, VectorView<T> beta)
+    {
+        // Replace Y with the Q of its QR decomposition.
+        T d(0);
+        QR_Decompose(Y,beta,d);
+        GetQFromQR(Y,beta);
+    }
+
+    template <class T> 
+    void RandomSV_Decompose(
+        const GenMatrix<T>& A, MatrixView<T> U, DiagMatrixView<RT> S,
+        MatrixView<T> Vt, ptrdiff_t oversample, ptrdiff_t niter)
+    {
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        const ptrdiff_t k = S.size();
+        TMVAssert(U.colsize() == M);
+        TMVAssert(U.rowsize() == k);
+        TMVAssert(Vt.colsize() == k);
+        TMVAssert(Vt.rowsize() == N);
+        TMVAssert(k <= TMV_MIN(M,N));
+        TMVAssert(oversample >= 0);
+        TMVAssert(niter >= 0);
+
+        if (M < N) {
+            // A = U S Vt  <=>  AT = VtT S UT
+            RandomSV_Decompose(
+                A.transpose(),Vt.transpose(),S,U.transpose(),
+                oversample,niter);
+            return;
+        }
+        if (k == 0) return;
+
+        const ptrdiff_t l = TMV_MIN(k+oversample,N);
+        Vector<T> beta(l);
+
+        // Y = A Omega
+        Matrix<T,ColMajor> Omega(N,l);
+        XorShiftRandom g;
+        for(ptrdiff_t j=0;j<l;++j) for(ptrdiff_t i=0;i<N;++i) 
+            SetGaussian(g,Omega.ref(i,j));
+        Matrix<T,ColMajor> Y = A * Omega;
+
+        // Power iterations.  Omega is reused for At Y.
+        for(ptrdiff_t iter=0;iter<niter;++iter) {
+            Orthonormalize(Y.view(),beta.view());
+            Omega = A.adjoint() * Y;
+            Orthonormalize(Omega.view(),beta.view());
+            Y = A * Omega;
+        }
+        Orthonormalize(Y.view(),beta.view());
+
+        // Bt = AT Q* is N x l, so we can do its SVD directly:
+        // Bt = W S Xt  =>  B = X* S WT  =>  A ~= (Q X*) S WT
+        Matrix<T,ColMajor> W = A.transpose() * Y.conjugate();
+        DiagMatrix<RT> SS(l);
+        Matrix<T,ColMajor> Xt(l,l);
+        SV_Decompose(W.view(),SS.view(),Xt.view(),true);
+
+        S = SS.subDiagMatrix(0,k);
+        U = Y * Xt.transpose().colRange(0,k);
+        Vt = W.transpose().rowRange(0,k);
+
+#ifdef XDEBUG
+        cout<<"RandomSV_Decompose: k = "<<k<<", l = "<<l<<endl;
+        cout<<"S = "<<S.diag()<<endl;
+        cout<<"Norm(UtU-1) = "<<Norm(U.adjoint()*U-T(1))<<endl;
+        cout<<"Norm(VtV-1) = "<<Norm(Vt*Vt.adjoint()-T(1))<<endl;
+        cout<<"Norm(A-USVt) = "<<Norm(A-U*S*Vt)<<endl;
+#endif
+    }
+
+#undef RT
+
+#define InstFile "TMV_SVDecompose_Random.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
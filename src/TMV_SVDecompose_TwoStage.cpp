@@ -0,0 +1,436 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+//#define XDEBUG
+
+// This file implements a two-stage reduction of a general matrix to
+// bidiagonal form:
+//
+// Stage 1: A = U1 B V1t, where B is an upper band matrix with nb 
+// super-diagonals.  For each panel of nb columns, we QR decompose the 
+// panel and update the trailing matrix with the block reflector.  
+// Then we do the same for the block of nb rows to the right of the band
+// (as a QR decomposition of its transpose).  Essentially all of the work 
+// is in matrix products, which are multithreaded with OpenMP.
+//
+// Stage 2: B = U2 D V2t, where D is bidiagonal.  This is the bulge
+// chasing algorithm for band matrices.  Step 0 of sweep j annihilates
+// row j to the right of the super-diagonal with a reflector from the 
+// right, which creates a bulge below the diagonal.  The first column 
+// of that is annihilated from the left, which creates a bulge beyond 
+// the band further along.  And so on until the bulge falls off the end
+// of the matrix.  As for TwoStageTridiagonalize, successive sweeps
+// are pipelined across the OpenMP threads.
+//
+// U and Vt are only formed if they are requested, in which case the 
+// stage 2 reflectors are saved and then applied as block reflectors.
+
+#include "TMV_Blas.h"
+#include "TMV_SVDiv.h"
+#include "TMV_QRDiv.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_Householder.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_TriMatrixArith.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_VectorArith.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef XDEBUG
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#endif
+
+#ifndef SVD_TWOSTAGE_BANDWIDTH
+#define SVD_TWOSTAGE_BANDWIDTH 32
+#endif
+
+// Step k of one sweep may start once the previous sweep has finished
+// step k+SVD_TWOSTAGE_LAG-1.  Steps that are closer than this overlap.
+#define SVD_TWOSTAGE_LAG 4
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    template <class T> 
+    static void ReduceToUpperBand(
+        MatrixView<T> A, VectorView<T> Ubeta, VectorView<T> Vtbeta, 
+        const ptrdiff_t nb, T& signdet)
+    {
+        // Reduce A to an upper band matrix with nb super-diagonals.
+        // The Householder vectors for U1 are left below the diagonal
+        // in the usual format for GetQFromQR (with betas in Ubeta).
+        // The Householder vectors for V1t are left in the rows above
+        // the band, so the band-shifted transpose of the upper part
+        // of A is in the format for GetQFromQR (with betas in Vtbeta).
+        const ptrdiff_t M = A.colsize();
+        const ptrdiff_t N = A.rowsize();
+        TMVAssert(N <= M);
+        TMVAssert(N > nb);
+        TMVAssert(Ubeta.size() == N);
+        TMVAssert(Vtbeta.size() == N-nb);
+        TMVAssert(A.ct() == NonConj);
+
+        Vtbeta.setZero();
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> BaseZ(nb);
+
+        for(ptrdiff_t j1=0; j1<N; j1+=nb) {
+            const ptrdiff_t j2 = TMV_MIN(j1+nb,N);
+
+            // QR decompose the column panel, and apply Qt to the 
+            // rest of these rows.
+            MatrixView<T> P = A.subMatrix(j1,M,j1,j2);
+            VectorView<T> bP = Ubeta.subVector(j1,j2);
+            QR_Decompose(P,bP,signdet);
+            if (j2 == N) break;
+            UpperTriMatrixView<T> Z = BaseZ.subTriMatrix(0,j2-j1);
+            BlockHouseholderMakeZ(P,Z,bP);
+            BlockHouseholderLDiv(P,Z,A.subMatrix(j1,M,j2,N));
+
+            // Now the same thing for the transpose of the row panel
+            // to the right of the band.
+            const ptrdiff_t p = j1+nb;
+            const ptrdiff_t k = TMV_MIN(nb,N-p);
+            MatrixView<T> Pt = A.subMatrix(j1,j1+k,p,N).transpose();
+            VectorView<T> bPt = Vtbeta.subVector(j1,j1+k);
+            QR_Decompose(Pt,bPt,signdet);
+            UpperTriMatrixView<T> Zt = BaseZ.subTriMatrix(0,k);
+            BlockHouseholderMakeZ(Pt,Zt,bPt);
+            BlockHouseholderLDiv(Pt,Zt,A.subMatrix(j1+k,M,p,N).transpose());
+        }
+    }
+
+    template <class T> 
+    static void BidiagBulgeChaseStep(
+        MatrixView<T> B, const ptrdiff_t nb, 
+        const ptrdiff_t j, const ptrdiff_t k, 
+        T* vU, T& Ubeta, T* vV, T& Vtbeta, T& det)
+    {
+        // Do step k of sweep j.
+        // The reflector from the right annihilates row r to the right of
+        // column c1 = j+1+k*nb.  For k = 0, this is row j itself, and for 
+        // k > 0 it is the first row of the bulge beyond the band.  
+        // Then the reflector from the left annihilates column c1 below 
+        // the diagonal.
+        // B only needs to be valid from nb-1 below the diagonal to 
+        // 2nb-1 above it.
+        // If vU and vV are not 0, the Householder vectors are copied there.
+        const ptrdiff_t N = B.colsize();
+        const ptrdiff_t r = k==0 ? j : j+1+(k-1)*nb;
+        const ptrdiff_t c1 = j+1+k*nb;
+        const ptrdiff_t c2 = TMV_MIN(c1+nb,N);
+        const ptrdiff_t c3 = TMV_MIN(c2+nb,N);
+        TMVAssert(c1 < N);
+
+        // B <- B HT
+        VectorView<T> x = B.row(r,c1,c2);
+        VectorView<T> u = x.subVector(1,c2-c1);
+        Vtbeta = HouseholderReflect(x,det);
+        TMVAssert(TMV_IMAG(x(0)) == RT(0));
+        if (Vtbeta != T(0)) 
+            HouseholderLMult(u,Vtbeta,B.subMatrix(r+1,c2,c1,c2).transpose());
+        if (vV && u.size() > 0) VectorViewOf(vV,u.size()) = u;
+        u.setZero();
+
+        // B <- H B
+        VectorView<T> y = B.col(c1,c1,c2);
+        VectorView<T> w = y.subVector(1,c2-c1);
+        Ubeta = HouseholderReflect(y,det);
+        TMVAssert(TMV_IMAG(y(0)) == RT(0));
+        if (Ubeta != T(0) && c3 > c1+1) 
+            HouseholderLMult(w,Ubeta,B.subMatrix(c1,c2,c1+1,c3));
+        if (vU && w.size() > 0) VectorViewOf(vU,w.size()) = w;
+        w.setZero();
+    }
+
+    template <class T> 
+    static void BandToBidiagonal(
+        MatrixView<T> B, const ptrdiff_t nb, const ptrdiff_t* offset,
+        MatrixView<T> U2, VectorView<T> U2beta, 
+        MatrixView<T> V2, VectorView<T> V2beta, T& signdet)
+    {
+        // Reduce the upper band matrix B to bidiagonal form.
+        // The Householder vectors for step k of sweep j are stored in
+        // column offset[j]+k of U2 and V2, and the betas in U2beta
+        // and V2beta.  If U2 or V2 has no columns, those are not saved.
+        const ptrdiff_t N = B.colsize();
+        const ptrdiff_t nsweep = N-1;
+        const bool saveu = U2.rowsize() > 0;
+        const bool savev = V2.rowsize() > 0;
+        T* U2ptr = U2.ptr();
+        T* V2ptr = V2.ptr();
+        const ptrdiff_t U2s = U2.stepj();
+        const ptrdiff_t V2s = V2.stepj();
+        T* Ubptr = U2beta.ptr();
+        T* Vbptr = V2beta.ptr();
+        TMVAssert(U2beta.step() == 1);
+        TMVAssert(V2beta.step() == 1);
+        T dummy(0);
+
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            AlignedArray<ptrdiff_t> progress(nsweep);
+            for(ptrdiff_t j=0;j<nsweep;++j) progress[j] = 0;
+            ptrdiff_t* prog = progress.get();
+            // signdet is only written inside the critical section below,
+            // so don't read it again in the parallel region.
+            const bool dodet = signdet != T(0);
+#pragma omp parallel
+            {
+                const ptrdiff_t nthreads = omp_get_num_threads();
+                const ptrdiff_t mythread = omp_get_thread_num();
+                T mydet = dodet ? T(1) : T(0);
+                T mydummy1(0), mydummy2(0);
+                for(ptrdiff_t j=mythread;j<nsweep;j+=nthreads) {
+                    const ptrdiff_t ns = BulgeChaseNSteps(N,nb,j);
+                    const ptrdiff_t nsprev = j > 0 ? 
+                        BulgeChaseNSteps(N,nb,j-1) : 0;
+                    for(ptrdiff_t k=0;k<ns;++k) {
+                        if (j > 0) {
+                            const ptrdiff_t need = 
+                                TMV_MIN(k+SVD_TWOSTAGE_LAG,nsprev);
+                            ptrdiff_t done;
+                            do {
+#pragma omp atomic read
+                                done = prog[j-1];
+                            } while (done < need);
+#pragma omp flush
+                        }
+                        const ptrdiff_t jk = offset[j]+k;
+                        BidiagBulgeChaseStep(
+                            B,nb,j,k,
+                            saveu ? U2ptr+jk*U2s : (T*)(0),
+                            saveu ? Ubptr[jk] : mydummy1,
+                            savev ? V2ptr+jk*V2s : (T*)(0),
+                            savev ? Vbptr[jk] : mydummy2, mydet);
+#pragma omp flush
+#pragma omp atomic write
+                        prog[j] = k+1;
+                    }
+                }
+                if (dodet) {
+#pragma omp critical (TMV_BandToBidiag_SignDet)
+                    signdet *= mydet;
+                }
+            }
+            return;
+        }
+#endif
+        T dummy2(0);
+        for(ptrdiff_t j=0;j<nsweep;++j) {
+            const ptrdiff_t ns = BulgeChaseNSteps(N,nb,j);
+            for(ptrdiff_t k=0;k<ns;++k) {
+                const ptrdiff_t jk = offset[j]+k;
+                BidiagBulgeChaseStep(
+                    B,nb,j,k,
+                    saveu ? U2ptr+jk*U2s : (T*)(0),
+                    saveu ? Ubptr[jk] : dummy,
+                    savev ? V2ptr+jk*V2s : (T*)(0),
+                    savev ? Vbptr[jk] : dummy2, signdet);
+            }
+        }
+    }
+
+    template <class T> 
+    static void DoMultBulgeChaseQ(
+        MatrixView<T> U, const ptrdiff_t nb, const ptrdiff_t* offset,
+        const GenMatrix<T>& V2, const GenVector<T>& beta2)
+    {
+        // Within a group of nb consecutive sweeps, reflectors with 
+        // different k only overlap if they are from consecutive steps,
+        // in which case the one with the larger k comes first.
+        // So we can apply all the reflectors with the same k together
+        // as a block reflector, going from the last step to the first.
+        // Different groups of sweeps are applied in order.
+        const ptrdiff_t N = U.rowsize();
+        const ptrdiff_t nsweep = N-1;
+        Matrix<T,ColMajor> BaseY(2*nb-1,nb);
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> BaseZ(nb);
+        Vector<T> bY(nb);
+
+        for(ptrdiff_t j0=0;j0<nsweep;j0+=nb) {
+            const ptrdiff_t j1 = TMV_MIN(j0+nb,nsweep);
+            for(ptrdiff_t k=BulgeChaseNSteps(N,nb,j0)-1;k>=0;--k) {
+                // The sweeps that have a step k are j0..j0+g-1.
+                ptrdiff_t g = 1;
+                while (j0+g < j1 && BulgeChaseNSteps(N,nb,j0+g) > k) ++g;
+                const ptrdiff_t r1 = j0+1+k*nb;
+                const ptrdiff_t nr = TMV_MIN(nb+g-1,N-r1);
+                MatrixView<T> Y = BaseY.subMatrix(0,nr,0,g);
+                Y.setZero();
+                for(ptrdiff_t q=0;q<g;++q) {
+                    const ptrdiff_t len = TMV_MIN(nb,N-r1-q);
+                    const ptrdiff_t jq = offset[j0+q]+k;
+                    Y(q,q) = T(1);
+                    Y.col(q,q+1,q+len) = V2.col(jq,0,len-1);
+                    bY(q) = beta2(jq);
+                }
+                UpperTriMatrixView<T> Z = BaseZ.subTriMatrix(0,g);
+                BlockHouseholderMakeZ(Y,Z,bY.subVector(0,g));
+                // (U Qg) = (Qgt Ut)t, and LDiv multiplies by Qgt.
+                BlockHouseholderLDiv(Y,Z,U.colRange(r1,r1+nr).adjoint());
+            }
+        }
+    }
+
+    template <class T> 
+    void MultBulgeChaseQ(
+        MatrixView<T> U, ptrdiff_t nb, const ptrdiff_t* offset,
+        const GenMatrix<T>& V2, const GenVector<T>& beta2)
+    {
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            const ptrdiff_t M = U.colsize();
+#pragma omp parallel
+            {
+                const ptrdiff_t nthreads = omp_get_num_threads();
+                const ptrdiff_t mythread = omp_get_thread_num();
+                const ptrdiff_t i1 = (mythread * M) / nthreads;
+                const ptrdiff_t i2 = ((mythread+1) * M) / nthreads;
+                if (i2 > i1) 
+                    DoMultBulgeChaseQ(U.rowRange(i1,i2),nb,offset,V2,beta2);
+            }
+        } else 
+#endif
+        {
+            DoMultBulgeChaseQ(U,nb,offset,V2,beta2);
+        }
+    }
+
+    template <class T> 
+    void TwoStageBidiagonalize(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, 
+        MatrixView<T> Vt, bool StoreU, T& signdet)
+    {
+        // Decompose A (input as U) into U B Vt, where B is real 
+        // bidiagonal.  B is returned in D and E.
+        // U is only set if StoreU, and Vt is only set if Vt.cptr() != 0.
+        // Otherwise the stage 2 reflectors for them are not even saved.
+        const ptrdiff_t M = U.colsize();
+        const ptrdiff_t N = U.rowsize();
+        const ptrdiff_t nb = SVD_TWOSTAGE_BANDWIDTH;
+        TMVAssert(N <= M);
+        TMVAssert(D.size() == N);
+        TMVAssert(E.size() == N-1);
+        TMVAssert(U.ct() == NonConj);
+        TMVAssert(N > 2*nb);
+        if (Vt.cptr()) {
+            TMVAssert(Vt.colsize() == N);
+            TMVAssert(Vt.rowsize() == N);
+            TMVAssert(Vt.ct() == NonConj);
+        }
+
+#ifdef XDEBUG
+        Matrix<T> A0(U);
+#endif
+
+        // Stage 1: Reduce to upper band form.
+        Vector<T> Ubeta1(N);
+        Vector<T> Vtbeta1(N-nb);
+        ReduceToUpperBand(U,Ubeta1.view(),Vtbeta1.view(),nb,signdet);
+
+        // Copy the band into a work array with room for the bulges.
+        // Element (i,j) of B is at Bmem[2nb + i + j*3nb], which is valid 
+        // for -2nb <= i-j <= nb.
+        const ptrdiff_t L = 3*nb;
+        const ptrdiff_t off = 2*nb;
+        AlignedArray<T> Bmem(off+N*(L+1));
+        for(ptrdiff_t i=0;i<off+N*(L+1);++i) Bmem[i] = T(0);
+        MatrixView<T> B = MatrixViewOf(Bmem.get()+off,N,N,1,L);
+        for(ptrdiff_t j=0;j<N;++j) {
+            const ptrdiff_t i1 = TMV_MAX(j-nb,ptrdiff_t(0));
+            B.col(j,i1,j+1) = U.col(j,i1,j+1);
+        }
+
+        // Stage 2: Reduce the band to bidiagonal form.
+        AlignedArray<ptrdiff_t> offset(N);
+        offset[0] = 0;
+        for(ptrdiff_t j=0;j<N-1;++j) 
+            offset[j+1] = offset[j] + BulgeChaseNSteps(N,nb,j);
+        const ptrdiff_t nqu = StoreU ? offset[N-1] : 0;
+        const ptrdiff_t nqv = Vt.cptr() ? offset[N-1] : 0;
+        Matrix<T,ColMajor> U2(nb-1,nqu);
+        Vector<T> U2beta(nqu);
+        Matrix<T,ColMajor> V2(nb-1,nqv);
+        Vector<T> V2beta(nqv);
+        BandToBidiagonal(
+            B,nb,offset.get(),U2.view(),U2beta.view(),
+            V2.view(),V2beta.view(),signdet);
+        D = B.diag().realPart();
+        E = B.diag(1).realPart();
+
+        if (Vt.cptr()) {
+            // Vt = V1t, formed the same way that Bidiagonalize's Vt is 
+            // formed, but with the vectors offset by nb rather than 1.
+            Vt.subMatrix(0,nb,0,N).setZero();
+            Vt.subMatrix(0,nb,0,nb).diag().setAllTo(T(1));
+            Vt.subMatrix(nb,N,0,nb).setZero();
+            Vt.subMatrix(nb,N,nb,N) = U.subMatrix(0,N-nb,nb,N);
+            GetQFromQR(Vt.subMatrix(nb,N,nb,N).transpose(),Vtbeta1);
+            // Vt = V2t V1t, so VtT = V1tT V2tT, and V2tT has the same
+            // form as U2.
+            MultBulgeChaseQ(Vt.transpose(),nb,offset.get(),V2,V2beta);
+        }
+        if (StoreU) {
+            // U = U1 U2
+            GetQFromQR(U,Ubeta1);
+            MultBulgeChaseQ(U,nb,offset.get(),U2,U2beta);
+        }
+
+#ifdef XDEBUG
+        if (StoreU && Vt.cptr()) {
+            Matrix<T> BB(N,N,T(0));
+            BB.diag() = D; BB.diag(1) = E;
+            Matrix<T> A2 = U*BB*Vt;
+            cout<<"TwoStageBidiagonalize: Norm(A0-UBVt) = "<<
+                Norm(A0-A2)<<endl;
+            if (!(Norm(A2-A0) < 0.001*Norm(A0))) {
+                cerr<<"TwoStageBidiagonalize: \n";
+                cerr<<"A0 = "<<A0<<endl;
+                cerr<<"U = "<<U<<endl;
+                cerr<<"D = "<<D<<endl;
+                cerr<<"E = "<<E<<endl;
+                cerr<<"Vt = "<<Vt<<endl;
+                cerr<<"UBVt = "<<A2<<endl;
+                abort();
+            }
+        }
+#endif
+    }
+
+#undef RT
+
+#define InstFile "TMV_SVDecompose_TwoStage.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
@@ -91,6 +91,42 @@ namespace tmv {
     void FindDCSingularValues(
         Vector<T>& S, const T rho, const GenVector<T>& D, const GenVector<T>& z);
 
+    // The U = U * X and Vt = Y * Vt products of the divide and conquer 
+    // algorithms (for both SVD and Eigen).  When called from inside a 
+    // parallel region, these are split into OpenMP tasks.
+    template <typename T> 
+    void DC_MultRight(MatrixView<T> U, const GenMatrix<RT>& X);
+
+    template <typename T> 
+    void DC_MultLeft(const GenMatrix<RT>& Y, MatrixView<T> Vt);
+
+    // The two-stage reductions to bidiagonal or tridiagonal form for 
+    // large matrices.  The first stage reduces the matrix to a band 
+    // matrix, and the second stage chases the bulges down the band.
+    template <typename T> 
+    void TwoStageBidiagonalize(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, 
+        MatrixView<T> Vt, bool StoreU, T& signdet);
+
+    // The number of bulge chasing steps in sweep j for a band of 
+    // width nb.  The last sweep only has to make the last off-diagonal
+    // element real.
+    inline ptrdiff_t BulgeChaseNSteps(ptrdiff_t N, ptrdiff_t nb, ptrdiff_t j)
+    { return j < N-2 ? 1 + (N-3-j)/nb : 1; }
+
+    // U <- U Q2, where Q2 is the product of the Hjkt from the bulge 
+    // chasing.  The Householder vector for step k of sweep j is in 
+    // column offset[j]+k of V2 (without the leading 1).
+    template <typename T> 
+    void MultBulgeChaseQ(
+        MatrixView<T> U, ptrdiff_t nb, const ptrdiff_t* offset,
+        const GenMatrix<T>& V2, const GenVector<T>& beta2);
+
+#ifdef _OPENMP
+    // The block size to use for splitting a loop of length n into tasks.
+    ptrdiff_t DC_TaskBlockSize(ptrdiff_t n, ptrdiff_t minblock);
+#endif
+
 
 #define CTx std::complex<Tx>
 
@@ -0,0 +1,295 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#include "tmv/TMV_SolveQueue.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <deque>
+#include <exception>
+#include <thread>
+#define TMV_SOLVEQUEUE_BATCH
+#endif
+
+namespace tmv {
+
+    template <typename T>
+    struct SolveQueue<T>::SolveQueue_Impl
+    {
+        SolveQueue_Impl(
+            const Factorization<T>& _f, ptrdiff_t _maxBatch,
+            double _maxWait) :
+            f(_f), maxBatch(_maxBatch), maxWait(_maxWait),
+            nsolved(0), npanels(0)
+#ifdef TMV_SOLVEQUEUE_BATCH
+            , nsolving(0),
+            maxSolving(TMV_MAX(ptrdiff_t(1),
+                               ptrdiff_t(std::thread::hardware_concurrency())))
+#endif
+        {}
+
+        const Factorization<T> f;
+        ptrdiff_t maxBatch;
+        double maxWait;
+        ptrdiff_t nsolved;
+        ptrdiff_t npanels;
+
+#ifdef TMV_SOLVEQUEUE_BATCH
+        typedef std::chrono::steady_clock Clock;
+
+        // A panel of right hand sides that will be solved together.
+        // The thread that starts a panel is its leader, which solves it.
+        struct Panel
+        {
+            Panel(ptrdiff_t n, ptrdiff_t maxk) :
+                x(n,maxk), k(0), full(false), done(false), 
+                start(Clock::now()) {}
+
+            Matrix<T,ColMajor> x;
+            ptrdiff_t k;
+            bool full;    // No more columns may be added.
+            bool done;    // The solution (or err) is set.
+            Clock::time_point start;
+            std::exception_ptr err;  // What the division threw, if anything.
+            std::condition_variable cv;
+        };
+
+        // The leader of p waits here until it should solve p.
+        void waitToSolve(
+            std::unique_lock<std::mutex>& lock, 
+            const std::shared_ptr<Panel>& p);
+
+        mutable std::mutex mu;
+        std::condition_variable leadcv;  // A panel filled or a solve ended.
+        std::shared_ptr<Panel> cur;      // The panel being filled.
+        ptrdiff_t nsolving;   // The number of panels being solved.
+        ptrdiff_t maxSolving; // Partial panels wait while this many are.
+#endif
+    };
+
+#ifdef TMV_SOLVEQUEUE_BATCH
+    template <typename T>
+    void SolveQueue<T>::SolveQueue_Impl::waitToSolve(
+        std::unique_lock<std::mutex>& lock, const std::shared_ptr<Panel>& p)
+    {
+        // A full panel is solved right away, so several panels may be 
+        // solved at once.  Otherwise, the panel collects requests for 
+        // maxWait seconds from when it was started.  After that, it 
+        // keeps collecting only while all the threads are busy solving 
+        // other panels, which bounds the wait by the time of one solve.
+        const Clock::time_point deadline = p->start + 
+            std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(maxWait));
+        while (!p->full) {
+            if (Clock::now() < deadline) leadcv.wait_until(lock,deadline);
+            else if (nsolving >= maxSolving) leadcv.wait(lock);
+            else break;
+        }
+    }
+#endif
+
+    template <typename T>
+    SolveQueue<T>::SolveQueue(
+        const Factorization<T>& f, ptrdiff_t maxBatch, double maxWait) :
+        pimpl(new SolveQueue_Impl(f,maxBatch,maxWait))
+    {
+        TMVAssert(!f.isEmpty());
+        TMVAssert(f.colsize() == f.rowsize());
+        TMVAssert(maxBatch > 0);
+        TMVAssert(maxWait >= 0.);
+    }
+
+    template <typename T>
+    SolveQueue<T>::~SolveQueue() {}
+
+    template <typename T>
+    void SolveQueue<T>::LDivEq(MatrixView<T> m)
+    {
+        TMVAssert(m.colsize() == pimpl->f.colsize());
+        const ptrdiff_t k = m.rowsize();
+        if (k == 0) return;
+
+#ifdef TMV_SOLVEQUEUE_BATCH
+        typedef typename SolveQueue_Impl::Panel Panel;
+        std::unique_lock<std::mutex> lock(pimpl->mu);
+
+        if (k >= pimpl->maxBatch) {
+            // Already at least a full panel, so no need to wait for more.
+            pimpl->nsolved += k;
+            ++pimpl->npanels;
+            lock.unlock();
+            pimpl->f.LDivEq(m);
+            return;
+        }
+
+        // Add m to the current panel, or start a new one if it won't fit.
+        std::shared_ptr<Panel> p = pimpl->cur;
+        const bool leader = !p || p->k + k > p->x.rowsize();
+        if (leader) {
+            if (p) {
+                p->full = true;
+                pimpl->leadcv.notify_all();
+            }
+            p = std::make_shared<Panel>(m.colsize(),pimpl->maxBatch);
+            pimpl->cur = p;
+        }
+        const ptrdiff_t j1 = p->k;
+        p->k += k;
+        p->x.colRange(j1,j1+k) = m;
+        if (p->k == p->x.rowsize()) {
+            p->full = true;
+            pimpl->leadcv.notify_all();
+        }
+
+        if (leader) {
+            // Each panel is solved by the thread that started it, so 
+            // this thread only waits for its own panel, no matter how
+            // many other requests keep arriving.
+            pimpl->waitToSolve(lock,p);
+            p->full = true;
+            if (pimpl->cur == p) pimpl->cur.reset();
+            const ptrdiff_t kp = p->k;
+            pimpl->nsolved += kp;
+            ++pimpl->npanels;
+            ++pimpl->nsolving;
+
+            // No one else writes to p now, so solve it without the lock.
+            // Meanwhile, new requests collect into the next panel.
+            lock.unlock();
+#ifndef NOTHROW
+            try {
+#endif
+                pimpl->f.LDivEq(p->x.colRange(0,kp));
+#ifndef NOTHROW
+            } catch (...) {
+                p->err = std::current_exception();
+            }
+#endif
+            lock.lock();
+            --pimpl->nsolving;
+            p->done = true;
+            p->cv.notify_all();
+            pimpl->leadcv.notify_all();
+        } else {
+            p->cv.wait(lock,[&p]() { return p->done; });
+        }
+        lock.unlock();
+#ifndef NOTHROW
+        if (p->err) std::rethrow_exception(p->err);
+#endif
+        m = p->x.colRange(j1,j1+k);
+#else
+        // Without C++11 threads, there is no batching, so each call is 
+        // solved immediately, and any exception propagates directly.
+        pimpl->f.LDivEq(m);
+#ifdef _OPENMP
+#pragma omp critical (tmv_solvequeue_count)
+#endif
+        {
+            pimpl->nsolved += k;
+            ++pimpl->npanels;
+        }
+#endif
+    }
+
+    template <typename T>
+    void SolveQueue<T>::LDivEq(VectorView<T> v)
+    { LDivEq(ColVectorViewOf(v)); }
+
+    template <typename T>
+    void SolveQueue<T>::LDiv(const GenMatrix<T>& m, MatrixView<T> x)
+    {
+        TMVAssert(m.colsize() == x.colsize());
+        TMVAssert(m.rowsize() == x.rowsize());
+        x = m;
+        LDivEq(x);
+    }
+
+    template <typename T>
+    void SolveQueue<T>::LDiv(const GenVector<T>& v, VectorView<T> x)
+    {
+        TMVAssert(v.size() == x.size());
+        x = v;
+        LDivEq(x);
+    }
+
+    template <typename T>
+    const Factorization<T>& SolveQueue<T>::getFactorization() const
+    { return pimpl->f; }
+
+    template <typename T>
+    ptrdiff_t SolveQueue<T>::getMaxBatch() const
+    { return pimpl->maxBatch; }
+
+    template <typename T>
+    void SolveQueue<T>::setMaxBatch(ptrdiff_t maxBatch)
+    {
+        TMVAssert(maxBatch > 0);
+#ifdef TMV_SOLVEQUEUE_BATCH
+        std::lock_guard<std::mutex> lock(pimpl->mu);
+#endif
+        pimpl->maxBatch = maxBatch;
+    }
+
+    template <typename T>
+    double SolveQueue<T>::getMaxWait() const
+    { return pimpl->maxWait; }
+
+    template <typename T>
+    void SolveQueue<T>::setMaxWait(double maxWait)
+    {
+        TMVAssert(maxWait >= 0.);
+#ifdef TMV_SOLVEQUEUE_BATCH
+        std::lock_guard<std::mutex> lock(pimpl->mu);
+#endif
+        pimpl->maxWait = maxWait;
+    }
+
+    template <typename T>
+    ptrdiff_t SolveQueue<T>::getNumSolved() const
+    {
+#ifdef TMV_SOLVEQUEUE_BATCH
+        std::lock_guard<std::mutex> lock(pimpl->mu);
+#endif
+        return pimpl->nsolved;
+    }
+
+    template <typename T>
+    ptrdiff_t SolveQueue<T>::getNumPanels() const
+    {
+#ifdef TMV_SOLVEQUEUE_BATCH
+        std::lock_guard<std::mutex> lock(pimpl->mu);
+#endif
+        return pimpl->npanels;
+    }
+
+#define InstFile "TMV_SolveQueue.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
@@ -29,11 +29,17 @@
 #include "tmv/TMV_SymBandMatrix.h"
 #include "tmv/TMV_BandMatrixArith.h"
 #include "tmv/TMV_SymMatrixArith.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_TriMatrixArith.h"
 
 #ifdef NOTHROW
 #include <iostream>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #include "tmv/TMV_BandMatrixArith.h"
 #include "tmv/TMV_MatrixArith.h"
@@ -185,12 +191,146 @@ namespace tmv {
 #endif
     }
 
+#ifdef TMV_BLOCKSIZE
+#define SBCH_BLOCKSIZE (TMV_BLOCKSIZE/2)
+#else
+#define SBCH_BLOCKSIZE 32
+#endif
+
+    template <bool cm, class T> 
+    static void BlockCH_Decompose(SymBandMatrixView<T> A)
+    {
+        // For wide bands, we can take advantage of Blas Level 3 speed
+        // by partitioning the matrix into blocks (like LAPACK's pbtrf).
+        // At each step, with kd = nlo and nb = the block size:
+        //
+        // A = [ A00  *   *  ]
+        //     [ A10 A11  *  ]
+        //     [  0  A21 A22 ]
+        //
+        // where A00 is nb x nb, A11 is kd x kd, and A10 is kd x nb.
+        // Since the rows of A10 are at most kd from the diagonal, A10 
+        // is upper triangular in its last nb rows, but the rest of it 
+        // and all of A11 are inside the band.
+        //
+        // 1) Cholesky decompose A00 into L00 L00t.
+        // 2) Solve for L10 = A10 L00t^-1.  
+        //    L10 has the same shape as A10, so this is done on a 
+        //    dense copy of A10 with the elements outside the band = 0.
+        // 3) Find A11' = A11 - L10 L10t.
+        // 4) Repeat with A11' (and A21, A22, etc.) as the new A.
+        //
+        // Steps 2 and 3 are split into tiles of rows, which are done
+        // in parallel with OpenMP.
+        TMVAssert(A.uplo() == Lower);
+        TMVAssert(A.ct() == NonConj);
+        TMVAssert(isReal(T()) || A.isherm());
+        TMVAssert(A.iscm() || A.isrm());
+        TMVAssert(cm == A.iscm());
+        const ptrdiff_t N = A.size();
+        const ptrdiff_t kd = A.nlo();
+        const ptrdiff_t nb = SBCH_BLOCKSIZE;
+        TMVAssert(kd > nb);
+#ifdef XDEBUG
+        Matrix<T> A0(A);
+#endif
+
+        // The working copy of A10.
+        Matrix<T,ColMajor> L10(kd,nb);
+        // The tile size for the trailing update.
+        const ptrdiff_t NT = 2*nb;
+
+        for(ptrdiff_t j1=0;j1<N;j1+=nb) {
+            const ptrdiff_t j2 = TMV_MIN(j1+nb,N);
+            const ptrdiff_t ib = j2-j1;
+            const ptrdiff_t m = TMV_MIN(kd,N-j2);
+
+            // 1) A00 = L00 L00t
+#ifdef NOTHROW
+            DoNonLapCH_Decompose<cm>(A.subSymBandMatrix(j1,j2));
+#else
+            try {
+                DoNonLapCH_Decompose<cm>(A.subSymBandMatrix(j1,j2));
+            } catch (NonPosDef&) {
+                throw NonPosDefHermBandMatrix<T>(A);
+            }
+#endif
+            if (m == 0) continue;
+
+            // Copy A10 into L10.  Column c of A10 is in the band for the 
+            // first kd-ib+c+1 rows.
+            MatrixView<T> L = L10.subMatrix(0,m,0,ib);
+            for(ptrdiff_t c=0;c<ib;++c) {
+                const ptrdiff_t r2 = TMV_MIN(m,kd-ib+c+1);
+                L.col(c,0,r2) = A.col(j1+c,j2,j2+r2);
+                L.col(c,r2,m).setZero();
+            }
+
+            ConstUpperTriMatrixView<T> L00t = 
+                A.subSymMatrix(j1,j2).upperTri();
+            const ptrdiff_t nt = (m-1)/NT+1;
+#ifdef _OPENMP
+            const bool par = nt > 1 && !omp_in_parallel();
+#endif
+
+            // 2) L10 = A10 L00t^-1
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (par)
+#endif
+            for(int t=0;t<nt;++t) {
+                const ptrdiff_t r1 = t*NT;
+                const ptrdiff_t r2 = TMV_MIN(r1+NT,m);
+                L.rowRange(r1,r2) %= L00t;
+            }
+
+            // Copy L10 back into A.
+            for(ptrdiff_t c=0;c<ib;++c) {
+                const ptrdiff_t r2 = TMV_MIN(m,kd-ib+c+1);
+                A.col(j1+c,j2,j2+r2) = L.col(c,0,r2);
+            }
+
+            // 3) A11 -= L10 L10t
+            // Row tile t updates the tiles (t,0) .. (t,t) of A11.  
+            // The later tiles have more work, so do them first.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (par)
+#endif
+            for(int tt=0;tt<nt;++tt) {
+                const int t = nt-1-tt;
+                const ptrdiff_t r1 = t*NT;
+                const ptrdiff_t r2 = TMV_MIN(r1+NT,m);
+                ConstMatrixView<T> Lr = L.rowRange(r1,r2);
+                if (r1 > 0) 
+                    A.subMatrix(j2+r1,j2+r2,j2,j2+r1) -= 
+                        Lr * L.rowRange(0,r1).adjoint();
+                A.subSymMatrix(j2+r1,j2+r2) -= Lr * Lr.adjoint();
+            }
+        }
+
+#ifdef XDEBUG
+        BandMatrix<T> LL = A.lowerBand();
+        BandMatrix<T> A2 = LL * LL.adjoint();
+        if (!(Norm(A2-A0) < 0.001*TMV_SQR(Norm(LL)))) {
+            cerr<<"BlockCH_Decompose: A = "<<TMV_Text(A)<<"  "<<A0<<endl;
+            cerr<<"Done: A = "<<A<<endl;
+            cerr<<"Norm(diff) = "<<Norm(A2-A0)<<endl;
+            abort();
+        }
+#endif
+    }
+
     template <class T> 
     static inline void NonLapCH_Decompose(SymBandMatrixView<T> A)
     {
         TMVAssert(A.iscm() || A.isrm());
-        if (A.iscm()) DoNonLapCH_Decompose<true>(A);
-        else DoNonLapCH_Decompose<false>(A);
+        // The blocked algorithm is only worth it for wide bands.
+        if (A.nlo() > 2*SBCH_BLOCKSIZE) {
+            if (A.iscm()) BlockCH_Decompose<true>(A);
+            else BlockCH_Decompose<false>(A);
+        } else {
+            if (A.iscm()) DoNonLapCH_Decompose<true>(A);
+            else DoNonLapCH_Decompose<false>(A);
+        }
     }
 
     template <class T> 
@@ -73,33 +73,41 @@ namespace tmv {
         }
     }
 
+    template <class T>
+    Divider<T>* GenSymBandMatrix<T>::newDiv() const
+    {
+        DivType dt = this->divtype & tmv::DivTypeFlags;
+        TMVAssert(dt == tmv::LU || dt == tmv::CH || dt == tmv::SV);
+        TMVAssert(isherm() || dt != tmv::CH);
+        switch (dt) {
+          case LU : 
+               return new BandLUDiv<T>(*this); 
+          case CH : 
+               return new HermBandCHDiv<T>(*this,this->divIsInPlace());
+          case SV : 
+               if (isherm()) 
+                   return new HermBandSVDiv<T>(*this);
+               else
+                   return new SymBandSVDiv<T>(*this);
+          default : 
+               // The above assert should have already failed
+               // so go ahead and fall through.
+               break;
+        }
+        return 0;
+    }
+
     template <class T>
     void GenSymBandMatrix<T>::setDiv() const
     {
-        if (!this->divIsSet()) {
-            DivType dt = this->getDivType();
-            TMVAssert(dt == tmv::LU || dt == tmv::CH || dt == tmv::SV);
-            TMVAssert(isherm() || dt != tmv::CH);
-            switch (dt) {
-              case LU : 
-                   this->divider.reset(new BandLUDiv<T>(*this)); 
-                   break;
-              case CH : 
-                   this->divider.reset(
-                       new HermBandCHDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case SV : 
-                   if (isherm()) 
-                       this->divider.reset(new HermBandSVDiv<T>(*this));
-                   else
-                       this->divider.reset(new SymBandSVDiv<T>(*this));
-                   break;
-              default : 
-                   // The above assert should have already failed
-                   // so go ahead and fall through.
-                   break;
-            }
-        }
+#if __cplusplus >= 201103L
+        if (this->divIsSet()) return;
+#endif
+        // Make sure only one thread does the decomposition.
+        DivLock<T> lock(*this);
+        if (this->divIsSet()) return;
+        this->setDefaultDivType();
+        this->divider.reset(newDiv());
     }
 
 #ifdef INST_INT
@@ -107,8 +115,15 @@ namespace tmv {
     void GenSymBandMatrix<int>::setDiv() const
     { TMVAssert(TMV_FALSE); }
     template <>
+    Divider<int>* GenSymBandMatrix<int>::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
+    template <>
     void GenSymBandMatrix<std::complex<int> >::setDiv() const
     { TMVAssert(TMV_FALSE); }
+    template <>
+    Divider<std::complex<int> >*
+    GenSymBandMatrix<std::complex<int> >::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
 #endif
 
     template <class T>
@@ -36,6 +36,11 @@
 #include <iostream>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#include <vector>
+#endif
+
 #ifdef XDEBUG
 #include "tmv/TMV_TriMatrixArith.h"
 #include <iostream>
@@ -54,6 +59,12 @@ namespace tmv {
 #else
 #define CH_BLOCKSIZE 64
 #define CH_BLOCKSIZE2 2
+#endif
+
+// The OpenMP version requires task dependencies, which were added in 
+// OpenMP 4.0.
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define TMV_OPENMP_CH
 #endif
 
     //
@@ -413,6 +424,118 @@ namespace tmv {
 #endif
     }
 
+#ifdef TMV_OPENMP_CH
+    template <bool cm, class T> 
+    static void OpenMPCH_Decompose(SymMatrixView<T> A)
+    {
+        // This is the same algorithm as BlockCH_Decompose, but the 
+        // updates are split into tiles, each of which is done as a 
+        // separate OpenMP task.  There are four kinds of tasks, named
+        // after their LAPACK/BLAS equivalents:
+        //
+        // POTRF: L(k,k) = Cholesky decomposition of A(k,k)
+        // TRSM:  L(i,k) = A(i,k) L(k,k)t^-1
+        // SYRK:  A(i,i) -= L(i,k) L(i,k)t
+        // GEMM:  A(i,j) -= L(i,k) L(j,k)t
+        //
+        // The dependencies between the tasks are tracked by OpenMP, so
+        // a tile's task is run as soon as the tiles it needs are ready.
+        // In particular, the next POTRF can start as soon as its tile has 
+        // been updated by the previous step, without waiting for the 
+        // rest of that step's trailing update to finish.
+        TMVAssert(A.uplo() == Lower);
+        TMVAssert(A.isrm() || A.iscm());
+        TMVAssert(A.ct() == NonConj);
+        TMVAssert(A.isherm());
+        TMVAssert(cm == A.iscm());
+
+        const ptrdiff_t N = A.size();
+        // Use larger tiles for larger matrices to keep the number of 
+        // tasks from getting too large.
+        const ptrdiff_t NB = 
+            N > 16*CH_BLOCKSIZE ? 4*CH_BLOCKSIZE : CH_BLOCKSIZE;
+        const ptrdiff_t nt = (N-1)/NB+1;
+        // The tasks depend on the elements of this array, not on the
+        // tiles of A themselves.
+        std::vector<char> dep(nt*nt);
+        char* d = &dep[0];
+        bool failed = false;
+
+#pragma omp parallel
+        {
+#pragma omp single
+            {
+                for(ptrdiff_t k=0;k<nt;++k) {
+                    const ptrdiff_t k1 = k*NB;
+                    const ptrdiff_t k2 = TMV_MIN(k1+NB,N);
+#pragma omp task depend(inout:d[k*nt+k])
+                    {
+#ifdef NOTHROW
+                        RecursiveCH_Decompose<cm>(A.subSymMatrix(k1,k2));
+#else
+                        // failed is written by other tasks, so it needs
+                        // to be read atomically too.
+                        bool stop;
+#pragma omp atomic read
+                        stop = failed;
+                        if (!stop) try {
+                            RecursiveCH_Decompose<cm>(A.subSymMatrix(k1,k2));
+                        } catch (NonPosDef&) {
+#pragma omp atomic write
+                            failed = true;
+                        }
+#endif
+                    }
+                    for(ptrdiff_t i=k+1;i<nt;++i) {
+                        const ptrdiff_t i1 = i*NB;
+                        const ptrdiff_t i2 = TMV_MIN(i1+NB,N);
+#pragma omp task depend(in:d[k*nt+k]) depend(inout:d[i*nt+k])
+                        {
+                            bool stop;
+#pragma omp atomic read
+                            stop = failed;
+                            if (!stop) 
+                                A.subMatrix(i1,i2,k1,k2) %= 
+                                    A.subSymMatrix(k1,k2).upperTri();
+                        }
+                    }
+                    for(ptrdiff_t i=k+1;i<nt;++i) {
+                        const ptrdiff_t i1 = i*NB;
+                        const ptrdiff_t i2 = TMV_MIN(i1+NB,N);
+#pragma omp task depend(in:d[i*nt+k]) depend(inout:d[i*nt+i])
+                        {
+                            bool stop;
+#pragma omp atomic read
+                            stop = failed;
+                            if (!stop) {
+                                MatrixView<T> Aik = A.subMatrix(i1,i2,k1,k2);
+                                A.subSymMatrix(i1,i2) -= Aik * Aik.adjoint();
+                            }
+                        }
+                        for(ptrdiff_t j=k+1;j<i;++j) {
+                            const ptrdiff_t j1 = j*NB;
+                            const ptrdiff_t j2 = j1+NB;
+#pragma omp task depend(in:d[i*nt+k],d[j*nt+k]) depend(inout:d[i*nt+j])
+                            {
+                                bool stop;
+#pragma omp atomic read
+                                stop = failed;
+                                if (!stop)
+                                    A.subMatrix(i1,i2,j1,j2) -= 
+                                        A.subMatrix(i1,i2,k1,k2) *
+                                        A.subMatrix(j1,j2,k1,k2).adjoint();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+#ifndef NOTHROW
+        if (failed) throw NonPosDefHermMatrix<T>(A);
+#endif
+    }
+#endif
+
     template <class T> 
     static void NonLapCH_Decompose(SymMatrixView<T> A)
     {
@@ -421,6 +544,16 @@ namespace tmv {
         TMVAssert(A.ct() == NonConj);
         TMVAssert(isReal(T()) || A.isherm());
 
+#ifdef TMV_OPENMP_CH
+        if (A.size() > 2*CH_BLOCKSIZE && 
+            !omp_in_parallel() && omp_get_max_threads() > 1) {
+            if (A.iscm())
+                OpenMPCH_Decompose<true>(A);
+            else
+                OpenMPCH_Decompose<false>(A);
+            return;
+        }
+#endif
         if (A.iscm())
             RecursiveCH_Decompose<true>(A);
         else
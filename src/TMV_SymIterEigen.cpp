@@ -0,0 +1,473 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+
+//#define XDEBUG
+
+// This file implements two iterative eigensolvers for finding a few
+// extremal eigenvalues of a large hermitian matrix, which is only 
+// accessed through matrix-vector products.
+//
+// LanczosEigen is the implicitly restarted Lanczos method of
+// Sorensen (1992, SIAM J. Matrix Anal. Appl., 13, 357).
+// A Lanczos factorization A Q_m = Q_m T_m + f e_m^T is built with
+// full reorthogonalization.  The eigenvalues of T_m (the Ritz values)
+// are found with EigenFromTridiagonal.  Then the m-k unwanted Ritz 
+// values are used as exact shifts in m-k implicit QR steps on T_m, 
+// which compresses the factorization down to a length k factorization
+// whose starting vector is filtered toward the wanted eigenvectors.
+// This is then extended back to length m, and so on until the 
+// residuals of the wanted Ritz pairs are small enough.
+//
+// LOBPCGEigen is the locally optimal block preconditioned conjugate 
+// gradient method of Knyazev (2001, SIAM J. Sci. Comput., 23, 517).
+// Each iteration does a Rayleigh-Ritz projection onto the space
+// spanned by the current approximations X, the (preconditioned) 
+// residuals W, and the previous search directions P.
+// Converged columns are dropped from W (soft locking), so the 
+// work per iteration goes down as the eigenvectors converge.
+
+#include "tmv/TMV_SymIterEigen.h"
+#include "tmv/TMV_SymSVD.h"
+#include "TMV_SymSVDiv.h"
+#include "TMV_QRDiv.h"
+#include "TMV_Random.h"
+#include "tmv/TMV_SymMatrix.h"
+#include "tmv/TMV_Matrix.h"
+#include "tmv/TMV_Vector.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_TriDiv.h"
+#include "tmv/TMV_Givens.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_VectorArith.h"
+#include "tmv/TMV_TriMatrixArith.h"
+#include <sstream>
+#include <cmath>
+
+#ifdef XDEBUG
+#include "tmv/TMV_SymMatrixArith.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#endif
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    template <class T> 
+    static inline void SetRandom(XorShiftRandom& g, T& x)
+    { x = T(2.*g.uniform()-1.); }
+
+    template <class T> 
+    static inline void SetRandom(XorShiftRandom& g, std::complex<T>& x)
+    {
+        T xr = T(2.*g.uniform()-1.);
+        x = std::complex<T>(xr,T(2.*g.uniform()-1.));
+    }
+
+    template <class T> 
+    static void Orthogonalize(
+        const GenMatrix<T>& Q, VectorView<T> v, VectorView<T> h)
+    {
+        // Make v orthogonal to the (orthonormal) columns of Q using 
+        // classical Gram-Schmidt.  h += Qt v.
+        // Two passes are enough to get v orthogonal to working precision.
+        // (Giraud et al, 2005, Numer. Math., 101, 87)
+        TMVAssert(h.size() == Q.rowsize());
+        if (Q.rowsize() == 0) return;
+        Vector<T> h1 = Q.adjoint() * v;
+        v -= Q * h1;
+        h += h1;
+        h1 = Q.adjoint() * v;
+        v -= Q * h1;
+        h += h1;
+    }
+
+    template <class T> 
+    static void RandomOrthoVector(
+        XorShiftRandom& g, const GenMatrix<T>& Q, VectorView<T> v)
+    {
+        // Set v to a random unit vector orthogonal to the columns of Q.
+        TMVAssert(Q.rowsize() < Q.colsize());
+        Vector<T> x(v.size());
+        Vector<T> h(Q.rowsize());
+        do {
+            for(ptrdiff_t i=0;i<v.size();++i) SetRandom(g,x.ref(i));
+            h.setZero();
+            Orthogonalize(Q,x.view(),h.view());
+        } while (Norm(x) == RT(0));
+        x /= Norm(x);
+        v = x;
+    }
+
+    template <class T> 
+    static void LanczosExtend(
+        const SymOperator<T>& A, MatrixView<T> Q, 
+        VectorView<RT> alpha, VectorView<RT> beta,
+        ptrdiff_t j1, RT& anorm, XorShiftRandom& g)
+    {
+        // Extend a Lanczos factorization of length j1 to length m.
+        // On input, Q.col(0..j1) are the Lanczos vectors, and 
+        // alpha(0..j1), beta(0..j1-1) are the elements of T.
+        // Q.col(j1) is the (normalized) next vector.
+        // On output, Q.col(m) is the normalized residual vector, and 
+        // beta(m-1) is its norm.
+        const ptrdiff_t n = Q.colsize();
+        const ptrdiff_t m = alpha.size();
+        TMVAssert(Q.rowsize() == m+1);
+        TMVAssert(beta.size() == m);
+        const RT eps = TMV_Epsilon<T>();
+        Vector<T> h(m);
+
+        for(ptrdiff_t j=j1;j<m;++j) {
+            VectorView<T> w = Q.col(j+1);
+            A.mult(Q.col(j),w);
+            h.subVector(0,j+1).setZero();
+            Orthogonalize(Q.colRange(0,j+1),w,h.subVector(0,j+1));
+            alpha(j) = TMV_REAL(h(j));
+            RT b = Norm(w);
+            anorm = TMV_MAX(anorm,TMV_ABS(alpha(j))+b);
+            if (b <= eps*anorm) {
+                // Found an invariant subspace.  Continue with a random 
+                // vector orthogonal to the current ones.
+                beta(j) = RT(0);
+                if (j+1 < n) RandomOrthoVector(g,Q.colRange(0,j+1),w);
+                else w.setZero();
+            } else {
+                beta(j) = b;
+                w /= b;
+            }
+        }
+    }
+
+    template <class T> 
+    static void ExactShiftQRStep(
+        VectorView<T> D, VectorView<T> E, MatrixView<T> P, T mu)
+    {
+        // Do one implicit QR step on the tridiagonal matrix given by D,E
+        // with the shift mu, accumulating the rotations in P.
+        // This is the same bulge chase as in ReduceHermTridiagonal,
+        // except that the shift is given rather than the Wilkinson shift.
+        const ptrdiff_t m = D.size();
+        TMVAssert(E.size() == m-1);
+        TMVAssert(P.rowsize() == m);
+        TMVAssert(D.step() == 1);
+        TMVAssert(E.step() == 1);
+        TMVAssert(isReal(T()));
+        if (m == 1) return;
+
+        T* Di = D.ptr();
+        T* Ei = E.ptr();
+        T y = *Di - mu;
+        T x = *Ei;
+        Givens<T> G = GivensRotate(y,x);
+        for(ptrdiff_t i=0;;++i,++Di,++Ei) {
+            G.symMult(*Di,*(Di+1),*Ei);
+            G.mult(P.colPair(i,i+1).transpose());
+            if (i==m-2) break;
+            G.mult(x,*(Ei+1));
+            G = GivensRotate(*Ei,x);
+        }
+    }
+
+    template <class T> 
+    void LanczosEigen(
+        const SymOperator<T>& A, MatrixView<T> V, VectorView<RT> lambda,
+        bool smallest, RT tol, ptrdiff_t ncv, ptrdiff_t maxiter)
+    {
+        const ptrdiff_t n = A.size();
+        const ptrdiff_t k = lambda.size();
+        TMVAssert(V.colsize() == n);
+        TMVAssert(V.rowsize() == k);
+        TMVAssert(k <= n);
+        TMVAssert(maxiter >= 0);
+        if (k == 0) return;
+
+        const RT eps = TMV_Epsilon<T>();
+        // The relative threshold used by ARPACK for tiny Ritz values.
+        const RT eps23 = std::pow(eps,RT(2)/RT(3));
+        if (tol <= RT(0)) tol = eps;
+        ptrdiff_t m = ncv > 0 ? ncv : TMV_MAX(2*k+1,k+20);
+        m = TMV_MIN(TMV_MAX(m,k+1),n);
+
+        // Memory is O(nm) for Q and O(m^2) for the small problem.
+        Matrix<T,ColMajor> Q(n,m+1);
+        Vector<RT> alpha(m);
+        Vector<RT> beta(m);
+        Vector<RT> D(m);
+        Vector<RT> E(m);
+        Matrix<RT,ColMajor> S(m,m);
+        Matrix<RT,ColMajor> P(m,m);
+        AlignedArray<ptrdiff_t> perm(m);
+        XorShiftRandom g;
+
+        // The wanted Ritz values are D(i1..i1+k) after sorting.
+        const ptrdiff_t i1 = smallest ? 0 : m-k;
+        RT anorm = RT(0);
+
+        RandomOrthoVector(g,Q.colRange(0,0),Q.col(0));
+        ptrdiff_t j1 = 0;
+        bool conv = false;
+        for(ptrdiff_t iter=0;;++iter) {
+            LanczosExtend(A,Q.view(),alpha.view(),beta.view(),j1,anorm,g);
+
+            D = alpha;
+            E = beta;
+            S.setToIdentity();
+            EigenFromTridiagonal(S.view(),D.view(),E.subVector(0,m-1));
+            D.sort(perm.get(),Ascend);
+            S.permuteCols(perm.get());
+
+            const RT thmax = TMV_MAX(TMV_ABS(D(0)),TMV_ABS(D(m-1)));
+            conv = true;
+            for(ptrdiff_t i=i1;i<i1+k;++i) {
+                RT resid = TMV_ABS(beta(m-1) * S(m-1,i));
+                if (resid > tol * TMV_MAX(TMV_ABS(D(i)),eps23*thmax)) {
+                    conv = false; break;
+                }
+            }
+#ifdef XDEBUG
+            cout<<"LanczosEigen iter "<<iter<<": theta = "<<
+                D.subVector(i1,i1+k)<<endl;
+#endif
+            if (conv || iter == maxiter || m == k) break;
+
+            // Apply the unwanted Ritz values as shifts.
+            Vector<RT> shifts = D;
+            D = alpha;
+            E = beta;
+            P.setToIdentity();
+            for(ptrdiff_t i=0;i<m;++i) if (i < i1 || i >= i1+k) 
+                ExactShiftQRStep(
+                    D.view(),E.subVector(0,m-1),P.view(),shifts(i));
+
+            // The new residual is
+            // f = Q P(:,k) E(k-1) + Q(:,m) beta(m-1) P(m-1,k-1)
+            Vector<T> f = Q.colRange(0,m) * P.col(k);
+            f *= E(k-1);
+            f += (beta(m-1)*P(m-1,k-1)) * Q.col(m);
+            Matrix<T,ColMajor> Qk = Q.colRange(0,m) * P.colRange(0,k);
+            Q.colRange(0,k) = Qk;
+            alpha.subVector(0,k) = D.subVector(0,k);
+            beta.subVector(0,k-1) = E.subVector(0,k-1);
+
+            RT b = Norm(f);
+            if (b <= eps*anorm) {
+                beta(k-1) = RT(0);
+                RandomOrthoVector(g,Q.colRange(0,k),Q.col(k));
+            } else {
+                beta(k-1) = b;
+                Q.col(k) = f/b;
+            }
+            j1 = k;
+        }
+
+        lambda = D.subVector(i1,i1+k);
+        V = Q.colRange(0,m) * S.colRange(i1,i1+k);
+        if (!conv) {
+            std::ostringstream s;
+            s << "LanczosEigen did not converge within "<<maxiter<<
+                " restarts.";
+            TMV_Warning(s.str());
+        }
+    }
+
+    template <class T> 
+    static void RayleighRitz(
+        MatrixView<T> Q, MatrixView<T> AQ, Vector<RT>& theta,
+        Matrix<T,ColMajor>& C, bool smallest, RT& anorm)
+    {
+        // Find the Ritz pairs of A in the space spanned by the 
+        // orthonormal columns of Q.
+        // Returns the k wanted ones in theta and C.
+        const ptrdiff_t ns = Q.rowsize();
+        const ptrdiff_t k = theta.size();
+        Matrix<T,ColMajor> G = Q.adjoint() * AQ;
+        HermMatrix<T,Lower|ColMajor> H(ns);
+        // Symmetrize to remove the round off errors.
+        H.lowerTri() = G.lowerTri();
+        H.lowerTri() += G.upperTri().adjoint();
+        H.lowerTri() /= RT(2);
+        Matrix<T,ColMajor> U(ns,ns);
+        Vector<RT> th(ns);
+        Eigen(H,U.view(),th.view());
+        anorm = TMV_MAX(anorm,TMV_MAX(TMV_ABS(th(0)),TMV_ABS(th(ns-1))));
+        const ptrdiff_t i1 = smallest ? 0 : ns-k;
+        theta = th.subVector(i1,i1+k);
+        if (C.colsize() != ns) C.resize(ns,k);
+        C = U.colRange(i1,i1+k);
+    }
+
+    template <class T> 
+    void LOBPCGEigen(
+        const SymOperator<T>& A, const SymOperator<T>* Prec,
+        MatrixView<T> V, VectorView<RT> lambda, 
+        bool smallest, RT tol, ptrdiff_t maxiter)
+    {
+        const ptrdiff_t n = A.size();
+        const ptrdiff_t k = lambda.size();
+        TMVAssert(V.colsize() == n);
+        TMVAssert(V.rowsize() == k);
+        TMVAssert(k <= n);
+        TMVAssert(!Prec || Prec->size() == n);
+        TMVAssert(maxiter >= 0);
+        if (k == 0) return;
+
+        const RT eps = TMV_Epsilon<T>();
+        const RT sqrteps = TMV_SQRT(eps);
+        if (tol <= RT(0)) tol = sqrteps;
+
+        // S = [ X W P ], AS = A S.  At most 3k columns.
+        Matrix<T,ColMajor> S(n,TMV_MIN(3*k,n));
+        Matrix<T,ColMajor> AS(n,TMV_MIN(3*k,n));
+        Matrix<T,ColMajor> X(n,k);
+        Matrix<T,ColMajor> AX(n,k);
+        Matrix<T,ColMajor> P(n,k);
+        Matrix<T,ColMajor> AP(n,k);
+        Matrix<T,ColMajor> R(n,k);
+        Matrix<T,ColMajor> C(k,k);
+        Vector<T> beta(TMV_MIN(3*k,n));
+        Vector<RT> theta(k);
+        AlignedArray<ptrdiff_t> active(k);
+        XorShiftRandom g;
+        RT anorm = RT(0);
+        T d(0);
+
+        // Initial guess
+        if (Norm(V) == RT(0)) {
+            for(ptrdiff_t j=0;j<k;++j) for(ptrdiff_t i=0;i<n;++i) 
+                SetRandom(g,X.ref(i,j));
+        } else {
+            X = V;
+        }
+        QR_Decompose(X.view(),beta.subVector(0,k),d);
+        GetQFromQR(X.view(),beta.subVector(0,k));
+        A.mult(X,AX.view());
+        RayleighRitz(X.view(),AX.view(),theta,C,smallest,anorm);
+        X = X * C;
+        AX = AX * C;
+
+        ptrdiff_t np = 0;
+        bool conv = false;
+        for(ptrdiff_t iter=0;;++iter) {
+            // Residuals R = AX - X theta
+            // These are calculated explicitly, so rounding errors keep 
+            // them from getting much below eps |A|.  Hence the tolerance
+            // is relative to anorm (the largest |theta| so far) rather
+            // than |theta(j)|.
+            ptrdiff_t nact = 0;
+            for(ptrdiff_t j=0;j<k;++j) {
+                R.col(j) = AX.col(j) - theta(j) * X.col(j);
+                RT resid = Norm(R.col(j));
+                if (resid > tol * anorm) active[nact++] = j;
+            }
+#ifdef XDEBUG
+            cout<<"LOBPCGEigen iter "<<iter<<": theta = "<<theta<<
+                ", nactive = "<<nact<<endl;
+#endif
+            conv = (nact == 0);
+            if (conv || iter == maxiter) break;
+
+            // Don't let the basis get bigger than n.
+            if (k + nact > n) nact = n-k;
+            if (nact == 0) break;
+            // Only use the search directions of the active vectors.
+            // The others are nearly zero once a vector has converged,
+            // which would make the basis below badly conditioned.
+            if (np > 0) np = nact;
+            if (k + nact + np > n) np = 0;
+
+            // W = Prec * R(active)
+            const ptrdiff_t ns = k + nact + np;
+            MatrixView<T> W = S.colRange(k,k+nact);
+            for(ptrdiff_t j=0;j<nact;++j) {
+                if (Prec) Prec->mult(R.col(active[j]),W.col(j));
+                else W.col(j) = R.col(active[j]);
+            }
+            // Make W orthogonal to X, and normalize the columns.
+            // This keeps the QR decomposition below well conditioned.
+            for(ptrdiff_t j=0;j<nact;++j) {
+                Vector<T> h(k,T(0));
+                Orthogonalize(X,W.col(j),h.view());
+                RT wnorm = Norm(W.col(j));
+                if (wnorm > RT(0)) W.col(j) /= wnorm;
+            }
+            A.mult(W,AS.colRange(k,k+nact));
+            S.colRange(0,k) = X;
+            AS.colRange(0,k) = AX;
+            for(ptrdiff_t j=0;j<np;++j) {
+                S.col(k+nact+j) = P.col(active[j]);
+                AS.col(k+nact+j) = AP.col(active[j]);
+            }
+
+            // Q R = S, AQ = AS R^-1
+            // If R is badly conditioned, the P directions are the 
+            // culprits (they become nearly parallel to X as the 
+            // iteration converges), so start over without them.
+            MatrixView<T> Sv = S.colRange(0,ns);
+            MatrixView<T> ASv = AS.colRange(0,ns);
+            QR_Decompose(Sv,beta.subVector(0,ns),d);
+            RT rmax = S.diag().subVector(0,ns).maxAbsElement();
+            RT rmin = S.diag().subVector(0,ns).minAbsElement();
+            if (rmin <= sqrteps*rmax) {
+                if (np > 0) {
+                    np = 0;
+                    --iter;
+                    continue;
+                } else {
+                    // X and W are linearly dependent, so the method 
+                    // has stagnated.
+                    break;
+                }
+            }
+            TriLDivEq(Sv.upperTri().transpose(),ASv.transpose());
+            GetQFromQR(Sv,beta.subVector(0,ns));
+
+            RayleighRitz(Sv,ASv,theta,C,smallest,anorm);
+            X = Sv * C;
+            AX = ASv * C;
+            np = k;
+            P = Sv.colRange(k,ns) * C.rowRange(k,ns);
+            AP = ASv.colRange(k,ns) * C.rowRange(k,ns);
+        }
+
+        lambda = theta;
+        V = X;
+        if (!conv) {
+            std::ostringstream s;
+            s << "LOBPCGEigen did not converge within "<<maxiter<<
+                " iterations.";
+            TMV_Warning(s.str());
+        }
+    }
+
+#undef RT
+
+#define InstFile "TMV_SymIterEigen.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
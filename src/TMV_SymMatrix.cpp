@@ -75,36 +75,41 @@ namespace tmv {
         }
     }
 
+    template <class T>
+    Divider<T>* GenSymMatrix<T>::newDiv() const
+    {
+        DivType dt = this->divtype & tmv::DivTypeFlags;
+        TMVAssert(dt == tmv::LU || dt == tmv::CH || dt == tmv::SV);
+        TMVAssert(isherm() || dt != tmv::CH);
+        switch (dt) {
+          case LU : 
+               return new SymLDLDiv<T>(*this,this->divIsInPlace());
+          case CH : 
+               return new HermCHDiv<T>(*this,this->divIsInPlace());
+          case SV : 
+               if (isherm()) 
+                   return new HermSVDiv<T>(*this,this->divIsInPlace());
+               else
+                   return new SymSVDiv<T>(*this,this->divIsInPlace());
+          default : 
+               // The above assert should have already failed
+               // so go ahead and fall through.
+               break;
+        }
+        return 0;
+    }
+
     template <class T>
     void GenSymMatrix<T>::setDiv() const
     {
-        if (!this->divIsSet()) {
-            DivType dt = this->getDivType();
-            TMVAssert(dt == tmv::LU || dt == tmv::CH || dt == tmv::SV);
-            TMVAssert(isherm() || dt != tmv::CH);
-            switch (dt) {
-              case LU : 
-                   this->divider.reset(
-                       new SymLDLDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case CH : 
-                   this->divider.reset(
-                       new HermCHDiv<T>(*this,this->divIsInPlace())); 
-                   break;
-              case SV : 
-                   if (isherm()) 
-                       this->divider.reset(
-                           new HermSVDiv<T>(*this,this->divIsInPlace()));
-                   else
-                       this->divider.reset(
-                           new SymSVDiv<T>(*this,this->divIsInPlace()));
-                   break;
-              default : 
-                   // The above assert should have already failed
-                   // so go ahead and fall through.
-                   break;
-            }
-        }
+#if __cplusplus >= 201103L
+        if (this->divIsSet()) return;
+#endif
+        // Make sure only one thread does the decomposition.
+        DivLock<T> lock(*this);
+        if (this->divIsSet()) return;
+        this->setDefaultDivType();
+        this->divider.reset(newDiv());
     }
 
 #ifdef INST_INT
@@ -112,8 +117,15 @@ namespace tmv {
     void GenSymMatrix<int>::setDiv() const
     { TMVAssert(TMV_FALSE); }
     template <>
+    Divider<int>* GenSymMatrix<int>::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
+    template <>
     void GenSymMatrix<std::complex<int> >::setDiv() const
     { TMVAssert(TMV_FALSE); }
+    template <>
+    Divider<std::complex<int> >*
+    GenSymMatrix<std::complex<int> >::newDiv() const
+    { TMVAssert(TMV_FALSE); return 0; }
 #endif
 
     template <class T> 
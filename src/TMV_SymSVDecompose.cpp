@@ -49,6 +49,12 @@ using std::cerr;
 using std::endl;
 #endif
 
+// Above this size, Hermitian matrices are reduced to tridiagonal form
+// in two stages.  See TMV_SymSVDecompose_TwoStage.cpp.
+#ifndef SYM_TWOSTAGE_LIMIT
+#define SYM_TWOSTAGE_LIMIT 512
+#endif
+
 namespace tmv {
 
 #define RT TMV_RealType(T)
@@ -1230,20 +1236,27 @@ namespace tmv {
         // The diagonal of the Tridiagonal Matrix T is stored in D.
         // The subdiagonal is stored in E.
         Vector<RT> E(N-1);
+        if (N >= SYM_TWOSTAGE_LIMIT) {
+            // For large matrices, the two-stage reduction is faster.
+            // It returns U directly.
+            TwoStageTridiagonalize(U,SS,E.view(),true);
+        } else {
 #ifdef LAP
-        Vector<T> Ubeta(N);
+            Vector<T> Ubeta(N);
 #else
-        Vector<T> Ubeta(N-1);
+            Vector<T> Ubeta(N-1);
 #endif
-        T signdet(0);
-        Tridiagonalize(
-            HermMatrixViewOf(U,Lower),Ubeta.view(),SS,E.view(),signdet);
-
-        // Now U stores Householder vectors for U in lower diagonal columns.
-        for(ptrdiff_t j=N-1;j>0;--j) U.col(j,j,N) = U.col(j-1,j,N);
-        U.col(0).makeBasis(0);
-        U.row(0,1,N).setZero();
-        GetQFromQR(U.subMatrix(1,N,1,N),Ubeta.subVector(0,N-1));
+            T signdet(0);
+            Tridiagonalize(
+                HermMatrixViewOf(U,Lower),Ubeta.view(),SS,E.view(),signdet);
+
+            // Now U stores Householder vectors for U in lower diagonal 
+            // columns.
+            for(ptrdiff_t j=N-1;j>0;--j) U.col(j,j,N) = U.col(j-1,j,N);
+            U.col(0).makeBasis(0);
+            U.row(0,1,N).setZero();
+            GetQFromQR(U.subMatrix(1,N,1,N),Ubeta.subVector(0,N-1));
+        }
 #ifdef XDEBUG
         Matrix<T> TT = A0;
         TT.setToIdentity();
@@ -1290,13 +1303,19 @@ namespace tmv {
         if (N == 0) return;
 
         Vector<RT> E(N-1);
+        if (N >= SYM_TWOSTAGE_LIMIT && A.isherm()) {
+            TwoStageTridiagonalize(
+                MatrixViewOf(A.ptr(),N,N,A.stepi(),A.stepj()),
+                SS,E.view(),false);
+        } else {
 #ifdef LAP
-        Vector<T> Ubeta(N);
+            Vector<T> Ubeta(N);
 #else
-        Vector<T> Ubeta(N-1);
+            Vector<T> Ubeta(N-1);
 #endif
-        T signdet(0);
-        Tridiagonalize(A,Ubeta.view(),SS,E.view(),signdet);
+            T signdet(0);
+            Tridiagonalize(A,Ubeta.view(),SS,E.view(),signdet);
+        }
         MatrixView<T> U(0,0,0,1,1,NonConj);
         EigenFromTridiagonal<T>(U,SS,E.view());
     }
@@ -31,6 +31,10 @@
 #include <iostream>
 using std::endl;
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #ifdef _OPENMP
 
@@ -95,6 +99,11 @@ namespace tmv {
 #define DC_LIMIT 32
 #endif
 
+    // The OpenMP parallelization here is the same as for the SVD version
+    // in TMV_SVDecompose_DC.cpp.  The recursion is done with tasks, and
+    // once we are in the parallel region, the conquer steps use tasks too.
+#define DC_TASK_LIMIT 128
+
     template <class T> 
     static T FindDCEigenValue(
         const ptrdiff_t k, const ptrdiff_t N, const T rho, const T* D, const T* z, 
@@ -717,6 +726,21 @@ namespace tmv {
         const T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
+        if (omp_in_parallel()) {
+            // Then we are already inside the divide and conquer recursion,
+            // so split the loop into tasks.
+            const ptrdiff_t nb = DC_TaskBlockSize(N,16);
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
+                for(ptrdiff_t k=k1;k<k2;k++) {
+                    S[k] = FindDCEigenValue(
+                        k,N,rho,D.cptr(),z.cptr(),
+                        zsq.cptr(),normsqz,diffmat.col(k).ptr());
+                }
+            }
+#pragma omp taskwait
+        } else
 #pragma omp parallel
         {
             Vector<T> diff(N);
@@ -768,6 +792,22 @@ namespace tmv {
         const T normsqz = zsq.sumElements();
 
 #ifdef _OPENMP
+        if (omp_in_parallel()) {
+            const ptrdiff_t nb = DC_TaskBlockSize(N,16);
+            for(ptrdiff_t k1=0;k1<N;k1+=nb) {
+                const ptrdiff_t k2 = TMV_MIN(k1+nb,N);
+#pragma omp task default(shared) firstprivate(k1,k2)
+                {
+                    Vector<T> diff(N);
+                    for(ptrdiff_t k=k1;k<k2;k++) {
+                        S[k] = FindDCEigenValue(
+                            k,N,rho,D.cptr(),z.cptr(),
+                            zsq.cptr(),normsqz,diff.ptr());
+                    }
+                }
+            }
+#pragma omp taskwait
+        } else
 #pragma omp parallel
         {
             Vector<T> diff(N);
@@ -799,7 +839,7 @@ namespace tmv {
     }
 
     template <class T> 
-    void EigenFromTridiagonal_DC(
+    static void DoEigenFromTridiagonal_DC(
         MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, bool UisI)
     {
         // Solve the SVD of unreduced Tridiagonal Matrix T (given by D,E).
@@ -934,39 +974,58 @@ namespace tmv {
             dbgcout<<"N > "<<DC_LIMIT<<endl;
             ptrdiff_t K = N/2;
             Vector<RT> z(N,RT(0));
+            const RT EK = E(K-1);
+
+            // The two sub-problems use disjoint parts of D, E, U and z,
+            // so they can be done in parallel.
+#ifdef _OPENMP
+            const bool dotask = omp_in_parallel() && N > DC_TASK_LIMIT;
+#endif
 
             // Do the left sub-problem
-            VectorView<RT> D1 = D.subVector(0,K);
-            VectorView<RT> E1 = E.subVector(0,K-1);
-            D1(K-1) -= RT(1);
-            Matrix<RT,ColMajor> U1(U.cptr()?K:1,K);
-            if (U.cptr()) {
-                U1.setToIdentity();
-                EigenFromTridiagonal_DC<RT>(U1.view(),D1,E1,true);
-                if (UisI) U.subMatrix(0,K,0,K) = U1;
-                else U.colRange(0,K) *= U1;
-            } else {
-                U1.row(0).makeBasis(K-1); // only need row(K-1)
-                EigenFromTridiagonal_DC<RT>(U1.view(),D1,E1,false);
+#ifdef _OPENMP
+#pragma omp task default(shared) if(dotask)
+#endif
+            {
+                VectorView<RT> D1 = D.subVector(0,K);
+                VectorView<RT> E1 = E.subVector(0,K-1);
+                D1(K-1) -= RT(1);
+                Matrix<RT,ColMajor> U1(U.cptr()?K:1,K);
+                if (U.cptr()) {
+                    U1.setToIdentity();
+                    DoEigenFromTridiagonal_DC<RT>(U1.view(),D1,E1,true);
+                    if (UisI) U.subMatrix(0,K,0,K) = U1;
+                    else DC_MultRight(U.colRange(0,K),U1);
+                } else {
+                    U1.row(0).makeBasis(K-1); // only need row(K-1)
+                    DoEigenFromTridiagonal_DC<RT>(U1.view(),D1,E1,false);
+                }
+                z.subVector(0,K) = U1.row(U.cptr() ? K-1 : 0); 
             }
-            z.subVector(0,K) = U1.row(U.cptr() ? K-1 : 0); 
 
             // Do the right sub-problem
-            VectorView<RT> D2 = D.subVector(K,N);
-            VectorView<RT> E2 = E.subVector(K,N-1);
-            const RT EK = E(K-1);
-            D2(0) -= EK*EK;
-            Matrix<RT,ColMajor> U2(U.cptr()?N-K:1,N-K);
-            if (U.cptr()) {
-                U2.setToIdentity();
-                EigenFromTridiagonal_DC<RT>(U2.view(),D2,E2,true);
-                if (UisI) U.subMatrix(K,N,K,N) = U2;
-                else U.colRange(K,N) *= U2;
-            } else {
-                U2.row(0).makeBasis(0); // only need col(0)
-                EigenFromTridiagonal_DC<RT>(U2.view(),D2,E2,false);
+#ifdef _OPENMP
+#pragma omp task default(shared) if(dotask)
+#endif
+            {
+                VectorView<RT> D2 = D.subVector(K,N);
+                VectorView<RT> E2 = E.subVector(K,N-1);
+                D2(0) -= EK*EK;
+                Matrix<RT,ColMajor> U2(U.cptr()?N-K:1,N-K);
+                if (U.cptr()) {
+                    U2.setToIdentity();
+                    DoEigenFromTridiagonal_DC<RT>(U2.view(),D2,E2,true);
+                    if (UisI) U.subMatrix(K,N,K,N) = U2;
+                    else DC_MultRight(U.colRange(K,N),U2);
+                } else {
+                    U2.row(0).makeBasis(0); // only need col(0)
+                    DoEigenFromTridiagonal_DC<RT>(U2.view(),D2,E2,false);
+                }
+                z.subVector(K,N) = EK * U2.row(0); 
             }
-            z.subVector(K,N) = EK * U2.row(0); 
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
 
 #ifdef XDEBUG
             Matrix<RT> M = DiagMatrixViewOf(D) + (z^z);
@@ -1162,7 +1221,7 @@ namespace tmv {
                         for(ptrdiff_t i=0;i<N;i++) xj(i) = z(i) / xj(i);
                         xj /= Norm(xj);
                     }
-                    U.colRange(0,N) *= W;
+                    DC_MultRight(U.colRange(0,N),W);
                     //dbgcout<<"W => (X) "<<W<<endl;
                     //dbgcout<<"U => "<<U<<endl;
 #ifdef XDEBUG
@@ -1270,6 +1329,27 @@ namespace tmv {
 #endif
     }
 
+    template <class T> 
+    void EigenFromTridiagonal_DC(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, bool UisI)
+    {
+#ifdef _OPENMP
+        // Start the parallel region for the recursion here, unless we are
+        // already in one.
+        if (D.size() > DC_TASK_LIMIT && !omp_in_parallel() && 
+            omp_get_max_threads() > 1) {
+#pragma omp parallel
+            {
+#pragma omp single
+                DoEigenFromTridiagonal_DC(U,D,E,UisI);
+            }
+        } else 
+#endif
+        {
+            DoEigenFromTridiagonal_DC(U,D,E,UisI);
+        }
+    }
+
 #undef RT
 
 #ifdef INST_INT
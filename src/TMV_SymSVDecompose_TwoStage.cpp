@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// The Template Matrix/Vector Library for C++ was created by Mike Jarvis     //
+// Copyright (C) 1998 - 2016                                                 //
+// All rights reserved                                                       //
+//                                                                           //
+// The project is hosted at https://code.google.com/p/tmv-cpp/               //
+// where you can find the current version and current documention.           //
+//                                                                           //
+// For concerns or problems with the software, Mike may be contacted at      //
+// mike_jarvis17 [at] gmail.                                                 //
+//                                                                           //
+// This software is licensed under a FreeBSD license.  The file              //
+// TMV_LICENSE should have bee included with this distribution.              //
+// It not, you can get a copy from https://code.google.com/p/tmv-cpp/.       //
+//                                                                           //
+// Essentially, you can use this software however you want provided that     //
+// you include the TMV_LICENSE file in any distribution that uses it.        //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+//#define XDEBUG
+
+// This file implements a two-stage reduction of a Hermitian matrix to
+// tridiagonal form:
+//
+// Stage 1: A = Q1 B Q1t, where B is a band matrix with nb sub-diagonals.
+// This is done one panel of nb columns at a time.  The part of the panel
+// below the band is QR decomposed, and the trailing matrix is updated
+// with the resulting block reflector.  So essentially all of the work is
+// in matrix products, which are multithreaded with OpenMP.
+//
+// Stage 2: B = Q2 T Q2t, where T is tridiagonal.  This uses the
+// bulge chasing algorithm of Schwarz (1968), as formulated for
+// multicore processors by Haidar, Ltaief & Dongarra (2011).
+// Sweep j annihilates column j below the sub-diagonal with a
+// Householder reflection of length nb, which creates a bulge further
+// down the band.  The first column of each bulge is then annihilated in
+// turn until the bulge falls off the end of the matrix.  The rest of each
+// bulge is left for the following sweeps.  All of this happens within
+// a small band work array, so it is cheap compared to stage 1.
+// Successive sweeps only touch the same elements when they are within a
+// few steps of each other, so with OpenMP the sweeps are pipelined across 
+// threads: each thread takes every nthreads-th sweep, and each step waits
+// only until the previous sweep is far enough ahead.
+//
+// If U is requested, we form Q1 in place from the stage 1 Householder 
+// vectors and then multiply by Q2 from the right.  The stage 2 
+// reflectors from nb consecutive sweeps with the same step number are 
+// combined into a single block reflector, so this is also done with 
+// matrix products.  The rows of U are split among the threads for this.
+
+#include "TMV_Blas.h"
+#include "TMV_SymSVDiv.h"
+#include "TMV_QRDiv.h"
+#include "tmv/TMV_Householder.h"
+#include "tmv/TMV_SymHouseholder.h"
+#include "tmv/TMV_SymMatrix.h"
+#include "tmv/TMV_SymMatrixArith.h"
+#include "tmv/TMV_TriMatrix.h"
+#include "tmv/TMV_TriMatrixArith.h"
+#include "tmv/TMV_MatrixArith.h"
+#include "tmv/TMV_VectorArith.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef XDEBUG
+#include "tmv/TMV_DiagMatrixArith.h"
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+#endif
+
+#ifndef SYM_TWOSTAGE_BANDWIDTH
+#define SYM_TWOSTAGE_BANDWIDTH 32
+#endif
+
+// Step k of one sweep may start once the previous sweep has finished
+// step k+SYM_TWOSTAGE_LAG-1.  Steps that are closer than this overlap.
+#define SYM_TWOSTAGE_LAG 4
+
+namespace tmv {
+
+#define RT TMV_RealType(T)
+
+    template <class T> 
+    static void ReduceToBand(
+        MatrixView<T> A, VectorView<T> beta, const ptrdiff_t nb)
+    {
+        // Reduce the Hermitian matrix stored in the lower triangle of A
+        // to a band matrix with nb sub-diagonals.
+        // For each panel, the part below the band is decomposed as
+        // P = Q R with Q = I - Y Z Yt.  Then the trailing matrix is
+        // updated as:
+        // A22 <- Qt A22 Q = A22 - V Yt - Y Vt
+        // where X = A22 Y Z and V = X - 1/2 Y Zt Yt X.
+        // The Householder vectors are left in A below the band, and 
+        // the betas are stored in beta, so the band-shifted lower part
+        // of A is in the usual format for GetQFromQR.
+        const ptrdiff_t N = A.colsize();
+        TMVAssert(A.rowsize() == N);
+        TMVAssert(N > nb+1);
+        TMVAssert(beta.size() == N-nb);
+        TMVAssert(A.ct() == NonConj);
+
+        beta.setZero();
+        T d(0);
+        UpperTriMatrix<T,NonUnitDiag|ColMajor> BaseZ(nb);
+        Matrix<T,ColMajor> BaseY(N-nb,nb);
+        Matrix<T,ColMajor> BaseYZ(N-nb,nb);
+        Matrix<T,ColMajor> BaseV(N-nb,nb);
+        Matrix<T,ColMajor> BaseM(nb,nb);
+
+        for(ptrdiff_t j1=0; N-j1-nb > 1; j1+=nb) {
+            const ptrdiff_t p = j1+nb;
+            const ptrdiff_t m = N-p;
+            const ptrdiff_t k = TMV_MIN(nb,m);
+            MatrixView<T> P = A.subMatrix(p,N,j1,j1+k);
+            VectorView<T> bP = beta.subVector(j1,j1+k);
+            QR_Decompose(P,bP,d);
+
+            UpperTriMatrixView<T> Z = BaseZ.subTriMatrix(0,k);
+            BlockHouseholderMakeZ(P,Z,bP);
+            // If the panel is wider than it is tall, the rest of it 
+            // still needs to be multiplied by Qt.
+            if (k < nb) BlockHouseholderLDiv(P,Z,A.subMatrix(p,N,j1+k,p));
+
+            MatrixView<T> Y = BaseY.subMatrix(0,m,0,k);
+            MatrixView<T> YZ = BaseYZ.subMatrix(0,m,0,k);
+            MatrixView<T> V = BaseV.subMatrix(0,m,0,k);
+            MatrixView<T> M = BaseM.subMatrix(0,k,0,k);
+            SymMatrixView<T> A22 = HermMatrixViewOf(
+                A.subMatrix(p,N,p,N),Lower);
+
+            Y = P;
+            Y.upperTri().setToIdentity();
+            YZ = Y * Z;
+            V = A22 * YZ;
+            M = YZ.adjoint() * V;
+            V -= RT(0.5) * Y * M;
+            Rank2KUpdate<true>(T(-1),Y,V,A22);
+        }
+    }
+
+    template <class T> 
+    static void BulgeChaseStep(
+        MatrixView<T> B, const ptrdiff_t nb, 
+        const ptrdiff_t j, const ptrdiff_t k, T* v, T& beta)
+    {
+        // Do step k of sweep j.
+        // Step 0 annihilates B(j+2:j+nb+1,j), and the later steps 
+        // annihilate the first column of the bulge created by the 
+        // previous step.
+        // B only needs to be valid within 2nb of the diagonal.
+        // If v is not 0, the Householder vector is copied there.
+        const ptrdiff_t N = B.colsize();
+        const ptrdiff_t c = k==0 ? j : j+1+(k-1)*nb;
+        const ptrdiff_t r1 = j+1+k*nb;
+        const ptrdiff_t r2 = TMV_MIN(r1+nb,N);
+        const ptrdiff_t r3 = TMV_MIN(r2+nb,N);
+        TMVAssert(r1 < N);
+
+        VectorView<T> x = B.col(c,r1,r2);
+        VectorView<T> u = x.subVector(1,r2-r1);
+        T d(0);
+        beta = HouseholderReflect(x,d);
+        TMVAssert(TMV_IMAG(x(0)) == RT(0));
+        if (beta != T(0)) {
+            if (k > 0) HouseholderLMult(u,beta,B.subMatrix(r1,r2,c+1,r1));
+            HouseholderLRMult(
+                u,beta,HermMatrixViewOf(B.subMatrix(r1,r2,r1,r2),Lower));
+            if (r3 > r2) 
+                HouseholderLMult(u,beta,B.subMatrix(r2,r3,r1,r2).adjoint());
+        }
+        if (v && u.size() > 0) VectorViewOf(v,u.size()) = u;
+        u.setZero();
+    }
+
+    template <class T> 
+    static void BandToTridiagonal(
+        MatrixView<T> B, const ptrdiff_t nb, const ptrdiff_t* offset,
+        MatrixView<T> V2, VectorView<T> beta2)
+    {
+        // Reduce the band matrix B to tridiagonal form with bulge chasing.
+        // The Householder vectors for step k of sweep j are stored in
+        // column offset[j]+k of V2, and the betas in beta2.
+        // If V2 has no columns, they are not saved.
+        const ptrdiff_t N = B.colsize();
+        const ptrdiff_t nsweep = N-1;
+        const bool saveq = V2.rowsize() > 0;
+        T* V2ptr = V2.ptr();
+        const ptrdiff_t V2s = V2.stepj();
+        T* b2ptr = beta2.ptr();
+        TMVAssert(beta2.step() == 1);
+        T dummy(0);
+
+#ifdef _OPENMP
+        if (!omp_in_parallel() && omp_get_max_threads() > 1) {
+            AlignedArray<ptrdiff_t> progress(nsweep);
+            for(ptrdiff_t j=0;j<nsweep;++j) progress[j] = 0;
+            ptrdiff_t* prog = progress.get();
+#pragma omp parallel
+            {
+                const ptrdiff_t nthreads = omp_get_num_threads();
+                const ptrdiff_t mythread = omp_get_thread_num();
+                T mydummy(0);
+                for(ptrdiff_t j=mythread;j<nsweep;j+=nthreads) {
+                    const ptrdiff_t ns = BulgeChaseNSteps(N,nb,j);
+                    const ptrdiff_t nsprev = j > 0 ? 
+                        BulgeChaseNSteps(N,nb,j-1) : 0;
+                    for(ptrdiff_t k=0;k<ns;++k) {
+                        if (j > 0) {
+                            const ptrdiff_t need = 
+                                TMV_MIN(k+SYM_TWOSTAGE_LAG,nsprev);
+                            ptrdiff_t done;
+                            do {
+#pragma omp atomic read
+                                done = prog[j-1];
+                            } while (done < need);
+#pragma omp flush
+                        }
+                        if (saveq) 
+                            BulgeChaseStep(
+                                B,nb,j,k,V2ptr+(offset[j]+k)*V2s,
+                                b2ptr[offset[j]+k]);
+                        else 
+                            BulgeChaseStep(B,nb,j,k,(T*)(0),mydummy);
+#pragma omp flush
+#pragma omp atomic write
+                        prog[j] = k+1;
+                    }
+                }
+            }
+            return;
+        }
+#endif
+        for(ptrdiff_t j=0;j<nsweep;++j) {
+            const ptrdiff_t ns = BulgeChaseNSteps(N,nb,j);
+            for(ptrdiff_t k=0;k<ns;++k) {
+                if (saveq) 
+                    BulgeChaseStep(
+                        B,nb,j,k,V2ptr+(offset[j]+k)*V2s,
+                        b2ptr[offset[j]+k]);
+                else 
+                    BulgeChaseStep(B,nb,j,k,(T*)(0),dummy);
+            }
+        }
+    }
+
+    template <class T> 
+    void TwoStageTridiagonalize(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, bool setU)
+    {
+        // Decompose the Hermitian matrix A, input as the lower triangle 
+        // of U, into U T Ut, where T is real tridiagonal.
+        // T is returned in D and E.
+        // If setU is false, U is just used as workspace.
+        const ptrdiff_t N = U.colsize();
+        const ptrdiff_t nb = SYM_TWOSTAGE_BANDWIDTH;
+        TMVAssert(U.rowsize() == N);
+        TMVAssert(D.size() == N);
+        TMVAssert(E.size() == N-1);
+        TMVAssert(U.ct() == NonConj);
+        TMVAssert(N > 2*nb);
+
+#ifdef XDEBUG
+        Matrix<T> A0(N,N);
+        A0.lowerTri() = U.lowerTri();
+        A0.upperTri().offDiag() = U.lowerTri().offDiag().adjoint();
+#endif
+
+        // Stage 1: Reduce to band form.
+        Vector<T> beta1(N-nb);
+        ReduceToBand(U,beta1.view(),nb);
+
+        // Copy the band into a work array with room for the bulges.
+        // Element (i,j) of B is at Bmem[i + j*2nb], which is valid for
+        // 0 <= i-j <= 2nb.
+        const ptrdiff_t L = 2*nb;
+        AlignedArray<T> Bmem(N*(L+1));
+        MatrixView<T> B = MatrixViewOf(Bmem.get(),N,N,1,L);
+        for(ptrdiff_t j=0;j<N;++j) {
+            const ptrdiff_t j2 = TMV_MIN(j+nb+1,N);
+            const ptrdiff_t j3 = TMV_MIN(j+L+1,N);
+            B.col(j,j,j2) = U.col(j,j,j2);
+            B.col(j,j2,j3).setZero();
+        }
+
+        // Stage 2: Reduce the band to tridiagonal form.
+        AlignedArray<ptrdiff_t> offset(N);
+        offset[0] = 0;
+        for(ptrdiff_t j=0;j<N-1;++j) 
+            offset[j+1] = offset[j] + BulgeChaseNSteps(N,nb,j);
+        const ptrdiff_t nq = setU ? offset[N-1] : 0;
+        Matrix<T,ColMajor> V2(nb-1,nq);
+        Vector<T> beta2(nq);
+        BandToTridiagonal(B,nb,offset.get(),V2.view(),beta2.view());
+        D = B.diag().realPart();
+        E = B.diag(-1).realPart();
+
+        if (setU) {
+            // U = Q1, formed in place the same way that Tridiagonalize's
+            // U is formed, but with the vectors offset by nb rather than 1.
+            for(ptrdiff_t j=N-1;j>=nb;--j) U.col(j,j,N) = U.col(j-nb,j,N);
+            U.subMatrix(0,nb,0,nb).setToIdentity();
+            U.subMatrix(nb,N,0,nb).setZero();
+            U.subMatrix(0,nb,nb,N).setZero();
+            GetQFromQR(U.subMatrix(nb,N,nb,N),beta1);
+
+            // U = Q1 Q2
+            MultBulgeChaseQ(U,nb,offset.get(),V2,beta2);
+        }
+
+#ifdef XDEBUG
+        if (setU) {
+            Matrix<T> TT(N,N,T(0));
+            TT.diag() = D; TT.diag(1) = TT.diag(-1) = E;
+            Matrix<T> A2 = U*TT*U.adjoint();
+            cout<<"TwoStageTridiagonalize: Norm(A0-UTUt) = "<<
+                Norm(A0-A2)<<endl;
+            if (!(Norm(A2-A0) < 0.001*Norm(A0))) {
+                cerr<<"TwoStageTridiagonalize: \n";
+                cerr<<"A0 = "<<A0<<endl;
+                cerr<<"U = "<<U<<endl;
+                cerr<<"D = "<<D<<endl;
+                cerr<<"E = "<<E<<endl;
+                cerr<<"UTUt = "<<A2<<endl;
+                abort();
+            }
+        }
+#endif
+    }
+
+#undef RT
+
+#define InstFile "TMV_SymSVDecompose_TwoStage.inst"
+#include "TMV_Inst.h"
+#undef InstFile
+
+} // namespace tmv
+
+
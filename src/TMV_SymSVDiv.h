@@ -35,6 +35,10 @@ namespace tmv {
         SymMatrixView<T> A, VectorView<T> beta,
         VectorView<Td> D, VectorView<RT> E, T& signdet);
 
+    template <typename T> 
+    void TwoStageTridiagonalize(
+        MatrixView<T> U, VectorView<RT> D, VectorView<RT> E, bool setU);
+
     template <typename T> 
     void EigenFromTridiagonal(
         MatrixView<T> U, VectorView<RT> D, VectorView<RT> E);
@@ -34,6 +34,10 @@
 #include <iostream>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef XDEBUG
 #include <iostream>
 using std::cout;
@@ -265,6 +269,33 @@ namespace tmv {
         }
     }
 
+#ifdef _OPENMP
+    template <class T, class TriM> 
+    static void OpenMPTriLDivEq(const TriM& A, MatrixView<T> B)
+    {
+        // Each column of B is an independent right hand side, so when
+        // there are many of them, we split B into panels of columns.
+        // Each panel is solved with the above recursive algorithm, and 
+        // the panels are done in parallel.
+        const ptrdiff_t K = B.rowsize();
+        const ptrdiff_t npanel = TMV_MIN(
+            ptrdiff_t(omp_get_max_threads()), K/TRI_DIV_BLOCKSIZE);
+        TMVAssert(npanel > 1);
+#pragma omp parallel for schedule(static)
+        for(ptrdiff_t p=0;p<npanel;++p) {
+            const ptrdiff_t j1 = p*K/npanel;
+            const ptrdiff_t j2 = (p+1)*K/npanel;
+            NonBlasTriLDivEq(A,B.colRange(j1,j2));
+        }
+    }
+
+    static inline bool UseOpenMPTriLDivEq(ptrdiff_t N, ptrdiff_t K)
+    {
+        return N > TRI_DIV_BLOCKSIZE2 && K >= 2*TRI_DIV_BLOCKSIZE &&
+            omp_get_max_threads() > 1 && !omp_in_parallel();
+    }
+#endif
+
 #ifdef BLAS
     template <class T, class Ta> 
     static inline void BlasTriLDivEq(
@@ -628,7 +659,12 @@ namespace tmv {
                 } else 
                     BlasTriLDivEq(A,B);
 #else
-                NonBlasTriLDivEq(A,B);
+#ifdef _OPENMP
+                if (UseOpenMPTriLDivEq(A.size(),B.rowsize()))
+                    OpenMPTriLDivEq(A,B);
+                else
+#endif
+                    NonBlasTriLDivEq(A,B);
 #endif
             }
         }
@@ -692,7 +728,12 @@ namespace tmv {
                 } else 
                     BlasTriLDivEq(A,B);
 #else
-                NonBlasTriLDivEq(A,B);
+#ifdef _OPENMP
+                if (UseOpenMPTriLDivEq(A.size(),B.rowsize()))
+                    OpenMPTriLDivEq(A,B);
+                else
+#endif
+                    NonBlasTriLDivEq(A,B);
 #endif
             }
         }
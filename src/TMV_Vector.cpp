@@ -20,6 +20,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "TMV_Blas.h"
+#include "TMV_SIMD.h"
 #include "tmv/TMV_Vector.h"
 #include "tmv/TMV_VIt.h"
 #include "TMV_ConvertIndex.h"
@@ -153,6 +154,36 @@ namespace tmv {
     //
     // norm2
     //
+    template <class T> 
+    static RT UnitNormSq(const ptrdiff_t n, const RT scale, const T* p)
+    {
+        // Only called for real T.  (Complex vectors are flattened first.)
+        RT sum(0);
+        if (scale == RT(1)) 
+            for(ptrdiff_t i=n;i>0;--i,++p) sum += TMV_NORM(*p);
+        else
+            for(ptrdiff_t i=n;i>0;--i,++p) sum += TMV_NORM(scale* (*p));
+        return sum;
+    }
+#ifdef TMV_SIMD_DISPATCH
+#ifdef INST_DOUBLE
+    static double UnitNormSq(
+        const ptrdiff_t n, const double scale, const double* p)
+    {
+        if (GetSIMDLevel() != SIMD_Baseline) return SIMD_NormSq(n,scale,p);
+        else return UnitNormSq<double>(n,scale,p);
+    }
+#endif
+#ifdef INST_FLOAT
+    static float UnitNormSq(
+        const ptrdiff_t n, const float scale, const float* p)
+    {
+        if (GetSIMDLevel() != SIMD_Baseline) return SIMD_NormSq(n,scale,p);
+        else return UnitNormSq<float>(n,scale,p);
+    }
+#endif
+#endif
+
     template <class T> 
     RT GenVector<T>::normSq(const RT scale) const
     {
@@ -161,15 +192,7 @@ namespace tmv {
         const ptrdiff_t s = step();
         if (s == 1) {
             if (isComplex(T())) return flatten().normSq(scale);
-            else {
-                RT sum(0);
-                const T* p = cptr();
-                if (scale == RT(1)) 
-                    for(ptrdiff_t i=size();i>0;--i,++p) sum += TMV_NORM(*p);
-                else
-                    for(ptrdiff_t i=size();i>0;--i,++p) sum += TMV_NORM(scale* (*p));
-                return sum;
-            }
+            else return UnitNormSq(size(),scale,cptr());
         } else if (s < 0) {
             return reverse().normSq(scale);
         } else if (s == 0) {
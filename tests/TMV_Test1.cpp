@@ -44,6 +44,7 @@ int main() try
     TestTriDiv<double>();
     TestMatrixDiv<double>();
     TestMatrixDet<double>();
+    TestAllocator<double>();
 #endif // DOUBLE
 
 #ifdef TEST_FLOAT
@@ -56,6 +57,7 @@ int main() try
     TestTriDiv<float>();
     TestMatrixDiv<float>();
     TestMatrixDet<float>();
+    TestAllocator<float>();
 #endif // FLOAT
 
 #ifdef TEST_INT
@@ -77,6 +79,7 @@ int main() try
     TestTriDiv<long double>();
     TestMatrixDiv<long double>();
     TestMatrixDet<long double>();
+    TestAllocator<long double>();
 #endif // LONGDOUBLE
 
 #endif
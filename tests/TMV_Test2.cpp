@@ -41,6 +41,7 @@ int main() try
     TestAllBandDiv<double>();
     TestAllSymDiv<double>();
     TestAllSymBandDiv<double>();
+    TestBatchedBandMatrix<double>();
 #endif
 
 #ifdef TEST_FLOAT
@@ -50,6 +51,7 @@ int main() try
     TestAllBandDiv<float>();
     TestAllSymDiv<float>();
     TestAllSymBandDiv<float>();
+    TestBatchedBandMatrix<float>();
 #endif
 
 #ifdef TEST_LONGDOUBLE
@@ -59,6 +61,7 @@ int main() try
     TestAllBandDiv<long double>();
     TestAllSymDiv<long double>();
     TestAllSymBandDiv<long double>();
+    TestBatchedBandMatrix<long double>();
 #endif 
 
 #ifdef TEST_INT
@@ -43,6 +43,7 @@ int main() try
     TestAllSmallMatrixDivA<double>();
     TestAllSmallMatrixDivB<double>();
     TestSmallMatrixDet<double>();
+    TestBatchedSmallMatrix<double>();
 #endif
 
 #ifdef TEST_FLOAT
@@ -54,6 +55,7 @@ int main() try
     TestAllSmallMatrixDivA<float>();
     TestAllSmallMatrixDivB<float>();
     TestSmallMatrixDet<float>();
+    TestBatchedSmallMatrix<float>();
 #endif
 
 #ifdef TEST_LONGDOUBLE
@@ -65,6 +67,7 @@ int main() try
     TestAllSmallMatrixDivA<long double>();
     TestAllSmallMatrixDivB<long double>();
     TestSmallMatrixDet<long double>();
+    TestBatchedSmallMatrix<long double>();
 #endif 
 
 #ifdef TEST_INT
@@ -0,0 +1,133 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_1.h"
+#include "TMV.h"
+
+// An allocator that just counts how many times it is used.
+class CountingAllocator : public tmv::Allocator
+{
+public :
+    CountingAllocator() : nalloc(0), nfree(0) {}
+    void* allocate(size_t nbytes, size_t align)
+    { ++nalloc; return tmv::HeapAllocate(nbytes,align); }
+    void deallocate(void* p, size_t )
+    { ++nfree; tmv::HeapDeallocate(p); }
+    int nalloc, nfree;
+};
+
+template <class T>
+static void DoSolve(
+    const tmv::Matrix<T>& a0, const tmv::Matrix<T>& b0, tmv::DivType dt,
+    tmv::MatrixView<T> x0)
+{
+    tmv::Matrix<T> a = a0;
+    a.divideUsing(dt);
+    x0 = b0 / a;
+}
+
+template <class T>
+static void TestAllocatorDiv(tmv::Allocator& alloc, std::string label)
+{
+    const int N = 40;
+    tmv::Matrix<T> a(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+        a(i,j) = T(2.+4*i-5*j) / T(7.+i+j);
+    a.diag().addToAll(T(N));
+    tmv::Matrix<T> b(N,3);
+    for(int i=0;i<N;++i) for(int j=0;j<3;++j) b(i,j) = T(1.-3*i+j);
+
+    const tmv::DivType dts[3] = { tmv::LU, tmv::QR, tmv::SV };
+    for(int k=0;k<3;++k) {
+        tmv::Matrix<T> x0(N,3);
+        DoSolve(a,b,dts[k],x0.view());
+
+        tmv::Matrix<T> x1(N,3);
+        tmv::ResetAllocationCounts();
+        {
+            tmv::AllocatorGuard guard(alloc);
+            for(int iter=0;iter<3;++iter) {
+                DoSolve(a,b,dts[k],x1.view());
+                if (iter == 0) tmv::ResetAllocationCounts();
+            }
+            Assert(tmv::GetAllocator() == &alloc,label+" GetAllocator");
+        }
+        Assert(tmv::GetAllocator() == 0,label+" guard restored allocator");
+        Assert(tmv::AllocationCount() > 0,label+" AllocationCount");
+        Assert(tmv::HeapAllocationCount() == 0,label+" no heap allocation");
+        Assert(Norm(x1-x0) <= EPS*Norm(x0),label+" same result");
+    }
+}
+
+template <class T>
+void TestAllocator()
+{
+    tmv::PoolAllocator pool;
+    TestAllocatorDiv<T>(pool,"PoolAllocator");
+
+    // Start the arena small, so it needs to merge its chunks.
+    tmv::ArenaAllocator arena(1024);
+    TestAllocatorDiv<T>(arena,"ArenaAllocator");
+
+    // Arrays made while the guard is active go back to the allocator
+    // they came from, even if the guard is gone.
+    CountingAllocator counter;
+    {
+        tmv::Vector<T>* v;
+        {
+            tmv::AllocatorGuard guard(counter);
+            v = new tmv::Vector<T>(10,T(1));
+            tmv::Vector<T> w = *v;
+            w *= T(2);
+            Assert(Norm(w) == T(2)*Norm(*v),"CountingAllocator Norm");
+        }
+        Assert(counter.nalloc == 2,"CountingAllocator nalloc");
+        Assert(counter.nfree == 1,"CountingAllocator nfree 1");
+        delete v;
+        Assert(counter.nfree == 2,"CountingAllocator nfree 2");
+    }
+
+    // Without any allocator, everything goes to the heap.
+    tmv::ResetAllocationCounts();
+    { tmv::Vector<T> v(10); }
+    Assert(tmv::AllocationCount() == 1,"Heap AllocationCount");
+    Assert(tmv::HeapAllocationCount() == 1,"HeapAllocationCount");
+
+    // Check the alignment settings.
+    const size_t align0 = tmv::GetAlignment();
+    Assert(align0 >= 16,"GetAlignment");
+    {
+        tmv::Vector<T> v(11);
+        Assert((size_t(v.cptr()) & (align0-1)) == 0,"Default alignment");
+        tmv::SetAlignment(256);
+        tmv::Matrix<std::complex<T> > m(5,7);
+        Assert((size_t(m.cptr()) & 255) == 0,"SetAlignment(256)");
+        // The pool needs to notice that its saved blocks might not be
+        // aligned enough anymore.
+        tmv::AllocatorGuard guard(pool);
+        for(int k=0;k<10;++k) {
+            tmv::Vector<T> w(k+1);
+            Assert((size_t(w.cptr()) & 255) == 0,"SetAlignment(256) pool");
+        }
+        tmv::SetAlignment(align0);
+    }
+    const size_t thresh0 = tmv::GetHugePageThreshold();
+    {
+        tmv::SetHugePageThreshold(1<<20);
+        tmv::Vector<T> v((1<<20)/sizeof(T)+1);
+        Assert((size_t(v.cptr()) & (tmv::TMV_HugePageSize-1)) == 0,
+               "Huge page alignment");
+        tmv::SetHugePageThreshold(thresh0);
+    }
+
+    std::cout<<"Allocator<"<<tmv::TMV_Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestAllocator<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestAllocator<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestAllocator<long double>();
+#endif
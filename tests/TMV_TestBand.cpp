@@ -598,6 +598,162 @@ static void TestBasicBandMatrix_IO()
 #endif
 }
 
+template <class T> 
+static void TestDiagMajorMultMV()
+{
+    // This is large enough to use the SIMD kernels for the diagonals 
+    // and to split the rows among the OpenMP threads.
+    const int N = 6000;
+    const int nlo = 4;
+    const int nhi = 7;
+
+    tmv::BandMatrix<T,tmv::DiagMajor> a(N,N,nlo,nhi);
+    tmv::BandMatrix<CT,tmv::DiagMajor> ca(N,N,nlo,nhi);
+    tmv::Vector<T> x(N);
+    tmv::Vector<CT> cx(N);
+    for(int i=0;i<N;++i) {
+        for(int j=i-nlo;j<=i+nhi;++j) if (j>=0 && j<N) {
+            a(i,j) = T(2+(3*i-j)%5);
+            ca(i,j) = CT(2+(3*i-j)%5,1-(i+2*j)%3);
+        }
+        x(i) = T(1+i%7);
+        cx(i) = CT(1+i%7,2-i%5);
+    }
+
+    // The right answers from explicit loops.
+    tmv::Vector<T> y0(N,T(0)), yt0(N,T(0)), yu0(N,T(0)), yl0(N,T(0));
+    tmv::Vector<CT> cy0(N,CT(0)), cyt0(N,CT(0)), cya0(N,CT(0));
+    for(int i=0;i<N;++i) {
+        for(int j=i-nlo;j<=i+nhi;++j) if (j>=0 && j<N) {
+            y0(i) += a(i,j) * x(j);
+            yt0(j) += a(i,j) * x(i);
+            if (j >= i) yu0(i) += a(i,j) * x(j);
+            if (j <= i) yl0(i) += a(i,j) * x(j);
+            cy0(i) += ca(i,j) * cx(j);
+            cyt0(j) += ca(i,j) * cx(i);
+            cya0(j) += tmv::TMV_CONJ(ca(i,j)) * cx(i);
+        }
+    }
+
+    // All of the values are small integers, so the results are exact.
+    const int eps = 0;
+    const int ceps = 0;
+
+    tmv::Vector<T> y = a*x;
+    Assert(Equal(y,y0,eps),"DiagMajor Band MultMV");
+    y = a.transpose()*x;
+    Assert(Equal(y,yt0,eps),"DiagMajor Band MultMV transpose");
+    y = x;
+    y += a*x;
+    Assert(Equal(y,y0+x,eps),"DiagMajor Band MultMV add");
+    y = a.upperBand()*x;
+    Assert(Equal(y,yu0,eps),"DiagMajor Band MultEqMV upper");
+    y = a.lowerBand()*x;
+    Assert(Equal(y,yl0,eps),"DiagMajor Band MultEqMV lower");
+    tmv::BandMatrix<T,tmv::ColMajor> acm = a;
+    tmv::BandMatrix<T,tmv::RowMajor> arm = a;
+    Assert(Equal(tmv::Vector<T>(acm*x),y0,eps),"ColMajor Band MultMV");
+    Assert(Equal(tmv::Vector<T>(arm*x),y0,eps),"RowMajor Band MultMV");
+
+    tmv::Vector<CT> cy = ca*cx;
+    Assert(Equal(cy,cy0,ceps),"DiagMajor Band MultMV complex");
+    cy = ca.transpose()*cx;
+    Assert(Equal(cy,cyt0,ceps),"DiagMajor Band MultMV complex transpose");
+    cy = ca.adjoint()*cx;
+    Assert(Equal(cy,cya0,ceps),"DiagMajor Band MultMV complex adjoint");
+    cy = ca.conjugate()*cx.conjugate();
+    Assert(Equal(cy,cy0.conjugate(),ceps),
+           "DiagMajor Band MultMV complex conj A and x");
+    tmv::Vector<CT> cxc = cx.conjugate();
+    cy = ca*cx.conjugate();
+    Assert(Equal(cy,tmv::Vector<CT>(ca*cxc),ceps),
+           "DiagMajor Band MultMV complex conj x");
+    cy = a*cx;
+    Assert(Equal(cy,tmv::Vector<CT>(acm*cx),ceps),
+           "DiagMajor Band MultMV real A complex x");
+}
+
+template <class T, tmv::StorageType S> 
+static void TestWideBandMultMM_1()
+{
+    // These bands are wide enough to use the blocked algorithm,
+    // and the sizes are not multiples of the block size.
+    const int M = 300;
+    const int N = 260;
+    const int K = 20;
+    const int P = 280;
+
+    tmv::BandMatrix<T,S> a(M,N,40,70);
+    tmv::BandMatrix<T,S> b(N,P,50,35);
+    tmv::BandMatrix<CT,S> ca(M,N,40,70);
+    tmv::Matrix<T> m(N,K);
+    tmv::Matrix<CT> cm(N,K);
+    for(int i=0;i<M;++i) for(int j=i-40;j<=i+70;++j) if (j>=0 && j<N) {
+        a(i,j) = T(2+(3*i-j)%5);
+        ca(i,j) = CT(2+(3*i-j)%5,1-(i+2*j)%3);
+    }
+    for(int i=0;i<N;++i) for(int j=i-50;j<=i+35;++j) if (j>=0 && j<P) 
+        b(i,j) = T(1-(i+2*j)%4);
+    for(int i=0;i<N;++i) for(int j=0;j<K;++j) {
+        m(i,j) = T(1+(i+j)%7);
+        cm(i,j) = CT(1+(i+j)%7,2-(i*j)%5);
+    }
+    tmv::Matrix<T> a0 = a;
+    tmv::Matrix<T> b0 = b;
+    tmv::Matrix<CT> ca0 = ca;
+
+    // All of the values are small integers, so the results are exact.
+    const int eps = 0;
+    const int ceps = 0;
+
+    tmv::Matrix<T> c0 = a0*m;
+    tmv::Matrix<T> c = a*m;
+    Assert(Equal(c,c0,eps),"Wide Band MultMM");
+    tmv::Matrix<T,tmv::RowMajor> cr = a*m;
+    Assert(Equal(cr,c0,eps),"Wide Band MultMM RowMajor C");
+    c += T(2)*a*m;
+    Assert(Equal(c,T(3)*c0,eps),"Wide Band MultMM add");
+    tmv::Matrix<T> m2 = a0.transpose()*c0;
+    tmv::Matrix<T> ct = a.transpose()*c0;
+    Assert(Equal(ct,m2,eps),"Wide Band MultMM transpose");
+
+    tmv::Matrix<CT> cc = ca*cm;
+    Assert(Equal(cc,tmv::Matrix<CT>(ca0*cm),ceps),"Wide Band MultMM complex");
+    cc = ca.conjugate()*cm;
+    Assert(Equal(cc,tmv::Matrix<CT>(ca0.conjugate()*cm),ceps),
+           "Wide Band MultMM complex conj");
+    cc = a*cm;
+    Assert(Equal(cc,tmv::Matrix<CT>(a0*cm),ceps),
+           "Wide Band MultMM real A complex B");
+
+    // The product has nlo = 90 and nhi = 105.
+    tmv::BandMatrix<T,S> d = a*b;
+    Assert(d.nlo() == 90 && d.nhi() == 105,"Wide Band MultBB bandwidth");
+    tmv::Matrix<T> d0 = a0*b0;
+    Assert(Equal(tmv::Matrix<T>(d),d0,eps),"Wide Band MultBB");
+    tmv::BandMatrix<T,tmv::DiagMajor> dd = a*b;
+    Assert(Equal(tmv::Matrix<T>(dd),d0,eps),"Wide Band MultBB DiagMajor C");
+    d -= T(2)*a*b;
+    Assert(Equal(tmv::Matrix<T>(d),-d0,eps),"Wide Band MultBB add");
+    tmv::BandMatrix<T,S> dw(M,P,100,110);
+    dw = a*b;
+    Assert(Equal(tmv::Matrix<T>(dw),d0,eps),"Wide Band MultBB wider C");
+    tmv::BandMatrix<CT,S> cd = ca*b;
+    Assert(Equal(tmv::Matrix<CT>(cd),tmv::Matrix<CT>(ca0*b0),ceps),
+           "Wide Band MultBB complex");
+    tmv::BandMatrix<CT,S> ch = ca.adjoint()*ca;
+    Assert(Equal(tmv::Matrix<CT>(ch),tmv::Matrix<CT>(ca0.adjoint()*ca0),ceps),
+           "Wide Band MultBB complex adjoint");
+}
+
+template <class T> 
+static void TestWideBandMultMM()
+{
+    TestWideBandMultMM_1<T,tmv::ColMajor>();
+    TestWideBandMultMM_1<T,tmv::RowMajor>();
+    TestWideBandMultMM_1<T,tmv::DiagMajor>();
+}
+
 template <class T, tmv::StorageType S> 
 static void TestBasicBandMatrix()
 {
@@ -612,6 +768,8 @@ void TestBandMatrix()
     TestBasicBandMatrix<T,tmv::RowMajor>();
     TestBasicBandMatrix<T,tmv::ColMajor>();
     TestBasicBandMatrix<T,tmv::DiagMajor>();
+    TestDiagMajorMultMV<T>();
+    TestWideBandMultMM<T>();
 
     std::cout<<"BandMatrix<"<<tmv::TMV_Text(T())<<"> passed all basic tests\n";
 
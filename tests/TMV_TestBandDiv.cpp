@@ -221,6 +221,75 @@ void TestBandDiv(tmv::DivType dt)
     std::cout<<tmv::TMV_Text(dt)<<" passed all tests\n";
 }
 
+template <class T> 
+static void TestBandSpikeDiv()
+{
+    // Force the partitioned (SPIKE) algorithm for small matrices, and 
+    // check that it agrees with the regular serial algorithm.
+    const int N = 200;
+    const int K = 3;
+    for (int nlo=1; nlo<=4; ++nlo) for (int nhi=1; nhi<=3; ++nhi) {
+        tmv::BandMatrix<T> b(N,N,nlo,nhi);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            if (j >= i-nlo && j <= i+nhi) b(i,j) = T(2+4*i-5*j+(i*j)%7)/T(N);
+        // Small diagonal elements in places, so the blocks need pivoting.
+        b.diag().addToAll(T(4));
+        for(int i=0;i<N;i+=7) b(i,i) = T(0.01);
+        tmv::Matrix<T> m(N,K);
+        for(int i=0;i<N;++i) for(int k=0;k<K;++k) m(i,k) = T(1+i-3*k);
+        tmv::Matrix<std::complex<T> > cm = std::complex<T>(1,2) * m;
+
+        tmv::BandMatrix<T> b2 = b;
+        b2.divideUsing(tmv::LU);
+        b2.saveDiv();
+        b2.setDiv();
+        Assert(!b2.lud().isPartitioned(),"Band Spike default not used");
+
+        tmv::UseBandSpike(20,4);
+        b.divideUsing(tmv::LU);
+        b.saveDiv();
+        b.setDiv();
+        tmv::UseBandSpike();
+        Assert(b.lud().isPartitioned(),"Band Spike used");
+
+        T eps = EPS * Norm(b) * Norm(b2.inverse());
+        tmv::Matrix<T> x1 = m/b;
+        tmv::Matrix<T> x2 = m/b2;
+        if (showacc) {
+            std::cout<<"nlo,nhi = "<<nlo<<','<<nhi<<std::endl;
+            std::cout<<"Norm(x1-x2) = "<<Norm(x1-x2)<<
+                "  "<<eps*Norm(x2)<<std::endl;
+        }
+        Assert(Norm(x1-x2) <= eps*Norm(x2),"Band Spike m/b");
+        tmv::Matrix<std::complex<T> > cx1 = cm/b;
+        tmv::Matrix<std::complex<T> > cx2 = cm/b2;
+        Assert(Norm(cx1-cx2) <= eps*Norm(cx2),"Band Spike cm/b");
+
+        tmv::BandMatrix<std::complex<T> > cb = std::complex<T>(3,-1) * b;
+        tmv::BandMatrix<std::complex<T> > cb2 = cb;
+        cb2.divideUsing(tmv::LU);
+        tmv::UseBandSpike(20,4);
+        cb.divideUsing(tmv::LU);
+        cb.saveDiv();
+        cb.setDiv();
+        tmv::UseBandSpike();
+        Assert(cb.lud().isPartitioned(),"Band Spike complex used");
+        cx1 = cm/cb;
+        cx2 = cm/cb2;
+        Assert(Norm(cx1-cx2) <= eps*Norm(cx2),"Band Spike cm/cb");
+
+        // These use the regular decomposition, calculated as needed.
+        tmv::Matrix<T> y1 = m.transpose()%b;
+        tmv::Matrix<T> y2 = m.transpose()%b2;
+        Assert(Norm(y1-y2) <= eps*Norm(y2),"Band Spike m%b");
+        Assert(Equal2(b.logDet(),b2.logDet(),eps),"Band Spike logDet");
+        Assert(b.checkDecomp(),"Band Spike checkDecomp");
+    }
+
+    std::cout<<"BandMatrix<"<<tmv::TMV_Text(T())<<"> Partitioned LU ";
+    std::cout<<"Division passed all tests\n";
+}
+
 template <class T> void TestAllBandDiv()
 {
     TestBandDecomp<T,tmv::ColMajor>();
@@ -231,6 +300,7 @@ template <class T> void TestAllBandDiv()
     TestBandDiv<T>(tmv::LU);
     TestBandDiv<T>(tmv::QR);
     TestBandDiv<T>(tmv::SV);
+    TestBandSpikeDiv<T>();
 }
 
 #ifdef TEST_DOUBLE
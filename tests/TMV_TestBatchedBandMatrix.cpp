@@ -0,0 +1,160 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_2.h"
+#include "TMV.h"
+#include "TMV_Band.h"
+#include <vector>
+
+#define NB 150
+#define N 20
+
+template <class T>
+static void TestBatchedBandMatrixReal()
+{
+    typedef TMV_RealType(T) RT;
+    const RT eps = EPS;
+
+    // Tridiagonal, diagonally dominant, so the Thomas algorithm is safe.
+    tmv::BatchedBandMatrix<T> a(NB,N,1,1);
+    // A general band matrix, some of which needs pivoting.
+    tmv::BatchedBandMatrix<T> h(NB,N,2,3);
+    tmv::Matrix<T> b(NB,N);
+
+    std::vector<tmv::BandMatrix<T> > va;
+    std::vector<tmv::BandMatrix<T> > vh;
+    for(int k=0;k<NB;++k) {
+        tmv::BandMatrix<T> ak(N,N,1,1);
+        for(int i=0;i<N;++i) for(int j=i-1;j<=i+1;++j)
+            if (j>=0 && j<N) ak(i,j) = i==j ? T(4.+k%5+i%3) : T(1.-2*i+j+k%7)/T(N);
+        tmv::BandMatrix<T> hk(N,N,2,3);
+        for(int i=0;i<N;++i) for(int j=i-2;j<=i+3;++j)
+            if (j>=0 && j<N) hk(i,j) = T(2.+4*i-5*j+k*(i-j+1)+(i*j*j)%7+(i==j?8:0))/T(3.+k);
+        // Make sure some of the batch need pivoting.
+        if (k%3 == 0) for(int i=0;i<N;i+=4) hk(i,i) = T(0);
+        va.push_back(ak);
+        vh.push_back(hk);
+        a.set(k,ak);
+        h.set(k,hk);
+        for(int i=0;i<N;++i) b(k,i) = T(1.-3*i+2*k);
+    }
+
+    for(int k=0;k<NB;++k) {
+        Assert(a(k,3,4) == va[k](3,4),"BatchedBandMatrix element access");
+        Assert(Norm(h.get(k)-vh[k]) == RT(0),"BatchedBandMatrix get");
+    }
+
+    // Thomas algorithm
+    tmv::BatchBandWorkspace<T> work;
+    tmv::Matrix<T> x = b;
+    tmv::BatchTridiag_Solve(a,x,work);
+    for(int k=0;k<NB;++k) {
+        tmv::Vector<T> x0 = b.row(k) / va[k];
+        Assert(Norm(x.row(k)-x0) <=
+               100*eps*Norm(va[k])*Norm(va[k].inverse())*Norm(x0),
+               "BatchTridiag_Solve");
+    }
+
+    // The general solver should work for the tridiagonal matrices too.
+    tmv::Matrix<T> x2 = b;
+    tmv::BatchBandLU_Solve(a,x2,work);
+    for(int k=0;k<NB;++k) {
+        tmv::Vector<T> x0 = b.row(k) / va[k];
+        Assert(Norm(x2.row(k)-x0) <=
+               100*eps*Norm(va[k])*Norm(va[k].inverse())*Norm(x0),
+               "BatchBandLU_Solve tridiag");
+    }
+
+    // Band LU solve, reusing the same workspace.
+    x = b;
+    tmv::BatchBandLU_Solve(h,x,work);
+    for(int k=0;k<NB;++k) {
+        tmv::Vector<T> x0 = b.row(k) / vh[k];
+        Assert(Norm(x.row(k)-x0) <=
+               100*eps*Norm(vh[k])*Norm(vh[k].inverse())*Norm(x0),
+               "BatchBandLU_Solve");
+    }
+
+    // A RowMajor B doesn't have the interleaved storage, so it is
+    // copied, but the results should be the same.
+    tmv::Matrix<T,tmv::RowMajor> xr = b;
+    tmv::BatchBandLU_Solve(h,xr);
+    Assert(Norm(xr-x) <= 10*eps*Norm(x),"BatchBandLU_Solve RowMajor");
+
+    // Identity
+    tmv::BatchedBandMatrix<T> id(NB,N,2,3);
+    id.setToIdentity();
+    x = b;
+    tmv::BatchBandLU_Solve(id,x.view(),work);
+    Assert(Norm(x-b) == RT(0),"BatchedBandMatrix identity");
+}
+
+template <class T>
+static void TestBatchedBandMatrixComplex()
+{
+    typedef std::complex<T> CT;
+    const T eps = EPS;
+
+    tmv::BatchedBandMatrix<CT> a(NB,N,1,1);
+    tmv::BatchedBandMatrix<CT> h(NB,N,3,1);
+    tmv::Matrix<CT> b(NB,N);
+
+    std::vector<tmv::BandMatrix<CT> > va;
+    std::vector<tmv::BandMatrix<CT> > vh;
+    for(int k=0;k<NB;++k) {
+        tmv::BandMatrix<CT> ak(N,N,1,1);
+        for(int i=0;i<N;++i) for(int j=i-1;j<=i+1;++j)
+            if (j>=0 && j<N) ak(i,j) = i==j ? CT(4.+k%5,i%3) : CT(1.-2*i+j,k%7)/T(N);
+        tmv::BandMatrix<CT> hk(N,N,3,1);
+        for(int i=0;i<N;++i) for(int j=i-3;j<=i+1;++j)
+            if (j>=0 && j<N) hk(i,j) = CT(2.+4*i-5*j+k+(i*j*j)%5+(i==j?8:0),3.*i-j*k)/T(3.+k);
+        if (k%4 == 0) for(int i=0;i<N;i+=3) hk(i,i) = CT(0);
+        va.push_back(ak);
+        vh.push_back(hk);
+        a.set(k,ak);
+        h.set(k,hk);
+        for(int i=0;i<N;++i) b(k,i) = CT(1.-3*i+2*k,i+k);
+    }
+
+    tmv::BatchBandWorkspace<CT> work;
+    tmv::Matrix<CT> x = b;
+    tmv::BatchTridiag_Solve(a,x,work);
+    for(int k=0;k<NB;++k) {
+        tmv::Vector<CT> x0 = b.row(k) / va[k];
+        Assert(Norm(x.row(k)-x0) <=
+               100*eps*Norm(va[k])*Norm(va[k].inverse())*Norm(x0),
+               "Complex BatchTridiag_Solve");
+    }
+
+    x = b;
+    tmv::BatchBandLU_Solve(h,x,work);
+    for(int k=0;k<NB;++k) {
+        tmv::Vector<CT> x0 = b.row(k) / vh[k];
+        Assert(Norm(x.row(k)-x0) <=
+               100*eps*Norm(vh[k])*Norm(vh[k].inverse())*Norm(x0),
+               "Complex BatchBandLU_Solve");
+    }
+
+    // A conjugated view of B also needs to be copied.
+    tmv::Matrix<CT> xc = b.conjugate();
+    tmv::BatchBandLU_Solve(h,xc.conjugate(),work);
+    Assert(Norm(xc.conjugate()-x) <= 10*eps*Norm(x),
+           "Complex BatchBandLU_Solve conj");
+}
+
+template <class T>
+void TestBatchedBandMatrix()
+{
+    TestBatchedBandMatrixReal<T>();
+    TestBatchedBandMatrixComplex<T>();
+    std::cout<<"BatchedBandMatrix<"<<tmv::TMV_Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestBatchedBandMatrix<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestBatchedBandMatrix<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestBatchedBandMatrix<long double>();
+#endif
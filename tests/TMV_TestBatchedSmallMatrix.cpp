@@ -0,0 +1,185 @@
+
+#include "TMV_Test.h"
+#include "TMV_Test_3.h"
+#include "TMV.h"
+#include "TMV_Small.h"
+#include <vector>
+
+#define NB 150
+
+template <class T>
+static void TestBatchedSmallMatrixReal()
+{
+    typedef TMV_RealType(T) RT;
+    const RT eps = EPS;
+
+    tmv::BatchedSmallMatrix<T,4,4> a(NB);
+    tmv::BatchedSmallMatrix<T,4,4> h(NB);
+    tmv::BatchedSmallMatrix<T,4,3> b(NB);
+    tmv::BatchedSmallMatrix<T,3,2> c(NB);
+
+    std::vector<tmv::SmallMatrix<T,4,4> > va(NB);
+    std::vector<tmv::SmallMatrix<T,4,4> > vh(NB);
+    std::vector<tmv::SmallMatrix<T,4,3> > vb(NB);
+    std::vector<tmv::SmallMatrix<T,3,2> > vc(NB);
+    for(int k=0;k<NB;++k) {
+        for(int i=0;i<4;++i) for(int j=0;j<4;++j) {
+            va[k](i,j) = T(2.+4*i-5*j+k*(i-j+1)+(i*j*j)%7+(i==j?8:0))/T(3.+k);
+        }
+        // Make sure some of the batch need pivoting.
+        if (k%3 == 0) va[k](0,0) = T(0);
+        vh[k] = va[k].transpose() * va[k];
+        vh[k].diag().addToAll(T(1));
+        for(int i=0;i<4;++i) for(int j=0;j<3;++j) {
+            vb[k](i,j) = T(1.-3*i+2*j+k);
+        }
+        for(int i=0;i<3;++i) for(int j=0;j<2;++j) {
+            vc[k](i,j) = T(7.+i*j-k);
+        }
+        a.set(k,va[k]);
+        h.set(k,vh[k]);
+        b.set(k,vb[k]);
+        c.set(k,vc[k]);
+    }
+
+    for(int k=0;k<NB;++k) {
+        Assert(a(k,1,2) == va[k](1,2),"BatchedSmallMatrix element access");
+        Assert(Norm(a.get(k)-va[k]) == RT(0),"BatchedSmallMatrix get");
+    }
+
+    // Multiplication
+    tmv::BatchedSmallMatrix<T,4,2> bc(NB);
+    tmv::BatchMultMM(b,c,bc);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<T,4,2> bc0 = vb[k] * vc[k];
+        Assert(Norm(bc.get(k)-bc0) <= eps*Norm(vb[k])*Norm(vc[k]),
+               "BatchMultMM");
+    }
+
+    // Determinant
+    tmv::Vector<T> det(NB);
+    tmv::BatchDet(a,det.view());
+    for(int k=0;k<NB;++k) {
+        T det0 = va[k].det();
+        Assert(Equal2(det(k),det0,100*eps*NormSq(va[k])*Norm(va[k])),
+               "BatchDet");
+    }
+
+    // Inverse
+    tmv::BatchedSmallMatrix<T,4,4> ainv(NB);
+    tmv::BatchInverse(a,ainv);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<T,4,4> ainv0 = va[k].inverse();
+        Assert(Norm(ainv.get(k)-ainv0) <=
+               100*eps*Norm(va[k])*NormSq(ainv0),"BatchInverse");
+    }
+
+    // LU solve
+    tmv::BatchedSmallMatrix<T,4,4> lu = a;
+    tmv::BatchedSmallMatrix<T,4,3> x = b;
+    tmv::BatchLU_Solve(lu,x);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<T,4,3> x0 = vb[k] / va[k];
+        Assert(Norm(x.get(k)-x0) <=
+               100*eps*Norm(va[k])*Norm(va[k].inverse())*Norm(x0),
+               "BatchLU_Solve");
+    }
+
+    // CH solve
+    tmv::BatchedSmallMatrix<T,4,4> ch = h;
+    x = b;
+    tmv::BatchCH_Solve(ch,x);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<T,4,3> x0 = vb[k] / vh[k];
+        Assert(Norm(x.get(k)-x0) <=
+               100*eps*Norm(vh[k])*Norm(vh[k].inverse())*Norm(x0),
+               "BatchCH_Solve");
+        tmv::SmallMatrix<T,4,4> l = ch.get(k);
+        for(int i=0;i<4;++i) for(int j=i+1;j<4;++j) l(i,j) = T(0);
+        Assert(Norm(l*l.adjoint()-vh[k]) <= 100*eps*Norm(vh[k]),
+               "BatchCH_Solve L L^H");
+    }
+
+    // Identity
+    tmv::BatchedSmallMatrix<T,4,4> id(NB);
+    id.setToIdentity();
+    tmv::BatchedSmallMatrix<T,4,4> aid(NB);
+    tmv::BatchMultMM(a,id,aid);
+    for(int k=0;k<NB;++k) {
+        Assert(Norm(aid.get(k)-va[k]) == RT(0),"BatchedSmallMatrix identity");
+    }
+}
+
+template <class T>
+static void TestBatchedSmallMatrixComplex()
+{
+    typedef std::complex<T> CT;
+    const T eps = EPS;
+
+    tmv::BatchedSmallMatrix<CT,3,3> a(NB);
+    tmv::BatchedSmallMatrix<CT,3,3> h(NB);
+    tmv::BatchedSmallMatrix<CT,3,2> b(NB);
+
+    std::vector<tmv::SmallMatrix<CT,3,3> > va(NB);
+    std::vector<tmv::SmallMatrix<CT,3,3> > vh(NB);
+    std::vector<tmv::SmallMatrix<CT,3,2> > vb(NB);
+    for(int k=0;k<NB;++k) {
+        for(int i=0;i<3;++i) for(int j=0;j<3;++j) {
+            va[k](i,j) = CT(2.+4*i-5*j+k+(i*j*j)%5+(i==j?8:0),3.*i-j*k)/T(3.+k);
+        }
+        vh[k] = va[k].adjoint() * va[k];
+        vh[k].diag().addToAll(T(1));
+        for(int i=0;i<3;++i) for(int j=0;j<2;++j) {
+            vb[k](i,j) = CT(1.-3*i+2*j+k,i+j);
+        }
+        a.set(k,va[k]);
+        h.set(k,vh[k]);
+        b.set(k,vb[k]);
+    }
+
+    tmv::Vector<CT> det(NB);
+    tmv::BatchDet(a,det.view());
+    for(int k=0;k<NB;++k) {
+        CT det0 = va[k].det();
+        Assert(Equal2(det(k),det0,100*eps*NormSq(va[k])*Norm(va[k])),
+               "Complex BatchDet");
+    }
+
+    tmv::BatchedSmallMatrix<CT,3,3> lu = a;
+    tmv::BatchedSmallMatrix<CT,3,2> x = b;
+    tmv::BatchLU_Solve(lu,x);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<CT,3,2> x0 = vb[k] / va[k];
+        Assert(Norm(x.get(k)-x0) <=
+               100*eps*Norm(va[k])*Norm(va[k].inverse())*Norm(x0),
+               "Complex BatchLU_Solve");
+    }
+
+    tmv::BatchedSmallMatrix<CT,3,3> ch = h;
+    x = b;
+    tmv::BatchCH_Solve(ch,x);
+    for(int k=0;k<NB;++k) {
+        tmv::SmallMatrix<CT,3,2> x0 = vb[k] / vh[k];
+        Assert(Norm(x.get(k)-x0) <=
+               100*eps*Norm(vh[k])*Norm(vh[k].inverse())*Norm(x0),
+               "Complex BatchCH_Solve");
+    }
+}
+
+template <class T>
+void TestBatchedSmallMatrix()
+{
+    TestBatchedSmallMatrixReal<T>();
+    TestBatchedSmallMatrixComplex<T>();
+    std::cout<<"BatchedSmallMatrix<"<<tmv::TMV_Text(T())<<"> passed all tests\n";
+}
+
+#ifdef TEST_DOUBLE
+template void TestBatchedSmallMatrix<double>();
+#endif
+#ifdef TEST_FLOAT
+template void TestBatchedSmallMatrix<float>();
+#endif
+#ifdef TEST_LONGDOUBLE
+template void TestBatchedSmallMatrix<long double>();
+#endif
@@ -5,6 +5,10 @@
 #include "TMV_Test.h"
 #include "TMV_Test_1.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 template <class T, tmv::StorageType stor> 
 void TestMatrixDecomp()
 {
@@ -591,20 +595,361 @@ void TestMatrixDecomp()
                     tmv::DiagMatrix<CT>(cS2/x) * cVt2.conjugate(),
                     ceps*(normc/x)*(normc/x)),"C SV13 Vt"); 
 #endif
+
+            if (mattype == 0) {
+                // Large enough to use the two-stage bidiagonalization.
+                if (showstartdone) std::cout<<"Large SV"<<std::endl;
+                const int M2 = 700;
+                const int N2 = 600;
+                tmv::Matrix<T,stor> m2(M2,N2);
+                tmv::Matrix<CT,stor> c2(M2,N2);
+                for(int i=0;i<M2;++i) for(int j=0;j<N2;++j) {
+                    m2(i,j) = T(2+4*i-5*j)/T(N2) + T((i*j)%11);
+                    c2(i,j) = CT(2+4*i-5*j,3-i)/T(N2) + T((i*j)%7);
+                }
+                T eps2 = EPS * T(N2);
+                T normm2 = Norm(m2);
+                T normc2 = Norm(c2);
+
+                tmv::Matrix<T,stor> U2 = m2;
+                tmv::DiagMatrix<T> S2(N2);
+                tmv::Matrix<T> Vt2(N2,N2);
+                SV_Decompose(U2,S2,Vt2,true);
+                Assert(Equal(m2,U2*S2*Vt2,eps2*normm2),"Large SV"); 
+                Assert(Equal(U2.transpose()*U2,T(1),eps2),"Large SV - UtU"); 
+                Assert(Equal(Vt2*Vt2.transpose(),T(1),eps2),"Large SV - VtV"); 
+                tmv::Matrix<T,stor> m3 = m2;
+                tmv::DiagMatrix<T> S3(N2);
+                SV_Decompose(m3,S3,false);
+                Assert(Equal(S3,S2,eps2*normm2),"Large SV S"); 
+
+                tmv::Matrix<CT,stor> cU2 = c2;
+                tmv::DiagMatrix<T> cS2(N2);
+                tmv::Matrix<CT> cVt2(N2,N2);
+                SV_Decompose(cU2,cS2,cVt2,true);
+                Assert(Equal(c2,cU2*cS2*cVt2,eps2*normc2),"Large C SV"); 
+                Assert(Equal(cU2.adjoint()*cU2,T(1),eps2),
+                       "Large C SV - UtU"); 
+                Assert(Equal(cVt2*cVt2.adjoint(),T(1),eps2),
+                       "Large C SV - VtV"); 
+                tmv::Matrix<CT,stor> c3 = c2;
+                tmv::DiagMatrix<T> cS3(N2);
+                SV_Decompose(c3,cS3,false);
+                Assert(Equal(cS3,cS2,eps2*normc2),"Large C SV S"); 
+            }
+
+            if (mattype == 0) {
+                // Randomized truncated SVD of a matrix with rapidly 
+                // decreasing singular values.
+                if (showstartdone) std::cout<<"Random SV"<<std::endl;
+                const int M2 = 300;
+                const int N2 = 200;
+                const int k = 10;
+                tmv::Matrix<T,stor> m2(M2,N2);
+                tmv::Matrix<CT,stor> c2(M2,N2);
+                for(int i=0;i<M2;++i) for(int j=0;j<N2;++j) {
+                    m2(i,j) = T(0);
+                    c2(i,j) = T(0);
+                }
+                for(int q=0;q<3*k;++q) {
+                    T sq = T(1) / T(1<<(q<20?q:20));
+                    for(int i=0;i<M2;++i) for(int j=0;j<N2;++j) {
+                        T ui = T(std::sin(0.1*(q+1)*i + q));
+                        T vj = T(std::cos(0.07*(q+2)*j + 0.3*q));
+                        T wi = T(std::cos(0.13*(q+1)*i));
+                        m2(i,j) += sq * ui * vj;
+                        c2(i,j) += sq * CT(ui,wi) * vj;
+                    }
+                }
+                T eps2 = EPS * T(N2);
+
+                tmv::Matrix<T> U2(M2,k);
+                tmv::DiagMatrix<T> S2(k);
+                tmv::Matrix<T> Vt2(k,N2);
+                RandomSV_Decompose(m2,U2,S2,Vt2);
+                tmv::DiagMatrix<T> S3(N2);
+                tmv::Matrix<T,stor> m3 = m2;
+                SV_Decompose(m3,S3,false);
+                Assert(Equal(S2,S3.subDiagMatrix(0,k),eps2*Norm(S3)),
+                       "Random SV S"); 
+                Assert(Equal(U2.transpose()*U2,T(1),eps2),"Random SV - UtU"); 
+                Assert(Equal(Vt2*Vt2.transpose(),T(1),eps2),"Random SV - VtV"); 
+                Assert(Norm(m2-U2*S2*Vt2) <= T(2)*S3(k)*T(N2),
+                       "Random SV - USVt"); 
+                tmv::Matrix<T> Vt3(k,M2);
+                tmv::Matrix<T> U3(N2,k);
+                RandomSV_Decompose(m2.transpose(),U3,S2,Vt3);
+                Assert(Equal(S2,S3.subDiagMatrix(0,k),eps2*Norm(S3)),
+                       "Random SV transpose S"); 
+
+                // x = b/m using the low rank approximation should match
+                // the full SVD truncated to the same rank.
+                tmv::Vector<T> b(M2);
+                for(int i=0;i<M2;++i) b(i) = T(3+i%7);
+                m3 = m2;
+                m3.svd().top(k);
+                tmv::Vector<T> x1 = b/m3;
+                m2.rsvd(k);
+                tmv::Vector<T> x2 = b/m2;
+                Assert(Equal(x1,x2,eps2*Norm(x1)*S3(0)/S3(k-1)),
+                       "Random SV x = b/m"); 
+
+                tmv::Matrix<CT> cU2(M2,k);
+                tmv::DiagMatrix<T> cS2(k);
+                tmv::Matrix<CT> cVt2(k,N2);
+                RandomSV_Decompose(c2,cU2,cS2,cVt2);
+                tmv::DiagMatrix<T> cS3(N2);
+                tmv::Matrix<CT,stor> c3 = c2;
+                SV_Decompose(c3,cS3,false);
+                Assert(Equal(cS2,cS3.subDiagMatrix(0,k),eps2*Norm(cS3)),
+                       "Random C SV S"); 
+                Assert(Equal(cU2.adjoint()*cU2,T(1),eps2),
+                       "Random C SV - UtU"); 
+                Assert(Equal(cVt2*cVt2.adjoint(),T(1),eps2),
+                       "Random C SV - VtV"); 
+                tmv::Vector<CT> cb(M2);
+                for(int i=0;i<M2;++i) cb(i) = CT(T(3+i%7),T(i%3));
+                c3 = c2;
+                c3.svd().top(k);
+                tmv::Vector<CT> cx1 = cb/c3;
+                c2.rsvd(k);
+                tmv::Vector<CT> cx2 = cb/c2;
+                Assert(Equal(cx1,cx2,eps2*Norm(cx1)*cS3(0)/cS3(k-1)),
+                       "Random C SV x = b/m"); 
+            }
+
+            if (mattype == 0) {
+                // Schur decomposition and eigenvalues of general matrices.
+                // N = 200 is large enough to use the multishift algorithm,
+                // and the 20x20 corner uses the double-shift algorithm.
+                if (showstartdone) std::cout<<"Schur"<<std::endl;
+                T eps2 = EPS * T(N);
+                for(int n=20;n<=N;n+=N-20) {
+                    tmv::Matrix<T,stor> m2 = m.subMatrix(0,n,0,n);
+                    tmv::Matrix<CT,stor> c2 = c.subMatrix(0,n,0,n);
+                    T normm2 = Norm(m2);
+                    T normc2 = Norm(c2);
+
+                    tmv::Matrix<T,stor> mT = m2;
+                    tmv::Matrix<T> Z(n,n);
+                    tmv::Vector<CT> lam(n);
+                    Schur_Decompose(mT,Z,lam);
+                    Assert(Equal(m2,Z*mT*Z.transpose(),eps2*normm2),"Schur"); 
+                    Assert(Equal(Z.transpose()*Z,T(1),eps2),"Schur - ZtZ"); 
+                    bool isquasitri = true;
+                    for(int j=0;j<n;++j) for(int i=j+2;i<n;++i) 
+                        if (mT(i,j) != T(0)) isquasitri = false;
+                    for(int j=0;j<n-2;++j) 
+                        if (mT(j+1,j) != T(0) && mT(j+2,j+1) != T(0))
+                            isquasitri = false;
+                    Assert(isquasitri,"Schur - T is quasi-triangular"); 
+                    Assert(Equal2(lam.sumElements(),CT(m2.trace()),
+                                  eps2*normm2),"Schur - trace"); 
+
+                    tmv::Matrix<T,stor> mT2 = m2;
+                    tmv::Matrix<T> Z2(n,n);
+                    tmv::Vector<CT> lam2(n);
+                    Schur_Decompose(mT2,Z2,lam2,false);
+                    Assert(Equal(m2,Z2*mT2*Z2.transpose(),eps2*normm2),
+                           "Schur double shift"); 
+                    Assert(Equal2(lam2.sumElements(),lam.sumElements(),
+                                  eps2*normm2),"Schur double shift - trace"); 
+
+                    tmv::Matrix<CT> V(n,n);
+                    Eigen(m2,V,lam);
+                    Assert(Equal(tmv::Matrix<CT>(m2)*V,
+                                 V*tmv::DiagMatrixViewOf(lam),eps2*normm2),
+                           "Eigen"); 
+                    Eigen(m2,lam2);
+                    Assert(Equal2(lam2.sumElements(),lam.sumElements(),
+                                  eps2*normm2),"Eigen values only"); 
+
+                    tmv::Matrix<CT,stor> cT = c2;
+                    tmv::Matrix<CT> cZ(n,n);
+                    Schur_Decompose(cT,cZ,lam);
+                    Assert(Equal(c2,cZ*cT*cZ.adjoint(),eps2*normc2),
+                           "C Schur"); 
+                    Assert(Equal(cZ.adjoint()*cZ,T(1),eps2),"C Schur - ZtZ"); 
+                    Assert(Norm(cT.lowerTri().offDiag()) == T(0),
+                           "C Schur - T is triangular"); 
+                    Assert(Equal(lam,cT.diag(),T(0)),"C Schur - lambda"); 
+                    Eigen(c2,V,lam);
+                    Assert(Equal(c2*V,V*tmv::DiagMatrixViewOf(lam),eps2*normc2),
+                           "C Eigen"); 
+                }
+            }
             std::cout<<"."; std::cout.flush();
         } while (false);
     }
 }
 
+template <class T> 
+void TestOpenMPDecomp()
+{
+    // The OpenMP versions of the decompositions are only used for matrices
+    // above some threshold size, and only if there is more than one thread
+    // available.  So use matrices that are large enough, and make sure
+    // we have a few threads here, even on a single core machine.
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+    if (nthreads < 3) omp_set_num_threads(3);
+#endif
+    typedef std::complex<T> CT;
+
+    // LU: min(M,N) > 2*LU_BLOCKSIZE
+    do {
+        if (showstartdone) {
+            std::cout<<"OpenMP LU"<<std::endl;
+        }
+        const int N = 300;
+        tmv::Matrix<T> m(N,N);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            m(i,j) = T(2+4*i-5*j)/T(10*N);
+        m.diag().addToAll(T(3));
+        m(3,4) = T(-2*N);
+        tmv::Matrix<CT> c(N,N);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            c(i,j) = CT(T(2+4*i-5*j),T(3-i))/T(10*N);
+        c.diag().addToAll(CT(3,1));
+        c(3,4) = CT(T(-2*N),T(N));
+        const T eps = EPS * T(N);
+        const T normm = Norm(m);
+        const T normc = Norm(c);
+
+        tmv::Matrix<T> m2 = m;
+        tmv::Permutation P(N);
+        LU_Decompose(m2,P);
+        tmv::Matrix<T> PLU = P*m2.unitLowerTri()*m2.upperTri();
+        if (showacc) {
+            std::cout<<"Norm(m-PLU) = "<<Norm(m-PLU)<<std::endl;
+            std::cout<<"cf "<<eps*normm<<std::endl;
+        }
+        Assert(Equal(m,PLU,eps*normm),"OpenMP LU"); 
+
+        tmv::Matrix<CT> c2 = c;
+        tmv::Permutation cP(N);
+        LU_Decompose(c2,cP);
+        tmv::Matrix<CT> cPLU = cP*c2.unitLowerTri()*c2.upperTri();
+        if (showacc) {
+            std::cout<<"Norm(c-PLU) = "<<Norm(c-cPLU)<<std::endl;
+            std::cout<<"cf "<<eps*normc<<std::endl;
+        }
+        Assert(Equal(c,cPLU,eps*normc),"C OpenMP LU"); 
+        std::cout<<"."; std::cout.flush();
+    } while (false);
+
+    // QR: TSQR for tall matrices (M >= 4N), and the lookahead blocked
+    // algorithm for N > 2*QR_BLOCKSIZE.
+    do {
+        if (showstartdone) {
+            std::cout<<"OpenMP QR"<<std::endl;
+        }
+        const int Ms[2] = { 2000, 300 };
+        const int Ns[2] = { 40, 300 };
+        for(int k=0;k<2;++k) {
+            const int M = Ms[k];
+            const int N = Ns[k];
+            tmv::Matrix<T> m(M,N);
+            for(int i=0;i<M;++i) for(int j=0;j<N;++j) 
+                m(i,j) = T(2+4*i-5*j)/T(10*M);
+            m.diag().addToAll(T(3));
+            m(3,4) = T(-2*N);
+            tmv::Matrix<CT> c(M,N);
+            for(int i=0;i<M;++i) for(int j=0;j<N;++j) 
+                c(i,j) = CT(T(2+4*i-5*j),T(3-i))/T(10*M);
+            c.diag().addToAll(CT(3,1));
+            c(3,4) = CT(T(-2*N),T(N));
+            const T eps = EPS * T(M);
+            const T normm = Norm(m);
+            const T normc = Norm(c);
+
+            tmv::Matrix<T> Q = m;
+            tmv::UpperTriMatrix<T> R(N);
+            QR_Decompose(Q,R);
+            tmv::Matrix<T> QR = Q*R;
+            if (showacc) {
+                std::cout<<"Norm(m-QR) = "<<Norm(m-QR)<<std::endl;
+                std::cout<<"cf "<<eps*normm<<std::endl;
+            }
+            Assert(Equal(m,QR,eps*normm),"OpenMP QR"); 
+            Assert(Equal(Q.transpose()*Q,T(1),eps),"OpenMP QR - QtQ"); 
+
+            tmv::Matrix<CT> cQ = c;
+            tmv::UpperTriMatrix<CT> cR(N);
+            QR_Decompose(cQ,cR);
+            tmv::Matrix<CT> cQR = cQ*cR;
+            if (showacc) {
+                std::cout<<"Norm(c-QR) = "<<Norm(c-cQR)<<std::endl;
+                std::cout<<"cf "<<eps*normc<<std::endl;
+            }
+            Assert(Equal(c,cQR,eps*normc),"C OpenMP QR"); 
+            Assert(Equal(cQ.adjoint()*cQ,T(1),eps),"C OpenMP QR - QtQ"); 
+        }
+        std::cout<<"."; std::cout.flush();
+    } while (false);
+
+    // SV: N > DC_TASK_LIMIT uses OpenMP tasks in the divide and conquer 
+    // bidiagonal solver when U or V is wanted.
+    do {
+        if (showstartdone) {
+            std::cout<<"OpenMP SV"<<std::endl;
+        }
+        const int N = 300;
+        tmv::Matrix<T> m(N,N);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            m(i,j) = T(2+4*i-5*j)/T(10*N);
+        for(int i=0;i<N;++i) m(i,i) += T(i+1);
+        tmv::Matrix<CT> c(N,N);
+        for(int i=0;i<N;++i) for(int j=0;j<N;++j) 
+            c(i,j) = CT(T(2+4*i-5*j),T(3-i))/T(10*N);
+        for(int i=0;i<N;++i) c(i,i) += T(N-i);
+        const T eps = EPS * T(N);
+        const T normm = Norm(m);
+        const T normc = Norm(c);
+
+        tmv::Matrix<T> U = m;
+        tmv::DiagMatrix<T> S(N);
+        tmv::Matrix<T> Vt(N,N);
+        SV_Decompose(U,S,Vt);
+        if (showacc) {
+            std::cout<<"Norm(m-USVt) = "<<Norm(m-U*S*Vt)<<std::endl;
+            std::cout<<"cf "<<eps*normm<<std::endl;
+        }
+        Assert(Equal(m,U*S*Vt,eps*normm),"OpenMP SV"); 
+        Assert(Equal(U.transpose()*U,T(1),eps),"OpenMP SV - UtU"); 
+        Assert(Equal(Vt*Vt.transpose(),T(1),eps),"OpenMP SV - VtV"); 
+
+        tmv::Matrix<CT> cU = c;
+        tmv::DiagMatrix<T> cS(N);
+        tmv::Matrix<CT> cVt(N,N);
+        SV_Decompose(cU,cS,cVt);
+        if (showacc) {
+            std::cout<<"Norm(c-USVt) = "<<Norm(c-cU*cS*cVt)<<std::endl;
+            std::cout<<"cf "<<eps*normc<<std::endl;
+        }
+        Assert(Equal(c,cU*cS*cVt,eps*normc),"C OpenMP SV"); 
+        Assert(Equal(cU.adjoint()*cU,T(1),eps),"C OpenMP SV - UtU"); 
+        Assert(Equal(cVt*cVt.adjoint(),T(1),eps),"C OpenMP SV - VtV"); 
+        std::cout<<"."; std::cout.flush();
+    } while (false);
+
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+}
+
 #ifdef TEST_DOUBLE
 template void TestMatrixDecomp<double,tmv::RowMajor>();
 template void TestMatrixDecomp<double,tmv::ColMajor>();
+template void TestOpenMPDecomp<double>();
 #endif
 #ifdef TEST_FLOAT
 template void TestMatrixDecomp<float,tmv::RowMajor>();
 template void TestMatrixDecomp<float,tmv::ColMajor>();
+template void TestOpenMPDecomp<float>();
 #endif
 #ifdef TEST_LONGDOUBLE
 template void TestMatrixDecomp<long double,tmv::RowMajor>();
 template void TestMatrixDecomp<long double,tmv::ColMajor>();
+template void TestOpenMPDecomp<long double>();
 #endif
@@ -922,21 +922,150 @@ static void TestSingularDiv(tmv::DivType dt)
     }
 }
 
+template <class T> 
+static void TestConcurrentDiv(tmv::DivType dt)
+{
+    // Several threads dividing by the same matrix at once should all 
+    // share a single decomposition if it is saved, or each use their
+    // own if it is not.
+    const int N = 60;
+    const int K = 64;
+    tmv::Matrix<T> m(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) m(i,j) = T(2+4*i-5*j)/T(N);
+    m.diag().addToAll(T(2*N));
+    tmv::Matrix<T> b(N,K);
+    for(int i=0;i<N;++i) for(int k=0;k<K;++k) b(i,k) = T(1+i-3*k);
+    tmv::Matrix<T> x1(N,K);
+    tmv::Matrix<T> x2(N,K);
+
+    m.divideUsing(dt);
+    m.saveDiv();
+    Assert(!m.divIsSet(),"Concurrent div not set before use");
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int k=0;k<K;++k) x1.col(k) = b.col(k)/m;
+    Assert(m.divIsSet(),"Concurrent div set after use");
+
+    tmv::Matrix<T> m2 = m;
+    m2.divideUsing(dt);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int k=0;k<K;++k) x2.col(k) = b.col(k)/m2;
+    Assert(!m2.divIsSet(),"Concurrent unsaved div not set after use");
+
+    T eps = EPS * Norm(m) * Norm(m.inverse());
+    Assert(Norm(m*x1-b) <= eps*Norm(b),"Concurrent div");
+    Assert(Norm(m*x2-b) <= eps*Norm(b),"Concurrent unsaved div");
+
+    if (dt == tmv::LU) {
+        // Without divideUsing, the threads also need to agree on the 
+        // default DivType, which is LU for a square matrix.
+        tmv::Matrix<T> m3 = m;
+        tmv::Matrix<T> x3(N,K);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(int k=0;k<K;++k) x3.col(k) = b.col(k)/m3;
+        Assert(!m3.divIsSet(),"Concurrent default div not set after use");
+        Assert(m3.getDivType() == tmv::LU,"Concurrent default div type");
+        Assert(Norm(m*x3-b) <= eps*Norm(b),"Concurrent default div");
+
+        tmv::Matrix<T> m4 = m;
+        m4.saveDiv();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(int k=0;k<K;++k) x3.col(k) = b.col(k)/m4;
+        Assert(m4.divIsSet(),"Concurrent default saved div set after use");
+        Assert(m4.getDivType() == tmv::LU,
+               "Concurrent default saved div type");
+        Assert(Norm(m*x3-b) <= eps*Norm(b),"Concurrent default saved div");
+    }
+    std::cout<<"Concurrent Matrix<"<<tmv::TMV_Text(T())<<"> Division using ";
+    std::cout<<tmv::TMV_Text(dt)<<" passed all tests\n";
+}
+
+template <class T> 
+static void TestMixedDiv()
+{
+    // LUMixed should give full precision answers for a well-conditioned
+    // matrix without needing the full precision decomposition.
+    const int N = 100;
+    const int K = 3;
+    tmv::Matrix<T> m(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) m(i,j) = T(2+4*i-5*j)/T(N);
+    m.diag().addToAll(T(N)/T(3));
+    tmv::Matrix<T> b(N,K);
+    for(int i=0;i<N;++i) for(int k=0;k<K;++k) b(i,k) = T(1+i-3*k);
+
+    m.divideUsing(tmv::LUMixed);
+    m.saveDiv();
+    m.setDiv();
+    std::ostream* dbgout = showdiv ? &std::cout : 0;
+    Assert(m.checkDecomp(dbgout),"LUMixed checkDecomp");
+
+    T eps = EPS * Norm(m) * Norm(m.inverse());
+    tmv::Matrix<T> x = b/m;
+    if (showacc) {
+        std::cout<<"Norm(m*x-b) = "<<Norm(m*x-b)<<std::endl;
+        std::cout<<"eps*Norm(b) = "<<eps*Norm(b)<<std::endl;
+        std::cout<<"numIter = "<<m.lumd().getNumIter()<<std::endl;
+    }
+    Assert(Norm(m*x-b) <= eps*Norm(b),"LUMixed b/m");
+    tmv::Matrix<T> y = b.transpose()%m;
+    Assert(Norm(y*m-b.transpose()) <= eps*Norm(b),"LUMixed b%m");
+    tmv::Matrix<std::complex<T> > cb = std::complex<T>(1,2) * b;
+    tmv::Matrix<std::complex<T> > cx = cb/m;
+    Assert(Norm(m*cx-cb) <= eps*Norm(cb),"LUMixed complex b/m");
+    Assert(!m.lumd().usedFallback(),"LUMixed no fallback");
+    Assert(m.lumd().getNumIter() > 0,"LUMixed numIter");
+
+    tmv::Matrix<T> m2 = m;
+    m2.divideUsing(tmv::LU);
+    Assert(Norm(x-b/m2) <= eps*Norm(x),"LUMixed vs LU");
+
+    // For an ill-conditioned matrix, refinement fails, and it falls 
+    // back to the full precision decomposition.
+    const int N2 = 8;
+    tmv::Matrix<T> h(N2,N2);
+    for(int i=0;i<N2;++i) for(int j=0;j<N2;++j) h(i,j) = T(1)/T(i+j+1);
+    tmv::Vector<T> hb(N2);
+    for(int i=0;i<N2;++i) hb(i) = T(i+1);
+    h.divideUsing(tmv::LUMixed);
+    h.saveDiv();
+    T heps = EPS * Norm(h) * Norm(h.inverse());
+    tmv::Vector<T> hx = hb/h;
+    Assert(Norm(h*hx-hb) <= heps*Norm(hb),"LUMixed ill-conditioned b/m");
+    if (std::numeric_limits<T>::digits == std::numeric_limits<double>::digits)
+        Assert(h.lumd().usedFallback(),"LUMixed fallback");
+
+    std::cout<<"Mixed precision Matrix<"<<tmv::TMV_Text(T())<<"> Division ";
+    std::cout<<"passed all tests\n";
+}
+
 template <class T> void TestMatrixDiv()
 {
     TestMatrixDecomp<T,tmv::ColMajor>();
     TestMatrixDecomp<T,tmv::RowMajor>();
+    TestOpenMPDecomp<T>();
     std::cout<<"Matrix<"<<tmv::TMV_Text(T())<<"> passed all ";
     std::cout<<"decomposition tests.\n";
     TestSquareDiv<T,tmv::ColMajor>(tmv::LU);
     TestSquareDiv<T,tmv::ColMajor>(tmv::QR);
     TestSquareDiv<T,tmv::ColMajor>(tmv::QRP);
     TestSquareDiv<T,tmv::ColMajor>(tmv::SV);
+    TestSquareDiv<T,tmv::ColMajor>(tmv::LUMixed);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::QR);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::QRP);
     TestNonSquareDiv<T,tmv::ColMajor>(tmv::SV);
     TestSingularDiv<T,tmv::ColMajor>(tmv::QRP);
     TestSingularDiv<T,tmv::ColMajor>(tmv::SV);
+    TestConcurrentDiv<T>(tmv::LU);
+    TestConcurrentDiv<T>(tmv::QR);
+    TestConcurrentDiv<T>(tmv::LUMixed);
+    TestMixedDiv<T>();
 }
 
 #ifdef TEST_DOUBLE
@@ -161,6 +161,123 @@ static void TestSmallSquareDiv()
     Assert(Norm(cvtemp=b3-e) < ceps*Norm(e),"Square e%c");
 }
 
+template <class T, tmv::StorageType stor, int N> 
+static void TestSmallSquareDivUsing()
+{
+    tmv::SmallMatrix<T,N,N,stor> m;
+
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) m(i,j) = T(2+4*i-5*j);
+    m.diag() *= T(11);
+    m /= T(7);
+    if (N > 1) m(1,0) = -2;
+    if (N > 2) m(2,0) = 7;
+    if (N > 3) m(3,0) = -10;
+    if (N > 2) m(2,2) = 30;
+
+    tmv::SmallMatrix<T,N,N,stor> h = m.transpose() * m;
+    h.diag().addToAll(T(1));
+
+    tmv::SmallVector<T,N> b(T(7));
+    b(0) = 2;
+    if (N > 1) b(1) = -10;
+    if (N > 2) b(2) = 5;
+    if (N > 3) b(3) = -5;
+
+    if (showstartdone) {
+        std::cout<<"Start TestSmallSquareDivUsing\n";
+        std::cout<<"m = "<<TMV_Text(m)<<" "<<m<<std::endl;
+        std::cout<<"h = "<<TMV_Text(h)<<" "<<h<<std::endl;
+    }
+
+    tmv::SmallVector<T,N> vtemp;
+    tmv::SmallMatrix<T,N,N> mtemp;
+
+    // CH
+    tmv::SmallMatrix<T,N,N> hinv;
+    h.makeInverse(hinv,tmv::CH);
+    T eps = EPS * Norm(h) * Norm(hinv);
+    Assert(Norm(mtemp=h*hinv-T(1)) < eps,"Square CH Inverse");
+    tmv::SmallVector<T,N> x = b;
+    h.LDivEq(x,tmv::CH);
+    Assert(Norm(vtemp=h*x-b) < eps*Norm(b),"Square CH b/h");
+    x = b;
+    h.RDivEq(x,tmv::CH);
+    Assert(Norm(vtemp=x*h-b) < eps*Norm(b),"Square CH b%h");
+    tmv::SmallMatrix<T,N,N> hh = h;
+    hh.upperTri().offDiag().setZero();
+    x = b;
+    hh.LDivEq(x,tmv::CH);
+    Assert(Norm(vtemp=h*x-b) < eps*Norm(b),"Square CH uses lower triangle");
+    // The default for / is still LU.
+    tmv::SmallMatrix<T,N,N> hhinv = hh.inverse();
+    T heps = EPS * Norm(hh) * Norm(hhinv);
+    x = b/hh;
+    Assert(Norm(vtemp=hh*x-b) < heps*Norm(b),"Square LU after CH");
+
+#ifndef NOTHROW
+    // A matrix that is not positive definite throws NonPosDef.
+    tmv::SmallMatrix<T,N,N> hneg = -h;
+    bool threw = false;
+    try {
+        x = b;
+        hneg.LDivEq(x,tmv::CH);
+    } catch (tmv::NonPosDef&) {
+        threw = true;
+    }
+    Assert(threw,"Square CH of non-posdef matrix throws NonPosDef");
+#endif
+
+    // QR
+    tmv::SmallMatrix<T,N,N> minv;
+    m.makeInverse(minv,tmv::QR);
+    eps = EPS * Norm(m) * Norm(minv);
+    Assert(Norm(mtemp=m*minv-T(1)) < eps,"Square QR Inverse");
+    x = b;
+    m.LDivEq(x,tmv::QR);
+    Assert(Norm(vtemp=m*x-b) < eps*Norm(b),"Square QR b/m");
+    x = b;
+    m.RDivEq(x,tmv::QR);
+    Assert(Norm(vtemp=x*m-b) < eps*Norm(b),"Square QR b%m");
+
+    // Complex
+    tmv::SmallMatrix<std::complex<T>,N,N,stor> c = m;
+    if (N > 1) c(1,0) *= std::complex<T>(0,2);
+    if (N > 1) c.col(1) *= std::complex<T>(-1,3);
+    tmv::SmallMatrix<std::complex<T>,N,N,stor> ch = c.adjoint() * c;
+    ch.diag().addToAll(T(1));
+    tmv::SmallVector<std::complex<T>,N> e;
+    e = b*std::complex<T>(1,2);
+    if (N > 1) e(1) += std::complex<T>(-1,5);
+    tmv::SmallVector<std::complex<T>,N> y;
+    tmv::SmallVector<std::complex<T>,N> cvtemp;
+    tmv::SmallMatrix<std::complex<T>,N,N> ctemp;
+
+    tmv::SmallMatrix<std::complex<T>,N,N> chinv;
+    ch.makeInverse(chinv,tmv::CH);
+    T ceps = EPS * Norm(ch) * Norm(chinv);
+    Assert(Norm(ctemp=ch*chinv-T(1)) < ceps,"Square CH CInverse");
+    y = e;
+    ch.LDivEq(y,tmv::CH);
+    Assert(Norm(cvtemp=ch*y-e) < ceps*Norm(e),"Square CH e/ch");
+    y = e;
+    ch.RDivEq(y,tmv::CH);
+    Assert(Norm(cvtemp=y*ch-e) < ceps*Norm(e),"Square CH e%ch");
+    y = b;
+    ch.LDivEq(y,tmv::CH);
+    Assert(Norm(cvtemp=ch*y-b) < ceps*Norm(b),"Square CH b/ch");
+
+    tmv::SmallMatrix<std::complex<T>,N,N> cinv;
+    c.makeInverse(cinv,tmv::QR);
+    ceps = EPS * Norm(c) * Norm(cinv);
+    Assert(Norm(ctemp=c*cinv-T(1)) < ceps,"Square QR CInverse");
+    y = e;
+    c.LDivEq(y,tmv::QR);
+    Assert(Norm(cvtemp=c*y-e) < ceps*Norm(e),"Square QR e/c");
+    y = e;
+    c.RDivEq(y,tmv::QR);
+    Assert(Norm(cvtemp=y*c-e) < ceps*Norm(e),"Square QR e%c");
+}
+
 template <class T, tmv::StorageType stor, int N> 
 static void TestSmallNonSquareDiv()
 {
@@ -283,6 +400,8 @@ void TestAllSmallMatrixDiv()
     TestSmallSquareDiv<T,tmv::ColMajor,5>();
     TestSmallNonSquareDiv<T,tmv::ColMajor,2>();
     TestSmallNonSquareDiv<T,tmv::ColMajor,5>();
+    TestSmallSquareDivUsing<T,tmv::ColMajor,4>();
+    TestSmallSquareDivUsing<T,tmv::RowMajor,8>();
 
 #if (XTEST & 2)
     TestSmallSquareDiv<T,tmv::ColMajor,1>();
@@ -290,6 +290,61 @@ void TestSymBandDiv(tmv::DivType dt, PosDefCode pdc)
     std::cout<<tmv::TMV_Text(dt)<<" passed all tests\n";
 }
 
+template <class T, tmv::UpLoType uplo, tmv::StorageType stor> 
+static void TestWideHermBandCH()
+{
+    // nlo is large enough here to use the blocked Cholesky algorithm.
+    typedef std::complex<T> CT;
+    const int N = 300;
+    const int nlo = 100;
+
+    tmv::HermBandMatrix<T,uplo|stor> m(N,nlo);
+    tmv::HermBandMatrix<CT,uplo|stor> c(N,nlo);
+    for(int i=0;i<N;++i) for(int j=i-nlo;j<=i;++j) if (j >= 0) {
+        m(i,j) = T(2.5+4*i-5*j+(i*j)%7) / T(10*N);
+        c(i,j) = i==j ? CT(m(i,j)) : CT(2.5+4*i-5*j+(i*j)%7,3-i+j) / T(10*N);
+    }
+    m.diag().addToAll(T(2*nlo));
+    c.diag().addToAll(T(2*nlo));
+    m.diag(0,N/4,N/2) *= T(10);
+    c.diag(0,N/4,N/2) *= T(10);
+
+    tmv::Vector<T> b(N);
+    for(int i=0;i<N;++i) b(i) = T(16-3*i);
+    tmv::Vector<CT> cb = b * CT(1,2);
+
+    T eps = EPS * Norm(m) * Norm(m.inverse());
+    T ceps = EPS * Norm(c) * Norm(c.inverse());
+
+    m.divideUsing(tmv::CH);
+    m.saveDiv();
+    m.setDiv();
+    Assert(m.chd().checkDecomp(m,0),"Wide HermBand CH decomp");
+    tmv::BandMatrix<T> L = m.chd().getL();
+    Assert(Norm(L*L.adjoint()-m) <= eps*Norm(m),"Wide HermBand CH L L^T");
+    tmv::Vector<T> x = b/m;
+    tmv::Vector<T> x0 = b/tmv::Matrix<T>(m);
+    Assert(Norm(x-x0) <= eps*Norm(x0),"Wide HermBand CH b/m");
+
+    c.divideUsing(tmv::CH);
+    c.saveDiv();
+    c.setDiv();
+    Assert(c.chd().checkDecomp(c,0),"Wide HermBand CH complex decomp");
+    tmv::BandMatrix<CT> cL = c.chd().getL();
+    Assert(Norm(cL*cL.adjoint()-c) <= ceps*Norm(c),
+           "Wide HermBand CH complex L L^H");
+    tmv::Vector<CT> cx = cb/c;
+    tmv::Vector<CT> cx0 = cb/tmv::Matrix<CT>(c);
+    Assert(Norm(cx-cx0) <= ceps*Norm(cx0),"Wide HermBand CH complex b/c");
+
+#ifndef NOTHROW
+    // A matrix that fails partway through one of the blocks.
+    m.unsetDiv();
+    m(N/2+5,N/2+5) = T(-1);
+    Assert(!IsPosDef(m),"Wide HermBand CH NonPosDef");
+#endif
+}
+
 template <class T> 
 void TestAllSymBandDiv()
 {
@@ -301,6 +356,9 @@ void TestAllSymBandDiv()
     TestSymBandDecomp<T,tmv::Upper,tmv::RowMajor>();
     TestSymBandDecomp<T,tmv::Lower,tmv::ColMajor>();
     TestSymBandDecomp<T,tmv::Lower,tmv::RowMajor>();
+    TestWideHermBandCH<T,tmv::Upper,tmv::ColMajor>();
+    TestWideHermBandCH<T,tmv::Lower,tmv::ColMajor>();
+    TestWideHermBandCH<T,tmv::Lower,tmv::RowMajor>();
     std::cout<<"SymBandMatrix<"<<tmv::TMV_Text(T())<<"> passed all ";
     std::cout<<"decomposition tests.\n";
     TestSymBandDiv<T>(tmv::CH,PosDef);
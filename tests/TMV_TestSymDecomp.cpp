@@ -9,6 +9,10 @@
 #include "TMV_Test_2.h"
 #include "TMV_TestSymArith.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifdef TMV_MEM_DEBUG
 // See the discussion of this in TMV_TestTri.cpp.  But basically, there seems to be something
 // in the std library exception class that doesn't interact well with the mmgr-style memory
@@ -16,6 +20,20 @@
 #define NOTHROW
 #endif
 
+// A simple preconditioner for the iterative eigensolvers
+template <class T>
+class JacobiPrec : public tmv::SymOperator<T>
+{
+public :
+    JacobiPrec(const tmv::GenVector<T>& _d) : d(_d) {}
+    using tmv::SymOperator<T>::mult;
+    ptrdiff_t size() const { return d.size(); }
+    void mult(const tmv::GenVector<T>& x, tmv::VectorView<T> y) const
+    { for(ptrdiff_t i=0;i<d.size();++i) y(i) = x(i)/d(i); }
+private :
+    tmv::Vector<T> d;
+};
+
 template <class T, tmv::UpLoType uplo, tmv::StorageType stor> 
 void TestHermDecomp()
 {
@@ -402,6 +420,116 @@ void TestHermDecomp()
             std::cout<<"."; std::cout.flush();
         }
 
+        // Eigen for matrices large enough to use the two-stage 
+        // reduction to tridiagonal form.
+        if (mattype == 0) {
+            if (showstartdone) std::cout<<"Large Eigen"<<std::endl;
+            const int N2 = 600;
+            tmv::HermMatrix<T,uplo|stor> m2(N2);
+            tmv::HermMatrix<CT,uplo|stor> c2(N2);
+            for(int i=0;i<N2;++i) for(int j=0;j<i;++j) {
+                m2(i,j) = T(2+4*i-5*j)/T(N2);
+                c2(i,j) = CT(2+4*i-5*j,3-i)/T(N2);
+            }
+            for(int i=0;i<N2;++i) {
+                m2(i,i) = T(i%7);
+                c2(i,i) = T(i%5);
+            }
+            T eps2 = EPS * T(N2);
+            T normm2 = Norm(m2);
+            T normc2 = Norm(c2);
+            tmv::Matrix<T> I2(N2,N2);
+            I2.setToIdentity();
+
+            tmv::Matrix<T> V2(N2,N2);
+            tmv::Vector<T> L2(N2);
+            Eigen(m2,V2,L2);
+            Assert(Equal(m2*V2,V2*DiagMatrixViewOf(L2),eps2*normm2),
+                   "Large Herm Eigen");
+            Assert(Equal(V2.transpose()*V2,I2,eps2),"Large Herm Eigen V");
+            tmv::Vector<T> L3(N2);
+            Eigen(m2,L3);
+            Assert(Equal(L3,L2,eps2*normm2),"Large Herm Eigen2");
+
+            tmv::Matrix<CT> cV2(N2,N2);
+            tmv::Vector<T> cL2(N2);
+            Eigen(c2,cV2,cL2);
+            Assert(Equal(c2*cV2,cV2*DiagMatrixViewOf(cL2),eps2*normc2),
+                   "Large Herm C Eigen");
+            Assert(Equal(cV2.adjoint()*cV2,I2,eps2),"Large Herm C Eigen V");
+            tmv::Vector<T> cL3(N2);
+            Eigen(c2,cL3);
+            Assert(Equal(cL3,cL2,eps2*normc2),"Large Herm C Eigen2");
+            std::cout<<"."; std::cout.flush();
+        }
+
+        // Iterative solvers for a few extremal eigenvalues.
+        if (mattype == 0) {
+            if (showstartdone) std::cout<<"Iterative Eigen"<<std::endl;
+            const int k = 5;
+            T eps2 = T(10) * std::sqrt(EPS) * normm;
+            T ceps2 = T(10) * std::sqrt(EPS) * normc;
+            tmv::Vector<T> L(N);
+            Eigen(m,L);
+            tmv::Vector<T> cL(N);
+            Eigen(c,cL);
+
+            tmv::Matrix<T> V(N,k);
+            tmv::Vector<T> Lk(k);
+            LanczosEigen(m,V.view(),Lk.view());
+            Assert(Equal(Lk,L.subVector(0,k),eps*normm),"Herm Lanczos");
+            Assert(Equal(m*V,V*DiagMatrixViewOf(Lk),eps*normm),
+                   "Herm Lanczos V");
+            LanczosEigen(m,V.view(),Lk.view(),false);
+            Assert(Equal(Lk,L.subVector(N-k,N),eps*normm),
+                   "Herm Lanczos largest");
+            Assert(Equal(m*V,V*DiagMatrixViewOf(Lk),eps*normm),
+                   "Herm Lanczos largest V");
+
+            tmv::Matrix<CT> cV(N,k);
+            LanczosEigen(c,cV.view(),Lk.view());
+            Assert(Equal(Lk,cL.subVector(0,k),ceps*normc),"Herm C Lanczos");
+            Assert(Equal(c*cV,cV*DiagMatrixViewOf(Lk),ceps*normc),
+                   "Herm C Lanczos V");
+
+            V.setZero();
+            LOBPCGEigen(m,V.view(),Lk.view());
+            Assert(Equal(Lk,L.subVector(0,k),eps2),"Herm LOBPCG");
+            Assert(Equal(m*V,V*DiagMatrixViewOf(Lk),eps2),"Herm LOBPCG V");
+            V.setZero();
+            LOBPCGEigen(m,V.view(),Lk.view(),false);
+            Assert(Equal(Lk,L.subVector(N-k,N),eps2),"Herm LOBPCG largest");
+
+            // With a (Jacobi) preconditioner
+            tmv::SymMatrixOperator<T,tmv::GenSymMatrix<T> > op(m);
+            JacobiPrec<T> prec(m.diag());
+            V.setZero();
+            LOBPCGEigen(op,&prec,V.view(),Lk.view());
+            Assert(Equal(Lk,L.subVector(0,k),eps2),"Herm Prec LOBPCG");
+            Assert(Equal(m*V,V*DiagMatrixViewOf(Lk),eps2),
+                   "Herm Prec LOBPCG V");
+
+            cV.setZero();
+            LOBPCGEigen(c,cV.view(),Lk.view());
+            Assert(Equal(Lk,cL.subVector(0,k),ceps2),"Herm C LOBPCG");
+            Assert(Equal(c*cV,cV*DiagMatrixViewOf(Lk),ceps2),
+                   "Herm C LOBPCG V");
+
+            // A banded matrix only needs the band.
+            tmv::HermBandMatrix<T,uplo|stor> b(N,1);
+            for(int i=0;i<N;++i) b(i,i) = T(2+i%3);
+            for(int i=1;i<N;++i) b(i,i-1) = T(-1);
+            tmv::Vector<T> bL(N);
+            Eigen(tmv::HermMatrix<T>(b),bL);
+            T normb = Norm(b);
+            LanczosEigen(b,V.view(),Lk.view());
+            Assert(Equal(Lk,bL.subVector(0,k),eps*normb),
+                   "HermBand Lanczos");
+            Assert(Equal(b*V,V*DiagMatrixViewOf(Lk),eps*normb),
+                   "HermBand Lanczos V");
+            std::cout<<"."; std::cout.flush();
+        }
+
         // Square Root
 #ifdef NOTHROW
         if (posdef) {
@@ -993,6 +1121,131 @@ void TestPolar()
     }
 }
 
+template <class T> 
+void TestOpenMPHermDecomp()
+{
+    // The OpenMP versions of the decompositions are only used for matrices
+    // above some threshold size, and only if there is more than one thread
+    // available.  So use matrices that are large enough, and make sure
+    // we have a few threads here, even on a single core machine.
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+    if (nthreads < 3) omp_set_num_threads(3);
+#endif
+    typedef std::complex<T> CT;
+
+    const int N = 300;
+    tmv::HermMatrix<T,tmv::Lower|tmv::ColMajor> m(N);
+    for(int i=0;i<N;++i) for(int j=0;j<=i;++j) 
+        m(i,j) = T(2+4*i-5*j)/T(10*N);
+    m.diag().addToAll(T(N));
+    tmv::HermMatrix<CT,tmv::Lower|tmv::ColMajor> c(N);
+    for(int i=0;i<N;++i) for(int j=0;j<i;++j) 
+        c(i,j) = CT(T(2+4*i-5*j),T(3-i+j))/T(10*N);
+    for(int i=0;i<N;++i) c(i,i) = T(N);
+    const T eps = EPS * T(N);
+    const T normm = Norm(m);
+    const T normc = Norm(c);
+
+    // CH: N > 2*CH_BLOCKSIZE uses the tiled algorithm with OpenMP tasks.
+    do {
+        if (showstartdone) {
+            std::cout<<"OpenMP CH"<<std::endl;
+        }
+        tmv::HermMatrix<T,tmv::Lower|tmv::ColMajor> m2 = m;
+        CH_Decompose(m2);
+        tmv::LowerTriMatrix<T> L = m2.lowerTri();
+        tmv::Matrix<T> LLt = L*L.adjoint();
+        if (showacc) {
+            std::cout<<"Norm(m-LLt) = "<<Norm(m-LLt)<<std::endl;
+            std::cout<<"cf "<<eps*normm<<std::endl;
+        }
+        Assert(Equal(m,LLt,eps*normm),"OpenMP CH");
+
+        tmv::HermMatrix<T,tmv::Lower|tmv::RowMajor> m3 = m;
+        CH_Decompose(m3);
+        L = m3.lowerTri();
+        LLt = L*L.adjoint();
+        Assert(Equal(m,LLt,eps*normm),"OpenMP CH RowMajor");
+
+        tmv::HermMatrix<CT,tmv::Lower|tmv::ColMajor> c2 = c;
+        CH_Decompose(c2);
+        tmv::LowerTriMatrix<CT> cL = c2.lowerTri();
+        tmv::Matrix<CT> cLLt = cL*cL.adjoint();
+        if (showacc) {
+            std::cout<<"Norm(c-LLt) = "<<Norm(c-cLLt)<<std::endl;
+            std::cout<<"cf "<<eps*normc<<std::endl;
+        }
+        Assert(Equal(c,cLLt,eps*normc),"C OpenMP CH");
+
+#ifndef NOTHROW
+        // A matrix that is not positive definite needs to throw 
+        // NonPosDef from whichever task finds the problem.
+        m2 = m;
+        m2(200,200) = T(-1);
+        bool threw = false;
+        try {
+            CH_Decompose(m2);
+        } catch (tmv::NonPosDef&) {
+            threw = true;
+        }
+        Assert(threw,"OpenMP CH of non-posdef matrix throws NonPosDef");
+
+        c2 = c;
+        c2(20,20) = T(-1);
+        threw = false;
+        try {
+            CH_Decompose(c2);
+        } catch (tmv::NonPosDef&) {
+            threw = true;
+        }
+        Assert(threw,"C OpenMP CH of non-posdef matrix throws NonPosDef");
+#endif
+        std::cout<<"."; std::cout.flush();
+    } while (false);
+
+    // Eigen: N > DC_TASK_LIMIT uses OpenMP tasks in the divide and conquer
+    // tridiagonal solver.  Spread out the eigenvalues, so that most of 
+    // them are not deflated.
+    do {
+        if (showstartdone) {
+            std::cout<<"OpenMP Eigen"<<std::endl;
+        }
+        tmv::HermMatrix<T,tmv::Lower|tmv::ColMajor> e = m;
+        for(int i=0;i<N;++i) e(i,i) = T(i+1);
+        tmv::HermMatrix<CT,tmv::Lower|tmv::ColMajor> ce = c;
+        for(int i=0;i<N;++i) ce(i,i) = T(N-i);
+        const T norme = Norm(e);
+        const T normce = Norm(ce);
+
+        tmv::Matrix<T> V(N,N);
+        tmv::Vector<T> L(N);
+        Eigen(e,V,L);
+        if (showacc) {
+            std::cout<<"Norm(eV-VL) = "<<Norm(e*V-V*DiagMatrixViewOf(L));
+            std::cout<<"  cf "<<eps*norme<<std::endl;
+        }
+        Assert(Equal(e*V,V*DiagMatrixViewOf(L),eps*norme),"OpenMP Eigen");
+        Assert(Equal(V.transpose()*V,T(1),eps),"OpenMP Eigen - VtV");
+
+        tmv::Matrix<CT> cV(N,N);
+        tmv::Vector<T> cL(N);
+        Eigen(ce,cV,cL);
+        if (showacc) {
+            std::cout<<"Norm(cV-VL) = "<<Norm(ce*cV-cV*DiagMatrixViewOf(cL));
+            std::cout<<"  cf "<<eps*normce<<std::endl;
+        }
+        Assert(Equal(ce*cV,cV*DiagMatrixViewOf(cL),eps*normce),
+               "C OpenMP Eigen");
+        Assert(Equal(cV.adjoint()*cV,T(1),eps),"C OpenMP Eigen - VtV");
+        std::cout<<"."; std::cout.flush();
+    } while (false);
+
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+}
+
 #ifdef TEST_DOUBLE
 template void TestHermDecomp<double,tmv::Upper,tmv::ColMajor>();
 template void TestHermDecomp<double,tmv::Upper,tmv::RowMajor>();
@@ -1004,6 +1257,7 @@ template void TestSymDecomp<double,tmv::Lower,tmv::ColMajor>();
 template void TestSymDecomp<double,tmv::Lower,tmv::RowMajor>();
 template void TestPolar<double,tmv::ColMajor>();
 template void TestPolar<double,tmv::RowMajor>();
+template void TestOpenMPHermDecomp<double>();
 #endif
 #ifdef TEST_FLOAT
 template void TestHermDecomp<float,tmv::Upper,tmv::ColMajor>();
@@ -1016,6 +1270,7 @@ template void TestSymDecomp<float,tmv::Lower,tmv::ColMajor>();
 template void TestSymDecomp<float,tmv::Lower,tmv::RowMajor>();
 template void TestPolar<float,tmv::ColMajor>();
 template void TestPolar<float,tmv::RowMajor>();
+template void TestOpenMPHermDecomp<float>();
 #endif
 #ifdef TEST_LONGDOUBLE
 template void TestHermDecomp<long double,tmv::Upper,tmv::ColMajor>();
@@ -1028,6 +1283,7 @@ template void TestSymDecomp<long double,tmv::Lower,tmv::ColMajor>();
 template void TestSymDecomp<long double,tmv::Lower,tmv::RowMajor>();
 template void TestPolar<long double,tmv::ColMajor>();
 template void TestPolar<long double,tmv::RowMajor>();
+template void TestOpenMPHermDecomp<long double>();
 #endif
 
 
@@ -6,6 +6,11 @@
 #include "TMV_Test.h"
 #include "TMV_Test_2.h"
 #include "TMV_TestSymArith.h"
+#include <sstream>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef TMV_MEM_DEBUG
 // See the discussion of this in TMV_TestTri.cpp.  But basically, there seems to be something
@@ -329,6 +334,302 @@ void TestSymDiv(tmv::DivType dt, PosDefCode pdc)
     std::cout<<tmv::TMV_Text(dt)<<" passed all tests\n";
 }
 
+template <class T> 
+static void TestFactorization()
+{
+    typedef std::complex<T> CT;
+    const int N = 30;
+    const int K = 150;  // Enough right hand sides to be split among threads.
+
+    tmv::Matrix<T> m(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) m(i,j) = T(2+4*i-5*j)/T(N);
+    m.diag().addToAll(T(N));
+    tmv::Matrix<T> b(N,K);
+    for(int i=0;i<N;++i) for(int k=0;k<K;++k) b(i,k) = T(1+i-3*k)/T(K);
+    const T eps = EPS * Norm(m) * Norm(m.inverse());
+
+    tmv::DivType dts[4] = { tmv::LU, tmv::QR, tmv::QRP, tmv::SV };
+    for(int id=0;id<4;++id) {
+        tmv::DivType dt = dts[id];
+        tmv::Factorization<T> f;
+        Assert(f.isEmpty(),"Factorization default is empty");
+        {
+            // The factorization must not depend on the original matrix.
+            tmv::Matrix<T> m1 = m;
+            f = tmv::Factorization<T>(m1,dt);
+            m1.setZero();
+        }
+        Assert(f.getDivType() == dt,"Factorization getDivType");
+        Assert(!f.isSingular(),"Factorization isSingular");
+        T s0, s1;
+        const T ld0 = m.logDet(&s0);
+        const T ld1 = f.logDet(&s1);
+        Assert(Equal2(ld1,ld0,eps*(T(1)+std::abs(ld0))) && s1 == s0,
+               "Factorization logDet");
+
+        tmv::Matrix<T> x(N,K);
+        f.LDiv(b,x.view());
+        Assert(Norm(m*x-b) <= eps*Norm(b),"Factorization LDiv");
+        x = b;
+        f.LDivEq(x.view());
+        Assert(Norm(m*x-b) <= eps*Norm(b),"Factorization LDivEq");
+        tmv::Matrix<T> y(K,N);
+        f.RDiv(b.transpose(),y.view());
+        Assert(Norm(y*m-b.transpose()) <= eps*Norm(b),"Factorization RDiv");
+        tmv::Vector<T> v = b.col(3);
+        f.LDivEq(v.view());
+        Assert(Norm(m*v-b.col(3)) <= eps*Norm(b.col(3)),
+               "Factorization LDivEq vector");
+
+        // Copies share the factors and may be used from many threads.
+        tmv::Factorization<T> f2 = f;
+        tmv::Matrix<T> x2(N,K);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for(int k=0;k<K;++k) {
+            tmv::Factorization<T> fk = f2;
+            fk.LDiv(b.col(k),x2.col(k));
+        }
+        Assert(Norm(m*x2-b) <= eps*Norm(b),"Factorization shared LDiv");
+
+        // Binary serialization
+        std::vector<double> buf(f.blobSize()/sizeof(double)+1);
+        char* cbuf = reinterpret_cast<char*>(&buf[0]);
+        f.writeBlob(cbuf);
+        tmv::Factorization<T> f3 = 
+            tmv::Factorization<T>::readBlob(cbuf,f.blobSize());
+        tmv::Factorization<T> f4 = 
+            tmv::Factorization<T>::readBlob(cbuf,f.blobSize(),false);
+        std::stringstream ss;
+        f.writeBlob(ss);
+        tmv::Factorization<T> f5 = tmv::Factorization<T>::readBlob(ss);
+        Assert(f3.getDivType() == dt,"Factorization readBlob DivType");
+        T s3;
+        Assert(f3.logDet(&s3) == ld1 && s3 == s1,
+               "Factorization readBlob logDet");
+        tmv::Matrix<T> x3(N,K);
+        f3.LDiv(b,x3.view());
+        Assert(Norm(x3-x) <= eps*Norm(x),"Factorization readBlob LDiv");
+        f4.LDiv(b,x3.view());
+        Assert(Norm(x3-x) <= eps*Norm(x),"Factorization in place blob");
+        f5.LDiv(b,x3.view());
+        Assert(Norm(x3-x) <= eps*Norm(x),"Factorization stream blob");
+#ifndef NOTHROW
+        // A header whose section sizes do not match its M, N and DivType
+        // must be rejected, even if the blob is long enough for them.
+        std::vector<double> buf2 = buf;
+        char* cbuf2 = reinterpret_cast<char*>(&buf2[0]);
+        ptrdiff_t* hp = reinterpret_cast<ptrdiff_t*>(cbuf2);
+        int inF = 0;
+        while (inF < 16 && hp[inF] != ptrdiff_t(N)*N) ++inF;
+        Assert(inF < 16,"Found nF in the Factorization header");
+        hp[inF] = 1;
+        try {
+            tmv::Factorization<T>::readBlob(cbuf2,f.blobSize());
+            Assert(false,"Factorization readBlob with an invalid nF");
+        } catch (tmv::ReadError&) {
+            Assert(true,"Caught ReadError for an invalid nF");
+        }
+        buf[0] = 0.;
+        try {
+            tmv::Factorization<T>::readBlob(cbuf,f.blobSize());
+            Assert(false,"Factorization readBlob of a corrupt blob");
+        } catch (tmv::ReadError&) {
+            Assert(true,"Caught ReadError of a corrupt blob");
+        }
+#endif
+    }
+
+    // Least squares, including the case with more columns than rows.
+    tmv::Matrix<T> a(N,N/2);
+    for(int i=0;i<N;++i) for(int j=0;j<N/2;++j) a(i,j) = T(3+2*i-j*j)/T(N);
+    a.diag().addToAll(T(N));
+    const T aeps = EPS * Norm(a) * Norm(a.inverse()) * T(10);
+    for(int id=1;id<4;++id) {
+        tmv::DivType dt = dts[id];
+        tmv::Factorization<T> f(a,dt);
+        tmv::Matrix<T> x(N/2,K);
+        f.LDiv(b,x.view());
+        tmv::Matrix<T> x0 = b/a;
+        Assert(Norm(x-x0) <= aeps*Norm(x0),"Factorization least squares");
+
+        tmv::Factorization<T> ft(a.transpose(),dt);
+        tmv::Matrix<T> y(K,N/2);
+        ft.RDiv(b.transpose(),y.view());
+        Assert(Norm(y-x0.transpose()) <= aeps*Norm(x0),
+               "Factorization transposed least squares");
+
+        std::stringstream ss;
+        ft.writeBlob(ss);
+        tmv::Factorization<T> ft2 = tmv::Factorization<T>::readBlob(ss);
+        ft2.RDiv(b.transpose(),y.view());
+        Assert(Norm(y-x0.transpose()) <= aeps*Norm(x0),
+               "Factorization transposed readBlob");
+    }
+
+    // Symmetric decompositions
+    tmv::SymMatrix<T> s(N);
+    for(int i=0;i<N;++i) for(int j=0;j<=i;++j) s(i,j) = T(2+4*i-5*j)/T(N);
+    tmv::SymMatrix<T> sp = s;
+    sp.diag().addToAll(T(N));
+    s.diag().addToAll(T(1));  // Indefinite
+    tmv::DivType sdts[3] = { tmv::LU, tmv::CH, tmv::SV };
+    for(int id=0;id<3;++id) {
+        tmv::DivType dt = sdts[id];
+        const tmv::SymMatrix<T>& ss = dt == tmv::CH ? sp : s;
+        const T seps = EPS * Norm(ss) * Norm(ss.inverse());
+        tmv::Factorization<T> f(ss,dt);
+        Assert(f.isSym() == (dt != tmv::SV),"Factorization isSym");
+        T s0, s1;
+        const T ld0 = ss.logDet(&s0);
+        const T ld1 = f.logDet(&s1);
+        Assert(Equal2(ld1,ld0,seps*(T(1)+std::abs(ld0))) && s1 == s0,
+               "Factorization sym logDet");
+        tmv::Matrix<T> x(N,K);
+        f.LDiv(b,x.view());
+        Assert(Norm(ss*x-b) <= seps*Norm(b),"Factorization sym LDiv");
+        tmv::Matrix<T> y = b.transpose();
+        f.RDivEq(y.view());
+        Assert(Norm(y*ss-b.transpose()) <= seps*Norm(b),
+               "Factorization sym RDivEq");
+
+        std::stringstream str;
+        f.writeBlob(str);
+        tmv::Factorization<T> f2 = tmv::Factorization<T>::readBlob(str);
+        Assert(f2.isSym() == f.isSym(),"Factorization sym readBlob isSym");
+        tmv::Matrix<T> x2(N,K);
+        f2.LDiv(b,x2.view());
+        Assert(Norm(x2-x) <= seps*Norm(x),"Factorization sym readBlob");
+    }
+
+    // Complex hermitian and symmetric
+    tmv::HermMatrix<CT> h(N);
+    tmv::SymMatrix<CT> cs(N);
+    for(int i=0;i<N;++i) for(int j=0;j<=i;++j) {
+        h(i,j) = CT(T(2+4*i-5*j),T(2*i-2*j))/T(N);
+        cs(i,j) = CT(T(2+4*i-5*j),T(i-2*j))/T(N);
+    }
+    h.diag().addToAll(T(4*N));
+    cs.diag().addToAll(T(N));
+    tmv::Matrix<CT> cb = b;
+    cb.imagPart() = b;
+    const T heps = EPS * Norm(h) * Norm(h.inverse());
+    const T cseps = EPS * Norm(cs) * Norm(cs.inverse());
+    tmv::Factorization<CT> fch(h,tmv::CH);
+    tmv::Factorization<CT> fh(h,tmv::LU);
+    tmv::Factorization<CT> fs(cs,tmv::LU);
+    tmv::Matrix<CT> cx(N,K);
+    fch.LDiv(cb,cx.view());
+    Assert(Norm(h*cx-cb) <= heps*Norm(cb),"Factorization complex CH");
+    fh.LDiv(cb,cx.view());
+    Assert(Norm(h*cx-cb) <= heps*Norm(cb),"Factorization complex herm LDL");
+    fs.LDiv(cb,cx.view());
+    Assert(Norm(cs*cx-cb) <= cseps*Norm(cb),"Factorization complex sym LDL");
+    std::stringstream str;
+    fs.writeBlob(str);
+    tmv::Factorization<CT> fs2 = tmv::Factorization<CT>::readBlob(str);
+    tmv::Matrix<CT> cx2(N,K);
+    fs2.LDiv(cb,cx2.view());
+    Assert(Norm(cx2-cx) <= cseps*Norm(cx),"Factorization complex readBlob");
+#ifndef NOTHROW
+    try {
+        str.clear();
+        str.seekg(0);
+        tmv::Factorization<T>::readBlob(str);
+        Assert(false,"Factorization readBlob with the wrong type");
+    } catch (tmv::ReadError&) {
+        Assert(true,"Caught ReadError for the wrong type");
+    }
+#endif
+
+    std::cout<<"Factorization<"<<tmv::TMV_Text(T())<<"> passed all tests\n";
+}
+
+template <class T> 
+static void TestSolveQueue()
+{
+    const int N = 100;
+    const int K = 200;
+
+    tmv::Matrix<T> m(N,N);
+    for(int i=0;i<N;++i) for(int j=0;j<N;++j) m(i,j) = T(2+4*i-5*j)/T(N);
+    m.diag().addToAll(T(N));
+    tmv::Matrix<T> b(N,K);
+    for(int i=0;i<N;++i) for(int k=0;k<K;++k) b(i,k) = T(1+i-3*k)/T(K);
+    const T eps = EPS * Norm(m) * Norm(m.inverse());
+
+    // Many right hand sides at once use the parallel panel TRSM.
+    tmv::Matrix<T> x0 = b/m;
+    Assert(Norm(m*x0-b) <= eps*Norm(b),"Multi-RHS division");
+
+    tmv::Factorization<T> f(m);
+    tmv::SolveQueue<T> q(f,16,0.001);
+    Assert(q.getMaxBatch() == 16,"SolveQueue getMaxBatch");
+    tmv::Matrix<T> x(N,K);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(int k=0;k<K;++k) q.LDiv(b.col(k),x.col(k));
+    Assert(Norm(m*x-b) <= eps*Norm(b),"SolveQueue LDiv");
+    Assert(q.getNumSolved() == K,"SolveQueue getNumSolved");
+    Assert(q.getNumPanels() >= K/16 && q.getNumPanels() <= K,
+           "SolveQueue getNumPanels");
+
+    // Several columns per request, including some at least a full panel.
+    q.setMaxWait(0.);
+    q.setMaxBatch(8);
+    x.setZero();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(int k=0;k<K/10;++k) 
+        q.LDiv(b.colRange(10*k,10*k+k%11),x.colRange(10*k,10*k+k%11));
+    for(int k=0;k<K/10;++k) {
+        Assert(Norm(m*x.colRange(10*k,10*k+k%11)-b.colRange(10*k,10*k+k%11))
+               <= eps*Norm(b),"SolveQueue multiple columns");
+    }
+
+    // Callers that keep sending requests must not keep any other caller
+    // from getting its answer.  Each thread makes at least nreq requests,
+    // and then it keeps going until every thread has made nreq, so the 
+    // loop only ends if each call returns while the others continue.
+    const int nreq = 20;
+    int nthreads = 1;
+    int nfinished = 0;
+    int nbad = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+ : nbad)
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp single
+        nthreads = omp_get_num_threads();
+        const int mythread = omp_get_thread_num();
+#else
+        const int mythread = 0;
+#endif
+        tmv::Vector<T> y(N);
+        for(int i=0;;++i) {
+            const int k = (7*i + mythread) % K;
+            q.LDiv(b.col(k),y.view());
+            if (!(Norm(m*y-b.col(k)) <= eps*Norm(b))) ++nbad;
+            int nf;
+#ifdef _OPENMP
+#pragma omp critical (TestSolveQueue_finished)
+#endif
+            {
+                if (i+1 == nreq) ++nfinished;
+                nf = nfinished;
+            }
+            if (i+1 >= nreq && nf == nthreads) break;
+        }
+    }
+    Assert(nbad == 0,"SolveQueue continuous requests");
+
+    std::cout<<"SolveQueue<"<<tmv::TMV_Text(T())<<"> passed all tests\n";
+}
+
 template <class T> 
 void TestAllSymDiv()
 {
@@ -342,6 +643,7 @@ void TestAllSymDiv()
     TestSymDecomp<T,tmv::Lower,tmv::RowMajor>();
     TestPolar<T,tmv::RowMajor>();
     TestPolar<T,tmv::ColMajor>();
+    TestOpenMPHermDecomp<T>();
     std::cout<<"SymMatrix<"<<tmv::TMV_Text(T())<<"> passed all ";
     std::cout<<"decomposition tests.\n";
     TestSymDiv<T>(tmv::CH,PosDef);
@@ -350,6 +652,8 @@ void TestAllSymDiv()
     TestSymDiv<T>(tmv::SV,PosDef);
     TestSymDiv<T>(tmv::SV,InDef);
     TestSymDiv<T>(tmv::SV,Sing);
+    TestFactorization<T>();
+    TestSolveQueue<T>();
 }
 
 #ifdef TEST_DOUBLE
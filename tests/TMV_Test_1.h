@@ -15,7 +15,9 @@ template <class T> void TestMatrixArith_7();
 template <class T> void TestMatrixArith_8();
 template <class T> void TestMatrixDiv();
 template <class T> void TestMatrixDet();
+template <class T> void TestAllocator();
 template <class T, tmv::StorageType stor> void TestMatrixDecomp();
+template <class T> void TestOpenMPDecomp();
 
 template <class T> void TestDiagMatrix();
 template <class T> void TestDiagMatrixArith_A1();
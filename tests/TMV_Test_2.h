@@ -20,6 +20,7 @@ template <class T> void TestBandDiv_C1(tmv::DivType dt);
 template <class T> void TestBandDiv_C2(tmv::DivType dt);
 template <class T> void TestBandDiv_D1(tmv::DivType dt);
 template <class T> void TestBandDiv_D2(tmv::DivType dt);
+template <class T> void TestBatchedBandMatrix();
 
 enum PosDefCode { PosDef, InDef, Sing };
 inline std::string PDLabel(PosDefCode pdc)
@@ -46,6 +47,7 @@ void TestHermDecomp();
 template <class T, tmv::UpLoType uplo, tmv::StorageType stor>
 void TestSymDecomp();
 template <class T, tmv::StorageType stor> void TestPolar();
+template <class T> void TestOpenMPHermDecomp();
 template <class T> void TestSymDiv_A(tmv::DivType dt, PosDefCode pc);
 template <class T> void TestSymDiv_B1(tmv::DivType dt, PosDefCode pc);
 template <class T> void TestSymDiv_B2(tmv::DivType dt, PosDefCode pc);
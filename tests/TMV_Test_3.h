@@ -48,6 +48,7 @@ template <class T> void TestAllSmallMatrixDiv();
 template <class T> void TestAllSmallMatrixDivA();
 template <class T> void TestAllSmallMatrixDivB();
 template <class T> void TestSmallMatrixDet();
+template <class T> void TestBatchedSmallMatrix();
 template <class T> void TestSmallMatrixDiv_A1a();
 template <class T> void TestSmallMatrixDiv_A1b();
 template <class T> void TestSmallMatrixDiv_A1c();